@@ -0,0 +1,317 @@
+/**
+ * anim.cpp
+ * Implementation of the tween animator
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "anim.h"
+
+// ========== EASING TABLES ==========
+
+#define ANIM_LUT_SIZE ((1 << ANIM_LUT_BITS) + 1)
+
+/**
+ * Easing curves for table generation (compile time only)
+ * 
+ * t and the result are plain numbers, 0.0 - 1.0.
+ */
+static constexpr double easeCurve(int easing, double t) {
+    switch (easing) {
+    case EASE_IN_QUAD:
+        return t * t;
+    case EASE_OUT_QUAD:
+        return 1 - (1 - t) * (1 - t);
+    case EASE_IN_OUT_QUAD:
+        return t < 0.5 ? 2 * t * t : 1 - 2 * (1 - t) * (1 - t);
+    case EASE_IN_CUBIC:
+        return t * t * t;
+    case EASE_OUT_CUBIC:
+        return 1 - (1 - t) * (1 - t) * (1 - t);
+    case EASE_IN_OUT_CUBIC:
+        return t < 0.5 ? 4 * t * t * t : 1 - 4 * (1 - t) * (1 - t) * (1 - t);
+    case EASE_OUT_BACK: {
+        // Overshoots by about 10 % around t = 0.6
+        const double c1 = 1.70158;
+        return 1 + (c1 + 1) * (t - 1) * (t - 1) * (t - 1) + c1 * (t - 1) * (t - 1);
+    }
+    case EASE_OUT_BOUNCE: {
+        // Four parabolas with decreasing height
+        const double n = 7.5625, d = 2.75;
+        if (t < 1 / d) return n * t * t;
+        if (t < 2 / d) { t -= 1.5 / d; return n * t * t + 0.75; }
+        if (t < 2.5 / d) { t -= 2.25 / d; return n * t * t + 0.9375; }
+        t -= 2.625 / d;
+        return n * t * t + 0.984375;
+    }
+    default:
+        return t;
+    }
+}
+
+/**
+ * All curves sampled at 257 points, Q14 (16384 = 1.0)
+ * 
+ * Q14 instead of Q16 so the overshoot of EASE_OUT_BACK fits into an
+ * int16_t. 9 curves × 257 × 2 bytes = 4.6 KB of flash.
+ */
+struct AnimEaseTable {
+    int16_t v[EASE_COUNT][ANIM_LUT_SIZE];
+};
+
+static constexpr AnimEaseTable makeEaseTable() {
+    AnimEaseTable table = {};
+    for (int e = 0; e < EASE_COUNT; e++) {
+        for (int i = 0; i < ANIM_LUT_SIZE; i++) {
+            double v = easeCurve(e, (double)i / (ANIM_LUT_SIZE - 1)) * 16384.0;
+            table.v[e][i] = (int16_t)(v >= 0 ? v + 0.5 : v - 0.5);
+        }
+    }
+    return table;
+}
+
+static constexpr AnimEaseTable ANIM_EASE = makeEaseTable();
+
+/**
+ * Table lookup with linear interpolation
+ * 
+ * The top ANIM_LUT_BITS bits of t select the entry, the remaining
+ * bits interpolate towards the next one.
+ */
+q16_t animEase(AnimEasing easing, q16_t t) {
+    if (t <= 0) return 0;
+    if (t >= 65536) return 65536;
+    if (easing == EASE_LINEAR || easing >= EASE_COUNT) return t;
+    
+    const int16_t* lut = ANIM_EASE.v[easing];
+    const int fracBits = 16 - ANIM_LUT_BITS;
+    int32_t index = t >> fracBits;
+    int32_t frac = t & ((1 << fracBits) - 1);
+    int32_t a = lut[index];
+    int32_t b = lut[index + 1];
+    int32_t q14 = a + (((b - a) * frac) >> fracBits);
+    return q14 << 2;  // Q14 → Q16
+}
+
+// ========== ANIMATOR ==========
+
+Animator::Animator() : _now(0) {
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+        _tweens[i].active = false;
+        _tweens[i].generation = 0;
+    }
+}
+
+/**
+ * Handle layout: generation in the high byte, slot + 1 in the low byte
+ */
+Animator::Tween* Animator::find(AnimHandle handle) {
+    uint8_t slot = (handle & 0xFF) - 1;
+    if (slot >= ANIM_MAX_TWEENS) return nullptr;
+    Tween& t = _tweens[slot];
+    if (!t.active || t.generation != (handle >> 8)) return nullptr;
+    return &t;
+}
+
+const Animator::Tween* Animator::find(AnimHandle handle) const {
+    return const_cast<Animator*>(this)->find(handle);
+}
+
+AnimHandle Animator::start(int16_t* target, int16_t to, uint16_t durationMs,
+                           AnimEasing easing, uint32_t delayMs, Rect* bounds) {
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+        Tween& t = _tweens[i];
+        if (t.active) continue;
+        
+        t.target = target;
+        t.bounds = bounds;
+        t.callback = nullptr;
+        t.context = nullptr;
+        t.startMs = _now + delayMs;
+        t.durationMs = durationMs ? durationMs : 1;
+        t.from = *target;
+        t.to = to;
+        t.easing = easing;
+        t.repeat = 0;
+        t.generation++;
+        t.active = true;
+        t.started = false;
+        t.yoyo = false;
+        t.changed = false;
+        t.finished = false;
+        return (AnimHandle)((t.generation << 8) | (i + 1));
+    }
+    return 0;
+}
+
+void Animator::setRepeat(AnimHandle handle, uint8_t count, bool yoyo) {
+    Tween* t = find(handle);
+    if (!t) return;
+    t->repeat = count;
+    t->yoyo = yoyo;
+}
+
+void Animator::onDone(AnimHandle handle, AnimCallback callback, void* context) {
+    Tween* t = find(handle);
+    if (!t) return;
+    t->callback = callback;
+    t->context = context;
+}
+
+bool Animator::cancel(AnimHandle handle) {
+    Tween* t = find(handle);
+    if (!t) return false;
+    t->active = false;
+    return true;
+}
+
+void Animator::cancelAll() {
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+        _tweens[i].active = false;
+    }
+}
+
+bool Animator::isActive(AnimHandle handle) const {
+    return find(handle) != nullptr;
+}
+
+uint8_t Animator::activeCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+        if (_tweens[i].active) count++;
+    }
+    return count;
+}
+
+/**
+ * Value of one tween at a point in time
+ * 
+ * progress = elapsed / duration (Q16), eased through the table, then
+ * value = from + (to - from) × eased. A run that ended is restarted
+ * (repeat) or marked finished.
+ */
+void Animator::compute(Tween& t, uint32_t nowMs) {
+    uint32_t elapsed = nowMs - t.startMs;
+    bool runEnded = elapsed >= t.durationMs;
+    // elapsed < 65536 here, so elapsed << 16 fits in 32 bits
+    q16_t progress = runEnded ? 65536 : (q16_t)((elapsed << 16) / t.durationMs);
+    q16_t eased = animEase((AnimEasing)t.easing, progress);
+    
+    int32_t delta = (int32_t)t.to - t.from;
+    int32_t value = t.from + (int32_t)(((int64_t)delta * eased + 0x8000) >> 16);
+    if (value < INT16_MIN) value = INT16_MIN;
+    if (value > INT16_MAX) value = INT16_MAX;
+    t.next = (int16_t)value;
+    t.changed = t.next != *t.target;
+    
+    if (!runEnded) return;
+    if (t.repeat) {
+        if (t.repeat != ANIM_FOREVER) t.repeat--;
+        t.startMs += t.durationMs;
+        if (t.yoyo) {
+            int16_t swap = t.from;
+            t.from = t.to;
+            t.to = swap;
+        }
+    } else {
+        t.finished = true;
+    }
+}
+
+/**
+ * Frame update
+ * 
+ * 
+ * 1. Compute the new value of every tween that is due.
+ * 2. Add old bounds of every element whose value changes.
+ * 3. Write the new values.
+ * 4. Add new bounds.
+ * 5. Free finished tweens and call their callbacks.
+ */
+void Animator::update(uint32_t nowMs, DirtyRects* dirty) {
+    _now = nowMs;
+    
+    // ========== COMPUTE ==========
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+        _tweens[i].changed = false;
+        _tweens[i].finished = false;
+    }
+    // Running tweens first, then the ones whose delay just ended, so
+    // a step that follows another on the same value starts from that
+    // step's final value
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+            Tween& t = _tweens[i];
+            if (!t.active || t.started != (pass == 0)) continue;
+            if ((int32_t)(nowMs - t.startMs) < 0) continue;  // Still delayed
+            
+            if (!t.started) {
+                t.from = *t.target;
+                for (uint8_t j = 0; j < ANIM_MAX_TWEENS; j++) {
+                    Tween& other = _tweens[j];
+                    if (j != i && other.changed && other.target == t.target) {
+                        t.from = other.next;
+                        other.changed = false;  // Superseded by this step
+                    }
+                }
+                t.started = true;
+            }
+            compute(t, nowMs);
+        }
+    }
+    
+    // ========== OLD BOUNDS ==========
+    if (dirty) {
+        for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+            if (_tweens[i].changed && _tweens[i].bounds) dirty->add(*_tweens[i].bounds);
+        }
+    }
+    
+    // ========== WRITE ==========
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+        if (_tweens[i].changed) *_tweens[i].target = _tweens[i].next;
+    }
+    
+    // ========== NEW BOUNDS ==========
+    if (dirty) {
+        for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+            if (_tweens[i].changed && _tweens[i].bounds) dirty->add(*_tweens[i].bounds);
+        }
+    }
+    
+    // ========== FINISH ==========
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++) {
+        Tween& t = _tweens[i];
+        if (!t.active || !t.finished) continue;
+        t.active = false;
+        t.finished = false;
+        if (t.callback) t.callback(t.context);  // May reuse this slot
+    }
+}
+
+// ========== TIMELINE ==========
+
+AnimTimeline::AnimTimeline(Animator& animator)
+    : _animator(animator), _stepStart(0), _end(0), _last(0) {
+}
+
+AnimTimeline& AnimTimeline::then(int16_t* target, int16_t to, uint16_t durationMs,
+                                 AnimEasing easing, Rect* bounds) {
+    _stepStart = _end;
+    _last = _animator.start(target, to, durationMs, easing, _stepStart, bounds);
+    _end = _stepStart + durationMs;
+    return *this;
+}
+
+AnimTimeline& AnimTimeline::with(int16_t* target, int16_t to, uint16_t durationMs,
+                                 AnimEasing easing, Rect* bounds) {
+    _last = _animator.start(target, to, durationMs, easing, _stepStart, bounds);
+    if (_stepStart + durationMs > _end) _end = _stepStart + durationMs;
+    return *this;
+}
+
+AnimTimeline& AnimTimeline::wait(uint32_t ms) {
+    _end += ms;
+    _stepStart = _end;
+    return *this;
+}
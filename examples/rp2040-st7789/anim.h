@@ -0,0 +1,251 @@
+/**
+ * anim.h
+ * Fixed-point tween animations with easing curves
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * A tween moves one int16_t value (a coordinate, a width, a color
+ * channel, ...) from wherever it is to a target value over a given
+ * time, following an easing curve. The Animator owns a fixed pool of
+ * tweens and updates all of them once per frame; nothing is allocated.
+ * 
+ * Fixed point: progress and curve values are Q16 (65536 = 1.0), so
+ * there is no soft-float on the Cortex-M0+. Easing curves are sampled
+ * at compile time into tables in flash and linearly interpolated.
+ * 
+ * Redrawing: a tween can be given the bounds of the element it moves.
+ * When the value changes, update() adds the element's old and new
+ * bounds to a DirtyRects list, so only those areas need redrawing.
+ * Usually the tween's target is a field of those bounds:
+ * 
+ * example:
+ * 
+ * Rect icon = { 0, 100, 32, 32 };
+ * Animator anim;
+ * anim.start(&icon.x, 200, 500, EASE_OUT_BACK, 0, &icon);
+ * 
+ * // Every frame:
+ * DirtyRects dirty;
+ * anim.update(to_ms_since_boot(get_absolute_time()), &dirty);
+ * for (uint8_t i = 0; i < dirty.count(); i++) redrawArea(dirty[i]);
+ * 
+ * Sequences are built with AnimTimeline (see below).
+ * 
+ */
+
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <stdint.h>
+#include "fixmath.h"
+#include "rect.h"
+#include "dirtyrect.h"
+
+#define ANIM_MAX_TWEENS 32    // < Tweens running at the same time
+#define ANIM_LUT_BITS   8     // < Easing tables have 2^8 + 1 entries
+#define ANIM_FOREVER    0xFF  // < Repeat count for endless loops
+
+/**
+ * Easing curves
+ * 
+ * In: slow start. Out: slow end. InOut: both. Back overshoots the
+ * target a little before settling, Bounce bounces on it.
+ */
+enum AnimEasing {
+    EASE_LINEAR,
+    EASE_IN_QUAD,
+    EASE_OUT_QUAD,
+    EASE_IN_OUT_QUAD,
+    EASE_IN_CUBIC,
+    EASE_OUT_CUBIC,
+    EASE_IN_OUT_CUBIC,
+    EASE_OUT_BACK,
+    EASE_OUT_BOUNCE,
+    EASE_COUNT
+};
+
+/**
+ * Function called when a tween ends
+ * 
+ * context The pointer given to Animator::onDone()
+ * 
+ * May start new tweens (e.g. to chain a state change).
+ */
+typedef void (*AnimCallback)(void* context);
+
+/**
+ * Tween reference returned by Animator::start(), 0 = none
+ * 
+ * Stays safe after the tween ended: a reused pool slot gets a new
+ * handle, so an old handle can never cancel someone else's tween.
+ */
+typedef uint16_t AnimHandle;
+
+/**
+ * Evaluate an easing curve
+ * 
+ * easing Curve
+ * t Progress, Q16, 0 - 65536
+ * 
+ * returns Eased progress, Q16 (may leave 0 - 65536 for EASE_OUT_BACK)
+ */
+q16_t animEase(AnimEasing easing, q16_t t);
+
+/**
+ * Tween pool and per-frame update
+ */
+class Animator {
+public:
+    Animator();
+    
+    /**
+     * Start a tween
+     * 
+     * target Value to animate
+     * to End value
+     * durationMs Duration in milliseconds (1 - 65535)
+     * easing Curve
+     * delayMs Wait this long (from the last update() time) first
+     * bounds Element moved by this tween, or nullptr
+     * 
+     * returns Handle, or 0 if the pool is full
+     * 
+     * The start value is read from target when the delay is over, so
+     * several tweens on the same value can run one after the other.
+     */
+    AnimHandle start(int16_t* target, int16_t to, uint16_t durationMs,
+                     AnimEasing easing, uint32_t delayMs = 0, Rect* bounds = nullptr);
+    
+    /**
+     * Repeat a tween
+     * 
+     * handle Tween
+     * count Extra runs after the first, ANIM_FOREVER for endless
+     * yoyo true to run backwards every second time (ping-pong)
+     */
+    void setRepeat(AnimHandle handle, uint8_t count, bool yoyo);
+    
+    /**
+     * Call a function when the tween ends (not when cancelled)
+     */
+    void onDone(AnimHandle handle, AnimCallback callback, void* context);
+    
+    /**
+     * Stop a tween where it is
+     * 
+     * returns false if it had already ended
+     */
+    bool cancel(AnimHandle handle);
+    
+    /**
+     * Stop every tween
+     */
+    void cancelAll();
+    
+    /**
+     * True while the tween is waiting or running
+     */
+    bool isActive(AnimHandle handle) const;
+    
+    /**
+     * Number of tweens waiting or running
+     */
+    uint8_t activeCount() const;
+    
+    /**
+     * Advance all tweens to a point in time
+     * 
+     * nowMs Current time in milliseconds (wraps safely)
+     * dirty Receives old and new bounds of moved elements, or nullptr
+     * 
+     * 
+     * All new values are computed first and written afterwards, so
+     * an element moved by two tweens (x and y) adds its bounds from
+     * before and after the frame, not an intermediate position.
+     */
+    void update(uint32_t nowMs, DirtyRects* dirty);
+    
+    /**
+     * Time of the last update()
+     */
+    uint32_t now() const { return _now; }
+
+private:
+    /**
+     * One pool entry
+     */
+    struct Tween {
+        int16_t* target;
+        Rect* bounds;
+        AnimCallback callback;
+        void* context;
+        uint32_t startMs;      // < When the current run starts
+        uint16_t durationMs;
+        int16_t from, to;
+        int16_t next;          // < Value computed by the current update()
+        uint8_t easing;
+        uint8_t repeat;        // < Runs left after this one
+        uint8_t generation;    // < Part of the handle, bumped on reuse
+        bool active;
+        bool started;          // < from has been read
+        bool yoyo;
+        bool changed;          // < next differs from *target
+        bool finished;         // < Ends in the current update()
+    };
+    
+    Tween _tweens[ANIM_MAX_TWEENS];
+    uint32_t _now;
+    
+    Tween* find(AnimHandle handle);
+    const Tween* find(AnimHandle handle) const;
+    void compute(Tween& t, uint32_t nowMs);
+};
+
+/**
+ * Builder for sequences of tweens
+ * 
+ * 
+ * then() starts a step when the previous step ends, with() starts it
+ * together with the previous step, wait() inserts a pause. Steps are
+ * ordinary tweens with computed delays, scheduled at once:
+ * 
+ * example:
+ * 
+ * AnimTimeline(anim)
+ *     .then(&menu.x, 0, 300, EASE_OUT_CUBIC, &menu)     // Slide in
+ *     .with(&menu.w, 160, 300, EASE_OUT_CUBIC, &menu)   // and grow
+ *     .wait(1000)
+ *     .then(&menu.x, -160, 200, EASE_IN_QUAD, &menu);   // Slide out
+ */
+class AnimTimeline {
+public:
+    /**
+     * Start a new sequence at the animator's current time
+     */
+    explicit AnimTimeline(Animator& animator);
+    
+    AnimTimeline& then(int16_t* target, int16_t to, uint16_t durationMs,
+                       AnimEasing easing, Rect* bounds = nullptr);
+    AnimTimeline& with(int16_t* target, int16_t to, uint16_t durationMs,
+                       AnimEasing easing, Rect* bounds = nullptr);
+    AnimTimeline& wait(uint32_t ms);
+    
+    /**
+     * Handle of the step added last (e.g. for onDone())
+     */
+    AnimHandle last() const { return _last; }
+    
+    /**
+     * Time from the start of the sequence to its end
+     */
+    uint32_t length() const { return _end; }
+
+private:
+    Animator& _animator;
+    uint32_t _stepStart;  // < Delay of the last step
+    uint32_t _end;        // < Delay at which the sequence ends
+    AnimHandle _last;
+};
+
+#endif // ANIM_H
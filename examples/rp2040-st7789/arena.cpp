@@ -0,0 +1,84 @@
+/**
+ * arena.cpp
+ * Implementation of the frame arena
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "arena.h"
+
+static FrameArena* s_arenas[2] = { nullptr, nullptr };   // < Arena of each core
+
+FrameArena::FrameArena(void* memory, uint32_t bytes)
+    : _memory((uint8_t*)memory), _capacity(bytes), _used(0), _frameHigh(0), _failed(false),
+      _stats() {
+}
+
+void* FrameArena::alloc(uint32_t bytes, uint32_t align) {
+    uint32_t start = (_used + align - 1) & ~(align - 1);
+    if (start > _capacity || bytes > _capacity - start) {
+        refuse();
+        return nullptr;
+    }
+    _used = start + bytes;
+    noteUse();
+    return _memory + start;
+}
+
+bool FrameArena::grow(void* block, uint32_t bytes, uint32_t more) {
+    if ((uint8_t*)block + bytes != _memory + _used) return false;
+    if (more > _capacity - _used) {
+        refuse();
+        return false;
+    }
+    _used += more;
+    noteUse();
+    return true;
+}
+
+void FrameArena::refuse() {
+    _stats.failures++;
+    _failed = true;
+}
+
+void FrameArena::noteUse() {
+    if (_used > _frameHigh) {
+        _frameHigh = _used;
+        if (_used > _stats.highWater) _stats.highWater = _used;
+    }
+}
+
+void FrameArena::reset() {
+    _stats.frames++;
+    _stats.lastFrame = _frameHigh;
+    if (_failed) _stats.failedFrames++;
+    _used = 0;
+    _frameHigh = 0;
+    _failed = false;
+}
+
+void FrameArena::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// ========== PER CORE ==========
+
+void FrameArena::setForCore(uint8_t core, FrameArena* arena) {
+    if (core < 2) s_arenas[core] = arena;
+}
+
+FrameArena* FrameArena::forCore(uint8_t core) {
+    return core < 2 ? s_arenas[core] : nullptr;
+}
+
+FrameArena* FrameArena::current() {
+    return s_arenas[get_core_num()];
+}
+
+void FrameArena::beginFrame() {
+    for (uint8_t core = 0; core < 2; core++) {
+        if (s_arenas[core]) s_arenas[core]->reset();
+    }
+}
@@ -0,0 +1,174 @@
+/**
+ * arena.h
+ * Per-frame bump allocator, one per core
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Render temporaries (span lists, visible-object lists, layouts of
+ * text that changes every frame) live for one frame at most. Giving
+ * them to malloc() costs a search of the newlib heap for every
+ * allocation and leaves it fragmented; FrameArena hands out memory by
+ * moving a pointer, and takes it all back at once when the next frame
+ * starts (reset()). Nothing is freed one by one, but mark() and
+ * rewind() drop everything allocated since a point, for temporaries
+ * of a single call. The last allocation can grow in place (grow()),
+ * for buffers whose final size is not known up front.
+ * 
+ * Each core gets its own arena (setForCore()), so the two cores never
+ * share one and no locking is needed; code finds the arena of the
+ * core it runs on with FrameArena::current(). The render loop calls
+ * FrameArena::beginFrame() at the start of every frame. Rasterizer
+ * and LinePipeline rewind the arena of the rendering core after each
+ * render call, so what a render function allocates for its strip is
+ * gone before the next strip.
+ * 
+ * When an arena is full, alloc() returns nullptr and the frame is
+ * counted as failed; nothing else happens. Users must have a way to
+ * draw without the memory (immediate mode: smaller batches on the
+ * stack, drawing each item as it comes) and take it, so running out
+ * costs speed, never pixels. The high-water mark tells how big the
+ * arena needs to be.
+ * 
+ * Arenas are for thread context only, not for interrupt handlers.
+ * 
+ * example:
+ * 
+ * static uint8_t arenaMemory[2][8192] __attribute__((aligned(8)));
+ * static FrameArena arena0(arenaMemory[0], 8192), arena1(arenaMemory[1], 8192);
+ * FrameArena::setForCore(0, &arena0);
+ * FrameArena::setForCore(1, &arena1);
+ * while (true) {
+ *     FrameArena::beginFrame();
+ *     ...                                     // TextLayoutCache::draw() etc. use current()
+ * }
+ * printf("high water %lu bytes\n", arena0.stats().highWater);
+ * 
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdint.h>
+
+#define ARENA_ALIGN 4   // < Default alignment of alloc()
+
+/**
+ * Counters since construction or the last resetStats()
+ */
+struct FrameArenaStats {
+    uint32_t frames;         // < reset() calls
+    uint32_t lastFrame;      // < Most bytes in use during the last frame
+    uint32_t highWater;      // < Most bytes ever in use
+    uint32_t failures;       // < Allocations refused because the arena was full
+    uint32_t failedFrames;   // < Frames with at least one refused allocation
+};
+
+/**
+ * Bump allocator over a block of caller memory
+ */
+class FrameArena {
+public:
+    /**
+     * memory Arena memory, 8-byte aligned
+     * bytes Size of memory
+     */
+    FrameArena(void* memory, uint32_t bytes);
+    
+    /**
+     * Allocate memory for the rest of the frame
+     * 
+     * bytes Size
+     * align Alignment, a power of two up to 8
+     * 
+     * returns the memory, or nullptr if the arena is full
+     */
+    void* alloc(uint32_t bytes, uint32_t align = ARENA_ALIGN);
+    
+    /**
+     * Allocate an array of count T (not constructed)
+     */
+    template <typename T>
+    T* allocArray(uint32_t count) {
+        if (count > UINT32_MAX / sizeof(T)) count = UINT32_MAX / sizeof(T);  // Refused by alloc()
+        return (T*)alloc(count * sizeof(T), alignof(T));
+    }
+    
+    /**
+     * Make the last allocation larger, in place
+     * 
+     * block The last block alloc() returned
+     * bytes Its size now
+     * more Bytes to add
+     * 
+     * returns false (block unchanged) if something was allocated after
+     * it or the arena is full
+     * 
+     * 
+     * For buffers whose final size is not known up front.
+     */
+    bool grow(void* block, uint32_t bytes, uint32_t more);
+    
+    /**
+     * Position to rewind() to
+     */
+    uint32_t mark() const { return _used; }
+    
+    /**
+     * Drop everything allocated since mark() returned m
+     */
+    void rewind(uint32_t m) {
+        if (m < _used) _used = m;
+    }
+    
+    /**
+     * Start a new frame: everything allocated is dropped
+     */
+    void reset();
+    
+    uint32_t used() const { return _used; }
+    uint32_t capacity() const { return _capacity; }
+    uint32_t available() const { return _capacity - _used; }
+    
+    const FrameArenaStats& stats() const { return _stats; }
+    void resetStats();
+    
+    // ========== PER CORE ==========
+    
+    /**
+     * Set the arena of a core (nullptr: none, users draw in immediate
+     * mode)
+     */
+    static void setForCore(uint8_t core, FrameArena* arena);
+    
+    /**
+     * Arena of a core, or nullptr
+     */
+    static FrameArena* forCore(uint8_t core);
+    
+    /**
+     * Arena of the calling core, or nullptr
+     */
+    static FrameArena* current();
+    
+    /**
+     * reset() the arenas of both cores
+     * 
+     * 
+     * From the render loop, while neither core is inside a frame.
+     */
+    static void beginFrame();
+
+private:
+    uint8_t* _memory;
+    uint32_t _capacity;
+    uint32_t _used;
+    uint32_t _frameHigh;   // < Most bytes in use in this frame
+    bool _failed;          // < An allocation was refused in this frame
+    FrameArenaStats _stats;
+    
+    void refuse();
+    void noteUse();
+};
+
+#endif // ARENA_H
@@ -0,0 +1,115 @@
+/**
+ * assetpack.cpp
+ * Implementation of the flash asset pack
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "assetpack.h"
+#include "bytes.h"
+#include "hardware/regs/addressmap.h"
+
+extern char __flash_binary_end;   // End of the firmware in flash (linker script)
+
+AssetPack::AssetPack()
+    : _data(nullptr), _size(0), _count(0), _hashes(nullptr), _entries(nullptr), _names(nullptr) {
+}
+
+bool AssetPack::open(const uint8_t* data, size_t size) {
+    _count = 0;
+    if (size < ASSET_PACK_HEADER_SIZE || ((uintptr_t)data & 3) || memcmp(data, "PAK1", 4) != 0) {
+        return false;
+    }
+    uint16_t count = read16(data + 4);
+    uint32_t packSize = read32(data + 8);
+    uint32_t namesSize = read32(data + 12);
+    uint32_t dataStart = ASSET_PACK_HEADER_SIZE + count * (4u + ASSET_ENTRY_SIZE) + namesSize;
+    if (count == 0 || packSize > size || namesSize > packSize || dataStart > packSize || namesSize == 0 ||
+        (namesSize & 3)) {
+        return false;
+    }
+    
+    // Tables are read in place: hashes ascending, every asset inside the pack
+    const uint32_t* hashes = (const uint32_t*)(data + ASSET_PACK_HEADER_SIZE);
+    const Entry* entries = (const Entry*)(hashes + count);
+    const char* names = (const char*)(entries + count);
+    if (names[namesSize - 1] != 0) return false;  // Last name terminated
+    for (uint16_t i = 0; i < count; i++) {
+        const Entry& e = entries[i];
+        if (i > 0 && hashes[i] <= hashes[i - 1]) return false;
+        if (e.offset < dataStart || e.offset > packSize || (e.offset & 3) || e.size > packSize - e.offset) {
+            return false;
+        }
+        if (e.name >= namesSize) return false;
+        if (e.format == ASSET_RGB565 && e.size != (uint32_t)e.width * e.height * 2) return false;
+    }
+    
+    _data = data;
+    _size = packSize;
+    _hashes = hashes;
+    _entries = entries;
+    _names = names;
+    _count = count;
+    return true;
+}
+
+bool AssetPack::openPartition() {
+    uintptr_t start = XIP_BASE + ASSET_PARTITION_OFFSET;
+    if ((uintptr_t)&__flash_binary_end > start) {
+        _count = 0;
+        return false;  // The firmware has grown into the partition
+    }
+    return open((const uint8_t*)start, ASSET_PARTITION_SIZE);
+}
+
+// ========== LOOKUP ==========
+
+int32_t AssetPack::indexOf(uint32_t hash) const {
+    int32_t lo = 0;
+    int32_t hi = (int32_t)_count - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        uint32_t h = _hashes[mid];
+        if (h < hash) lo = mid + 1;
+        else if (h > hash) hi = mid - 1;
+        else return mid;
+    }
+    return -1;
+}
+
+bool AssetPack::at(uint16_t index, Asset& asset) const {
+    if (index >= _count) return false;
+    const Entry& e = _entries[index];
+    asset.data = _data + e.offset;
+    asset.size = e.size;
+    asset.format = e.format;
+    asset.width = e.width;
+    asset.height = e.height;
+    asset.name = _names + e.name;
+    return true;
+}
+
+bool AssetPack::findHash(uint32_t hash, Asset& asset) const {
+    int32_t index = indexOf(hash);
+    return index >= 0 && at((uint16_t)index, asset);
+}
+
+bool AssetPack::find(const char* name, Asset& asset) const {
+    int32_t index = indexOf(assetHash(name));
+    if (index < 0 || strcmp(_names + _entries[index].name, name) != 0) return false;
+    return at((uint16_t)index, asset);
+}
+
+// ========== DRAWING ==========
+
+bool AssetPack::drawImage(ST7789& display, int16_t x, int16_t y, const Asset& asset,
+                          XipStream* stream) {
+    if (asset.format != ASSET_RGB565) return false;
+    if (stream && asset.size >= XIP_STREAM_MIN_BYTES) {
+        stream->drawImage(display, x, y, asset.width, asset.height, (const uint16_t*)asset.data);
+    } else {
+        display.drawBufferAsync(x, y, asset.width, asset.height, (const uint16_t*)asset.data);
+    }
+    return true;
+}
@@ -0,0 +1,189 @@
+/**
+ * assetpack.h
+ * Read-only asset pack in its own flash partition
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Keeps pictures, fonts, clips and splashes out of the firmware: they
+ * are packed into one file by tools/assetpack.py and written to a
+ * flash partition of their own, so UI art can be changed without
+ * building or flashing the firmware again.
+ * 
+ * Nothing is copied or loaded. The pack is used where it lies in the
+ * XIP window, and every asset is a pointer into flash and a size:
+ * RGB565 pictures go from flash to the SPI by DMA (drawImage()), and
+ * the other formats are opened in place by their players
+ * (JpegDecoder, DeltaPlayer, VideoPlayer, BootSplash, Font). Large
+ * pictures can be read through an XipStream instead, so they do not
+ * push the code out of the XIP cache.
+ * 
+ * Assets are found by name. The index is a sorted table of 32-bit
+ * FNV-1a hashes of the names, kept apart from the entries so the
+ * binary search only reads hashes (two per XIP cache line); the
+ * packer refuses names with the same hash, and find() compares the
+ * name once at the end. A name known at compile time can be hashed
+ * there (assetHash() is constexpr) and looked up with findHash().
+ * 
+ * Format (little endian, everything 4-byte aligned):
+ * 
+ *   header   "PAK1", asset count (uint16), 0 (uint16), pack size
+ *            (uint32), names size (uint32)
+ *   hashes   count × uint32, ascending
+ *   entries  count × (uint32 offset from the pack start, uint32 size,
+ *            uint16 name offset, uint8 format, uint8 0, uint16 width,
+ *            uint16 height; width and height are 0 but for pictures)
+ *   names    null-terminated UTF-8, in hash order
+ *   data     the assets, each starting on a 4-byte boundary
+ * 
+ * example:
+ * 
+ * AssetPack pack;
+ * Asset banner, fontAsset;
+ * if (pack.openPartition() && pack.find("banner", banner)) {
+ *     AssetPack::drawImage(display, 0, 0, banner);      // DMA straight from flash
+ * }
+ * Font font;
+ * if (pack.find("demo.fnt", fontAsset)) {
+ *     font.open(fontAsset.data, fontAsset.size);         // Glyphs stay in flash
+ * }
+ * 
+ */
+
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+#include "xipstream.h"
+
+#define ASSET_PACK_HEADER_SIZE 16
+#define ASSET_ENTRY_SIZE       16
+
+#ifndef ASSET_PARTITION_OFFSET
+#define ASSET_PARTITION_OFFSET (1024 * 1024)   // < Flash offset of the partition (above the firmware)
+#endif
+#ifndef ASSET_PARTITION_SIZE
+#define ASSET_PARTITION_SIZE   (1024 * 1024)   // < Rest of a 2 MB flash
+#endif
+
+enum AssetFormat {
+    ASSET_RAW,
+    ASSET_RGB565,   // < width × height pixels, row by row
+    ASSET_JPEG,
+    ASSET_DELTA,
+    ASSET_VIDEO,
+    ASSET_SPLASH,
+    ASSET_FONT
+};
+
+/**
+ * FNV-1a hash of an asset name, as the packer computes it
+ */
+constexpr uint32_t assetHash(const char* name) {
+    uint32_t h = 2166136261u;
+    while (*name) {
+        h = (h ^ (uint8_t)*name++) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * An asset: where it is in flash, its size and what it is
+ */
+struct Asset {
+    const uint8_t* data;   // < In the XIP window, 4-byte aligned
+    uint32_t size;         // < Bytes
+    uint8_t format;        // < AssetFormat
+    uint16_t width;        // < Pictures only
+    uint16_t height;
+    const char* name;
+};
+
+/**
+ * Asset pack in flash
+ */
+class AssetPack {
+public:
+    AssetPack();
+    
+    /**
+     * Check a pack and use it
+     * 
+     * data Pack made by assetpack.py, 4-byte aligned; must stay valid
+     * size Bytes available at data (the pack may be smaller)
+     * 
+     * returns false if there is no valid pack there
+     * 
+     * 
+     * Every entry is checked once (O(count)), so lookups need no
+     * checks.
+     */
+    bool open(const uint8_t* data, size_t size);
+    
+    /**
+     * Open the pack in the asset partition (ASSET_PARTITION_OFFSET)
+     * 
+     * returns false if the partition holds no valid pack (nothing was
+     * written there yet) or the firmware has grown into it
+     */
+    bool openPartition();
+    
+    /**
+     * Find an asset by name
+     * 
+     * returns false if the pack has no asset of that name
+     */
+    bool find(const char* name, Asset& asset) const;
+    
+    /**
+     * Find an asset by the hash of its name (assetHash()), skipping
+     * the hashing and the name check
+     */
+    bool findHash(uint32_t hash, Asset& asset) const;
+    
+    /**
+     * Asset by its place in the index (0 - count() - 1), for listing
+     * the pack
+     */
+    bool at(uint16_t index, Asset& asset) const;
+    
+    /**
+     * Send an RGB565 picture to the display by DMA, straight from
+     * flash (drawBufferAsync(): clipped, returns before it is sent)
+     * 
+     * stream If given, pictures of XIP_STREAM_MIN_BYTES or more are
+     *        read through it and leave the XIP cache alone
+     * 
+     * returns false if the asset is not an RGB565 picture
+     */
+    static bool drawImage(ST7789& display, int16_t x, int16_t y, const Asset& asset,
+                          XipStream* stream = nullptr);
+    
+    uint16_t count() const { return _count; }
+    uint32_t size() const { return _size; }
+    bool isOpen() const { return _count > 0; }
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t size;
+        uint16_t name;
+        uint8_t format;
+        uint8_t reserved;
+        uint16_t width;
+        uint16_t height;
+    };
+    
+    const uint8_t* _data;
+    uint32_t _size;
+    uint16_t _count;
+    const uint32_t* _hashes;
+    const Entry* _entries;
+    const char* _names;
+    
+    int32_t indexOf(uint32_t hash) const;
+};
+
+#endif // ASSETPACK_H
@@ -0,0 +1,71 @@
+/**
+ * bargraph.cpp
+ * Implementation of the spectrum bar graph
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "bargraph.h"
+
+BarGraph::BarGraph(ST7789& display, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                   uint8_t bars)
+    : _display(display), _x(x), _y(y), _w(w), _h(h),
+      _bars(bars > BARGRAPH_MAX_BARS ? BARGRAPH_MAX_BARS : bars),
+      _barColor(COLOR_GREEN), _backColor(COLOR_BLACK), _pixelsDrawn(0) {
+    if (_bars == 0) _bars = 1;
+}
+
+void BarGraph::setColors(uint16_t bar, uint16_t background) {
+    _barColor = bar;
+    _backColor = background;
+}
+
+void BarGraph::begin() {
+    _display.fillRect(_x, _y, _w, _h, _backColor);
+    for (uint8_t i = 0; i < _bars; i++) {
+        _heights[i] = 0;
+    }
+    _pixelsDrawn = 0;
+}
+
+/**
+ * Update bars
+ * 
+ * 
+ * Bar i covers bins [i × count / bars, (i + 1) × count / bars). Its
+ * height is scaled from 0-255 to 0-h. Then:
+ * 
+ *   grew:   fill rows (bottom - new) .. (bottom - old) with bar color
+ *   shrank: fill rows (bottom - old) .. (bottom - new) with background
+ */
+void BarGraph::update(const uint8_t* values, uint16_t count) {
+    uint16_t pitch = _w / _bars;
+    uint16_t barWidth = pitch > 1 ? pitch - 1 : 1;  // 1 pixel gap
+    uint16_t bottom = _y + _h;
+    
+    for (uint8_t i = 0; i < _bars; i++) {
+        // ========== BAR VALUE ==========
+        uint16_t first = (uint32_t)i * count / _bars;
+        uint16_t last = (uint32_t)(i + 1) * count / _bars;
+        if (last <= first) last = first + 1;
+        uint8_t value = 0;
+        for (uint16_t bin = first; bin < last && bin < count; bin++) {
+            if (values[bin] > value) value = values[bin];
+        }
+        uint16_t height = (uint32_t)value * _h / 255;
+        
+        // ========== DELTA FILL ==========
+        uint16_t old = _heights[i];
+        if (height == old) continue;
+        
+        uint16_t x = _x + i * pitch;
+        if (height > old) {
+            _display.fillRect(x, bottom - height, barWidth, height - old, _barColor);
+            _pixelsDrawn += (uint32_t)barWidth * (height - old);
+        } else {
+            _display.fillRect(x, bottom - old, barWidth, old - height, _backColor);
+            _pixelsDrawn += (uint32_t)barWidth * (old - height);
+        }
+        _heights[i] = height;
+    }
+}
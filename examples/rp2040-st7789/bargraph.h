@@ -0,0 +1,87 @@
+/**
+ * bargraph.h
+ * Spectrum bar graph with delta redraw
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Vertical bars growing from the bottom of a rectangle, one bar per
+ * group of frequency bins. When the values change, a bar is not
+ * redrawn: only the strip between its old and new height is filled,
+ * with the bar color if it grew or the background if it shrank.
+ * A typical spectrum update touches a few pixels per bar instead of
+ * the whole rectangle.
+ * 
+ * example:
+ * 
+ * BarGraph bars(display, 0, 200, 240, 120, 48);  // 48 bars
+ * bars.begin();
+ * bars.update(levels, 128);                     // 128 bins → 48 bars
+ * 
+ */
+
+#ifndef BARGRAPH_H
+#define BARGRAPH_H
+
+#include <stdint.h>
+#include "st7789.h"
+
+#define BARGRAPH_MAX_BARS 120  // < At least 2 pixels per bar on 240 px
+
+/**
+ * Bar graph widget
+ */
+class BarGraph {
+public:
+    /**
+     * Constructor - creates bar graph in a screen rectangle
+     * 
+     * display Display to draw on
+     * x, y Top-left corner
+     * w, h Size in pixels
+     * bars Number of bars (at most BARGRAPH_MAX_BARS)
+     * 
+     * Bars are w / bars pixels wide including a 1 pixel gap.
+     */
+    BarGraph(ST7789& display, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+             uint8_t bars);
+    
+    /**
+     * Set colors (takes effect at the next begin())
+     * 
+     * bar Bar color
+     * background Background color
+     */
+    void setColors(uint16_t bar, uint16_t background);
+    
+    /**
+     * Clear the rectangle and reset all bars to zero height
+     */
+    void begin();
+    
+    /**
+     * Show new values
+     * 
+     * values One byte per bin, 0 = empty bar, 255 = full height
+     * count Number of bins; each bar shows the maximum of its bins
+     * 
+     * 
+     * At most one fill per bar, none if its height did not change.
+     */
+    void update(const uint8_t* values, uint16_t count);
+    
+    /**
+     * Pixels filled by update() since begin()
+     */
+    uint32_t pixelsDrawn() const { return _pixelsDrawn; }
+    
+private:
+    ST7789& _display;
+    uint16_t _x, _y, _w, _h;
+    uint8_t _bars;
+    uint16_t _barColor, _backColor;
+    uint16_t _heights[BARGRAPH_MAX_BARS];  // < Height drawn for each bar
+    uint32_t _pixelsDrawn;
+};
+
+#endif // BARGRAPH_H
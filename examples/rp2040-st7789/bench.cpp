@@ -0,0 +1,2192 @@
+/**
+ * bench.cpp
+ * Implementation of the on-device benchmarks
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "bench.h"
+#include "terminal.h"
+#include "hexview.h"
+#include "waterfall.h"
+#include "waveform.h"
+#include "fft.h"
+#include "bargraph.h"
+#include "worker.h"
+#include "stripchart.h"
+#include "anim.h"
+#include "fixmath.h"
+#include "jpeg.h"
+#include "testcard_jpg.h"
+#include "delta.h"
+#include "demo_dlt.h"
+#include "video.h"
+#include "demo_vid.h"
+#include "fill.h"
+#include "raster.h"
+#include "drawqueue.h"
+#include "pipeline.h"
+#include "glyphcache.h"
+#include "font.h"
+#include "demo_fnt.h"
+#include "textlayout.h"
+#include "assetpack.h"
+#include "demo_pak.h"
+#include "xipstream.h"
+#include "arena.h"
+#include "compositor.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/xip_ctrl.h"
+
+void runBenchmarks(ST7789& display) {
+    printf("\n===== BENCHMARKS =====\n");
+    benchTerminal(display);
+    benchHexView(display);
+    benchWaterfall(display);
+    benchWaveform(display);
+    benchFft(display);
+    benchStripChart(display);
+    benchAnim(display);
+    benchMath();
+    benchJpeg(display);
+    benchDelta(display);
+    benchVideo(display);
+    benchFill(display);
+    benchBatch(display);
+    benchRaster(display);
+    benchQueue(display);
+    benchPipeline(display);
+    benchGlyphCache(display);
+    benchFont(display);
+    benchLayout(display);
+    benchAssets(display);
+    benchXipStream(display);
+    benchArena(display);
+    benchCompositor(display);
+    printf("===== DONE =====\n\n");
+}
+
+// ========== TERMINAL ==========
+
+/**
+ * Serial link character rates with 8N1 framing (start + 8 data + stop)
+ */
+#define BENCH_CPS_115200 (115200 / 10)
+#define BENCH_CPS_1M     (1000000 / 10)
+
+/**
+ * Build a log-like test text
+ * 
+ * Mix of colored status lines, long lines that wrap and hex dumps,
+ * so the measurement includes escape parsing and scrolling.
+ */
+static size_t makeTerminalText(char* buf, size_t size) {
+    size_t len = 0;
+    int line = 0;
+    
+    while (len + 128 < size) {
+        switch (line % 4) {
+        case 0:
+            len += snprintf(buf + len, size - len,
+                            "\x1b[32m[  OK  ]\x1b[0m Started service %d\n", line);
+            break;
+        case 1:
+            len += snprintf(buf + len, size - len,
+                            "\x1b[1;33mwarn:\x1b[0m retry %d on bus 0x%02X, "
+                            "timeout after %d ms\n", line, line & 0x7F, line * 3);
+            break;
+        case 2:
+            len += snprintf(buf + len, size - len,
+                            "%08X: %02X %02X %02X %02X %02X %02X %02X %02X\n",
+                            line * 16, line & 0xFF, 0xDE, 0xAD, 0xBE, 0xEF,
+                            line >> 8, 0x55, 0xAA);
+            break;
+        default:
+            len += snprintf(buf + len, size - len,
+                            "\x1b[31merr\x1b[0m: \x1b[7m CRC \x1b[27m mismatch\n");
+            break;
+        }
+        line++;
+    }
+    return len;
+}
+
+void benchTerminal(ST7789& display) {
+    static char text[16 * 1024];
+    static Terminal term(display);
+    size_t len = makeTerminalText(text, sizeof(text));
+    const size_t blockSizes[] = { 16, 64, 256 };
+    
+    printf("--- Terminal: %u bytes of log text ---\n", (unsigned)len);
+    
+    for (size_t b = 0; b < sizeof(blockSizes) / sizeof(blockSizes[0]); b++) {
+        size_t block = blockSizes[b];
+        term.reset();
+        term.flush();
+        
+        uint64_t start = time_us_64();
+        for (size_t pos = 0; pos < len; pos += block) {
+            size_t n = (len - pos < block) ? len - pos : block;
+            term.write(text + pos, n);
+            term.flush();
+        }
+        uint64_t elapsed = time_us_64() - start;
+        
+        uint32_t cps = (uint32_t)((uint64_t)len * 1000000 / elapsed);
+        printf("block %3u: %lu chars/s, %lu cells in %lu windows, %lu scrolls\n",
+               (unsigned)block, (unsigned long)cps,
+               (unsigned long)term.cellsDrawn(), (unsigned long)term.windowsSent(),
+               (unsigned long)term.scrolls());
+        printf("           115200 baud: %s (%lu%% busy), 1 Mbaud: %s (%lu%% busy)\n",
+               cps >= BENCH_CPS_115200 ? "OK" : "TOO SLOW",
+               (unsigned long)(100ULL * BENCH_CPS_115200 / cps),
+               cps >= BENCH_CPS_1M ? "OK" : "TOO SLOW",
+               (unsigned long)(100ULL * BENCH_CPS_1M / cps));
+    }
+    
+    // Leave the display unscrolled for whoever draws next
+    display.setScrollStart(0);
+}
+
+// ========== HEX VIEWER ==========
+
+/**
+ * Time one refresh() and report it with the number of cells drawn
+ */
+static uint32_t timeHexRefresh(HexView& view, uint32_t* cells) {
+    uint32_t before = view.cellsDrawn();
+    uint64_t start = time_us_64();
+    view.refresh();
+    uint32_t elapsed = (uint32_t)(time_us_64() - start);
+    *cells = view.cellsDrawn() - before;
+    return elapsed;
+}
+
+void benchHexView(ST7789& display) {
+    static HexView view(display);
+    static uint8_t ram[4096];
+    const uint8_t* flash = (const uint8_t*)XIP_BASE;
+    const size_t flashSize = 1024 * 1024;
+    uint32_t us, cells;
+    
+    printf("--- Hex viewer: 1 MB of flash ---\n");
+    
+    view.setData(flash, flashSize);
+    us = timeHexRefresh(view, &cells);
+    printf("first draw:   %6lu us, %4lu cells\n", (unsigned long)us, (unsigned long)cells);
+    
+    // Page down through the start of the buffer
+    uint32_t total = 0, worst = 0, totalCells = 0;
+    const int pages = 20;
+    for (int i = 0; i < pages; i++) {
+        view.pageDown();
+        us = timeHexRefresh(view, &cells);
+        total += us;
+        totalCells += cells;
+        if (us > worst) worst = us;
+    }
+    printf("page down:    %6lu us avg, %6lu us worst, %4lu cells avg\n",
+           (unsigned long)(total / pages), (unsigned long)worst,
+           (unsigned long)(totalCells / pages));
+    
+    // Jump to the end: offsets change in every digit
+    view.scrollTo(flashSize - 1);
+    us = timeHexRefresh(view, &cells);
+    printf("jump to end:  %6lu us, %4lu cells\n", (unsigned long)us, (unsigned long)cells);
+    
+    // Scroll one row at a time (hardware scroll + one new row)
+    total = 0;
+    totalCells = 0;
+    for (int i = 0; i < pages; i++) {
+        view.scrollBy(-1);
+        total += timeHexRefresh(view, &cells);
+        totalCells += cells;
+    }
+    printf("scroll 1 row: %6lu us avg, %4lu cells avg\n",
+           (unsigned long)(total / pages), (unsigned long)(totalCells / pages));
+    
+    // Move a one byte selection
+    size_t base = view.topOffset();
+    total = 0;
+    totalCells = 0;
+    for (int i = 0; i < pages; i++) {
+        view.setSelection(base + i, base + i);
+        total += timeHexRefresh(view, &cells);
+        totalCells += cells;
+    }
+    printf("selection:    %6lu us avg, %4lu cells avg\n",
+           (unsigned long)(total / pages), (unsigned long)(totalCells / pages));
+    
+    // Live capture buffer: one byte changes between refreshes
+    for (size_t i = 0; i < sizeof(ram); i++) ram[i] = (uint8_t)i;
+    view.setData(ram, sizeof(ram));
+    view.refresh();
+    total = 0;
+    totalCells = 0;
+    for (int i = 0; i < pages; i++) {
+        ram[i * 13] ^= 0x01;
+        total += timeHexRefresh(view, &cells);
+        totalCells += cells;
+    }
+    printf("byte change:  %6lu us avg, %4lu cells avg\n",
+           (unsigned long)(total / pages), (unsigned long)(totalCells / pages));
+    
+    display.setScrollStart(0);
+}
+
+// ========== WATERFALL ==========
+
+void benchWaterfall(ST7789& display) {
+    static Waterfall waterfall(display, 0, SCREEN_HEIGHT);
+    static uint8_t spectrum[128];
+    const int rows = 1000;
+    
+    printf("--- Waterfall: %d lines, 128 bins, full screen ---\n", rows);
+    
+    waterfall.begin();
+    uint64_t pushTime = 0;
+    uint64_t start = time_us_64();
+    for (int row = 0; row < rows; row++) {
+        // Noise floor plus two carriers drifting across the band
+        for (int bin = 0; bin < 128; bin++) {
+            spectrum[bin] = (uint8_t)((bin * 37 + row * 11) & 0x1F);
+        }
+        spectrum[(row / 4) & 127] = 255;
+        spectrum[(127 - row / 8) & 127] = 180;
+        
+        uint64_t t0 = time_us_64();
+        waterfall.pushRow(spectrum, 128);
+        pushTime += time_us_64() - t0;
+    }
+    display.waitIdle();
+    uint64_t elapsed = time_us_64() - start;
+    
+    printf("%lu lines/s (%lu us per line, %lu us inside pushRow)\n",
+           (unsigned long)((uint64_t)rows * 1000000 / elapsed),
+           (unsigned long)(elapsed / rows), (unsigned long)(pushTime / rows));
+    printf("target 100 lines/s: %s\n",
+           (uint64_t)rows * 1000000 / elapsed >= 100 ? "OK" : "TOO SLOW");
+    
+    display.setScrollArea(0, 0);
+    display.setScrollStart(0);
+}
+
+// ========== WAVEFORM ==========
+
+/**
+ * Synthetic analog trace: slow triangle wave plus noise, 12-bit range
+ */
+static int16_t waveSample(uint32_t i, uint32_t* noise) {
+    *noise = *noise * 1664525u + 1013904223u;  // LCG
+    int32_t phase = (int32_t)((i >> 4) & 0xFFF);
+    int32_t triangle = (phase < 0x800) ? phase : 0xFFF - phase;
+    return (int16_t)(triangle * 2 - 2048 + (int32_t)((*noise >> 24) & 0x3F) - 32);
+}
+
+void benchWaveform(ST7789& display) {
+    static WaveMinMax storage[8192];
+    static int16_t chunk[1024];
+    static WaveformPyramid pyramid;
+    static WaveformPlot plot(display, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    const uint32_t sizes[] = { 1000000, 10000000 };
+    const uint16_t blocks[] = { 256, 2048 };
+    
+    // Reference: cost of one drawPixel(), to estimate a naive plot
+    uint64_t t0 = time_us_64();
+    for (int i = 0; i < 1000; i++) {
+        display.drawPixel(i % SCREEN_WIDTH, i % SCREEN_HEIGHT, COLOR_GREEN);
+    }
+    uint32_t pixelNs = (uint32_t)(time_us_64() - t0);  // us per 1000 = ns each
+    
+    for (int s = 0; s < 2; s++) {
+        uint32_t count = sizes[s];
+        uint32_t noise = 1;
+        printf("--- Waveform: %lu samples, block %u ---\n",
+               (unsigned long)count, blocks[s]);
+        
+        // ========== BUILD ==========
+        size_t entries = WaveformPyramid::storageEntries(count, blocks[s]);
+        uint64_t genTime = 0;
+        uint64_t start = time_us_64();
+        pyramid.begin(storage, sizeof(storage) / sizeof(storage[0]), blocks[s]);
+        for (uint32_t pos = 0; pos < count; pos += 1024) {
+            uint32_t n = (count - pos < 1024) ? count - pos : 1024;
+            uint64_t g0 = time_us_64();
+            for (uint32_t i = 0; i < n; i++) chunk[i] = waveSample(pos + i, &noise);
+            genTime += time_us_64() - g0;
+            pyramid.append(chunk, n);
+        }
+        pyramid.finish(nullptr);
+        uint32_t buildUs = (uint32_t)(time_us_64() - start - genTime);
+        printf("build: %lu ms (%lu samples/ms), %u levels, %lu bytes\n",
+               (unsigned long)(buildUs / 1000),
+               (unsigned long)((uint64_t)count * 1000 / (buildUs ? buildUs : 1)),
+               pyramid.levels(), (unsigned long)(entries * sizeof(WaveMinMax)));
+        
+        // ========== RENDER ==========
+        plot.setSource(&pyramid);
+        plot.setScale(-2100, 2100);
+        plot.invalidate();
+        
+        for (uint32_t zoom = 1; zoom <= 4096; zoom *= 16) {
+            size_t length = count / zoom;
+            uint64_t total = 0;
+            const int steps = 10;
+            for (int step = 0; step < steps; step++) {
+                plot.setView((size_t)step * length / 8, length);
+                uint64_t r0 = time_us_64();
+                plot.render();
+                total += time_us_64() - r0;
+            }
+            printf("zoom 1:%-4lu %8lu samples/column: %6lu us per render (pan)\n",
+                   (unsigned long)zoom, (unsigned long)(length / SCREEN_WIDTH),
+                   (unsigned long)(total / steps));
+        }
+        printf("drawPixel per sample would take ~%lu ms\n",
+               (unsigned long)((uint64_t)count * pixelNs / 1000000));
+    }
+}
+
+// ========== FFT ==========
+
+/**
+ * One spectrum computation, runs on either core
+ */
+struct FftJob {
+    const int16_t* samples;
+    FftComplex* buf;
+    uint8_t* levels;
+    uint8_t log2Size;
+};
+
+static void fftJob(void* arg) {
+    FftJob* job = (FftJob*)arg;
+    uint16_t size = 1 << job->log2Size;
+    fftWindowHann(job->samples, job->buf, size);
+    fftForward(job->buf, job->log2Size);
+    fftLogMagnitudes(job->buf, job->levels, size / 2);
+}
+
+void benchFft(ST7789& display) {
+    static int16_t samples[FFT_MAX_SIZE];
+    static FftComplex buf[FFT_MAX_SIZE];
+    static uint8_t levels[2][FFT_MAX_SIZE / 2];
+    static BarGraph bars(display, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 60);
+    const int frames = 50;
+    
+    printf("--- FFT + bar graph (60 bars, full screen) ---\n");
+    printf(" size   fft us   bars us   core0 only fps   fft on core1 fps\n");
+    
+    for (uint8_t log2Size = 6; log2Size <= FFT_MAX_LOG2; log2Size++) {
+        uint16_t size = 1 << log2Size;
+        FftJob job = { samples, buf, levels[0], log2Size };
+        uint32_t noise = 1;
+        
+        // Two tones plus noise, moving a little every frame
+        auto makeSignal = [&](int frame) {
+            for (uint16_t i = 0; i < size; i++) {
+                noise = noise * 1664525u + 1013904223u;
+                int32_t a = ((i * (size / 8 + frame)) & 0xFF) < 128 ? 8000 : -8000;
+                int32_t b = ((i * 3) & 0x3F) < 32 ? 2000 : -2000;
+                samples[i] = (int16_t)(a + b + (int32_t)((noise >> 20) & 0x3FF) - 512);
+            }
+        };
+        
+        // ========== SEPARATE COSTS ==========
+        bars.begin();
+        uint64_t fftTime = 0, barTime = 0;
+        for (int f = 0; f < frames; f++) {
+            makeSignal(f);
+            uint64_t t0 = time_us_64();
+            fftJob(&job);
+            uint64_t t1 = time_us_64();
+            bars.update(levels[0], size / 2);
+            barTime += time_us_64() - t1;
+            fftTime += t1 - t0;
+        }
+        uint32_t serialFps = (uint32_t)((uint64_t)frames * 1000000 / (fftTime + barTime));
+        
+        // ========== PIPELINED ==========
+        // Core 1 computes frame f+1 while core 0 draws frame f
+        bars.begin();
+        makeSignal(0);
+        job.levels = levels[0];
+        fftJob(&job);
+        uint64_t start = time_us_64();
+        for (int f = 0; f < frames; f++) {
+            makeSignal(f + 1);
+            job.levels = levels[(f + 1) & 1];
+            workerSubmit(fftJob, &job);
+            bars.update(levels[f & 1], size / 2);
+            workerWait();
+        }
+        uint32_t pipeFps = (uint32_t)((uint64_t)frames * 1000000 / (time_us_64() - start));
+        
+        printf("%5u %8lu %9lu %16lu %18lu\n", size,
+               (unsigned long)(fftTime / frames), (unsigned long)(barTime / frames),
+               (unsigned long)serialFps, (unsigned long)pipeFps);
+    }
+}
+
+// ========== STRIP CHART ==========
+
+/**
+ * Time per push() and per full redraw() for one chart setup
+ */
+static void timeStripChart(StripChart& chart, uint8_t series, const char* name) {
+    static const uint16_t colors[STRIP_MAX_SERIES] = {
+        COLOR_GREEN, COLOR_YELLOW, COLOR_CYAN, COLOR_MAGENTA
+    };
+    const int samples = 1000;
+    int16_t values[STRIP_MAX_SERIES];
+    
+    for (uint8_t s = 0; s < series; s++) {
+        chart.addSeries(colors[s], s == 0 ? STRIP_FILLED : STRIP_LINE);
+    }
+    chart.setRange(-1000, 1000);
+    chart.begin();
+    
+    uint64_t start = time_us_64();
+    for (int i = 0; i < samples; i++) {
+        for (uint8_t s = 0; s < series; s++) {
+            // Triangle waves with a different period per series
+            int32_t period = 64 + 48 * s;
+            int32_t phase = i % period;
+            int32_t tri = phase < period / 2 ? phase : period - phase;
+            values[s] = (int16_t)(tri * 4000 / period - 1000);
+        }
+        chart.push(values);
+    }
+    uint64_t pushTime = time_us_64() - start;
+    
+    // History is full now: this is what every sample would cost
+    // without the ring buffer
+    uint64_t t0 = time_us_64();
+    chart.redraw();
+    uint64_t redrawTime = time_us_64() - t0;
+    
+    printf("%-6s %7u %12lu %10lu\n", name, series,
+           (unsigned long)(pushTime / samples), (unsigned long)redrawTime);
+}
+
+void benchStripChart(ST7789& display) {
+    static StripChart sweep1(display, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, STRIP_SWEEP);
+    static StripChart sweep4(display, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, STRIP_SWEEP);
+    static StripChart scroll1(display, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, STRIP_SCROLL);
+    static StripChart scroll4(display, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, STRIP_SCROLL);
+    
+    printf("--- Strip chart: 1000 samples, full screen ---\n");
+    printf("mode    series   us/sample  redraw us\n");
+    timeStripChart(sweep1, 1, "sweep");
+    timeStripChart(sweep4, 4, "sweep");
+    timeStripChart(scroll1, 1, "scroll");
+    timeStripChart(scroll4, 4, "scroll");
+    
+    display.waitIdle();
+    display.setScrollArea(0, 0);
+    display.setScrollStart(0);
+}
+
+// ========== ANIMATION ==========
+
+#define BENCH_BOXES 16  // < Two tweens each: fills the pool
+
+/**
+ * Redraw one dirty area: background, then every box that overlaps it
+ */
+static void redrawBoxes(ST7789& display, const Rect& area, const Rect* boxes,
+                        const uint16_t* colors) {
+    display.fillRect(area.x, area.y, area.w, area.h, COLOR_BLACK);
+    for (uint8_t i = 0; i < BENCH_BOXES; i++) {
+        Rect part = rectIntersect(area, boxes[i]);
+        if (!rectEmpty(part)) display.fillRect(part.x, part.y, part.w, part.h, colors[i]);
+    }
+}
+
+void benchAnim(ST7789& display) {
+    static Animator anim;
+    static Rect boxes[BENCH_BOXES];
+    static uint16_t colors[BENCH_BOXES];
+    static const uint16_t palette[4] = { COLOR_RED, COLOR_GREEN, COLOR_CYAN, COLOR_YELLOW };
+    DirtyRects dirty;
+    const int frames = 300;
+    const uint32_t frameMs = 16;  // Simulated 60 fps clock
+    
+    printf("--- Animator: %d boxes, %d frames ---\n", BENCH_BOXES, frames);
+    
+    anim.cancelAll();
+    anim.update(0, nullptr);
+    for (uint8_t i = 0; i < BENCH_BOXES; i++) {
+        boxes[i].x = (int16_t)((i % 4) * 56);
+        boxes[i].y = (int16_t)((i / 4) * 80);
+        boxes[i].w = 16;
+        boxes[i].h = 16;
+        colors[i] = palette[i & 3];
+        
+        AnimEasing easing = (AnimEasing)(1 + i % (EASE_COUNT - 1));
+        AnimHandle h = anim.start(&boxes[i].x, (int16_t)(boxes[i].x + 24), 400 + 20 * i,
+                                  easing, 0, &boxes[i]);
+        anim.setRepeat(h, ANIM_FOREVER, true);
+        h = anim.start(&boxes[i].y, (int16_t)(boxes[i].y + 60), 700 + 10 * i,
+                       EASE_IN_OUT_CUBIC, 0, &boxes[i]);
+        anim.setRepeat(h, ANIM_FOREVER, true);
+    }
+    
+    display.fillScreen(COLOR_BLACK);
+    uint64_t updateTime = 0, drawTime = 0;
+    int64_t pixels = 0;
+    for (int f = 1; f <= frames; f++) {
+        uint64_t t0 = time_us_64();
+        anim.update(f * frameMs, &dirty);
+        uint64_t t1 = time_us_64();
+        for (uint8_t i = 0; i < dirty.count(); i++) {
+            redrawBoxes(display, dirty[i], boxes, colors);
+        }
+        drawTime += time_us_64() - t1;
+        updateTime += t1 - t0;
+        pixels += dirty.area();
+        dirty.clear();
+    }
+    
+    // Full screen redraw for comparison
+    Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    uint64_t t0 = time_us_64();
+    redrawBoxes(display, screen, boxes, colors);
+    uint64_t fullTime = time_us_64() - t0;
+    
+    printf("update: %lu us/frame (%u tweens)\n",
+           (unsigned long)(updateTime / frames), anim.activeCount());
+    printf("dirty redraw: %lu us/frame, %lu px/frame\n",
+           (unsigned long)(drawTime / frames), (unsigned long)(pixels / frames));
+    printf("full redraw: %lu us/frame, %d px/frame\n",
+           (unsigned long)fullTime, SCREEN_WIDTH * SCREEN_HEIGHT);
+    anim.cancelAll();
+}
+
+// ========== FIXED-POINT MATH ==========
+
+#define BENCH_MATH_N 4096
+
+// Results are stored here so the compiler cannot drop the calls
+static volatile int32_t sinkFix;
+static volatile float sinkFloat;
+
+/**
+ * Print one comparison line: nanoseconds per call and max error
+ */
+static void printMath(const char* name, uint64_t fixUs, uint64_t floatUs, float maxError,
+                      const char* unit) {
+    printf("%-8s %8lu %10lu %8.1fx   %.4f %s\n", name,
+           (unsigned long)(fixUs * 1000 / BENCH_MATH_N),
+           (unsigned long)(floatUs * 1000 / BENCH_MATH_N),
+           fixUs ? (double)floatUs / fixUs : 0.0, (double)maxError, unit);
+}
+
+void benchMath() {
+    static int32_t inputA[BENCH_MATH_N];
+    static int32_t inputB[BENCH_MATH_N];
+    uint32_t noise = 1;
+    
+    for (int i = 0; i < BENCH_MATH_N; i++) {
+        noise = noise * 1664525u + 1013904223u;
+        inputA[i] = (int32_t)(noise >> 8) - (1 << 23);
+        noise = noise * 1664525u + 1013904223u;
+        inputB[i] = (int32_t)(noise >> 12) - (1 << 19);
+        if (inputB[i] == 0) inputB[i] = 1;
+    }
+    
+    printf("--- Fixed-point math vs. float (%d calls each) ---\n", BENCH_MATH_N);
+    printf("function  fix ns   float ns  speedup   max error\n");
+    
+    // ========== SIN ==========
+    uint64_t t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) sinkFix = fixSin((uint16_t)inputA[i]);
+    uint64_t fixUs = time_us_64() - t0;
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) {
+        sinkFloat = sinf((float)(uint16_t)inputA[i] * (float)(2 * FIX_PI / 65536));
+    }
+    uint64_t floatUs = time_us_64() - t0;
+    float maxError = 0;
+    for (int i = 0; i < BENCH_MATH_N; i++) {
+        float ref = sinf((float)(uint16_t)inputA[i] * (float)(2 * FIX_PI / 65536));
+        float error = fabsf(fixSin((uint16_t)inputA[i]) / 32767.0f - ref);
+        if (error > maxError) maxError = error;
+    }
+    printMath("sin", fixUs, floatUs, maxError, "");
+    
+    // ========== ATAN2 ==========
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) sinkFix = fixAtan2(inputB[i], inputA[i]);
+    fixUs = time_us_64() - t0;
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) sinkFloat = atan2f((float)inputB[i], (float)inputA[i]);
+    floatUs = time_us_64() - t0;
+    maxError = 0;
+    for (int i = 0; i < BENCH_MATH_N; i++) {
+        float ref = atan2f((float)inputB[i], (float)inputA[i]) * (float)(180 / FIX_PI);
+        float degrees = (int16_t)fixAtan2(inputB[i], inputA[i]) * (360.0f / 65536);
+        float error = fabsf(degrees - ref);
+        if (error > 180) error = 360 - error;
+        if (error > maxError) maxError = error;
+    }
+    printMath("atan2", fixUs, floatUs, maxError, "deg");
+    
+    // ========== SQRT ==========
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) sinkFix = fixSqrt(inputA[i] & 0x7FFFFFFF);
+    fixUs = time_us_64() - t0;
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) {
+        sinkFloat = sqrtf((float)(inputA[i] & 0x7FFFFFFF) * (1.0f / 65536));
+    }
+    floatUs = time_us_64() - t0;
+    maxError = 0;
+    for (int i = 0; i < BENCH_MATH_N; i++) {
+        float ref = sqrtf((float)(inputA[i] & 0x7FFFFFFF) * (1.0f / 65536));
+        float error = fabsf(fixSqrt(inputA[i] & 0x7FFFFFFF) / 65536.0f - ref);
+        if (error > maxError) maxError = error;
+    }
+    printMath("sqrt", fixUs, floatUs, maxError, "");
+    
+    // ========== RECIPROCAL ==========
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) sinkFix = fixRecip(1 + (inputA[i] & 0xFF));
+    fixUs = time_us_64() - t0;
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) sinkFloat = 1.0f / (float)(1 + (inputA[i] & 0xFF));
+    floatUs = time_us_64() - t0;
+    printMath("recip", fixUs, floatUs, 0.5f / 65536, "");
+    
+    // ========== DIVISION ==========
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) sinkFix = fixDiv(inputB[i], inputA[i]);
+    fixUs = time_us_64() - t0;
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) sinkFloat = (float)inputB[i] / (float)inputA[i];
+    floatUs = time_us_64() - t0;
+    maxError = 0;
+    for (int i = 0; i < BENCH_MATH_N; i++) {
+        float ref = (float)inputB[i] / (float)inputA[i];
+        float error = fabsf(fixDiv(inputB[i], inputA[i]) / 65536.0f - ref);
+        if (error > maxError) maxError = error;
+    }
+    printMath("div", fixUs, floatUs, maxError, "");
+    
+    // 64-bit integer division, what (a << 16) / b compiles to
+    t0 = time_us_64();
+    for (int i = 0; i < BENCH_MATH_N; i++) {
+        sinkFix = (int32_t)(((int64_t)inputB[i] << 16) / inputA[i]);
+    }
+    uint64_t longUs = time_us_64() - t0;
+    printf("div via int64: %lu ns\n", (unsigned long)(longUs * 1000 / BENCH_MATH_N));
+}
+
+// ========== JPEG ==========
+
+#define BENCH_JPEG_RUNS 5
+
+/**
+ * Average decode time of BENCH_JPEG_RUNS runs at (x, y), in us
+ */
+static uint32_t timeJpeg(JpegDecoder& jpeg, int16_t x, int16_t y) {
+    uint64_t t0 = time_us_64();
+    for (int i = 0; i < BENCH_JPEG_RUNS; i++) {
+        if (!jpeg.decode(x, y)) {
+            printf("decode failed: error %d\n", jpeg.error());
+            return 0;
+        }
+    }
+    return (uint32_t)((time_us_64() - t0) / BENCH_JPEG_RUNS);
+}
+
+void benchJpeg(ST7789& display) {
+    static JpegDecoder jpeg(display);
+    static int16_t coefficients[JPEG_DUAL_CORE_WORDS];
+    
+    if (!jpeg.open(testcard_jpg, sizeof(testcard_jpg))) {
+        printf("--- JPEG: open failed, error %d ---\n", jpeg.error());
+        return;
+    }
+    printf("--- JPEG: %ux%u test card, %u bytes ---\n",
+           jpeg.width(), jpeg.height(), (unsigned)sizeof(testcard_jpg));
+    
+    jpeg.setDualCore(nullptr);
+    uint32_t single = timeJpeg(jpeg, 0, 0);
+    uint32_t cropped = timeJpeg(jpeg, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    jpeg.setDualCore(coefficients);
+    uint32_t dual = timeJpeg(jpeg, 0, 0);
+    jpeg.setDualCore(nullptr);
+    
+    printf("single core: %lu.%lu ms/image\n",
+           (unsigned long)(single / 1000), (unsigned long)(single % 1000 / 100));
+    printf("dual core:   %lu.%lu ms/image\n",
+           (unsigned long)(dual / 1000), (unsigned long)(dual % 1000 / 100));
+    printf("1/4 visible: %lu.%lu ms/image (single core)\n",
+           (unsigned long)(cropped / 1000), (unsigned long)(cropped % 1000 / 100));
+    printf("RAM: %u bytes decoder, +%u bytes dual core buffer\n",
+           (unsigned)sizeof(JpegDecoder), (unsigned)sizeof(coefficients));
+}
+
+// ========== DELTA ANIMATION ==========
+
+#define BENCH_DELTA_SECONDS 3
+
+void benchDelta(ST7789& display) {
+    static DeltaPlayer player(display);
+    
+    if (!player.open(demo_dlt, sizeof(demo_dlt))) {
+        printf("--- Delta animation: open failed ---\n");
+        return;
+    }
+    printf("--- Delta animation: %ux%u, %u frames, %u bytes ---\n", player.width(),
+           player.height(), player.frameCount(), (unsigned)sizeof(demo_dlt));
+    
+    // Every frame back to back: frame 0 (full), the deltas, the loop frame
+    uint32_t firstUs = 0, firstBytes = 0, maxUs = 0;
+    uint64_t totalUs = 0, totalBytes = 0, totalData = 0;
+    for (uint16_t i = 0; i <= player.frameCount(); i++) {
+        if (!player.drawFrame()) {
+            printf("frame %u damaged\n", i);
+            return;
+        }
+        const DeltaStats& stats = player.lastStats();
+        if (i == 0) {
+            firstUs = stats.us;
+            firstBytes = stats.spiBytes;
+            continue;
+        }
+        totalUs += stats.us;
+        totalBytes += stats.spiBytes;
+        totalData += stats.dataBytes;
+        if (stats.us > maxUs) maxUs = stats.us;
+    }
+    uint16_t deltas = player.frameCount();
+    
+    printf("first frame: %lu us, %lu bytes sent\n",
+           (unsigned long)firstUs, (unsigned long)firstBytes);
+    printf("delta frames: %lu us avg, %lu us max, %lu bytes sent, %lu bytes read\n",
+           (unsigned long)(totalUs / deltas), (unsigned long)maxUs,
+           (unsigned long)(totalBytes / deltas), (unsigned long)(totalData / deltas));
+    printf("max rate: %lu fps (30 fps needs 33333 us/frame)\n",
+           (unsigned long)(maxUs ? 1000000 / maxUs : 0));
+    
+    // Real time at the frame rate stored in the file
+    player.rewind();
+    uint32_t drawn = 0;
+    uint64_t end = time_us_64() + BENCH_DELTA_SECONDS * 1000000ull;
+    while (time_us_64() < end) {
+        if (player.update((uint32_t)(time_us_64() / 1000))) drawn++;
+    }
+    printf("real time: %lu frames in %d s at %u ms/frame, %lu late\n", (unsigned long)drawn,
+           BENCH_DELTA_SECONDS, player.frameMs(), (unsigned long)player.lateFrames());
+}
+
+// ========== VIDEO ==========
+
+#define BENCH_VIDEO_SECONDS 3
+
+void benchVideo(ST7789& display) {
+    static VideoPlayer video(display);
+    
+    if (!video.open(demo_vid, sizeof(demo_vid))) {
+        printf("--- Video: open failed ---\n");
+        return;
+    }
+    printf("--- Video: %ux%u, %u frames, %u bytes ---\n", video.width(), video.height(),
+           video.frameCount(), (unsigned)sizeof(demo_vid));
+    
+    if (!video.play(0, 0, 2 * video.frameCount(), false)) {
+        printf("clip damaged\n");
+        return;
+    }
+    const VideoStats& s = video.stats();
+    printf("as fast as possible: %lu frames in %lu us, %lu.%lu fps\n",
+           (unsigned long)s.frames, (unsigned long)s.us,
+           (unsigned long)(s.frames * 1000000ull / s.us),
+           (unsigned long)(s.frames * 10000000ull / s.us % 10));
+    printf("reader: %lu bytes, %lu KB/s\n", (unsigned long)s.bytesRead,
+           (unsigned long)(s.bytesRead * 1000ull / 1024 * 1000 / s.us));
+    printf("core 1: decode %lu us, waiting for reader %lu us, for display %lu us\n",
+           (unsigned long)s.decodeUs, (unsigned long)s.inputWaitUs, (unsigned long)s.outputWaitUs);
+    printf("core 0: display %lu us (%lu bytes), waiting for decoder %lu us\n",
+           (unsigned long)s.spiWaitUs, (unsigned long)s.spiBytes, (unsigned long)s.bandWaitUs);
+    
+    // The decoder sits in the middle: whatever it waits for most is
+    // slower than it is
+    const char* bottleneck = "decoder";
+    if (s.outputWaitUs > s.decodeUs && s.outputWaitUs >= s.inputWaitUs) {
+        bottleneck = "display SPI";
+    } else if (s.inputWaitUs > s.decodeUs) {
+        bottleneck = "reader";
+    }
+    printf("bottleneck: %s\n", bottleneck);
+    
+    // Real time at the frame rate stored in the clip
+    uint32_t frames = BENCH_VIDEO_SECONDS * 1000 / (video.frameMs() ? video.frameMs() : 1);
+    video.play(0, 0, frames, true);
+    printf("real time: %lu frames in %lu ms at %u ms/frame, %lu late\n",
+           (unsigned long)video.stats().frames, (unsigned long)(video.stats().us / 1000),
+           video.frameMs(), (unsigned long)video.stats().lateFrames);
+}
+
+// ========== FILLS ==========
+
+static void printFill(const char* name, uint32_t us, uint32_t rawUs) {
+    printf("%-22s %6lu us  %3lu%% of SPI speed\n", name, (unsigned long)us,
+           (unsigned long)(us ? (uint64_t)rawUs * 100 / us : 0));
+}
+
+void benchFill(ST7789& display) {
+    static uint16_t line[SCREEN_WIDTH];
+    printf("--- Fills: 240x320 ---\n");
+    
+    // The SPI limit: the same window from a ready line
+    for (uint16_t i = 0; i < SCREEN_WIDTH; i++) line[i] = COLOR_BLUE;
+    uint32_t t0 = time_us_32();
+    display.beginPixels(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (uint16_t row = 0; row < SCREEN_HEIGHT; row++) {
+        display.writePixelsAsync(line, SCREEN_WIDTH);
+    }
+    display.waitIdle();
+    uint32_t rawUs = time_us_32() - t0;
+    printFill("ready line (DMA)", rawUs, rawUs);
+    
+    t0 = time_us_32();
+    display.fillRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, COLOR_BLACK);
+    printFill("fillRect", time_us_32() - t0, rawUs);
+    
+    static const char* const gradients[] = { "horizontal", "vertical", "diagonal", "radial" };
+    for (uint8_t type = GRADIENT_HORIZONTAL; type <= GRADIENT_RADIAL; type++) {
+        t0 = time_us_32();
+        fillRectGradient(display, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, COLOR_BLUE, COLOR_ORANGE,
+                         (GradientType)type);
+        display.waitIdle();
+        char name[24];
+        snprintf(name, sizeof(name), "gradient %s", gradients[type]);
+        printFill(name, time_us_32() - t0, rawUs);
+    }
+    
+    static const char* const patterns[] = { "checker", "stripes h", "stripes v", "stripes d",
+                                            "hatch", "crosshatch" };
+    for (uint8_t type = PATTERN_CHECKER; type <= PATTERN_CROSSHATCH; type++) {
+        t0 = time_us_32();
+        fillRectPattern(display, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, COLOR_BLACK, COLOR_CYAN,
+                        (PatternType)type, 8);
+        display.waitIdle();
+        char name[24];
+        snprintf(name, sizeof(name), "pattern %s", patterns[type]);
+        printFill(name, time_us_32() - t0, rawUs);
+    }
+}
+
+// ========== BATCHES ==========
+
+#define BENCH_SCATTER_POINTS 1000
+#define BENCH_GRID_STEP      20
+
+static void printBatch(const char* name, uint32_t loopUs, uint32_t batchUs, uint32_t windows) {
+    printf("%-14s loop %6lu us  batch %6lu us  (%lu.%lux, %lu windows)\n", name,
+           (unsigned long)loopUs, (unsigned long)batchUs,
+           (unsigned long)(batchUs ? loopUs / batchUs : 0),
+           (unsigned long)(batchUs ? loopUs * 10 / batchUs % 10 : 0), (unsigned long)windows);
+}
+
+void benchBatch(ST7789& display) {
+    static Point points[BENCH_SCATTER_POINTS];
+    static Span spans[SCREEN_HEIGHT];
+    static Rect lines[SCREEN_WIDTH / BENCH_GRID_STEP + SCREEN_HEIGHT / BENCH_GRID_STEP];
+    printf("--- Batched primitives ---\n");
+    
+    // Scatter plot: random points, drawPixel() per point against one
+    // drawPixels() (its time includes sorting)
+    uint32_t noise = 1;
+    for (uint32_t i = 0; i < BENCH_SCATTER_POINTS; i++) {
+        noise = noise * 1664525u + 1013904223u;
+        points[i].x = (int16_t)((noise >> 8) % SCREEN_WIDTH);
+        points[i].y = (int16_t)((noise >> 16) % SCREEN_HEIGHT);
+        points[i].color = (uint16_t)(noise >> 4);
+    }
+    display.fillScreen(COLOR_BLACK);
+    uint32_t t0 = time_us_32();
+    for (uint32_t i = 0; i < BENCH_SCATTER_POINTS; i++) {
+        display.drawPixel(points[i].x, points[i].y, points[i].color);
+    }
+    uint32_t loopUs = time_us_32() - t0;
+    display.fillScreen(COLOR_BLACK);
+    t0 = time_us_32();
+    uint32_t windows = display.drawPixels(points, BENCH_SCATTER_POINTS);
+    printBatch("scatter 1000", loopUs, time_us_32() - t0, windows);
+    
+    // Grid lines: one-pixel rectangles, fillRect() each against fillRects()
+    uint32_t n = 0;
+    for (int16_t x = 0; x < SCREEN_WIDTH; x += BENCH_GRID_STEP) {
+        lines[n++] = { x, 0, 1, SCREEN_HEIGHT };
+    }
+    for (int16_t y = 0; y < SCREEN_HEIGHT; y += BENCH_GRID_STEP) {
+        lines[n++] = { 0, y, SCREEN_WIDTH, 1 };
+    }
+    t0 = time_us_32();
+    for (uint32_t i = 0; i < n; i++) {
+        display.fillRect(lines[i].x, lines[i].y, lines[i].w, lines[i].h, COLOR_GREEN);
+    }
+    loopUs = time_us_32() - t0;
+    t0 = time_us_32();
+    windows = display.fillRects(lines, n, COLOR_GREEN);
+    printBatch("grid", loopUs, time_us_32() - t0, windows);
+    
+    // Filled circle as one span per row, fillRect() each against drawSpans()
+    const int16_t radius = 100;
+    n = 0;
+    for (int16_t dy = -radius; dy <= radius; dy++) {
+        int16_t half = (int16_t)sqrtf((float)(radius * radius - dy * dy));
+        spans[n++] = { (int16_t)(SCREEN_WIDTH / 2 - half), (int16_t)(SCREEN_HEIGHT / 2 + dy),
+                       (uint16_t)(2 * half + 1), COLOR_ORANGE };
+    }
+    t0 = time_us_32();
+    for (uint32_t i = 0; i < n; i++) {
+        display.fillRect(spans[i].x, spans[i].y, spans[i].w, 1, spans[i].color);
+    }
+    loopUs = time_us_32() - t0;
+    t0 = time_us_32();
+    windows = display.drawSpans(spans, n);
+    printBatch("circle spans", loopUs, time_us_32() - t0, windows);
+}
+
+// ========== PARALLEL RASTERIZATION ==========
+
+#define BENCH_RASTER_LINES   64   // < Frame buffer height (30 KB)
+#define BENCH_SPRITES        48
+#define BENCH_SPRITE_SIZE    16
+#define BENCH_DISCS          12
+
+/**
+ * Scene shared by the workloads (read only while rendering)
+ */
+struct BenchScene {
+    uint16_t sprite[BENCH_SPRITE_SIZE * BENCH_SPRITE_SIZE];  // < 0 = transparent
+    int16_t spriteX[BENCH_SPRITES], spriteY[BENCH_SPRITES];
+    int16_t discX[BENCH_DISCS], discY[BENCH_DISCS], discR[BENCH_DISCS];
+    uint16_t discColor[BENCH_DISCS];
+};
+
+static BenchScene benchScene;
+
+static inline uint16_t benchRgb(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+static inline uint16_t benchBackground(int16_t y) {
+    return benchRgb(0, 0, (uint8_t)(40 + y * 160 / SCREEN_HEIGHT));
+}
+
+/**
+ * Nothing: only the splitting, synchronization and SPI remain
+ */
+static void renderEmpty(void* context, uint16_t* pixels, const Rect& area) {
+    (void)context;
+    (void)pixels;
+    (void)area;
+}
+
+/**
+ * Light work per pixel: background plus color-keyed sprite copies
+ */
+static void renderSprites(void* context, uint16_t* pixels, const Rect& area) {
+    const BenchScene& scene = *static_cast<const BenchScene*>(context);
+    for (int16_t row = 0; row < area.h; row++) {
+        uint16_t color = benchBackground(area.y + row);
+        uint16_t* line = pixels + row * area.w;
+        for (int16_t i = 0; i < area.w; i++) line[i] = color;
+    }
+    for (uint8_t s = 0; s < BENCH_SPRITES; s++) {
+        Rect box = { scene.spriteX[s], scene.spriteY[s], BENCH_SPRITE_SIZE, BENCH_SPRITE_SIZE };
+        Rect r = rectIntersect(box, area);
+        if (rectEmpty(r)) continue;
+        for (int16_t y = r.y; y < r.y + r.h; y++) {
+            const uint16_t* src = scene.sprite + (y - box.y) * BENCH_SPRITE_SIZE + (r.x - box.x);
+            uint16_t* dst = pixels + (y - area.y) * area.w + (r.x - area.x);
+            for (int16_t i = 0; i < r.w; i++) {
+                if (src[i]) dst[i] = src[i];
+            }
+        }
+    }
+}
+
+/**
+ * Heavy work per pixel: anti-aliased discs, a square root and a
+ * blend for every pixel of every disc's box
+ */
+static void renderDiscs(void* context, uint16_t* pixels, const Rect& area) {
+    const BenchScene& scene = *static_cast<const BenchScene*>(context);
+    for (int16_t row = 0; row < area.h; row++) {
+        uint16_t color = benchBackground(area.y + row);
+        uint16_t* line = pixels + row * area.w;
+        for (int16_t i = 0; i < area.w; i++) line[i] = color;
+    }
+    for (uint8_t d = 0; d < BENCH_DISCS; d++) {
+        int16_t radius = scene.discR[d];
+        Rect box = { (int16_t)(scene.discX[d] - radius - 1), (int16_t)(scene.discY[d] - radius - 1),
+                     (int16_t)(2 * radius + 3), (int16_t)(2 * radius + 3) };
+        Rect r = rectIntersect(box, area);
+        if (rectEmpty(r)) continue;
+        uint16_t fg = scene.discColor[d];
+        for (int16_t y = r.y; y < r.y + r.h; y++) {
+            int32_t dy = y - scene.discY[d];
+            uint16_t* dst = pixels + (y - area.y) * area.w + (r.x - area.x);
+            for (int16_t i = 0; i < r.w; i++) {
+                int32_t dx = r.x + i - scene.discX[d];
+                // Distance in 1/16 pixel; coverage 0 - 16 over one pixel
+                int32_t dist = isqrt32((uint32_t)(dx * dx + dy * dy) << 8);
+                int32_t cover = radius * 16 + 8 - dist;
+                if (cover <= 0) continue;
+                if (cover >= 16) {
+                    dst[i] = fg;
+                    continue;
+                }
+                uint16_t bg = dst[i];
+                int32_t red = (bg >> 11) + ((((fg >> 11) - (bg >> 11)) * cover) >> 4);
+                int32_t green = ((bg >> 5) & 0x3F) + (((((fg >> 5) & 0x3F) - ((bg >> 5) & 0x3F)) * cover) >> 4);
+                int32_t blue = (bg & 0x1F) + ((((fg & 0x1F) - (bg & 0x1F)) * cover) >> 4);
+                dst[i] = (uint16_t)((red << 11) | (green << 5) | blue);
+            }
+        }
+    }
+}
+
+/**
+ * Per-pixel math like an image decoder: a plasma from three sines
+ */
+static void renderPlasma(void* context, uint16_t* pixels, const Rect& area) {
+    (void)context;
+    for (int16_t row = 0; row < area.h; row++) {
+        int16_t y = area.y + row;
+        int32_t sy = fixSin((uint16_t)(y * 300));
+        uint16_t* line = pixels + row * area.w;
+        for (int16_t i = 0; i < area.w; i++) {
+            int16_t x = area.x + i;
+            int32_t v = fixSin((uint16_t)(x * 400)) + sy + fixSin((uint16_t)((x + y) * 250));
+            uint8_t level = (uint8_t)((v + 3 * 32768) >> 9);  // 0 - 191
+            line[i] = benchRgb(level, (uint8_t)(191 - level), level >> 1);
+        }
+    }
+}
+
+static void makeBenchScene() {
+    BenchScene& scene = benchScene;
+    const int16_t half = BENCH_SPRITE_SIZE / 2;
+    for (int16_t y = 0; y < BENCH_SPRITE_SIZE; y++) {
+        for (int16_t x = 0; x < BENCH_SPRITE_SIZE; x++) {
+            int16_t dx = x - half, dy = y - half;
+            bool inside = dx * dx + dy * dy < half * half;
+            scene.sprite[y * BENCH_SPRITE_SIZE + x] = inside ? benchRgb(255, (uint8_t)(160 + 4 * y), 32) : 0;
+        }
+    }
+    uint32_t noise = 7;
+    for (uint8_t s = 0; s < BENCH_SPRITES; s++) {
+        noise = noise * 1664525u + 1013904223u;
+        scene.spriteX[s] = (int16_t)((noise >> 8) % (SCREEN_WIDTH + BENCH_SPRITE_SIZE)) - half;
+        scene.spriteY[s] = (int16_t)((noise >> 20) % (SCREEN_HEIGHT + BENCH_SPRITE_SIZE)) - half;
+    }
+    for (uint8_t d = 0; d < BENCH_DISCS; d++) {
+        noise = noise * 1664525u + 1013904223u;
+        scene.discX[d] = (int16_t)((noise >> 8) % SCREEN_WIDTH);
+        scene.discY[d] = (int16_t)((noise >> 16) % SCREEN_HEIGHT);
+        scene.discR[d] = (int16_t)(20 + (noise >> 26));
+        scene.discColor[d] = (uint16_t)(noise >> 3) | 0x8410;
+    }
+}
+
+/**
+ * Full screen in frame buffer mode: BENCH_RASTER_LINES at a time
+ */
+static uint32_t timeFrame(Rasterizer& raster, uint16_t* framebuffer, RasterSplit split,
+                          RasterFn render, uint32_t* waitUs) {
+    uint32_t us = 0;
+    *waitUs = 0;
+    for (int16_t y = 0; y < SCREEN_HEIGHT; y += BENCH_RASTER_LINES) {
+        Rect area = { 0, y, SCREEN_WIDTH, BENCH_RASTER_LINES };
+        raster.renderFrame(framebuffer, area, split, render, &benchScene);
+        us += raster.stats().us;
+        *waitUs += raster.stats().waitUs[0];
+    }
+    return us;
+}
+
+static void printSpeedup(const char* name, uint32_t oneUs, uint32_t twoUs) {
+    printf("  %-13s 1 core %6lu us  2 cores %6lu us  %lu.%02lux\n", name, (unsigned long)oneUs,
+           (unsigned long)twoUs, (unsigned long)(twoUs ? oneUs / twoUs : 0),
+           (unsigned long)(twoUs ? oneUs * 100 / twoUs % 100 : 0));
+}
+
+void benchRaster(ST7789& display) {
+    static Rasterizer raster(display);
+    static uint16_t framebuffer[SCREEN_WIDTH * BENCH_RASTER_LINES];
+    static const char* const names[] = { "empty", "sprites", "aa discs", "plasma" };
+    static const RasterFn workloads[] = { renderEmpty, renderSprites, renderDiscs, renderPlasma };
+    const Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    printf("--- Parallel rasterization: 240x320 ---\n");
+    makeBenchScene();
+    workerStart();
+    
+    for (uint8_t w = 0; w < 4; w++) {
+        printf("%s:\n", names[w]);
+        uint32_t us[2], waitUs[2];
+        
+        // Strip mode: the SPI sets the floor (about 38 ms at 32 MHz)
+        for (uint8_t cores = 1; cores <= 2; cores++) {
+            raster.setCores(cores);
+            raster.renderStrips(screen, workloads[w], &benchScene);
+            us[cores - 1] = raster.stats().us;
+        }
+        display.waitIdle();
+        printSpeedup("strips", us[0], us[1]);
+        printf("  %-13s core 0 render %lu us, waits %lu us; core 1 render %lu us, waits %lu us\n", "",
+               (unsigned long)raster.stats().renderUs[0], (unsigned long)raster.stats().waitUs[0],
+               (unsigned long)raster.stats().renderUs[1], (unsigned long)raster.stats().waitUs[1]);
+        
+        // Frame buffer mode: rendering only, the flush runs afterwards
+        for (uint8_t cores = 1; cores <= 2; cores++) {
+            raster.setCores(cores);
+            us[cores - 1] = timeFrame(raster, framebuffer, RASTER_BANDS, workloads[w], &waitUs[cores - 1]);
+        }
+        printSpeedup("frame bands", us[0], us[1]);
+        us[1] = timeFrame(raster, framebuffer, RASTER_STRIPS, workloads[w], &waitUs[1]);
+        printSpeedup("frame strips", us[0], us[1]);
+        printf("  %-13s barrier wait %lu us over %u calls\n", "", (unsigned long)waitUs[1],
+               SCREEN_HEIGHT / BENCH_RASTER_LINES);
+        display.waitIdle();
+    }
+    raster.setCores(2);
+}
+
+// ========== DRAW QUEUE ==========
+
+#define BENCH_QUEUE_PUSHES  1000
+#define BENCH_QUEUE_TICK_US 100    // < Interrupt rate: 10 kHz
+#define BENCH_QUEUE_MS      200
+
+/**
+ * SysTick as a free-running 24-bit cycle counter (counts down)
+ */
+static void startCycleCounter() {
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;  // Enabled, processor clock, no interrupt
+}
+
+static inline uint32_t cyclesSince(uint32_t start) {
+    return (start - systick_hw->cvr) & 0x00FFFFFF;
+}
+
+static DrawQueue benchQueueInstance;
+
+/**
+ * Interrupt side: what a capture handler would post
+ */
+struct BenchQueueIsr {
+    uint32_t ticks;
+    uint32_t cycles;
+    uint32_t maxCycles;
+};
+
+static volatile BenchQueueIsr benchIsr;
+
+static bool benchQueueTick(repeating_timer_t* timer) {
+    (void)timer;
+    uint32_t ticks = benchIsr.ticks + 1;
+    uint32_t start = systick_hw->cvr;
+    benchQueueInstance.pushNumber(168, 4, ticks, 10, COLOR_WHITE, COLOR_BLACK);
+    benchQueueInstance.pushFill(230, 4, 6, 6, (ticks & 64) ? COLOR_GREEN : COLOR_BLACK);
+    uint32_t cycles = cyclesSince(start);
+    benchIsr.ticks = ticks;
+    benchIsr.cycles = benchIsr.cycles + cycles;
+    if (cycles > benchIsr.maxCycles) benchIsr.maxCycles = cycles;
+    return true;
+}
+
+void benchQueue(ST7789& display) {
+    DrawQueue& queue = benchQueueInstance;
+    printf("--- Draw queue ---\n");
+    queue.init();
+    display.fillScreen(COLOR_BLACK);
+    startCycleCounter();
+    
+    // Counter read overhead, subtracted below
+    uint32_t start = systick_hw->cvr;
+    uint32_t overhead = cyclesSince(start);
+    
+    // Push cost from thread code, queue never full
+    uint32_t total = 0, low = 0xFFFFFFFF, high = 0;
+    for (uint32_t i = 0; i < BENCH_QUEUE_PUSHES; i++) {
+        start = systick_hw->cvr;
+        queue.pushPixel((int16_t)(i % SCREEN_WIDTH), (int16_t)(20 + i / SCREEN_WIDTH), COLOR_CYAN);
+        uint32_t cycles = cyclesSince(start) - overhead;
+        total += cycles;
+        if (cycles < low) low = cycles;
+        if (cycles > high) high = cycles;
+        if (queue.count() >= DRAWQ_SIZE / 2) queue.drain(display);
+    }
+    queue.drain(display);
+    printf("push (thread)    min %lu  avg %lu  max %lu cycles\n", (unsigned long)low,
+           (unsigned long)(total / BENCH_QUEUE_PUSHES), (unsigned long)high);
+    
+    // Drain cost per command for a full queue of fills
+    for (uint32_t i = 0; i < DRAWQ_SIZE; i++) {
+        queue.pushFill((int16_t)((i % 16) * 15), (int16_t)(40 + (i / 16) * 15), 12, 12, COLOR_ORANGE);
+    }
+    uint32_t t0 = time_us_32();
+    uint32_t drained = queue.drain(display);
+    uint32_t us = time_us_32() - t0;
+    printf("drain            %lu fills in %lu us (%lu us each)\n", (unsigned long)drained,
+           (unsigned long)us, (unsigned long)(drained ? us / drained : 0));
+    
+    // Overflow: twice the capacity without draining
+    uint32_t dropped = queue.dropped();
+    for (uint32_t i = 0; i < 2 * DRAWQ_SIZE; i++) {
+        queue.pushPixel((int16_t)i, 100, COLOR_RED);
+    }
+    printf("overflow         %lu of %u pushes dropped, high water %lu\n",
+           (unsigned long)(queue.dropped() - dropped), 2 * DRAWQ_SIZE, (unsigned long)queue.highWater());
+    queue.drain(display);
+    
+    // Interrupt handler posting a counter and an activity LED at
+    // 10 kHz while the main loop drains and keeps drawing
+    benchIsr.ticks = 0;
+    benchIsr.cycles = 0;
+    benchIsr.maxCycles = 0;
+    dropped = queue.dropped();
+    uint32_t skipped = queue.skipped();
+    repeating_timer_t timer;
+    add_repeating_timer_us(-BENCH_QUEUE_TICK_US, benchQueueTick, nullptr, &timer);
+    uint32_t drains = 0;
+    drained = 0;
+    t0 = time_us_32();
+    while (time_us_32() - t0 < BENCH_QUEUE_MS * 1000) {
+        drained += queue.drain(display);
+        drains++;
+        display.fillRect(0, 120 + (drains % 100), SCREEN_WIDTH, 1, (uint16_t)(drains * 97));
+    }
+    cancel_repeating_timer(&timer);
+    drained += queue.drain(display);
+    
+    uint32_t ticks = benchIsr.ticks;
+    printf("push (interrupt) avg %lu  max %lu cycles per push over %lu interrupts\n",
+           (unsigned long)(ticks ? benchIsr.cycles / (2 * ticks) : 0),
+           (unsigned long)(benchIsr.maxCycles / 2), (unsigned long)ticks);
+    printf("                 %lu drained in %lu drains, %lu skipped (covered), %lu dropped\n",
+           (unsigned long)drained, (unsigned long)drains, (unsigned long)(queue.skipped() - skipped),
+           (unsigned long)(queue.dropped() - dropped));
+}
+
+// ========== LINE PIPELINE ==========
+
+#define BENCH_PIPE_BURST 8   // < Every 8th line of the bursty producer is slow
+
+/**
+ * Sprites, but every BENCH_PIPE_BURST-th line takes as long as four
+ * lines on the SPI (a text line, a slow decoder block): the average
+ * still keeps up, the slow lines only do with enough buffers
+ */
+static void renderBursty(void* context, uint16_t* pixels, const Rect& area) {
+    renderSprites(context, pixels, area);
+    if (area.y % BENCH_PIPE_BURST == BENCH_PIPE_BURST - 1) {
+        busy_wait_us_32((uint32_t)area.w * area.h * 16 * 4 / 32);  // 4 × the line's SPI time at 32 MHz
+    }
+}
+
+void benchPipeline(ST7789& display) {
+    static uint16_t memory[PIPE_MAX_BUFFERS * SCREEN_WIDTH];
+    static const char* const names[] = { "sprites", "plasma", "bursty" };
+    static const RasterFn workloads[] = { renderSprites, renderPlasma, renderBursty };
+    static const uint8_t bufferCounts[] = { 2, 3, 4, 8 };
+    const Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    printf("--- Line pipeline: 240x320, one line per buffer ---\n");
+    makeBenchScene();
+    
+    for (uint8_t w = 0; w < 3; w++) {
+        printf("%s:\n", names[w]);
+        for (uint8_t b = 0; b < 4; b++) {
+            LinePipeline pipe(display, memory, bufferCounts[b] * SCREEN_WIDTH, bufferCounts[b]);
+            pipe.run(screen, workloads[w], &benchScene, 1);
+            const PipelineStats& s = pipe.stats();
+            printf("  %u buffers %6lu us  underruns %3lu (%5lu us idle)  producer %6lu us, waited %6lu us\n",
+                   bufferCounts[b], (unsigned long)s.us, (unsigned long)s.underruns,
+                   (unsigned long)s.idleUs, (unsigned long)s.produceUs, (unsigned long)s.bufferWaitUs);
+        }
+    }
+}
+
+// ========== GLYPH CACHE ==========
+
+#define BENCH_TEXT_FRAMES 20
+#define BENCH_TEXT_ARENA  (32 * 12 * 16)   // < 32 glyphs at scale 2, 128 at scale 1
+
+/**
+ * A status screen: the same labels every frame, three color pairs
+ * (90 different glyphs)
+ */
+static const char* const benchLabels[] = {
+    "CPU  42%", "TEMP 41.5 C", "RSSI -67 dBm", "SSID workshop-2g", "UPTIME 3d 04:12:09",
+    "HEAP 112 KB free", "FPS 58.9", "BATT 3.91 V 87%", "LINK 54 Mbit/s", "TX 1204 RX 9911",
+    "MODE auto", "ERR 0"
+};
+#define BENCH_LABELS (sizeof(benchLabels) / sizeof(benchLabels[0]))
+
+static const uint16_t benchTextFg[] = { COLOR_WHITE, COLOR_YELLOW, COLOR_GREEN };
+static const uint16_t benchTextBg[] = { COLOR_BLACK, COLOR_BLUE, COLOR_BLACK };
+
+/**
+ * Everything the XIP cache holds has to come from flash again
+ */
+static void flushXipCache() {
+    xip_ctrl_hw->flush = 1;
+    (void)xip_ctrl_hw->flush;  // The read waits for the flush
+}
+
+/**
+ * Draw the labels, from the cache or (cache nullptr) rendered from the
+ * font into two alternating buffers; returns the characters drawn
+ */
+static uint32_t drawBenchLabels(ST7789& display, GlyphCache* cache, uint8_t scale) {
+    static uint16_t cells[2][12 * 16];
+    uint32_t chars = 0;
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < BENCH_LABELS; i++) {
+        int16_t y = 8 + i * 10 * scale;
+        uint16_t fg = benchTextFg[i % 3];
+        uint16_t bg = benchTextBg[i % 3];
+        if (cache) {
+            cache->drawText(display, 8, y, benchLabels[i], fg, bg);
+        } else {
+            int16_t x = 8;
+            for (const char* p = benchLabels[i]; *p; p++, x += 6 * scale) {
+                GlyphCache::renderGlyph(*p, fg, bg, scale, cells[n]);
+                display.drawBufferAsync(x, y, 6 * scale, 8 * scale, cells[n]);  // Waits for the other buffer
+                n ^= 1;
+            }
+        }
+        chars += strlen(benchLabels[i]);
+    }
+    display.waitIdle();
+    return chars;
+}
+
+/**
+ * Draw BENCH_TEXT_FRAMES frames, returns characters per second
+ */
+static uint32_t timeBenchLabels(ST7789& display, GlyphCache* cache, uint8_t scale, bool cold) {
+    uint32_t chars = 0;
+    uint32_t us = 0;
+    for (uint8_t f = 0; f < BENCH_TEXT_FRAMES; f++) {
+        if (cold) flushXipCache();
+        uint32_t t0 = time_us_32();
+        chars += drawBenchLabels(display, cache, scale);
+        us += time_us_32() - t0;
+    }
+    return (uint32_t)((uint64_t)chars * 1000000 / us);
+}
+
+/**
+ * CPU time to get one glyph's pixels, without the SPI
+ */
+static uint32_t prepareNs(GlyphCache* cache, uint8_t scale) {
+    static uint16_t cell[12 * 16];
+    uint32_t glyphs = 0;
+    uint32_t t0 = time_us_32();
+    for (uint8_t f = 0; f < BENCH_TEXT_FRAMES; f++) {
+        for (uint8_t i = 0; i < BENCH_LABELS; i++) {
+            for (const char* p = benchLabels[i]; *p; p++) {
+                if (cache) {
+                    sinkFix = cache->glyph(*p, benchTextFg[i % 3], benchTextBg[i % 3])[0];
+                } else {
+                    GlyphCache::renderGlyph(*p, benchTextFg[i % 3], benchTextBg[i % 3], scale, cell);
+                    sinkFix = cell[0];
+                }
+                glyphs++;
+            }
+        }
+    }
+    return (uint32_t)((uint64_t)(time_us_32() - t0) * 1000 / glyphs);
+}
+
+void benchGlyphCache(ST7789& display) {
+    static uint16_t arena[BENCH_TEXT_ARENA];
+    static const uint8_t slotCounts[] = { 16, 32, 64, 128 };
+    printf("--- Glyph cache: %u labels, %u frames ---\n", (unsigned)BENCH_LABELS, BENCH_TEXT_FRAMES);
+    
+    for (uint8_t scale = 1; scale <= 2; scale++) {
+        uint32_t cell = 48 * scale * scale;
+        display.fillScreen(COLOR_BLACK);
+        printf("scale %u:\n", scale);
+        printf("  uncached         %6lu chars/s (%6lu cold)  prepare %5lu ns/glyph\n",
+               (unsigned long)timeBenchLabels(display, nullptr, scale, false),
+               (unsigned long)timeBenchLabels(display, nullptr, scale, true),
+               (unsigned long)prepareNs(nullptr, scale));
+        
+        for (uint8_t s = 0; s < 4; s++) {
+            if (slotCounts[s] * cell > BENCH_TEXT_ARENA) continue;
+            GlyphCache cache(arena, slotCounts[s] * cell, scale);
+            uint32_t warm = timeBenchLabels(display, &cache, scale, false);
+            const GlyphCacheStats& st = cache.stats();
+            uint32_t hitRate = (uint32_t)((uint64_t)st.hits * 100 / (st.hits + st.misses));
+            uint32_t evictions = st.evictions;
+            uint32_t cold = timeBenchLabels(display, &cache, scale, true);
+            printf("  %3u slots (%2lu KB) %6lu chars/s (%6lu cold)  prepare %5lu ns/glyph  hits %3lu%%, %lu evictions\n",
+                   slotCounts[s], (unsigned long)(slotCounts[s] * cell * 2 / 1024),
+                   (unsigned long)warm, (unsigned long)cold, (unsigned long)prepareNs(&cache, scale),
+                   (unsigned long)hitRate, (unsigned long)evictions);
+        }
+    }
+}
+
+// ========== UNICODE FONT ==========
+
+#define BENCH_FONT_LOOKUPS 20000
+#define BENCH_FONT_RANGES  512     // < Ranges of the synthetic large font
+#define BENCH_FONT_SIZE    (FONT_HEADER_SIZE + BENCH_FONT_RANGES * 8 + 8 * 8)
+
+/**
+ * A font with 4096 code points in 512 ranges of 8 (CJK-like
+ * spacing), all sharing 8 empty glyphs: only the index is real
+ */
+static const uint8_t* makeLargeFont() {
+    static uint32_t words[BENCH_FONT_SIZE / 4];
+    uint8_t* data = (uint8_t*)words;
+    memset(data, 0, sizeof(words));
+    memcpy(data, "FNT1", 4);
+    data[4] = 16;                                  // Line height
+    data[6] = 14;                                  // Ascent
+    data[8] = BENCH_FONT_RANGES & 0xFF;
+    data[9] = BENCH_FONT_RANGES >> 8;
+    data[10] = 8;                                  // Glyphs
+    data[14] = data[15] = 0xFF;                    // No fallback
+    uint32_t* ranges = words + FONT_HEADER_SIZE / 4;
+    for (uint32_t i = 0; i < BENCH_FONT_RANGES; i++) {
+        ranges[i * 2] = 0x4E00 + i * 16;
+        ranges[i * 2 + 1] = 8;                     // Count 8, first glyph 0
+    }
+    for (uint32_t i = 0; i < 8; i++) {
+        words[(FONT_HEADER_SIZE + BENCH_FONT_RANGES * 8) / 4 + i * 2] = 16u << 24;   // Advance 16, no ink
+    }
+    return data;
+}
+
+/**
+ * Average glyphIndex() time over code points from first, step apart
+ */
+static uint32_t lookupNs(const Font& font, uint32_t first, uint32_t count, uint32_t step) {
+    uint32_t t0 = time_us_32();
+    for (uint32_t i = 0; i < BENCH_FONT_LOOKUPS; i++) {
+        sinkFix = font.glyphIndex(first + (i % count) * step);
+    }
+    return (uint32_t)((uint64_t)(time_us_32() - t0) * 1000 / BENCH_FONT_LOOKUPS);
+}
+
+void benchFont(ST7789& display) {
+    static const char* const labels[] = {
+        "SSID: workshop-2g", "Café Wi-Fi → 5 GHz", "Büro 2.4G · Straße", "Temp ±0.5 °C, 12 µs"
+    };
+    printf("--- Unicode font ---\n");
+    Font font;
+    if (!font.open(demo_fnt, sizeof(demo_fnt))) {
+        printf("demo font not valid\n");
+        return;
+    }
+    Font large;
+    large.open(makeLargeFont(), BENCH_FONT_SIZE);
+    
+    printf("lookup, demo font (%u glyphs, %u ranges):\n", font.glyphCount(), font.rangeCount());
+    printf("  ASCII     %4lu ns\n", (unsigned long)lookupNs(font, 0x20, 95, 1));
+    printf("  Latin-1   %4lu ns\n", (unsigned long)lookupNs(font, 0xC0, 64, 1));
+    printf("  missing   %4lu ns\n", (unsigned long)lookupNs(font, 0x4E00, 1000, 7));
+    printf("lookup, large font (%u ranges):\n", large.rangeCount());
+    printf("  present   %4lu ns\n", (unsigned long)lookupNs(large, 0x4E00, BENCH_FONT_RANGES, 16));
+    printf("  missing   %4lu ns\n", (unsigned long)lookupNs(large, 0x4E08, BENCH_FONT_RANGES, 16));
+    
+    uint16_t a = font.glyphIndex('A');
+    uint32_t t0 = time_us_32();
+    for (uint32_t i = 0; i < BENCH_FONT_LOOKUPS; i++) {
+        sinkFix = font.kerning(a, (uint16_t)(i % font.glyphCount()));
+    }
+    printf("kerning     %4lu ns (%u pairs)\n",
+           (unsigned long)((uint64_t)(time_us_32() - t0) * 1000 / BENCH_FONT_LOOKUPS),
+           font.kerningCount());
+    
+    // Decoding alone, then measuring and drawing whole labels
+    uint32_t bytes = 0;
+    uint32_t chars = 0;
+    t0 = time_us_32();
+    for (uint32_t n = 0; n < 500; n++) {
+        const char* p = labels[n % 4];
+        const char* start = p;
+        while (utf8Next(p)) chars++;
+        bytes += p - start;
+    }
+    uint32_t us = time_us_32() - t0;
+    printf("UTF-8       %4lu KB/s, %lu chars/s\n", (unsigned long)((uint64_t)bytes * 1000000 / 1024 / us),
+           (unsigned long)((uint64_t)chars * 1000000 / us));
+    
+    t0 = time_us_32();
+    for (uint32_t n = 0; n < 500; n++) {
+        sinkFix = font.textWidth(labels[n % 4]);
+    }
+    printf("textWidth   %4lu ns per label\n", (unsigned long)((time_us_32() - t0) * 1000 / 500));
+    
+    display.fillScreen(COLOR_BLACK);
+    for (uint8_t i = 0; i < 4; i++) {
+        uint32_t labelChars = 0;
+        for (const char* p = labels[i]; utf8Next(p);) labelChars++;
+        t0 = time_us_32();
+        for (uint8_t f = 0; f < 10; f++) {
+            font.drawText(display, 4, 4 + i * font.lineHeight(), labels[i], COLOR_WHITE);
+        }
+        us = (time_us_32() - t0) / 10;
+        printf("  \"%s\" %4lu us, %lu chars/s\n", labels[i], (unsigned long)us,
+               (unsigned long)((uint64_t)labelChars * 1000000 / us));
+    }
+}
+
+// ========== TEXT LAYOUT ==========
+
+#define BENCH_LAYOUT_FRAMES 20
+
+static const char* const benchDialog =
+    "Connect to \"Café Wi-Fi\" (5 GHz)? The device restarts once the "
+    "password is saved.";
+
+static const char* const benchListItems[] = {
+    "workshop-2g", "Café Wi-Fi", "Büro 2.4G", "Straße-Gäste", "iPhone von Jörg", "Ærø Camping"
+};
+#define BENCH_LIST_ITEMS (sizeof(benchListItems) / sizeof(benchListItems[0]))
+
+static TextLayout benchScratchLayout;   // < Layout shaped without the cache
+
+/**
+ * One frame of the dialog screen: a wrapped, centered paragraph and a
+ * list, either shaped every time or through the cache
+ */
+static void drawLayoutFrame(ST7789& display, const Font& font, TextLayoutCache& cache, bool cached) {
+    TextLayout& scratch = benchScratchLayout;
+    Rect box = { 20, 8, 200, 0 };
+    if (cached) {
+        cache.drawText(display, box, benchDialog, ALIGN_CENTER, COLOR_WHITE);
+    } else {
+        TextLayoutCache::shape(font, benchDialog, box.w, ALIGN_CENTER, scratch);
+        cache.draw(display, box.x, box.y, scratch, COLOR_WHITE);
+    }
+    for (uint8_t i = 0; i < BENCH_LIST_ITEMS; i++) {
+        Rect item = { 8, (int16_t)(150 + i * font.lineHeight()), 224, 0 };
+        if (cached) {
+            cache.drawText(display, item, benchListItems[i], ALIGN_RIGHT, COLOR_CYAN);
+        } else {
+            TextLayoutCache::shape(font, benchListItems[i], item.w, ALIGN_RIGHT, scratch);
+            cache.draw(display, item.x, item.y, scratch, COLOR_CYAN);
+        }
+    }
+}
+
+void benchLayout(ST7789& display) {
+    static TextLayout entries[12];
+    printf("--- Text layout: wrapped dialog + %u list items ---\n", (unsigned)BENCH_LIST_ITEMS);
+    Font font;
+    if (!font.open(demo_fnt, sizeof(demo_fnt))) return;
+    TextLayoutCache cache(font, entries, 12);
+    TextLayout& scratch = benchScratchLayout;
+    
+    uint32_t t0 = time_us_32();
+    for (uint8_t f = 0; f < BENCH_LAYOUT_FRAMES; f++) {
+        TextLayoutCache::shape(font, benchDialog, 200, ALIGN_CENTER, scratch);
+    }
+    uint32_t shapeUs = (time_us_32() - t0) / BENCH_LAYOUT_FRAMES;
+    cache.layout(benchDialog, 200, ALIGN_CENTER);
+    t0 = time_us_32();
+    for (uint8_t f = 0; f < BENCH_LAYOUT_FRAMES; f++) {
+        sinkFix = cache.layout(benchDialog, 200, ALIGN_CENTER).lineCount;
+    }
+    uint32_t hitUs = (time_us_32() - t0) / BENCH_LAYOUT_FRAMES;
+    display.fillScreen(COLOR_BLACK);
+    t0 = time_us_32();
+    for (uint8_t f = 0; f < BENCH_LAYOUT_FRAMES; f++) {
+        cache.draw(display, 20, 8, scratch, COLOR_WHITE);
+    }
+    uint32_t drawUs = (time_us_32() - t0) / BENCH_LAYOUT_FRAMES;
+    printf("dialog: %u lines, %u glyphs; shape %lu us, cache hit %lu us, draw %lu us\n",
+           scratch.lineCount, scratch.glyphCount, (unsigned long)shapeUs, (unsigned long)hitUs,
+           (unsigned long)drawUs);
+    
+    for (uint8_t cached = 0; cached < 2; cached++) {
+        cache.clear();
+        cache.resetStats();
+        t0 = time_us_32();
+        for (uint8_t f = 0; f < BENCH_LAYOUT_FRAMES; f++) {
+            drawLayoutFrame(display, font, cache, cached);
+        }
+        uint32_t us = (time_us_32() - t0) / BENCH_LAYOUT_FRAMES;
+        if (cached) {
+            printf("frame, cached  %6lu us  (%lu hits, %lu misses, %lu us shaping in all)\n",
+                   (unsigned long)us, (unsigned long)cache.stats().hits,
+                   (unsigned long)cache.stats().misses, (unsigned long)cache.stats().shapeUs);
+        } else {
+            printf("frame, shaped  %6lu us\n", (unsigned long)us);
+        }
+    }
+}
+
+// ========== ASSET PACK ==========
+
+#define BENCH_ASSET_LOOKUPS 20000
+#define BENCH_PACK_ASSETS   512                             // < Assets in the synthetic pack
+#define BENCH_PACK_NAMES    (BENCH_PACK_ASSETS * 12)        // < "asset/0000" + null, padded
+#define BENCH_PACK_SIZE     (ASSET_PACK_HEADER_SIZE + BENCH_PACK_ASSETS * (4 + ASSET_ENTRY_SIZE) + \
+                             BENCH_PACK_NAMES)
+
+/**
+ * A pack of 512 empty assets named "asset/0000" to "asset/0511",
+ * built like assetpack.py does: entries in hash order
+ */
+static const uint8_t* makeLargePack() {
+    static uint32_t words[BENCH_PACK_SIZE / 4];
+    uint8_t* data = (uint8_t*)words;
+    memset(data, 0, sizeof(words));
+    uint32_t* hashes = words + ASSET_PACK_HEADER_SIZE / 4;
+    uint32_t* entries = hashes + BENCH_PACK_ASSETS;
+    char* names = (char*)(entries + BENCH_PACK_ASSETS * ASSET_ENTRY_SIZE / 4);
+    
+    // Insertion sort of (hash, number) by hash
+    static uint16_t order[BENCH_PACK_ASSETS];
+    char name[12];
+    for (uint16_t i = 0; i < BENCH_PACK_ASSETS; i++) {
+        snprintf(name, sizeof(name), "asset/%04u", i);
+        uint32_t h = assetHash(name);
+        uint16_t k = i;
+        while (k > 0 && hashes[k - 1] > h) {
+            hashes[k] = hashes[k - 1];
+            order[k] = order[k - 1];
+            k--;
+        }
+        hashes[k] = h;
+        order[k] = i;
+    }
+    for (uint16_t k = 0; k < BENCH_PACK_ASSETS; k++) {
+        snprintf(names + k * 12, 12, "asset/%04u", order[k]);
+        entries[k * 4] = BENCH_PACK_SIZE;              // Offset: empty asset at the end
+        entries[k * 4 + 2] = k * 12;                   // Name offset, format ASSET_RAW
+    }
+    memcpy(data, "PAK1", 4);
+    data[4] = BENCH_PACK_ASSETS & 0xFF;
+    data[5] = BENCH_PACK_ASSETS >> 8;
+    words[2] = BENCH_PACK_SIZE;
+    words[3] = BENCH_PACK_NAMES;
+    return data;
+}
+
+/**
+ * Average find() time over names, or over names that are not in the
+ * pack when names is nullptr; every lookup after an XIP cache flush
+ * when cold
+ */
+static uint32_t findNs(const AssetPack& pack, const char* const* names, uint32_t count, bool cold) {
+    static char missing[16][12];
+    if (!names) {
+        for (uint8_t i = 0; i < 16; i++) {
+            snprintf(missing[i], sizeof(missing[i]), "missing/%02u", i);
+        }
+        count = 16;
+    }
+    Asset asset;
+    uint32_t lookups = cold ? BENCH_ASSET_LOOKUPS / 20 : BENCH_ASSET_LOOKUPS;
+    uint32_t total = 0;
+    uint32_t t0 = time_us_32();
+    for (uint32_t i = 0; i < lookups; i++) {
+        const char* name = names ? names[i % count] : missing[i % count];
+        if (cold) {
+            flushXipCache();
+            t0 = time_us_32();
+        }
+        sinkFix = pack.find(name, asset);
+        if (cold) total += time_us_32() - t0;
+    }
+    if (!cold) total = time_us_32() - t0;
+    return (uint32_t)((uint64_t)total * 1000 / lookups);
+}
+
+/**
+ * Average time to find a name by comparing it with every name in
+ * turn (what a pack without an index would do)
+ */
+static uint32_t scanNs(const AssetPack& pack, const char* const* names, uint32_t count) {
+    Asset asset;
+    uint32_t lookups = BENCH_ASSET_LOOKUPS / 20;
+    uint32_t t0 = time_us_32();
+    for (uint32_t i = 0; i < lookups; i++) {
+        const char* name = names[i % count];
+        for (uint16_t k = 0; pack.at(k, asset); k++) {
+            if (strcmp(asset.name, name) == 0) break;
+        }
+        sinkFix = asset.size;
+    }
+    return (uint32_t)((uint64_t)(time_us_32() - t0) * 1000 / lookups);
+}
+
+void benchAssets(ST7789& display) {
+    static const char* names[BENCH_PACK_ASSETS];
+    AssetPack pack;
+    const char* source = "asset partition";
+    if (!pack.openPartition()) {
+        source = "linked-in demo pack (partition empty)";
+        if (!pack.open(demo_pak, sizeof(demo_pak))) {
+            printf("--- Asset pack: demo pack not valid ---\n");
+            return;
+        }
+    }
+    printf("--- Asset pack: %u assets, %lu bytes, %s ---\n", pack.count(),
+           (unsigned long)pack.size(), source);
+    
+    Asset asset;
+    uint16_t count = 0;
+    while (count < BENCH_PACK_ASSETS && pack.at(count, asset)) {
+        names[count++] = asset.name;
+    }
+    const uint32_t bannerHash = assetHash("banner");
+    uint32_t t0 = time_us_32();
+    for (uint32_t i = 0; i < BENCH_ASSET_LOOKUPS; i++) {
+        sinkFix = pack.findHash(bannerHash, asset);
+    }
+    uint32_t hashNs = (uint32_t)((uint64_t)(time_us_32() - t0) * 1000 / BENCH_ASSET_LOOKUPS);
+    printf("find, %u assets:\n", count);
+    printf("  present   %5lu ns\n", (unsigned long)findNs(pack, names, count, false));
+    printf("  missing   %5lu ns\n", (unsigned long)findNs(pack, nullptr, count, false));
+    printf("  by hash   %5lu ns\n", (unsigned long)hashNs);
+    printf("  cold      %5lu ns (XIP cache flushed before each)\n",
+           (unsigned long)findNs(pack, names, count, true));
+    
+    AssetPack large;
+    large.open(makeLargePack(), BENCH_PACK_SIZE);
+    for (uint16_t i = 0; i < BENCH_PACK_ASSETS; i++) {
+        large.at(i, asset);
+        names[i] = asset.name;
+    }
+    printf("find, %u assets:\n", large.count());
+    printf("  present   %5lu ns\n", (unsigned long)findNs(large, names, BENCH_PACK_ASSETS, false));
+    printf("  missing   %5lu ns\n", (unsigned long)findNs(large, nullptr, BENCH_PACK_ASSETS, false));
+    printf("  scan      %5lu ns (strcmp over the names)\n",
+           (unsigned long)scanNs(large, names, BENCH_PACK_ASSETS));
+    
+    // The picture straight from flash by DMA, then copied to RAM first
+    if (!pack.find("banner", asset) || asset.format != ASSET_RGB565) {
+        printf("no banner picture in the pack\n");
+        return;
+    }
+    static uint16_t copy[240 * 64];
+    if (asset.size > sizeof(copy)) return;
+    display.fillScreen(COLOR_BLACK);
+    for (uint8_t mode = 0; mode < 3; mode++) {
+        uint32_t us = 0;
+        for (uint8_t n = 0; n < 10; n++) {
+            if (mode == 1) flushXipCache();
+            t0 = time_us_32();
+            if (mode < 2) {
+                AssetPack::drawImage(display, 0, n * 16, asset);
+            } else {
+                memcpy(copy, asset.data, asset.size);
+                display.drawBufferAsync(0, n * 16, asset.width, asset.height, copy);
+            }
+            display.waitIdle();
+            us += time_us_32() - t0;
+        }
+        us /= 10;
+        static const char* const modes[] = { "from flash", "from flash, cold", "copied to RAM" };
+        printf("%ux%u %-16s %5lu us, %lu KB/s\n", asset.width, asset.height, modes[mode],
+               (unsigned long)us, (unsigned long)((uint64_t)asset.size * 1000000 / 1024 / us));
+    }
+    printf("RAM: %u bytes per AssetPack, %lu bytes saved per copy\n", (unsigned)sizeof(AssetPack),
+           (unsigned long)asset.size);
+}
+
+// ========== XIP STREAMING ==========
+
+#define BENCH_XIP_FRAMES 20
+
+/**
+ * CPU part of a UI frame: shaping and measuring text, with the code
+ * and the font tables read from flash
+ */
+static void uiFrameWork(const Font& font) {
+    TextLayoutCache::shape(font, benchDialog, 200, ALIGN_CENTER, benchScratchLayout);
+    for (uint8_t i = 0; i < BENCH_LIST_ITEMS; i++) {
+        sinkFix = font.textWidth(benchListItems[i]);
+    }
+}
+
+struct BenchJitter {
+    uint32_t avgUs;
+    uint32_t maxUs;
+    uint32_t hitPercent;   // < XIP cache hits during the work
+    uint32_t blitUs;       // < Average blit, until the display was idle
+};
+
+/**
+ * Time the UI work after each of BENCH_XIP_FRAMES blits of the
+ * picture (none if picture is nullptr), read through stream if given
+ */
+static void timeUiFrames(ST7789& display, const Font& font, const Asset* picture,
+                         XipStream* stream, BenchJitter& out) {
+    uint32_t total = 0;
+    uint32_t blitTotal = 0;
+    uint64_t hits = 0;
+    uint64_t accesses = 0;
+    out.maxUs = 0;
+    uiFrameWork(font);  // Warm
+    for (uint8_t f = 0; f < BENCH_XIP_FRAMES; f++) {
+        if (picture) {
+            uint32_t tb = time_us_32();
+            AssetPack::drawImage(display, 0, 240, *picture, stream);
+            display.waitIdle();
+            blitTotal += time_us_32() - tb;
+        }
+        xip_ctrl_hw->ctr_hit = 0;  // Any write clears a counter
+        xip_ctrl_hw->ctr_acc = 0;
+        uint32_t t0 = time_us_32();
+        uiFrameWork(font);
+        uint32_t us = time_us_32() - t0;
+        hits += xip_ctrl_hw->ctr_hit;
+        accesses += xip_ctrl_hw->ctr_acc;
+        total += us;
+        if (us > out.maxUs) out.maxUs = us;
+    }
+    out.avgUs = total / BENCH_XIP_FRAMES;
+    out.blitUs = blitTotal / BENCH_XIP_FRAMES;
+    out.hitPercent = accesses ? (uint32_t)(hits * 100 / accesses) : 100;
+}
+
+void benchXipStream(ST7789& display) {
+    static uint16_t lines[2 * 2 * SCREEN_WIDTH] __attribute__((aligned(4)));
+    XipStream stream(lines, sizeof(lines) / 2);
+    AssetPack pack;
+    Asset banner;
+    Font font;
+    if ((!pack.openPartition() && !pack.open(demo_pak, sizeof(demo_pak))) ||
+        !pack.find("banner", banner) || !font.open(demo_fnt, sizeof(demo_fnt))) {
+        printf("--- XIP streaming: no banner picture ---\n");
+        return;
+    }
+    printf("--- XIP streaming: UI frame after %ux%u blits (%lu KB, XIP cache 16 KB) ---\n",
+           banner.width, banner.height, (unsigned long)(banner.size / 1024));
+    
+    display.fillScreen(COLOR_BLACK);
+    BenchJitter none, cached, streamed;
+    timeUiFrames(display, font, nullptr, nullptr, none);
+    timeUiFrames(display, font, &banner, nullptr, cached);
+    stream.resetStats();
+    timeUiFrames(display, font, &banner, &stream, streamed);
+    
+    const BenchJitter* results[] = { &none, &cached, &streamed };
+    static const char* const names[] = { "no blit", "after cached blit", "after streamed blit" };
+    for (uint8_t i = 0; i < 3; i++) {
+        const BenchJitter& r = *results[i];
+        printf("%-20s avg %4lu us, max %4lu us (+%lu us), %lu%% cache hits\n", names[i],
+               (unsigned long)r.avgUs, (unsigned long)r.maxUs,
+               (unsigned long)(r.maxUs > none.avgUs ? r.maxUs - none.avgUs : 0),
+               (unsigned long)r.hitPercent);
+    }
+    printf("blit: through cache %lu us, streamed %lu us (waited %lu us for the FIFO)\n",
+           (unsigned long)cached.blitUs, (unsigned long)streamed.blitUs,
+           (unsigned long)(stream.stats().waitUs / BENCH_XIP_FRAMES));
+}
+
+// ========== FRAME ARENA ==========
+
+#define BENCH_ARENA_FRAMES 20
+#define BENCH_ARENA_ALLOCS 48     // < Temporaries per frame (about 6.5 KB)
+#define BENCH_ARENA_BYTES  8192   // < Arena of each core
+#define BENCH_ARENA_TINY   256    // < Too small for the dialog's spans
+
+static uint8_t benchArenaMemory[2][BENCH_ARENA_BYTES] __attribute__((aligned(8)));
+
+enum BenchCulling { CULL_ARENA, CULL_MALLOC, CULL_NONE };
+
+static BenchCulling benchCulling;   // < How renderCulled() gets its list
+
+/**
+ * Sprites, drawn from a list of the ones that touch the strip: the
+ * list is taken from the frame arena of the core, from malloc(), or
+ * not made at all (every sprite is tested while drawing)
+ */
+static void renderCulled(void* context, uint16_t* pixels, const Rect& area) {
+    const BenchScene& scene = *static_cast<const BenchScene*>(context);
+    uint8_t* list = nullptr;
+    if (benchCulling == CULL_ARENA) {
+        FrameArena* arena = FrameArena::current();
+        if (arena) list = arena->allocArray<uint8_t>(BENCH_SPRITES);
+    } else if (benchCulling == CULL_MALLOC) {
+        list = (uint8_t*)malloc(BENCH_SPRITES);
+    }
+    uint8_t count = 0;
+    for (uint8_t s = 0; s < BENCH_SPRITES; s++) {
+        Rect box = { scene.spriteX[s], scene.spriteY[s], BENCH_SPRITE_SIZE, BENCH_SPRITE_SIZE };
+        if (!list) {
+            count++;
+        } else if (!rectEmpty(rectIntersect(box, area))) {
+            list[count++] = s;
+        }
+    }
+    
+    for (int16_t row = 0; row < area.h; row++) {
+        uint16_t color = benchBackground(area.y + row);
+        uint16_t* line = pixels + row * area.w;
+        for (int16_t i = 0; i < area.w; i++) line[i] = color;
+    }
+    for (uint8_t k = 0; k < count; k++) {
+        uint8_t s = list ? list[k] : k;
+        Rect box = { scene.spriteX[s], scene.spriteY[s], BENCH_SPRITE_SIZE, BENCH_SPRITE_SIZE };
+        Rect r = rectIntersect(box, area);
+        if (rectEmpty(r)) continue;
+        for (int16_t y = r.y; y < r.y + r.h; y++) {
+            const uint16_t* src = scene.sprite + (y - box.y) * BENCH_SPRITE_SIZE + (r.x - box.x);
+            uint16_t* dst = pixels + (y - area.y) * area.w + (r.x - area.x);
+            for (int16_t i = 0; i < r.w; i++) {
+                if (src[i]) dst[i] = src[i];
+            }
+        }
+    }
+    if (benchCulling == CULL_MALLOC) free(list);
+}
+
+/**
+ * One frame of BENCH_ARENA_ALLOCS temporaries of 16 - 256 bytes, from
+ * the arena or from malloc()
+ */
+static uint32_t timeAllocFrames(FrameArena* arena) {
+    static void* blocks[BENCH_ARENA_ALLOCS];
+    uint32_t t0 = time_us_32();
+    for (uint8_t f = 0; f < BENCH_ARENA_FRAMES; f++) {
+        for (uint8_t i = 0; i < BENCH_ARENA_ALLOCS; i++) {
+            uint32_t bytes = 16 + (i * 37) % 241;
+            blocks[i] = arena ? arena->alloc(bytes) : malloc(bytes);
+            if (blocks[i]) *(volatile uint8_t*)blocks[i] = i;
+        }
+        if (arena) {
+            arena->reset();
+        } else {
+            for (uint8_t i = 0; i < BENCH_ARENA_ALLOCS; i++) free(blocks[i]);
+        }
+    }
+    return (time_us_32() - t0) / BENCH_ARENA_FRAMES;
+}
+
+void benchArena(ST7789& display) {
+    static TextLayout entries[12];
+    static Rasterizer raster(display);
+    FrameArena arena0(benchArenaMemory[0], BENCH_ARENA_BYTES);
+    FrameArena arena1(benchArenaMemory[1], BENCH_ARENA_BYTES);
+    FrameArena tiny(benchArenaMemory[0], BENCH_ARENA_TINY);
+    const Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    printf("--- Frame arena: %u bytes per core ---\n", BENCH_ARENA_BYTES);
+    
+    uint32_t mallocUs = timeAllocFrames(nullptr);
+    uint32_t arenaUs = timeAllocFrames(&arena0);
+    printf("%u temporaries per frame: malloc/free %lu us, arena %lu us\n", BENCH_ARENA_ALLOCS,
+           (unsigned long)mallocUs, (unsigned long)arenaUs);
+    
+    // Text: the dialog's spans in one list, or in stack batches
+    Font font;
+    if (font.open(demo_fnt, sizeof(demo_fnt))) {
+        TextLayoutCache cache(font, entries, 12);
+        FrameArena* arenas[] = { nullptr, &arena0, &tiny };
+        static const char* const names[] = { "immediate", "arena", "tiny arena" };
+        display.fillScreen(COLOR_BLACK);
+        drawLayoutFrame(display, font, cache, true);  // Shape once
+        for (uint8_t a = 0; a < 3; a++) {
+            FrameArena::setForCore(0, arenas[a]);
+            FrameArena::beginFrame();
+            if (arenas[a]) arenas[a]->resetStats();
+            uint32_t t0 = time_us_32();
+            for (uint8_t f = 0; f < BENCH_ARENA_FRAMES; f++) {
+                drawLayoutFrame(display, font, cache, true);
+                FrameArena::beginFrame();  // Counts the frame
+            }
+            uint32_t us = (time_us_32() - t0) / BENCH_ARENA_FRAMES;
+            if (arenas[a]) {
+                const FrameArenaStats& s = arenas[a]->stats();
+                printf("dialog, %-10s %5lu us  (high water %lu bytes, %lu failures in %lu of %lu frames)\n",
+                       names[a], (unsigned long)us, (unsigned long)s.highWater,
+                       (unsigned long)s.failures, (unsigned long)s.failedFrames, (unsigned long)s.frames);
+            } else {
+                printf("dialog, %-10s %5lu us\n", names[a], (unsigned long)us);
+            }
+        }
+    }
+    
+    // Render callbacks on both cores, each with the arena of its core
+    static const char* const cullNames[] = { "arena", "malloc", "no list" };
+    makeBenchScene();
+    workerStart();
+    raster.setCores(2);
+    FrameArena::setForCore(0, &arena0);
+    FrameArena::setForCore(1, &arena1);
+    arena0.resetStats();
+    arena1.resetStats();
+    printf("sprites, culled per strip (2 cores):\n");
+    for (uint8_t c = 0; c < 3; c++) {
+        benchCulling = (BenchCulling)c;
+        uint32_t total = 0;
+        for (uint8_t f = 0; f < BENCH_ARENA_FRAMES; f++) {
+            FrameArena::beginFrame();
+            raster.renderStrips(screen, renderCulled, &benchScene);
+            total += raster.stats().us;
+        }
+        display.waitIdle();
+        printf("  %-8s %6lu us  (render core 0 %lu us, core 1 %lu us)\n", cullNames[c],
+               (unsigned long)(total / BENCH_ARENA_FRAMES), (unsigned long)raster.stats().renderUs[0],
+               (unsigned long)raster.stats().renderUs[1]);
+    }
+    printf("high water: core 0 %lu bytes, core 1 %lu bytes\n",
+           (unsigned long)arena0.stats().highWater, (unsigned long)arena1.stats().highWater);
+    FrameArena::setForCore(0, nullptr);
+    FrameArena::setForCore(1, nullptr);
+}
+
+// ========== COMPOSITOR ==========
+
+#define BENCH_UI_FRAMES 30
+#define BENCH_UI_ROWS   8
+#define BENCH_UI_ROW_H  24
+
+static const Rect benchUiScreen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+static const Rect benchUiPanel = { 16, 40, 208, BENCH_UI_ROWS * BENCH_UI_ROW_H };
+static const Rect benchUiToast = { 20, 268, 200, 36 };
+
+/**
+ * State of the layered screen: discs behind a list panel, a toast and
+ * a cursor on top
+ */
+struct BenchUi {
+    uint8_t values[BENCH_UI_ROWS];   // < Bar length of each list row
+    int16_t cursorX, cursorY;
+    bool toast;
+};
+
+static BenchUi benchUi;
+
+static Rect benchUiRow(uint8_t row) {
+    Rect r = { benchUiPanel.x, (int16_t)(benchUiPanel.y + row * BENCH_UI_ROW_H), benchUiPanel.w,
+               BENCH_UI_ROW_H };
+    return r;
+}
+
+static Rect benchUiCursor() {
+    Rect r = { benchUi.cursorX, benchUi.cursorY, 8, 12 };
+    return r;
+}
+
+static void fillArea(uint16_t* pixels, const Rect& area, const Rect& box, uint16_t color) {
+    Rect r = rectIntersect(box, area);
+    if (rectEmpty(r)) return;
+    for (int16_t y = r.y; y < r.y + r.h; y++) {
+        uint16_t* dst = pixels + (y - area.y) * area.w + (r.x - area.x);
+        for (int16_t i = 0; i < r.w; i++) dst[i] = color;
+    }
+}
+
+/**
+ * Content layer: the list panel, opaque over its box
+ */
+static void renderUiList(void* context, uint16_t* pixels, const Rect& area) {
+    const BenchUi& ui = *static_cast<const BenchUi*>(context);
+    fillArea(pixels, area, benchUiPanel, benchRgb(24, 24, 32));
+    for (uint8_t i = 0; i < BENCH_UI_ROWS; i++) {
+        Rect row = benchUiRow(i);
+        Rect bar = { (int16_t)(row.x + 8), (int16_t)(row.y + 6), ui.values[i], BENCH_UI_ROW_H - 12 };
+        fillArea(pixels, area, bar, i & 1 ? COLOR_CYAN : COLOR_GREEN);
+        Rect line = { row.x, (int16_t)(row.y + BENCH_UI_ROW_H - 1), row.w, 1 };
+        fillArea(pixels, area, line, benchRgb(64, 64, 80));
+    }
+}
+
+/**
+ * Overlay layer: the toast (opaque) and the cursor (an arrow, the
+ * rest of its box shows what is below)
+ */
+static void renderUiOverlay(void* context, uint16_t* pixels, const Rect& area) {
+    const BenchUi& ui = *static_cast<const BenchUi*>(context);
+    if (ui.toast) {
+        fillArea(pixels, area, benchUiToast, COLOR_ORANGE);
+        Rect inner = { (int16_t)(benchUiToast.x + 2), (int16_t)(benchUiToast.y + 2),
+                       (int16_t)(benchUiToast.w - 4), (int16_t)(benchUiToast.h - 4) };
+        fillArea(pixels, area, inner, COLOR_BLACK);
+    }
+    for (int16_t row = 0; row < 12; row++) {
+        Rect r = { ui.cursorX, (int16_t)(ui.cursorY + row), (int16_t)(row < 8 ? row + 1 : 3), 1 };
+        fillArea(pixels, area, r, COLOR_WHITE);
+    }
+}
+
+/**
+ * Next frame: the cursor moves every frame, a row changes every 5th
+ * and the toast comes or goes every 10th; the changes are reported to
+ * the compositor unless everything is redrawn
+ */
+static void stepBenchUi(Compositor& ui, uint8_t frame, bool opaque) {
+    ui.invalidate(2, benchUiCursor());
+    benchUi.cursorX = (int16_t)(20 + (frame * 7) % 200);
+    benchUi.cursorY = (int16_t)(20 + (frame * 11) % 280);
+    ui.invalidate(2, benchUiCursor());
+    if (frame % 5 == 0) {
+        uint8_t row = frame / 5 % BENCH_UI_ROWS;
+        benchUi.values[row] = (uint8_t)(20 + (benchUi.values[row] * 7 + 31) % 170);
+        ui.invalidate(1, benchUiRow(row));
+    }
+    if (frame % 10 == 0) {
+        benchUi.toast = !benchUi.toast;
+        ui.invalidate(2, benchUiToast);
+        ui.setOpaque(2, &benchUiToast, opaque && benchUi.toast ? 1 : 0);
+    }
+}
+
+void benchCompositor(ST7789& display) {
+    static uint16_t lines[2 * 8 * SCREEN_WIDTH];
+    static const char* const names[] = { "full redraw", "damage only", "damage + opaque" };
+    Compositor ui(display, lines, sizeof(lines) / 2);
+    ui.addLayer(renderDiscs, &benchScene);
+    ui.addLayer(renderUiList, &benchUi);
+    ui.addLayer(renderUiOverlay, &benchUi);
+    printf("--- Compositor: discs, list panel, toast + cursor; %u frames ---\n", BENCH_UI_FRAMES);
+    makeBenchScene();
+    
+    for (uint8_t mode = 0; mode < 3; mode++) {
+        memset(&benchUi, 0, sizeof(benchUi));
+        for (uint8_t i = 0; i < BENCH_UI_ROWS; i++) benchUi.values[i] = (uint8_t)(40 + i * 17);
+        ui.setOpaque(0, &benchUiScreen, 1);
+        ui.setOpaque(1, &benchUiPanel, mode == 2 ? 1 : 0);
+        ui.setOpaque(2, nullptr, 0);
+        ui.invalidateAll();
+        ui.flush();
+        display.waitIdle();
+        ui.resetStats();
+        
+        uint32_t total = 0;
+        uint32_t worst = 0;
+        for (uint8_t f = 1; f <= BENCH_UI_FRAMES; f++) {
+            uint32_t t0 = time_us_32();
+            stepBenchUi(ui, f, mode == 2);
+            if (mode == 0) ui.invalidateAll();
+            ui.flush();
+            display.waitIdle();
+            uint32_t us = time_us_32() - t0;
+            total += us;
+            if (us > worst) worst = us;
+        }
+        const CompositorStats& s = ui.stats();
+        printf("%-16s avg %6lu us, max %6lu us  %6lu px sent, %6lu rendered, %6lu skipped per frame\n",
+               names[mode], (unsigned long)(total / BENCH_UI_FRAMES), (unsigned long)worst,
+               (unsigned long)(s.pixels / BENCH_UI_FRAMES), (unsigned long)(s.layerPixels / BENCH_UI_FRAMES),
+               (unsigned long)(s.skippedPixels / BENCH_UI_FRAMES));
+    }
+}
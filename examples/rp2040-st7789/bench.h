@@ -0,0 +1,292 @@
+/**
+ * bench.h
+ * On-device performance benchmarks
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Each benchmark draws on the real display, measures with the
+ * microsecond timer and prints its results to USB serial. They are
+ * meant to be run once at startup (see RUN_BENCHMARKS in main.cpp).
+ * 
+ * Numbers depend on the SPI baud rate and system clock, so always
+ * report them together with those settings.
+ * 
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "st7789.h"
+
+/**
+ * Run every benchmark below in sequence
+ * 
+ * display Initialized display
+ */
+void runBenchmarks(ST7789& display);
+
+/**
+ * Terminal emulator throughput
+ * 
+ * 
+ * Feeds a synthetic colored log through the terminal in blocks of
+ * 16, 64 and 256 bytes (flush() after every block, like a UART RX
+ * handler would) and reports sustained characters per second.
+ * 
+ * The result is compared against what a serial link delivers with
+ * 8N1 framing (10 bits per character):
+ * - 115200 baud = 11520 chars/s
+ * - 1 Mbaud     = 100000 chars/s
+ */
+void benchTerminal(ST7789& display);
+
+/**
+ * Hex viewer on a 1 MB buffer
+ * 
+ * 
+ * Views the first megabyte of flash (through XIP) and measures the
+ * first full draw, page-down, one-row hardware scroll, moving the
+ * selection and a single changed byte in a RAM buffer.
+ */
+void benchHexView(ST7789& display);
+
+/**
+ * Waterfall line rate
+ * 
+ * 
+ * Pushes synthetic 128-bin spectra into a full screen waterfall and
+ * reports lines per second (target: 100+) and how much of that time
+ * the CPU spent mapping colors versus waiting for the SPI.
+ */
+void benchWaterfall(ST7789& display);
+
+/**
+ * Waveform pyramid and plot on 1M and 10M sample traces
+ * 
+ * 
+ * Samples are generated and streamed into the pyramid in chunks (a
+ * 10M sample trace does not fit in RAM or flash). Reports build time,
+ * pyramid size, and render time at several zoom levels, compared with
+ * plotting every sample with drawPixel().
+ */
+void benchWaveform(ST7789& display);
+
+/**
+ * FFT size vs. spectrum update rate
+ * 
+ * 
+ * For 64 to 1024 point FFTs: time for window + FFT + log magnitudes,
+ * time for the bar graph update, and the frame rate reached when the
+ * FFT of the next frame runs on core 1 while core 0 draws the bars.
+ */
+void benchFft(ST7789& display);
+
+/**
+ * Strip chart cost per sample
+ * 
+ * 
+ * Pushes samples into sweep and scroll charts with 1 and 4 series,
+ * and compares the time per sample with redrawing the whole history
+ * (what a chart without a ring buffer would do for every sample).
+ */
+void benchStripChart(ST7789& display);
+
+/**
+ * Animator with dirty rectangle redraw
+ * 
+ * 
+ * 16 boxes move around on yoyo tweens with different easings. Each
+ * frame only the dirty rectangles are redrawn. Reports the update()
+ * cost, redraw time and redrawn area per frame against a full screen
+ * redraw.
+ */
+void benchAnim(ST7789& display);
+
+/**
+ * Fixed-point math against float
+ * 
+ * 
+ * Time per call of each fixmath function and of the float function it
+ * replaces (sinf, atan2f, sqrtf, division), plus the largest error of
+ * the fixed-point result over the test inputs. Does not draw.
+ */
+void benchMath();
+
+/**
+ * JPEG decoder
+ * 
+ * 
+ * Decodes the built-in 240×320 4:2:0 test card (assets/testcard.jpg)
+ * full screen on one core and on both cores, and once at an offset
+ * where only a quarter of it is visible. Reports ms per image and the
+ * RAM the decoder uses.
+ */
+void benchJpeg(ST7789& display);
+
+/**
+ * Delta animation playback
+ * 
+ * 
+ * Plays the built-in 240×320 demo (assets/demo.dlt, made with
+ * tools/deltaenc.py --demo) as fast as possible and reports time and
+ * bytes sent per frame against the 33 ms budget of 30 fps, then in
+ * real time at the file's frame rate, counting late frames.
+ */
+void benchDelta(ST7789& display);
+
+/**
+ * Video pipeline throughput
+ * 
+ * 
+ * Plays the built-in 240×320 clip (assets/demo.vid, made with
+ * tools/videoenc.py --demo) twice as fast as possible and reports the
+ * sustained frame rate, where each core spent its time and which
+ * stage held the others up, then plays it in real time at the clip's
+ * frame rate, counting late frames.
+ */
+void benchVideo(ST7789& display);
+
+/**
+ * Gradient and pattern fills
+ * 
+ * 
+ * Full-screen fills of every gradient type and a few patterns, timed
+ * against the same window streamed from a line that needs no
+ * generating (the SPI limit) and against fillRect().
+ */
+void benchFill(ST7789& display);
+
+/**
+ * Batched primitives against one call per element
+ * 
+ * 
+ * A 1000-point random scatter plot (drawPixel() per point against
+ * drawPixels()), a 20-pixel grid of lines (fillRect() against
+ * fillRects()) and a filled circle as one span per row (fillRect()
+ * against drawSpans()). Reports both times and the windows sent.
+ */
+void benchBatch(ST7789& display);
+
+/**
+ * Rendering on one core against both
+ * 
+ * 
+ * Three workloads over the whole screen: sprites (little work per
+ * pixel), anti-aliased discs (a square root and a blend per pixel)
+ * and a plasma (per-pixel math, like an image decoder), plus an empty
+ * render function that leaves only the synchronization. Each runs in
+ * strip mode (bounded by the SPI) and in frame buffer mode, split in
+ * bands and in strips (rendering time only), on 1 and 2 cores.
+ */
+void benchRaster(ST7789& display);
+
+/**
+ * Draw command queue
+ * 
+ * 
+ * Push cost in CPU cycles (SysTick) from thread code and from a
+ * 10 kHz timer interrupt that posts a counter and an activity LED
+ * while the main loop drains and draws, the drain cost per command,
+ * and what an overflowing queue drops.
+ */
+void benchQueue(ST7789& display);
+
+/**
+ * Line pipeline with 2 to 8 buffers
+ * 
+ * 
+ * Sprites (light), plasma (about as slow as the SPI) and a bursty
+ * producer whose every 8th line takes four lines' SPI time, one line
+ * per buffer. Reports the time, the underruns (bus idle because the
+ * producer was late) and how long the producer waited for a buffer.
+ */
+void benchPipeline(ST7789& display);
+
+/**
+ * Text with and without the glyph cache
+ * 
+ * 
+ * A status screen of 12 labels in three color pairs, redrawn 20
+ * times at scale 1 and 2: characters per second uncached and with
+ * caches of 16 to 128 glyphs (12 KB at most), also right after an
+ * XIP cache flush (cold: the font and the code come from flash
+ * again), the CPU time per glyph without the SPI, and the hit rate.
+ */
+void benchGlyphCache(ST7789& display);
+
+/**
+ * Sparse Unicode font
+ * 
+ * 
+ * Glyph lookup time for ASCII, Latin-1 and missing code points in
+ * the demo font and in a synthetic font of 512 ranges (the binary
+ * search is a few steps longer), kerning lookup, UTF-8 decoding,
+ * textWidth() and drawing labels with non-ASCII characters.
+ */
+void benchFont(ST7789& display);
+
+/**
+ * Text layout with and without the cache
+ * 
+ * 
+ * A wrapped, centered paragraph and 6 right-aligned list items with
+ * non-ASCII names: shaping time against a cache hit and drawing, then
+ * whole frames shaped every time against frames from the cache.
+ */
+void benchLayout(ST7789& display);
+
+/**
+ * Asset pack lookups and drawing from flash
+ * 
+ * 
+ * Uses the pack in the asset partition, or the linked-in demo pack
+ * if none was loaded. Name lookup time for present and missing
+ * names, by a precomputed hash, right after an XIP cache flush, and
+ * in a synthetic pack of 512 assets against a linear scan of the
+ * names; then a 240x64 picture sent by DMA straight from flash
+ * against copying it to RAM first.
+ */
+void benchAssets(ST7789& display);
+
+/**
+ * Render loop jitter after large blits, through the XIP cache and
+ * through the streaming FIFO
+ * 
+ * 
+ * The CPU part of a UI frame (shaping a paragraph, measuring labels)
+ * timed on its own, then right after each of 20 blits of the 30 KB
+ * banner, sent from flash through the XIP cache and streamed: the
+ * average and worst frame, the extra time against no blit and the
+ * XIP cache hit rate during the frame. Also the blit times.
+ */
+void benchXipStream(ST7789& display);
+
+/**
+ * Per-frame arenas against malloc()
+ * 
+ * 
+ * 48 temporaries of 16 - 256 bytes a frame from malloc()/free() and
+ * from an arena; the dialog screen's text drawn in stack batches,
+ * with its spans in an arena and with an arena too small for them
+ * (failures fall back to the batches); then sprites rendered in
+ * strips on both cores, each strip first culling the sprites into a
+ * list taken from the core's arena, from malloc() or not at all.
+ * Also the high-water marks of the two arenas.
+ */
+void benchArena(ST7789& display);
+
+/**
+ * Layered compositor against redrawing the screen on every change
+ * 
+ * 
+ * Anti-aliased discs under a list panel, with a toast and a cursor
+ * on top: for 30 frames the cursor moves, a list row changes every
+ * 5th frame and the toast comes or goes every 10th. Composed in full
+ * every frame, composed only where the layers report damage, and the
+ * same with the panel and the toast marked opaque. Frame time, and
+ * pixels sent, rendered and skipped under opaque layers.
+ */
+void benchCompositor(ST7789& display);
+
+#endif // BENCH_H
@@ -0,0 +1,29 @@
+/**
+ * bytes.h
+ * Little-endian reads from byte buffers
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * The file formats read in place from flash (fonts, asset packs,
+ * splashes, delta animations, video clips) are little endian and not
+ * always aligned, and the M0+ faults on unaligned halfword and word
+ * loads, so their fields are read a byte at a time.
+ * 
+ */
+
+#ifndef BYTES_H
+#define BYTES_H
+
+#include <stdint.h>
+
+static inline uint16_t read16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t read32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+#endif // BYTES_H
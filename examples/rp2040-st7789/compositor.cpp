@@ -0,0 +1,139 @@
+/**
+ * compositor.cpp
+ * Implementation of the layer compositor
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "compositor.h"
+#include "arena.h"
+
+Compositor::Compositor(ST7789& display, uint16_t* memory, uint32_t pixels)
+    : _display(display), _bufferPixels(pixels / 2), _layerCount(0), _stats() {
+    _buffers[0] = memory;
+    _buffers[1] = memory + _bufferPixels;
+}
+
+void Compositor::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+int8_t Compositor::addLayer(RasterFn render, void* context) {
+    if (_layerCount >= COMPOSITOR_MAX_LAYERS || !render) return -1;
+    Layer& l = _layers[_layerCount];
+    l.render = render;
+    l.context = context;
+    l.opaqueCount = 0;
+    l.damage.clear();
+    return (int8_t)_layerCount++;
+}
+
+void Compositor::setOpaque(uint8_t layer, const Rect* rects, uint8_t count) {
+    if (layer >= _layerCount) return;
+    Layer& l = _layers[layer];
+    l.opaqueCount = 0;
+    for (uint8_t i = 0; rects && i < count && l.opaqueCount < COMPOSITOR_MAX_OPAQUE; i++) {
+        if (!rectEmpty(rects[i])) l.opaque[l.opaqueCount++] = rects[i];
+    }
+}
+
+void Compositor::invalidate(uint8_t layer, const Rect& r) {
+    if (layer < _layerCount) _layers[layer].damage.add(r);
+}
+
+void Compositor::invalidateAll() {
+    if (_layerCount) _layers[0].damage.addScreen();
+}
+
+bool Compositor::isDirty() const {
+    for (uint8_t k = 0; k < _layerCount; k++) {
+        if (_layers[k].damage.count()) return true;
+    }
+    return false;
+}
+
+// ========== COMPOSITION ==========
+
+/**
+ * An opaque area of a layer above this one covers r
+ */
+bool Compositor::coveredAbove(uint8_t layer, const Rect& r) const {
+    for (uint8_t k = layer + 1; k < _layerCount; k++) {
+        const Layer& l = _layers[k];
+        for (uint8_t i = 0; i < l.opaqueCount; i++) {
+            if (rectContains(l.opaque[i], r)) return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Highest layer that is opaque over all of r: the layers below it
+ * are not seen there (0 if none is)
+ */
+uint8_t Compositor::firstLayer(const Rect& r) const {
+    for (uint8_t k = _layerCount - 1; k > 0; k--) {
+        const Layer& l = _layers[k];
+        for (uint8_t i = 0; i < l.opaqueCount; i++) {
+            if (rectContains(l.opaque[i], r)) return k;
+        }
+    }
+    return 0;
+}
+
+void Compositor::composeArea(const Rect& area) {
+    int32_t lines = _bufferPixels / area.w;
+    FrameArena* arena = FrameArena::current();
+    
+    _display.beginPixels(area.x, area.y, area.w, area.h);
+    uint8_t k = 0;
+    for (int16_t y = area.y; y < area.y + area.h; y += lines, k ^= 1) {
+        Rect strip = { area.x, y, area.w, area.h };
+        strip.h = area.y + area.h - y < lines ? area.y + area.h - y : lines;
+        uint32_t pixels = (uint32_t)strip.w * strip.h;
+        
+        // Bottom up from the first layer seen, each over the one before
+        uint8_t first = firstLayer(strip);
+        for (uint8_t layer = first; layer < _layerCount; layer++) {
+            uint32_t mark = arena ? arena->mark() : 0;
+            _layers[layer].render(_layers[layer].context, _buffers[k], strip);
+            if (arena) arena->rewind(mark);
+        }
+        _stats.layerPixels += pixels * (_layerCount - first);
+        _stats.skippedPixels += pixels * first;
+        
+        // Returns once the strip before (in the other buffer) was taken
+        _display.writePixelsAsync(_buffers[k], pixels);
+    }
+    _stats.areas++;
+    _stats.pixels += (uint32_t)area.w * area.h;
+}
+
+bool Compositor::flush() {
+    if (_layerCount == 0 || _bufferPixels < SCREEN_WIDTH) return false;
+    uint32_t t0 = time_us_32();
+    
+    // One list for all layers, without what is hidden under opaque layers
+    _areas.clear();
+    for (uint8_t k = 0; k < _layerCount; k++) {
+        DirtyRects& damage = _layers[k].damage;
+        for (uint8_t i = 0; i < damage.count(); i++) {
+            if (coveredAbove(k, damage[i])) {
+                _stats.hiddenAreas++;
+            } else {
+                _areas.add(damage[i]);
+            }
+        }
+        damage.clear();
+    }
+    if (_areas.count() == 0) return false;
+    
+    for (uint8_t i = 0; i < _areas.count(); i++) {
+        composeArea(_areas[i]);
+    }
+    _stats.flushes++;
+    _stats.us += time_us_32() - t0;
+    return true;
+}
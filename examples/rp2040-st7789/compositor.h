@@ -0,0 +1,164 @@
+/**
+ * compositor.h
+ * Layers with their own damage, composed only where something changed
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * A UI is usually a few layers that change at different rates: static
+ * art at the bottom, content (lists, graphs) in the middle, and an
+ * overlay (toasts, a cursor) on top. Redrawing everything when the
+ * cursor moves sends the whole screen again and renders every layer
+ * under it. Compositor keeps a DirtyRects list per layer; what changes
+ * reports its area on its own layer (invalidate()), and flush()
+ * composes only those areas.
+ * 
+ * A layer is a render function (the same as Rasterizer takes) that
+ * draws its part of an area over the pixels below it, or leaves them.
+ * The bottom layer must set every pixel. Areas are composed in strips
+ * in two line buffers and sent through one display window per area,
+ * the next strip being composed while the DMA sends the last.
+ * 
+ * Each layer can name the areas where it covers everything below
+ * (setOpaque(): the background, a toast's box). Composition goes from
+ * the top down: a strip starts with the highest layer that is opaque
+ * over all of it, and the layers under that one are not rendered.
+ * Damage on a layer that is hidden under an opaque area of a layer
+ * above is dropped before anything is drawn.
+ * 
+ * The opaque areas are only read by flush(). A layer whose opaque
+ * areas move (a toast sliding in) must also invalidate where they
+ * were and where they are.
+ * 
+ * example:
+ * 
+ * static uint16_t lines[2 * 8 * SCREEN_WIDTH];           // 2 buffers of 8 lines
+ * static Compositor ui(display, lines, sizeof(lines) / 2);
+ * uint8_t back = ui.addLayer(drawWallpaper, &wallpaper);
+ * uint8_t list = ui.addLayer(drawList, &menu);
+ * uint8_t over = ui.addLayer(drawOverlay, &overlay);
+ * ui.setOpaque(back, &screen, 1);
+ * ui.invalidateAll();
+ * while (true) {
+ *     ui.invalidate(over, cursorBefore);                  // Cursor moved
+ *     ui.invalidate(over, cursorNow);
+ *     ui.flush();                                         // Two small areas sent
+ * }
+ * 
+ */
+
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <stdint.h>
+#include "st7789.h"
+#include "raster.h"
+#include "dirtyrect.h"
+
+#define COMPOSITOR_MAX_LAYERS 4
+#define COMPOSITOR_MAX_OPAQUE 4   // < Opaque areas per layer
+
+/**
+ * Counters since construction or the last resetStats()
+ */
+struct CompositorStats {
+    uint32_t flushes;         // < flush() calls that drew something
+    uint32_t areas;           // < Damaged areas composed
+    uint32_t pixels;          // < Pixels sent
+    uint32_t layerPixels;     // < Pixels rendered, summed over the layers
+    uint32_t skippedPixels;   // < Layer pixels not rendered, under an opaque layer
+    uint32_t hiddenAreas;     // < Damage dropped, hidden under an opaque layer
+    uint32_t us;              // < Time in flush()
+};
+
+/**
+ * Layer compositor over the display
+ */
+class Compositor {
+public:
+    /**
+     * memory Line buffer memory, split into two buffers; each must hold
+     *        at least one line of the widest area (SCREEN_WIDTH pixels)
+     * pixels Size of memory in pixels
+     */
+    Compositor(ST7789& display, uint16_t* memory, uint32_t pixels);
+    
+    /**
+     * Add a layer on top of the others
+     * 
+     * render Draws the layer's part of an area over the pixels below
+     * context Passed to render
+     * 
+     * returns the layer's index (0 at the bottom), or -1 if there are
+     * COMPOSITOR_MAX_LAYERS already
+     */
+    int8_t addLayer(RasterFn render, void* context);
+    
+    /**
+     * Set the areas where a layer covers everything below it
+     * 
+     * rects Areas in screen coordinates (copied; nullptr for none)
+     * count Number of areas, at most COMPOSITOR_MAX_OPAQUE are kept
+     */
+    void setOpaque(uint8_t layer, const Rect* rects, uint8_t count);
+    
+    /**
+     * Mark an area of a layer as changed
+     */
+    void invalidate(uint8_t layer, const Rect& r);
+    
+    /**
+     * Mark the whole screen as changed (on the bottom layer)
+     */
+    void invalidateAll();
+    
+    /**
+     * Anything to flush
+     */
+    bool isDirty() const;
+    
+    /**
+     * Compose the changed areas and send them
+     * 
+     * returns false if nothing had changed
+     * 
+     * 
+     * Returns when the last strip has been handed to the display's DMA;
+     * the render functions have all returned by then. The damage of
+     * every layer is cleared.
+     */
+    bool flush();
+    
+    /**
+     * Damage of a layer, since the last flush()
+     */
+    const DirtyRects& damage(uint8_t layer) const { return _layers[layer].damage; }
+    
+    uint8_t layerCount() const { return _layerCount; }
+    
+    const CompositorStats& stats() const { return _stats; }
+    void resetStats();
+
+private:
+    struct Layer {
+        RasterFn render;
+        void* context;
+        Rect opaque[COMPOSITOR_MAX_OPAQUE];
+        uint8_t opaqueCount;
+        DirtyRects damage;
+    };
+    
+    ST7789& _display;
+    uint16_t* _buffers[2];
+    uint32_t _bufferPixels;   // < Pixels per buffer
+    Layer _layers[COMPOSITOR_MAX_LAYERS];
+    uint8_t _layerCount;
+    DirtyRects _areas;        // < Damage of all layers, during flush()
+    CompositorStats _stats;
+    
+    bool coveredAbove(uint8_t layer, const Rect& r) const;
+    uint8_t firstLayer(const Rect& r) const;
+    void composeArea(const Rect& area);
+};
+
+#endif // COMPOSITOR_H
@@ -0,0 +1,213 @@
+/**
+ * delta.cpp
+ * Implementation of the frame-delta animation player
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "delta.h"
+#include "bytes.h"
+
+DeltaPlayer::DeltaPlayer(ST7789& display)
+    : _display(display), _data(nullptr), _end(nullptr), _next(nullptr), _firstDelta(nullptr),
+      _loopFrame(nullptr), _width(0), _height(0), _frameCount(0), _frameMs(0), _paletteSize(0),
+      _x(0), _y(0), _frame(0), _loop(true), _finished(false), _started(false), _startMs(0),
+      _due(0), _late(0), _bufferIndex(0), _stats(), _pos(nullptr), _runLeft(0),
+      _runRepeat(false), _runColor(0) {
+}
+
+// ========== HEADER ==========
+
+bool DeltaPlayer::open(const uint8_t* data, size_t size) {
+    _data = nullptr;
+    if (size < DELTA_HEADER_SIZE || memcmp(data, "DLT1", 4) != 0) return false;
+    
+    uint16_t width = read16(data + 4);
+    uint16_t height = read16(data + 6);
+    uint16_t frames = read16(data + 8);
+    uint16_t palette = read16(data + 12);
+    uint32_t loop = read32(data + 16);
+    if (width == 0 || height == 0 || width > SCREEN_WIDTH || height > SCREEN_HEIGHT) return false;
+    if (frames == 0 || palette > 256) return false;
+    if (DELTA_HEADER_SIZE + 2u * palette > size || loop >= size) return false;
+    
+    _data = data;
+    _end = data + size;
+    _width = width;
+    _height = height;
+    _frameCount = frames;
+    _frameMs = read16(data + 10);
+    _paletteSize = palette;
+    _loopFrame = loop ? data + loop : nullptr;
+    
+    memset(_palette, 0, sizeof(_palette));
+    for (uint16_t i = 0; i < palette; i++) {
+        _palette[i] = read16(data + DELTA_HEADER_SIZE + 2 * i);
+    }
+    
+    if (_x + _width > SCREEN_WIDTH || _y + _height > SCREEN_HEIGHT) {
+        _x = _y = 0;
+    }
+    rewind();
+    return true;
+}
+
+bool DeltaPlayer::setPosition(uint16_t x, uint16_t y) {
+    if (x + _width > SCREEN_WIDTH || y + _height > SCREEN_HEIGHT) return false;
+    _x = x;
+    _y = y;
+    return true;
+}
+
+void DeltaPlayer::rewind() {
+    _next = nullptr;
+    _firstDelta = nullptr;
+    _frame = 0;
+    _finished = false;
+    _started = false;
+    _late = 0;
+}
+
+// ========== PLAYBACK ==========
+
+/**
+ * Frame order with the loop frame L: 0 1 2 ... n-1 L 1 2 ... n-1 L ...
+ * 
+ * L turns frame n-1 back into frame 0, so after it playback goes on
+ * with frame 1. Without a loop frame, frame 0 (full) is drawn again.
+ */
+bool DeltaPlayer::drawFrame() {
+    if (!_data || _finished) return false;
+    
+    const uint8_t* frames = _data + DELTA_HEADER_SIZE + 2 * _paletteSize;
+    const uint8_t* src = _next ? _next : frames;
+    uint16_t index = _next ? _frame + 1 : 0;
+    if (index == _frameCount) {
+        index = 0;
+        src = _loopFrame ? _loopFrame : frames;
+    }
+    
+    _pos = src;
+    if (!decodeFrame()) return false;
+    
+    if (src == frames) _firstDelta = _pos;
+    _next = (src == _loopFrame) ? _firstDelta : _pos;
+    _frame = index;
+    if (!_loop && index == _frameCount - 1) _finished = true;
+    return true;
+}
+
+bool DeltaPlayer::update(uint32_t nowMs) {
+    if (!_data || _finished) return false;
+    if (!_started) {
+        _started = true;
+        _startMs = nowMs;
+        _due = 0;
+    }
+    
+    uint32_t dueMs = _startMs + _due * _frameMs;
+    if ((int32_t)(nowMs - dueMs) < 0) return false;
+    if (nowMs - dueMs >= _frameMs && _due > 0) _late++;
+    _due++;
+    return drawFrame();
+}
+
+// ========== DECODING ==========
+
+bool DeltaPlayer::decodeFrame() {
+    uint32_t t0 = time_us_32();
+    const uint8_t* start = _pos;
+    memset(&_stats, 0, sizeof(_stats));
+    
+    if (_end - _pos < 2) return false;
+    uint16_t count = read16(_pos);
+    _pos += 2;
+    
+    for (uint16_t i = 0; i < count; i++) {
+        if (_end - _pos < 8) return false;
+        uint16_t x = read16(_pos);
+        uint16_t y = read16(_pos + 2);
+        uint16_t w = read16(_pos + 4);
+        uint16_t h = read16(_pos + 6);
+        _pos += 8;
+        if (w == 0 || h == 0 || x + w > _width || y + h > _height) return false;
+        if (!drawRect(_x + x, _y + y, w, h)) return false;
+    }
+    _display.waitIdle();
+    
+    _stats.dataBytes = _pos - start;
+    _stats.us = time_us_32() - t0;
+    return true;
+}
+
+/**
+ * Send one rectangle in bands of whole rows
+ * 
+ * 
+ * Each band is unpacked into one half of the double buffer and sent
+ * by DMA while the next band goes into the other half. Starting a
+ * transfer waits for the one before, so the half being filled is
+ * never the one on the SPI.
+ */
+bool DeltaPlayer::drawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    uint16_t rows = DELTA_BUFFER_PIXELS / w;
+    _runLeft = 0;
+    
+    for (uint16_t row = 0; row < h; row += rows) {
+        uint16_t n = (h - row < rows) ? h - row : rows;
+        uint16_t* buffer = _buffer[_bufferIndex];
+        if (!unpack(buffer, (uint32_t)n * w)) return false;
+        
+        _display.drawBufferAsync(x, y + row, w, n, buffer);
+        _bufferIndex ^= 1;
+        _stats.spiBytes += DELTA_WINDOW_BYTES + 2u * n * w;
+    }
+    _stats.rects++;
+    _stats.pixels += (uint32_t)w * h;
+    return _runLeft == 0;  // A run must not reach into the next rect
+}
+
+uint16_t DeltaPlayer::readPixel() {
+    if (_paletteSize) return _palette[*_pos++];
+    uint16_t v = read16(_pos);
+    _pos += 2;
+    return v;
+}
+
+/**
+ * Expand runs into count pixels, continuing a run left over from the
+ * previous band
+ */
+bool DeltaPlayer::unpack(uint16_t* out, uint32_t count) {
+    uint8_t pixelBytes = _paletteSize ? 1 : 2;
+    
+    while (count) {
+        if (_runLeft == 0) {
+            if (_end - _pos < 1 + pixelBytes) return false;
+            uint8_t op = *_pos++;
+            _runRepeat = op & 0x80;
+            _runLeft = _runRepeat ? op - 127 : op + 1;
+            if (_runRepeat) _runColor = readPixel();
+        }
+        
+        uint32_t n = _runLeft < count ? _runLeft : count;
+        _runLeft -= n;
+        count -= n;
+        
+        if (_runRepeat) {
+            uint16_t color = _runColor;
+            while (n--) *out++ = color;
+        } else if (_paletteSize) {
+            if ((uint32_t)(_end - _pos) < n) return false;
+            const uint8_t* p = _pos;
+            _pos += n;
+            while (n--) *out++ = _palette[*p++];
+        } else {
+            if ((uint32_t)(_end - _pos) < 2 * n) return false;
+            while (n--) *out++ = readPixel();
+        }
+    }
+    return true;
+}
@@ -0,0 +1,189 @@
+/**
+ * delta.h
+ * Frame-delta animation player
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Plays animations made with tools/deltaenc.py from flash. Raw
+ * frames would be 150 KB each at full screen; in this format the
+ * first frame is stored whole and every other frame only as the
+ * rectangles that changed since the previous one. Each rectangle
+ * becomes one display window, so the panel keeps the unchanged
+ * pixels and the SPI only carries the changes.
+ * 
+ * Rectangle pixels are run-length coded (runs may cross rows) and
+ * use 8-bit palette indices when the animation has at most 256
+ * colors. They are unpacked a few rows at a time into a double
+ * buffer and sent by DMA while the next rows are unpacked.
+ * 
+ * File format (little endian, no alignment):
+ * 
+ *   header   "DLT1", width, height, frame count, frame time in ms,
+ *            palette size (0 = RGB565 pixels), 0, loop frame offset
+ *            (uint32, 0 if none)
+ *   palette  palette size × RGB565
+ *   frames   rect count, then per rect: x, y, w, h, pixel runs
+ * 
+ *   run      0x00-0x7F: n + 1 literal pixels follow
+ *            0x80-0xFF: one pixel follows, repeated n - 127 times
+ * 
+ * The loop frame goes from the last frame back to the first, so a
+ * looping animation never needs a full redraw after the first pass.
+ * 
+ * example:
+ * 
+ * DeltaPlayer player(display);
+ * if (player.open(idle_dlt, sizeof(idle_dlt))) {
+ *     player.setPosition(40, 60);
+ *     while (true) {
+ *         player.update(to_ms_since_boot(get_absolute_time()));
+ *     }
+ * }
+ * 
+ */
+
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+
+#define DELTA_HEADER_SIZE   20
+#define DELTA_BUFFER_PIXELS (SCREEN_WIDTH * 4)  // < Per half of the double buffer
+#define DELTA_WINDOW_BYTES  11                   // < CASET + RASET + RAMWR with parameters
+
+/**
+ * Numbers for the last frame drawn
+ */
+struct DeltaStats {
+    uint16_t rects;        // < Rectangles drawn
+    uint32_t pixels;       // < Pixels sent
+    uint32_t spiBytes;     // < Pixel and window command bytes on the SPI
+    uint32_t dataBytes;    // < Bytes read from the file
+    uint32_t us;           // < Decode + send time
+};
+
+/**
+ * Delta animation player
+ */
+class DeltaPlayer {
+public:
+    DeltaPlayer(ST7789& display);
+    
+    /**
+     * Check the header and rewind to the first frame
+     * 
+     * data Animation file in memory; must stay valid while playing
+     * size Size in bytes
+     * 
+     * returns false if the header is damaged or the animation is larger
+     * than the screen
+     */
+    bool open(const uint8_t* data, size_t size);
+    
+    uint16_t width() const { return _width; }
+    uint16_t height() const { return _height; }
+    uint16_t frameCount() const { return _frameCount; }
+    uint16_t frameMs() const { return _frameMs; }
+    
+    /**
+     * Screen position of the top-left corner
+     * 
+     * returns false (position unchanged) if the animation would not
+     * fit on screen at (x, y)
+     * 
+     * Only takes effect with the next full frame, so call it before
+     * playback or right after rewind().
+     */
+    bool setPosition(uint16_t x, uint16_t y);
+    
+    /**
+     * Play once (false) or forever (true, default)
+     */
+    void setLoop(bool loop) { _loop = loop; }
+    
+    /**
+     * Start again from the first (full) frame
+     */
+    void rewind();
+    
+    /**
+     * Draw the next frame now, regardless of timing
+     * 
+     * returns false at the end (not looping) or if the data is damaged
+     */
+    bool drawFrame();
+    
+    /**
+     * Draw the next frame if it is due
+     * 
+     * nowMs Current time in milliseconds
+     * 
+     * returns true if a frame was drawn
+     * 
+     * Frames are timed from the first frame drawn, not from the
+     * previous one, so a slow frame does not delay the rest. If the
+     * player fell more than a frame behind it catches up by drawing
+     * without waiting (counted in lateFrames()).
+     */
+    bool update(uint32_t nowMs);
+    
+    /**
+     * Index of the frame on screen (0 - frameCount() - 1)
+     */
+    uint16_t frame() const { return _frame; }
+    
+    /**
+     * True after the last frame when not looping
+     */
+    bool finished() const { return _finished; }
+    
+    const DeltaStats& lastStats() const { return _stats; }
+    
+    /**
+     * Frames drawn later than their due time since open() / rewind()
+     */
+    uint32_t lateFrames() const { return _late; }
+
+private:
+    ST7789& _display;
+    const uint8_t* _data;
+    const uint8_t* _end;
+    const uint8_t* _next;          // < Next frame to decode
+    const uint8_t* _firstDelta;    // < Frame 1 (after the loop frame)
+    const uint8_t* _loopFrame;
+    
+    uint16_t _width, _height;
+    uint16_t _frameCount;
+    uint16_t _frameMs;
+    uint16_t _paletteSize;
+    uint16_t _x, _y;
+    uint16_t _frame;
+    bool _loop;
+    bool _finished;
+    bool _started;
+    uint32_t _startMs;
+    uint32_t _due;                 // < Frames drawn since _startMs
+    uint32_t _late;
+    
+    uint16_t _palette[256];        // < Copied to RAM: faster than flash
+    uint16_t _buffer[2][DELTA_BUFFER_PIXELS];
+    uint8_t _bufferIndex;
+    
+    DeltaStats _stats;
+    
+    // ========== RUN DECODER ==========
+    const uint8_t* _pos;
+    uint8_t _runLeft;              // < Pixels left in the current run
+    bool _runRepeat;
+    uint16_t _runColor;
+    
+    bool decodeFrame();
+    bool drawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    bool unpack(uint16_t* out, uint32_t count);
+    uint16_t readPixel();
+};
+
+#endif // DELTA_H
@@ -0,0 +1,79 @@
+/**
+ * dirtyrect.cpp
+ * Implementation of the dirty rectangle list
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "dirtyrect.h"
+#include "st7789.h"
+
+DirtyRects::DirtyRects() : _count(0) {
+}
+
+void DirtyRects::remove(uint8_t index) {
+    _rects[index] = _rects[--_count];
+}
+
+/**
+ * Add an area
+ * 
+ * 
+ * Merging can make the new box overlap further entries, so after a
+ * merge the merged box is added again until nothing changes.
+ */
+void DirtyRects::add(const Rect& area) {
+    static const Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    Rect r = rectIntersect(area, screen);
+    if (rectEmpty(r)) return;
+    
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (uint8_t i = 0; i < _count; i++) {
+            if (rectContains(_rects[i], r)) return;
+            
+            Rect box = rectUnion(_rects[i], r);
+            if (rectContains(r, _rects[i]) ||
+                rectArea(box) <= rectArea(_rects[i]) + rectArea(r)) {
+                r = box;
+                remove(i);
+                merged = true;
+                break;
+            }
+        }
+    }
+    
+    if (_count < DIRTY_MAX_RECTS) {
+        _rects[_count++] = r;
+        return;
+    }
+    
+    // ========== FULL ==========
+    uint8_t best = 0;
+    int32_t bestGrowth = INT32_MAX;
+    for (uint8_t i = 0; i < _count; i++) {
+        int32_t growth = rectArea(rectUnion(_rects[i], r)) - rectArea(_rects[i]);
+        if (growth < bestGrowth) {
+            bestGrowth = growth;
+            best = i;
+        }
+    }
+    Rect box = rectUnion(_rects[best], r);
+    remove(best);
+    add(box);
+}
+
+void DirtyRects::addScreen() {
+    Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    _count = 0;
+    add(screen);
+}
+
+int32_t DirtyRects::area() const {
+    int32_t total = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        total += rectArea(_rects[i]);
+    }
+    return total;
+}
@@ -0,0 +1,87 @@
+/**
+ * dirtyrect.h
+ * List of screen areas that need to be redrawn
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Without a frame buffer (240×320×2 = 150 KB, more than half the RAM)
+ * the screen cannot be redrawn from memory every frame. Instead,
+ * whatever changes reports the area it touched, and the application
+ * redraws only those areas.
+ * 
+ * Areas are clipped to the screen and merged while they are added:
+ * - an area inside an existing one is dropped
+ * - two areas are combined into their bounding box when that box is
+ *   not larger than both areas drawn separately (e.g. the old and new
+ *   position of an element that moved a few pixels)
+ * - when the list is full, the new area is combined with the entry
+ *   whose bounding box grows the least
+ * 
+ * example:
+ * 
+ * DirtyRects dirty;
+ * dirty.add(oldBounds);
+ * dirty.add(newBounds);
+ * for (uint8_t i = 0; i < dirty.count(); i++) {
+ *     redrawArea(dirty[i]);
+ * }
+ * dirty.clear();
+ * 
+ */
+
+#ifndef DIRTYRECT_H
+#define DIRTYRECT_H
+
+#include <stdint.h>
+#include "rect.h"
+
+#define DIRTY_MAX_RECTS 16  // < Entries before areas are force-merged
+
+/**
+ * Dirty rectangle list
+ */
+class DirtyRects {
+public:
+    DirtyRects();
+    
+    /**
+     * Mark an area as needing a redraw
+     * 
+     * r Area in screen coordinates (clipped to the screen here)
+     */
+    void add(const Rect& r);
+    
+    /**
+     * Mark the whole screen (replaces every entry)
+     */
+    void addScreen();
+    
+    /**
+     * Forget every entry (after the areas were redrawn)
+     */
+    void clear() { _count = 0; }
+    
+    /**
+     * Number of areas
+     */
+    uint8_t count() const { return _count; }
+    
+    /**
+     * Area by index (0 - count() - 1)
+     */
+    const Rect& operator[](uint8_t index) const { return _rects[index]; }
+    
+    /**
+     * Total pixels in all areas
+     */
+    int32_t area() const;
+
+private:
+    Rect _rects[DIRTY_MAX_RECTS];
+    uint8_t _count;
+    
+    void remove(uint8_t index);
+};
+
+#endif // DIRTYRECT_H
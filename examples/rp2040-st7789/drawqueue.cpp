@@ -0,0 +1,170 @@
+/**
+ * drawqueue.cpp
+ * Implementation of the draw command queue
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "drawqueue.h"
+#include "font5x7.h"
+
+#define DRAWQ_MASK   (DRAWQ_SIZE - 1)
+#define DRAWQ_DONE   0xFF   // < op of a command drain() skips
+
+DrawQueue::DrawQueue()
+    : _slots(), _lock(nullptr), _head(0), _tail(0), _dropped(0), _highWater(0), _skipped(0) {
+}
+
+void DrawQueue::init() {
+    if (!_lock) _lock = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+// ========== PRODUCERS ==========
+
+/**
+ * Queue a command
+ * 
+ * 
+ * Only the ticket is taken under the lock. Between claiming the slot
+ * and publishing it the producer may be interrupted, even by another
+ * push; the consumer then stops at this slot until it is published.
+ */
+bool DrawQueue::push(const DrawCommand& cmd) {
+    uint32_t save = spin_lock_blocking(_lock);
+    uint32_t ticket = _head;
+    uint32_t used = ticket - _tail;
+    if (used >= DRAWQ_SIZE) {
+        _dropped = _dropped + 1;
+        spin_unlock(_lock, save);
+        return false;
+    }
+    _head = ticket + 1;
+    if (used + 1 > _highWater) _highWater = used + 1;
+    spin_unlock(_lock, save);
+    
+    Slot& slot = _slots[ticket & DRAWQ_MASK];
+    slot.cmd = cmd;
+    __dmb();  // Command visible before the sequence number
+    slot.seq = ticket + 1;
+    return true;
+}
+
+bool DrawQueue::pushFill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    DrawCommand cmd = { DRAW_FILL, 0, color, 0, x, y, w, h, 0 };
+    return push(cmd);
+}
+
+bool DrawQueue::pushPixel(int16_t x, int16_t y, uint16_t color) {
+    DrawCommand cmd = { DRAW_PIXEL, 0, color, 0, x, y, 1, 1, 0 };
+    return push(cmd);
+}
+
+bool DrawQueue::pushNumber(int16_t x, int16_t y, uint32_t value, uint8_t digits, uint16_t color,
+                           uint16_t background) {
+    if (digits == 0) digits = 1;
+    if (digits > DRAWQ_MAX_DIGITS) digits = DRAWQ_MAX_DIGITS;
+    DrawCommand cmd = { DRAW_NUMBER, digits, color, background, x, y,
+                        (uint16_t)(digits * 6), 8, value };
+    return push(cmd);
+}
+
+// ========== CONSUMER ==========
+
+/**
+ * Screen area a command paints completely (every command is opaque)
+ */
+static Rect commandRect(const DrawCommand& cmd) {
+    Rect r = { cmd.x, cmd.y, (int16_t)(cmd.w > INT16_MAX ? INT16_MAX : cmd.w),
+               (int16_t)(cmd.h > INT16_MAX ? INT16_MAX : cmd.h) };
+    return r;
+}
+
+uint32_t DrawQueue::drain(ST7789& display) {
+    // Copy the published commands out and free their slots at once
+    uint32_t n = 0;
+    uint32_t tail = _tail;
+    while (n < DRAWQ_SIZE) {
+        const Slot& slot = _slots[tail & DRAWQ_MASK];
+        if (slot.seq != tail + 1) break;
+        __dmb();  // Command read after the sequence number
+        _batch[n++] = slot.cmd;
+        __dmb();  // ... and before the slot is handed back
+        tail++;
+        _tail = tail;
+    }
+    
+    // A command painted over by a later one is not worth sending
+    for (uint32_t i = 0; i < n; i++) {
+        Rect r = commandRect(_batch[i]);
+        for (uint32_t j = i + 1; j < n; j++) {
+            if (_batch[j].op != DRAWQ_DONE && rectContains(commandRect(_batch[j]), r)) {
+                _batch[i].op = DRAWQ_DONE;
+                _skipped++;
+                break;
+            }
+        }
+    }
+    
+    // Runs of the same kind go out as one batch
+    uint32_t i = 0;
+    while (i < n) {
+        const DrawCommand& cmd = _batch[i];
+        uint32_t count = 0;
+        switch (cmd.op) {
+        case DRAW_PIXEL:
+            while (i < n && (_batch[i].op == DRAW_PIXEL || _batch[i].op == DRAWQ_DONE)) {
+                if (_batch[i].op == DRAW_PIXEL) {
+                    _points[count++] = { _batch[i].x, _batch[i].y, _batch[i].color };
+                }
+                i++;
+            }
+            display.drawPixels(_points, count);
+            break;
+        case DRAW_FILL: {
+            uint16_t color = cmd.color;
+            while (i < n && ((_batch[i].op == DRAW_FILL && _batch[i].color == color) ||
+                             _batch[i].op == DRAWQ_DONE)) {
+                if (_batch[i].op == DRAW_FILL) _rects[count++] = commandRect(_batch[i]);
+                i++;
+            }
+            display.fillRects(_rects, count, color);
+            break;
+        }
+        case DRAW_NUMBER:
+            drawNumber(display, cmd);
+            i++;
+            break;
+        default:
+            i++;
+            break;
+        }
+    }
+    return n;
+}
+
+/**
+ * Number in 6×8 cells, right-aligned, lowest digits if it does not fit
+ */
+void DrawQueue::drawNumber(ST7789& display, const DrawCommand& cmd) {
+    uint8_t digits = cmd.digits;
+    if (digits == 0 || digits > DRAWQ_MAX_DIGITS) return;
+    char text[DRAWQ_MAX_DIGITS];
+    uint32_t v = cmd.value;
+    for (int8_t i = digits - 1; i >= 0; i--) {
+        text[i] = (v != 0 || i == digits - 1) ? (char)('0' + v % 10) : ' ';
+        v /= 10;
+    }
+    
+    uint16_t w = digits * 6;
+    for (uint8_t row = 0; row < 8; row++) {
+        uint16_t* line = _text + row * w;
+        for (uint8_t c = 0; c < digits; c++) {
+            const uint8_t* glyph = FONT5X7[text[c] - FONT5X7_FIRST];
+            for (uint8_t col = 0; col < 6; col++) {
+                bool on = col < FONT5X7_WIDTH && row < FONT5X7_HEIGHT && (glyph[col] >> row) & 1;
+                line[c * 6 + col] = on ? cmd.color : cmd.background;
+            }
+        }
+    }
+    display.drawBuffer(cmd.x, cmd.y, w, 8, _text);
+}
@@ -0,0 +1,164 @@
+/**
+ * drawqueue.h
+ * Draw command queue for interrupt handlers and both cores
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Interrupt handlers must not call the display driver: it blocks on
+ * the SPI, and the main loop may be in the middle of a transfer. They
+ * post small fixed-size commands here instead (fill a rectangle, set
+ * a pixel, show a number), and the render loop - on either core -
+ * drains the queue now and then into batched bus operations.
+ * 
+ * Any number of producers (thread code on both cores and interrupt
+ * handlers on both) and one consumer. The M0+ has no exclusive
+ * load/store, so a producer claims its slot with the SIO hardware
+ * spinlock held and interrupts off for just the index update (a
+ * handful of instructions); the command is copied and published
+ * outside of it, with a per-slot sequence number. The consumer takes
+ * no lock at all. A full queue drops the command and counts it; it
+ * never blocks.
+ * 
+ * example:
+ * 
+ * static DrawQueue queue;
+ * queue.init();
+ * 
+ * void onCapture() {                                  // Interrupt handler
+ *     queue.pushNumber(180, 4, ++captures, 6, COLOR_WHITE, COLOR_BLACK);
+ *     queue.pushFill(230, 4, 6, 6, COLOR_GREEN);     // Activity LED
+ * }
+ * 
+ * while (true) {                                      // Render loop
+ *     queue.drain(display);
+ *     ...
+ * }
+ * 
+ */
+
+#ifndef DRAWQUEUE_H
+#define DRAWQUEUE_H
+
+#include <stdint.h>
+#include "hardware/sync.h"
+#include "st7789.h"
+
+#define DRAWQ_SIZE        64   // < Slots (power of 2)
+#define DRAWQ_MAX_DIGITS  10   // < Widest number (uint32_t)
+
+/**
+ * Command types
+ */
+enum DrawOp {
+    DRAW_FILL,     // < Rectangle x, y, w, h in color
+    DRAW_PIXEL,    // < Pixel x, y in color
+    DRAW_NUMBER    // < value right-aligned in digits 6×8 cells at x, y
+};
+
+/**
+ * One queued command (20 bytes; 24 with its slot's sequence number)
+ */
+struct DrawCommand {
+    uint8_t op;            // < DrawOp
+    uint8_t digits;        // < DRAW_NUMBER field width (1 - DRAWQ_MAX_DIGITS)
+    uint16_t color;        // < RGB565 color
+    uint16_t background;   // < DRAW_NUMBER background
+    int16_t x, y;          // < Top-left corner
+    uint16_t w, h;         // < DRAW_FILL size
+    uint32_t value;        // < DRAW_NUMBER value
+};
+
+/**
+ * Multi-producer, single-consumer draw command queue
+ */
+class DrawQueue {
+public:
+    DrawQueue();
+    
+    /**
+     * Claim a hardware spinlock; call once before the first push
+     * (before enabling the interrupts that push)
+     */
+    void init();
+    
+    /**
+     * Queue a command (interrupt-safe, either core)
+     * 
+     * cmd Command, copied
+     * 
+     * returns false if the queue was full (the command is dropped and
+     * counted in dropped())
+     */
+    bool push(const DrawCommand& cmd);
+    
+    bool pushFill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color);
+    bool pushPixel(int16_t x, int16_t y, uint16_t color);
+    bool pushNumber(int16_t x, int16_t y, uint32_t value, uint8_t digits, uint16_t color,
+                    uint16_t background);
+    
+    /**
+     * Draw everything queued so far (one consumer at a time)
+     * 
+     * display Display; must not be in use on the other core
+     * 
+     * returns the number of commands taken from the queue
+     * 
+     * 
+     * The slots are copied out and freed first, so producers never
+     * wait for the SPI. Commands completely covered by a later fill or
+     * number (a counter updated twice) are skipped; runs of pixels
+     * become one drawPixels() call, runs of same-colored fills one
+     * fillRects() call. Stops at a slot that is claimed but not
+     * published yet (a producer interrupted mid-push); the rest is
+     * drawn next time.
+     */
+    uint32_t drain(ST7789& display);
+    
+    /**
+     * Commands waiting (claimed slots, published or not)
+     */
+    uint32_t count() const { return _head - _tail; }
+    
+    /**
+     * Commands dropped because the queue was full
+     */
+    uint32_t dropped() const { return _dropped; }
+    
+    /**
+     * Most slots ever in use at once
+     */
+    uint32_t highWater() const { return _highWater; }
+    
+    /**
+     * Commands skipped by drain() because a later one covered them
+     */
+    uint32_t skipped() const { return _skipped; }
+
+private:
+    /**
+     * A slot is published when seq is its ticket + 1
+     */
+    struct Slot {
+        volatile uint32_t seq;
+        DrawCommand cmd;
+    };
+    
+    Slot _slots[DRAWQ_SIZE];
+    spin_lock_t* _lock;
+    volatile uint32_t _head;        // < Next ticket (producers, under the lock)
+    volatile uint32_t _tail;        // < Next ticket to drain (consumer)
+    volatile uint32_t _dropped;     // < Under the lock
+    volatile uint32_t _highWater;   // < Under the lock
+    uint32_t _skipped;              // < Consumer only
+    
+    // Consumer work space
+    DrawCommand _batch[DRAWQ_SIZE];
+    Point _points[DRAWQ_SIZE];
+    Rect _rects[DRAWQ_SIZE];
+    uint16_t _text[DRAWQ_MAX_DIGITS * 6 * 8];
+    
+    void drawNumber(ST7789& display, const DrawCommand& cmd);
+};
+
+#endif // DRAWQUEUE_H
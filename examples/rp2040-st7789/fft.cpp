@@ -0,0 +1,192 @@
+/**
+ * fft.cpp
+ * Implementation of the Q15 FFT
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "fft.h"
+#include "fixmath.h"
+
+// ========== COMPILE-TIME TABLES ==========
+
+/**
+ * Twiddle factors W^k = exp(-2πik / FFT_MAX_SIZE)
+ * 
+ * Radix-4 butterflies need W^k, W^2k and W^3k, so three quarters of
+ * the circle are stored (768 entries, 3 KB of flash).
+ */
+#define FFT_TWIDDLES (FFT_MAX_SIZE * 3 / 4)
+
+struct FftTwiddleTable {
+    FftComplex w[FFT_TWIDDLES];
+};
+
+static constexpr FftTwiddleTable makeTwiddles() {
+    FftTwiddleTable table = {};
+    for (int k = 0; k < FFT_TWIDDLES; k++) {
+        double angle = 2 * FIX_PI * k / FFT_MAX_SIZE;
+        table.w[k].re = fixConstQ15(fixConstCos(angle));
+        table.w[k].im = fixConstQ15(-fixConstSin(angle));
+    }
+    return table;
+}
+
+static constexpr FftTwiddleTable FFT_TWIDDLE = makeTwiddles();
+
+/**
+ * First half of a Hann window of FFT_MAX_SIZE points
+ * 
+ * w[i] = 0.5 - 0.5 cos(2πi / N). Smaller sizes use every n-th entry,
+ * the second half mirrors the first.
+ */
+struct FftWindowTable {
+    int16_t w[FFT_MAX_SIZE / 2 + 1];
+};
+
+static constexpr FftWindowTable makeHann() {
+    FftWindowTable table = {};
+    for (int i = 0; i <= FFT_MAX_SIZE / 2; i++) {
+        double angle = 2 * FIX_PI * i / FFT_MAX_SIZE;
+        table.w[i] = fixConstQ15(0.5 - 0.5 * fixConstCos(angle));
+    }
+    return table;
+}
+
+static constexpr FftWindowTable FFT_HANN = makeHann();
+
+// ========== Q15 HELPERS ==========
+
+/**
+ * Complex multiply a × w, result in Q15 with rounding
+ */
+static inline void fftMul(const FftComplex& a, const FftComplex& w, int32_t& re, int32_t& im) {
+    re = ((int32_t)a.re * w.re - (int32_t)a.im * w.im + (1 << 14)) >> 15;
+    im = ((int32_t)a.re * w.im + (int32_t)a.im * w.re + (1 << 14)) >> 15;
+}
+
+// ========== PUBLIC FUNCTIONS ==========
+
+void fftWindowHann(const int16_t* in, FftComplex* out, uint16_t size) {
+    uint16_t step = FFT_MAX_SIZE / size;
+    for (uint16_t i = 0; i < size; i++) {
+        uint16_t j = (i <= size / 2) ? i : size - i;
+        out[i].re = (int16_t)(((int32_t)in[i] * FFT_HANN.w[j * step]) >> 15);
+        out[i].im = 0;
+    }
+}
+
+/**
+ * Forward FFT
+ * 
+ * 
+ * 1. Bit-reversal permutation: after it, each block of 4m values at
+ *    positions g, g+m, g+2m, g+3m holds the size-m DFTs of the input
+ *    samples with index ≡ 0, 2, 1, 3 (mod 4) of that block.
+ * 2. Optional radix-2 stage (m = 1 → 2) when log2Size is odd.
+ * 3. Radix-4 stages, m = size of the sub-DFTs being combined:
+ * 
+ *      c0 = F0[k]        c1 = W^k F1[k]
+ *      c2 = W^2k F2[k]   c3 = W^3k F3[k]
+ * 
+ *      X[k]    = c0 +  c1 + c2 +  c3
+ *      X[k+m]  = c0 - jc1 - c2 + jc3
+ *      X[k+2m] = c0 -  c1 + c2 -  c3
+ *      X[k+3m] = c0 + jc1 - c2 - jc3
+ * 
+ *    with W = exp(-2πi / 4m). Multiplying by ±j is free (swap and
+ *    negate), so only three multiplications are needed.
+ */
+void fftForward(FftComplex* data, uint8_t log2Size) {
+    if (log2Size == 0 || log2Size > FFT_MAX_LOG2) return;
+    uint16_t size = 1 << log2Size;
+    
+    // ========== BIT REVERSAL ==========
+    for (uint16_t i = 1, j = 0; i < size; i++) {
+        uint16_t bit = size >> 1;
+        while (j & bit) {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+        if (i < j) {
+            FftComplex tmp = data[i];
+            data[i] = data[j];
+            data[j] = tmp;
+        }
+    }
+    
+    uint16_t m = 1;
+    
+    // ========== RADIX-2 STAGE ==========
+    if (log2Size & 1) {
+        for (uint16_t i = 0; i < size; i += 2) {
+            int32_t re0 = data[i].re, im0 = data[i].im;
+            int32_t re1 = data[i + 1].re, im1 = data[i + 1].im;
+            data[i].re = (int16_t)((re0 + re1) >> 1);
+            data[i].im = (int16_t)((im0 + im1) >> 1);
+            data[i + 1].re = (int16_t)((re0 - re1) >> 1);
+            data[i + 1].im = (int16_t)((im0 - im1) >> 1);
+        }
+        m = 2;
+    }
+    
+    // ========== RADIX-4 STAGES ==========
+    for (; m < size; m *= 4) {
+        uint16_t stride = FFT_MAX_SIZE / (4 * m);  // Twiddle index step
+        
+        for (uint16_t g = 0; g < size; g += 4 * m) {
+            for (uint16_t k = 0; k < m; k++) {
+                FftComplex* p = &data[g + k];
+                
+                // Inputs in bit-reversed block order: F0, F2, F1, F3
+                int32_t c0re = p[0].re, c0im = p[0].im;
+                int32_t c1re, c1im, c2re, c2im, c3re, c3im;
+                fftMul(p[2 * m], FFT_TWIDDLE.w[k * stride], c1re, c1im);
+                fftMul(p[m], FFT_TWIDDLE.w[2 * k * stride], c2re, c2im);
+                fftMul(p[3 * m], FFT_TWIDDLE.w[3 * k * stride], c3re, c3im);
+                
+                int32_t s02re = c0re + c2re, s02im = c0im + c2im;  // c0 + c2
+                int32_t d02re = c0re - c2re, d02im = c0im - c2im;  // c0 - c2
+                int32_t s13re = c1re + c3re, s13im = c1im + c3im;  // c1 + c3
+                int32_t d13re = c1re - c3re, d13im = c1im - c3im;  // c1 - c3
+                
+                // Divide by 4 to keep the result in Q15 range
+                p[0].re = (int16_t)((s02re + s13re) >> 2);
+                p[0].im = (int16_t)((s02im + s13im) >> 2);
+                // -j(c1 - c3) = (d13im, -d13re)
+                p[m].re = (int16_t)((d02re + d13im) >> 2);
+                p[m].im = (int16_t)((d02im - d13re) >> 2);
+                p[2 * m].re = (int16_t)((s02re - s13re) >> 2);
+                p[2 * m].im = (int16_t)((s02im - s13im) >> 2);
+                // +j(c1 - c3) = (-d13im, d13re)
+                p[3 * m].re = (int16_t)((d02re - d13im) >> 2);
+                p[3 * m].im = (int16_t)((d02im + d13re) >> 2);
+            }
+        }
+    }
+}
+
+/**
+ * Log magnitude without square root
+ * 
+ * 
+ * log2(|X|) = log2(re² + im²) / 2. The integer part of log2 is the
+ * position of the highest set bit, the 4 bits below it give a linear
+ * approximation of the fraction (max error about 0.09 octave).
+ */
+void fftLogMagnitudes(const FftComplex* data, uint8_t* out, uint16_t bins) {
+    for (uint16_t i = 0; i < bins; i++) {
+        uint32_t power = (uint32_t)((int32_t)data[i].re * data[i].re) +
+                         (uint32_t)((int32_t)data[i].im * data[i].im);
+        if (power == 0) {
+            out[i] = 0;
+            continue;
+        }
+        
+        uint8_t msb = 31 - __builtin_clz(power);
+        uint32_t frac = (msb >= 4) ? (power >> (msb - 4)) & 0xF : (power << (4 - msb)) & 0xF;
+        uint32_t log2x16 = msb * 16 + frac;  // 16 × log2(power)
+        out[i] = (uint8_t)(log2x16 / 2 > 255 ? 255 : log2x16 / 2);
+    }
+}
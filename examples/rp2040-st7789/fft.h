@@ -0,0 +1,86 @@
+/**
+ * fft.h
+ * Fixed-point (Q15) FFT for the Cortex-M0+
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * The RP2040 has no floating point unit, so the FFT works on 16-bit
+ * fixed-point numbers in Q15 format: an int16_t x stands for the
+ * value x / 32768, i.e. -1.0 to +0.99997.
+ * 
+ * Algorithm: in-place decimation-in-time FFT on bit-reversed input.
+ * Stages are processed in pairs as radix-4 butterflies (3 complex
+ * multiplications per 4 points instead of 4 for two radix-2 stages).
+ * If log2(size) is odd, one radix-2 stage without multiplications is
+ * done first.
+ * 
+ * To avoid overflow every stage divides by its radix, so the result
+ * is the DFT divided by the size. Twiddle factors and the Hann window
+ * are computed at compile time and stored in flash.
+ * 
+ * example:
+ * 
+ * FftComplex buf[256];
+ * uint8_t level[128];
+ * fftWindowHann(samples, buf, 256);   // Real samples → windowed complex
+ * fftForward(buf, 8);                 // 2^8 = 256 points
+ * fftLogMagnitudes(buf, level, 128);  // First half = 0 ... fs/2
+ * 
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+
+#define FFT_MAX_LOG2 10                  // < Largest supported size: 2^10
+#define FFT_MAX_SIZE (1 << FFT_MAX_LOG2) // < 1024 points
+
+/**
+ * Complex Q15 value
+ */
+struct FftComplex {
+    int16_t re;  // < Real part (Q15)
+    int16_t im;  // < Imaginary part (Q15)
+};
+
+/**
+ * Apply a Hann window to real samples and convert them to complex
+ * 
+ * in Real Q15 samples
+ * out Complex buffer for fftForward()
+ * size Number of samples (power of two, at most FFT_MAX_SIZE)
+ * 
+ * The window reduces spectral leakage: a pure tone shows as a narrow
+ * peak instead of a wide skirt.
+ */
+void fftWindowHann(const int16_t* in, FftComplex* out, uint16_t size);
+
+/**
+ * In-place forward FFT
+ * 
+ * data 2^log2Size complex values, replaced by the spectrum
+ * log2Size Size as power of two (1 - FFT_MAX_LOG2)
+ * 
+ * Output bin k is the DFT at frequency k × fs / size, scaled by
+ * 1 / size. Bins above size / 2 mirror the lower half for real input.
+ */
+void fftForward(FftComplex* data, uint8_t log2Size);
+
+/**
+ * Logarithmic magnitudes for display
+ * 
+ * data FFT output
+ * out One byte per bin
+ * bins Number of bins to convert (usually size / 2)
+ * 
+ * 
+ * out = 16 × log2(|X|), i.e. 16 steps per doubling of amplitude
+ * (about 0.38 dB per step, 96 dB over the full 0-255 range). Uses
+ * only integer operations, no square root. The bytes can be fed
+ * straight into Waterfall::pushRow() or BarGraph::update().
+ */
+void fftLogMagnitudes(const FftComplex* data, uint8_t* out, uint16_t bins);
+
+#endif // FFT_H
@@ -0,0 +1,241 @@
+/**
+ * fill.cpp
+ * Implementation of the gradient and pattern fills
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "fill.h"
+#include "fixmath.h"
+
+// ========== TABLES ==========
+
+/**
+ * 4×4 ordered dither thresholds (0 - 15)
+ */
+static const uint8_t FILL_BAYER[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 }
+};
+
+/**
+ * sqrt(i / 1023) × 255: distance from squared distance for radial
+ * gradients (1 KB)
+ */
+#define FILL_SQRT_SIZE 1024
+
+struct FillSqrtTable {
+    uint8_t v[FILL_SQRT_SIZE];
+};
+
+static constexpr FillSqrtTable makeSqrtTable() {
+    FillSqrtTable table = {};
+    for (int i = 0; i < FILL_SQRT_SIZE; i++) {
+        table.v[i] = (uint8_t)(255 * fixConstSqrt((double)i / (FILL_SQRT_SIZE - 1)) + 0.5);
+    }
+    return table;
+}
+
+static constexpr FillSqrtTable FILL_SQRT = makeSqrtTable();
+
+/**
+ * Line being generated and line on the DMA
+ */
+static uint16_t s_line[2][SCREEN_WIDTH];
+
+// ========== HELPERS ==========
+
+/**
+ * Part of the rectangle inside the display's clip rectangle
+ */
+static Rect visibleRect(const ST7789& display, int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    Rect r = { x, y, (int16_t)(w > INT16_MAX ? INT16_MAX : w), (int16_t)(h > INT16_MAX ? INT16_MAX : h) };
+    return rectIntersect(r, display.clipRect());
+}
+
+/**
+ * RGB565 channels on a 0 - 255 scale with the low bits zero, so a
+ * channel plus a dither threshold below one step rounds back to itself
+ */
+struct FillRgb {
+    int32_t r, g, b;
+};
+
+static inline FillRgb expand(uint16_t c) {
+    return { (c >> 11) << 3, ((c >> 5) & 0x3F) << 2, (c & 0x1F) << 3 };
+}
+
+/**
+ * Dithered pack: red and blue steps are 8, green steps 4
+ */
+static inline uint16_t pack(int32_t r, int32_t g, int32_t b, uint8_t d) {
+    return (uint16_t)((((r + (d >> 1)) >> 3) << 11) | (((g + (d >> 2)) >> 2) << 5) |
+                      ((b + (d >> 1)) >> 3));
+}
+
+// ========== GRADIENTS ==========
+
+/**
+ * Linear gradient line: channels in 16.16, one addition per channel
+ * and pixel
+ */
+static void linearLine(uint16_t* out, uint16_t w, FillRgb c, FillRgb step, const uint8_t* dither) {
+    for (uint16_t i = 0; i < w; i++) {
+        out[i] = pack(c.r >> 16, c.g >> 16, c.b >> 16, dither[i & 3]);
+        c.r += step.r;
+        c.g += step.g;
+        c.b += step.b;
+    }
+}
+
+/**
+ * Radial gradient line
+ * 
+ * 
+ * Coordinates are doubled so pixel centers are integers. The squared
+ * distance grows by 4dx + 4 per pixel (additions only), one shift and
+ * one multiply scale it to the table, which gives the distance as
+ * 0 - 255. Both coordinates stay below 2^15, so the sum fits unsigned.
+ */
+static void radialLine(uint16_t* out, uint16_t w, int32_t dx, int32_t dy, uint8_t shift,
+                       uint32_t scale, FillRgb from, FillRgb delta, const uint8_t* dither) {
+    uint32_t d2 = (uint32_t)dx * dx + (uint32_t)dy * dy;
+    for (uint16_t i = 0; i < w; i++) {
+        int32_t t = FILL_SQRT.v[((d2 >> shift) * scale) >> 16];
+        out[i] = pack(from.r + ((delta.r * t) >> 8), from.g + ((delta.g * t) >> 8),
+                      from.b + ((delta.b * t) >> 8), dither[i & 3]);
+        d2 += 4 * dx + 4;
+        dx += 2;
+    }
+}
+
+void fillRectGradient(ST7789& display, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                      uint16_t from, uint16_t to, GradientType type) {
+    // The gradient spans the whole rectangle, even the part clipped off;
+    // ox, oy is where the visible part starts inside it
+    Rect v = visibleRect(display, x, y, w, h);
+    if (rectEmpty(v)) return;
+    int32_t gw = w > INT16_MAX ? INT16_MAX : w;
+    int32_t gh = h > INT16_MAX ? INT16_MAX : h;
+    int32_t ox = v.x - x, oy = v.y - y;
+    
+    FillRgb c0 = expand(from);
+    FillRgb c1 = expand(to);
+    FillRgb delta = { c1.r - c0.r, c1.g - c0.g, c1.b - c0.b };
+    
+    int32_t span = (type != GRADIENT_VERTICAL ? gw - 1 : 0) + (type != GRADIENT_HORIZONTAL ? gh - 1 : 0);
+    FillRgb step = {};
+    if (span > 0) {
+        step = { delta.r * 65536 / span, delta.g * 65536 / span, delta.b * 65536 / span };
+    }
+    FillRgb stepX = type == GRADIENT_VERTICAL ? FillRgb{} : step;
+    FillRgb stepY = type == GRADIENT_HORIZONTAL ? FillRgb{} : step;
+    
+    // Radial: squared distance to the corners maps to the last entry;
+    // large gradients are shifted down first so scale keeps its bits
+    uint32_t radius2 = (uint32_t)(gw - 1) * (gw - 1) + (uint32_t)(gh - 1) * (gh - 1);
+    uint8_t shift = 0;
+    while ((radius2 >> shift) > 0xFFFF) shift++;
+    uint32_t scale = radius2 ? ((uint32_t)(FILL_SQRT_SIZE - 1) << 16) / (radius2 >> shift) : 0;
+    
+    display.beginPixels(v.x, v.y, v.w, v.h);
+    for (int16_t row = 0; row < v.h; row++) {
+        uint16_t* line = s_line[row & 1];
+        const uint8_t* bayer = FILL_BAYER[(v.y + row) & 3];
+        uint8_t dither[4];
+        for (uint8_t i = 0; i < 4; i++) {
+            dither[i] = bayer[(v.x + i) & 3];
+        }
+        
+        int32_t gy = oy + row;
+        if (type == GRADIENT_RADIAL) {
+            radialLine(line, v.w, 2 * ox + 1 - gw, 2 * gy + 1 - gh, shift, scale, c0, delta, dither);
+        } else {
+            FillRgb start = { (c0.r << 16) + gy * stepY.r + ox * stepX.r,
+                              (c0.g << 16) + gy * stepY.g + ox * stepX.g,
+                              (c0.b << 16) + gy * stepY.b + ox * stepX.b };
+            linearLine(line, v.w, start, stepX, dither);
+        }
+        display.writePixelsAsync(line, v.w);
+    }
+}
+
+// ========== PATTERNS ==========
+
+/**
+ * Alternating runs of size pixels; pos is the pattern position of the
+ * first pixel
+ */
+static void bandLine(uint16_t* out, uint16_t w, uint32_t pos, uint8_t size,
+                     uint16_t even, uint16_t odd) {
+    uint16_t color = ((pos / size) & 1) ? odd : even;
+    uint16_t run = size - pos % size;
+    uint16_t i = 0;
+    while (i < w) {
+        uint16_t end = (w - i < run) ? w : i + run;
+        while (i < end) out[i++] = color;
+        color = (color == even) ? odd : even;
+        run = size;
+    }
+}
+
+static void solidLine(uint16_t* out, uint16_t w, uint16_t color) {
+    for (uint16_t i = 0; i < w; i++) {
+        out[i] = color;
+    }
+}
+
+/**
+ * Foreground on every size-th pixel starting at first
+ */
+static void dotLine(uint16_t* out, uint16_t w, uint16_t first, uint8_t size, uint16_t color) {
+    for (uint16_t i = first; i < w; i += size) {
+        out[i] = color;
+    }
+}
+
+void fillRectPattern(ST7789& display, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                     uint16_t background, uint16_t foreground, PatternType type, uint8_t size) {
+    // Anchored to the screen, so only the visible part matters
+    Rect v = visibleRect(display, x, y, w, h);
+    if (rectEmpty(v)) return;
+    if (size == 0) size = 1;
+    x = v.x;
+    w = v.w;
+    
+    display.beginPixels(v.x, v.y, v.w, v.h);
+    for (int16_t row = 0; row < v.h; row++) {
+        uint16_t* line = s_line[row & 1];
+        uint16_t py = v.y + row;
+        
+        switch (type) {
+        case PATTERN_CHECKER:
+            if ((py / size) & 1) {
+                bandLine(line, w, x, size, foreground, background);
+            } else {
+                bandLine(line, w, x, size, background, foreground);
+            }
+            break;
+        case PATTERN_STRIPES_H:
+            solidLine(line, w, (py / size) & 1 ? foreground : background);
+            break;
+        case PATTERN_STRIPES_V:
+            bandLine(line, w, x, size, background, foreground);
+            break;
+        case PATTERN_STRIPES_D:
+            bandLine(line, w, x + py, size, background, foreground);
+            break;
+        case PATTERN_HATCH:
+        case PATTERN_CROSSHATCH:
+            solidLine(line, w, background);
+            dotLine(line, w, (size - (x + py) % size) % size, size, foreground);
+            if (type == PATTERN_CROSSHATCH) {
+                dotLine(line, w, (py % size + size - x % size) % size, size, foreground);
+            }
+            break;
+        }
+        display.writePixelsAsync(line, w);
+    }
+}
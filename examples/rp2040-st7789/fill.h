@@ -0,0 +1,80 @@
+/**
+ * fill.h
+ * Gradient and pattern fills generated line by line
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * A full-screen gradient as an image would be 150 KB of flash. These
+ * fills compute each line into a small buffer instead and send it by
+ * DMA while the next line is computed, through one display window for
+ * the whole rectangle. Generating a line takes a fraction of the time
+ * the SPI needs to send it, so a fill runs at about SPI speed and needs
+ * two line buffers (960 bytes) of RAM.
+ * 
+ * Gradients step each color channel in 16.16 fixed point (additions
+ * only along a line; radial gradients use a square root table) and
+ * are dithered with a 4×4 ordered pattern, which hides the steps of
+ * 5-bit red and blue. A flat color stays flat.
+ * 
+ * Patterns are built from runs, so their cost per line does not
+ * depend on the cell size. They are anchored to the screen, not to
+ * the rectangle, so neighbouring fills line up.
+ * 
+ * Both return while the last line is still on the DMA; the next
+ * driver call waits for it, as after drawBufferAsync().
+ * 
+ * example:
+ * 
+ * fillRectGradient(display, 0, 0, 240, 320, COLOR_BLUE, COLOR_BLACK, GRADIENT_VERTICAL);
+ * fillRectPattern(display, 20, 200, 200, 40, COLOR_WHITE, COLOR_BLACK, PATTERN_CHECKER, 8);
+ * 
+ */
+
+#ifndef FILL_H
+#define FILL_H
+
+#include <stdint.h>
+#include "st7789.h"
+
+enum GradientType {
+    GRADIENT_HORIZONTAL,   // < from on the left, to on the right
+    GRADIENT_VERTICAL,     // < from at the top, to at the bottom
+    GRADIENT_DIAGONAL,     // < from top-left to bottom-right
+    GRADIENT_RADIAL        // < from in the center, to in the corners
+};
+
+enum PatternType {
+    PATTERN_CHECKER,       // < size × size squares
+    PATTERN_STRIPES_H,     // < Horizontal bands, size lines each
+    PATTERN_STRIPES_V,     // < Vertical bands, size pixels each
+    PATTERN_STRIPES_D,     // < Diagonal bands (45°), size pixels each
+    PATTERN_HATCH,         // < 1-pixel diagonal lines every size pixels
+    PATTERN_CROSSHATCH     // < Hatch in both directions
+};
+
+/**
+ * Fill a rectangle with a color gradient
+ * 
+ * x, y Top-left corner
+ * w, h Size (clipped to the display's clip rectangle)
+ * from, to RGB565 end colors
+ * type Direction, see GradientType
+ */
+void fillRectGradient(ST7789& display, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                      uint16_t from, uint16_t to, GradientType type);
+
+/**
+ * Fill a rectangle with a two-color pattern
+ * 
+ * x, y Top-left corner
+ * w, h Size (clipped to the display's clip rectangle)
+ * background, foreground RGB565 colors (foreground: the lines, the
+ *                        odd squares or bands)
+ * type See PatternType
+ * size Cell size in pixels (1 - 255)
+ */
+void fillRectPattern(ST7789& display, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                     uint16_t background, uint16_t foreground, PatternType type, uint8_t size);
+
+#endif // FILL_H
@@ -0,0 +1,251 @@
+/**
+ * fixmath.cpp
+ * Implementation of the fixed-point math functions
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "fixmath.h"
+#include "hardware/divider.h"
+
+// ========== COMPILE-TIME TABLES ==========
+
+/**
+ * Quarter sine wave, 257 points from 0° to 90° in Q15 (514 bytes)
+ * 
+ * The other three quarters are mirror images, so one quarter is
+ * enough. One entry more than 256 so interpolation at the last step
+ * needs no special case.
+ */
+#define FIX_SIN_BITS 8
+#define FIX_SIN_SIZE ((1 << FIX_SIN_BITS) + 1)
+
+struct FixSinTable {
+    int16_t v[FIX_SIN_SIZE];
+};
+
+static constexpr FixSinTable makeSinTable() {
+    FixSinTable table = {};
+    for (int i = 0; i < FIX_SIN_SIZE; i++) {
+        table.v[i] = fixConstQ15(fixConstSin(FIX_PI / 2 * i / (FIX_SIN_SIZE - 1)));
+    }
+    return table;
+}
+
+static constexpr FixSinTable FIX_SIN = makeSinTable();
+
+/**
+ * CORDIC angles atan(2^-i) in 1/16 angle units (2^20 = full turn)
+ * 
+ * The extra 4 bits keep the rounding errors of 16 table entries from
+ * adding up to more than the result resolution.
+ */
+#define FIX_CORDIC_STEPS 16
+#define FIX_CORDIC_EXTRA 4
+
+struct FixAtanTable {
+    int32_t v[FIX_CORDIC_STEPS];
+};
+
+static constexpr FixAtanTable makeAtanTable() {
+    FixAtanTable table = {};
+    double power = 1.0;
+    for (int i = 0; i < FIX_CORDIC_STEPS; i++) {
+        double angle = fixConstAtan(power) * (65536 << FIX_CORDIC_EXTRA) / (2 * FIX_PI);
+        table.v[i] = (int32_t)(angle + 0.5);
+        power /= 2;
+    }
+    return table;
+}
+
+static constexpr FixAtanTable FIX_ATAN = makeAtanTable();
+
+/**
+ * 65536 / n for n = 0 - FIX_RECIP_MAX (1.3 KB; entry 0 saturates)
+ */
+struct FixRecipTable {
+    int32_t v[FIX_RECIP_MAX + 1];
+};
+
+static constexpr FixRecipTable makeRecipTable() {
+    FixRecipTable table = {};
+    table.v[0] = INT32_MAX;
+    for (int n = 1; n <= FIX_RECIP_MAX; n++) {
+        table.v[n] = (65536 + n / 2) / n;
+    }
+    return table;
+}
+
+static constexpr FixRecipTable FIX_RECIP = makeRecipTable();
+
+// ========== ARITHMETIC ==========
+
+/**
+ * Q16 division
+ * 
+ * 
+ * a / b in Q16 is (a × 65536) / b, which needs a 64-bit dividend.
+ * Instead it is done as long division on the 32-bit hardware divider
+ * (8 cycles per division, quotient and remainder at once):
+ * 
+ *   integer part = |a| / |b|, remainder r
+ *   2 × 8 fraction bits: r × 256 / |b|, new remainder, repeat
+ * 
+ * r × 256 must fit 32 bits, so divisors of 2^24 and above are shifted
+ * down first; that only drops bits far below Q16 resolution.
+ */
+q16_t fixDiv(q16_t a, q16_t b) {
+    if (b == 0) return a >= 0 ? INT32_MAX : -INT32_MAX;
+    
+    bool negative = (a < 0) != (b < 0);
+    uint32_t ua = a < 0 ? -(uint32_t)a : (uint32_t)a;
+    uint32_t ub = b < 0 ? -(uint32_t)b : (uint32_t)b;
+    
+    divmod_result_t r = hw_divider_divmod_u32(ua, ub);
+    uint32_t quotient = to_quotient_u32(r);
+    uint32_t remainder = to_remainder_u32(r);
+    if (quotient >= 0x8000) return negative ? -INT32_MAX : INT32_MAX;
+    
+    while (ub >= (1u << 24)) {
+        ub >>= 8;
+        remainder >>= 8;
+    }
+    for (int step = 0; step < 2; step++) {
+        r = hw_divider_divmod_u32(remainder << 8, ub);
+        quotient = (quotient << 8) | to_quotient_u32(r);
+        remainder = to_remainder_u32(r);
+    }
+    
+    return negative ? -(q16_t)quotient : (q16_t)quotient;
+}
+
+q16_t fixRecip(uint32_t n) {
+    if (n <= FIX_RECIP_MAX) return FIX_RECIP.v[n];
+    return (q16_t)to_quotient_u32(hw_divider_divmod_u32(65536 + n / 2, n));
+}
+
+// ========== SQUARE ROOT ==========
+
+/**
+ * Digit-by-digit square root
+ * 
+ * 
+ * Works like long division in base 4: each step decides one result
+ * bit by trying to subtract (2 × result + bit) × bit from what is
+ * left. 16 steps of shifts, adds and compares, no multiplication.
+ */
+uint16_t isqrt32(uint32_t x) {
+    uint32_t result = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > x) bit >>= 2;
+    
+    while (bit) {
+        if (x >= result + bit) {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)result;
+}
+
+/**
+ * Q16 square root
+ * 
+ * 
+ * sqrt(x / 65536) × 65536 = sqrt(x × 65536). x × 65536 does not fit
+ * 32 bits, so x is shifted left by an even amount s as far as it
+ * goes, then sqrt(x × 2^s) × 2^((16 - s) / 2) gives the result with
+ * 16 significant bits.
+ */
+q16_t fixSqrt(q16_t x) {
+    if (x <= 0) return 0;
+    int shift = __builtin_clz((uint32_t)x) & ~1;  // Even, 0 - 30
+    if (shift > 16) shift = 16;
+    uint32_t root = isqrt32((uint32_t)x << shift);
+    return (q16_t)(root << ((16 - shift) / 2));
+}
+
+// ========== TRIGONOMETRY ==========
+
+/**
+ * Table sine
+ * 
+ * 
+ * angle bits: [15:14] quadrant, [13:6] table index, [5:0] fraction.
+ * Quadrants 1 and 3 run the table backwards, 2 and 3 are negative.
+ */
+int16_t fixSin(uint16_t angle) {
+    uint8_t quadrant = angle >> 14;
+    uint32_t offset = angle & 0x3FFF;
+    if (quadrant & 1) offset = 0x4000 - offset;
+    
+    uint32_t index = offset >> 6;
+    int32_t frac = offset & 0x3F;
+    int32_t value = FIX_SIN.v[index];
+    if (frac) {
+        value += ((FIX_SIN.v[index + 1] - value) * frac + 32) >> 6;
+    }
+    return (int16_t)((quadrant & 2) ? -value : value);
+}
+
+/**
+ * CORDIC arc tangent (vectoring mode)
+ * 
+ * 
+ * The vector is rotated towards the x axis by ±atan(2^-i) in step i.
+ * A rotation by atan(2^-i) is (x + y/2^i, y - x/2^i) up to a constant
+ * scale, so each step is two shifts and two adds. The sum of the
+ * rotations is the angle of the original vector.
+ * 
+ * Before the loop the vector is moved into the right half plane (the
+ * loop converges within ±99°) and scaled so the coordinates are large
+ * enough for precision but cannot overflow (CORDIC grows them by 1.65).
+ */
+uint16_t fixAtan2(int32_t y, int32_t x) {
+    if (x == 0 && y == 0) return 0;
+    if (x == INT32_MIN || y == INT32_MIN) {
+        x >>= 1;  // So that -x and -y below cannot overflow
+        y >>= 1;
+    }
+    
+    int32_t angle = 0;  // 1/16 units
+    if (x < 0) {
+        x = -x;
+        y = -y;
+        angle = 0x8000 << FIX_CORDIC_EXTRA;  // 180°
+    }
+    
+    // ========== SCALE ==========
+    uint32_t ax = (uint32_t)x;
+    uint32_t ay = y < 0 ? -(uint32_t)y : (uint32_t)y;
+    uint32_t largest = ax > ay ? ax : ay;
+    while (largest >= (1u << 28)) {
+        x >>= 1;
+        y >>= 1;
+        largest >>= 1;
+    }
+    while (largest < (1u << 20)) {
+        x <<= 1;
+        y <<= 1;
+        largest <<= 1;
+    }
+    
+    // ========== ROTATE ==========
+    for (int i = 0; i < FIX_CORDIC_STEPS; i++) {
+        int32_t dx = y >> i;
+        int32_t dy = x >> i;
+        if (y > 0) {
+            x += dx;
+            y -= dy;
+            angle += FIX_ATAN.v[i];
+        } else {
+            x -= dx;
+            y += dy;
+            angle -= FIX_ATAN.v[i];
+        }
+    }
+    return (uint16_t)((angle + (1 << (FIX_CORDIC_EXTRA - 1))) >> FIX_CORDIC_EXTRA);
+}
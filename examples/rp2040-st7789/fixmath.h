@@ -0,0 +1,184 @@
+/**
+ * fixmath.h
+ * Fixed-point math for the Cortex-M0+ (no FPU)
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Every float operation on the RP2040 is a function call into
+ * software floating point. Gauges, radar sweeps, circles and
+ * rotations only need a few correct digits, so this module does the
+ * same with integers:
+ * 
+ * - fixSin() / fixCos(): quarter-wave table in flash + interpolation
+ * - fixAtan2(): CORDIC, shifts and adds only
+ * - isqrt32() / fixSqrt(): bit-by-bit square root, no division
+ * - fixRecip(): table of 1/n for n up to the screen height (slopes)
+ * - fixDiv(): Q16 division on the SIO hardware divider
+ * 
+ * Formats:
+ * - q16_t: 16.16 fixed point, 65536 = 1.0
+ * - Q15 (int16_t): -32767 ... 32767 = -1.0 ... 1.0
+ * - angles: uint16_t, 65536 = full turn (0x4000 = 90°), so angle
+ *   arithmetic wraps around for free
+ * 
+ * The constexpr helpers at the end of this file are for generating
+ * tables at compile time; they use double and must not be called at
+ * run time.
+ * 
+ * example:
+ * 
+ * uint16_t angle = FIX_DEG(30);
+ * int16_t x = cx + ((radius * fixCos(angle)) >> 15);
+ * int16_t y = cy - ((radius * fixSin(angle)) >> 15);
+ * 
+ */
+
+#ifndef FIXMATH_H
+#define FIXMATH_H
+
+#include <stdint.h>
+
+typedef int32_t q16_t;          // < Fixed point 16.16 (65536 = 1.0)
+
+#define FIX_ONE        65536    // < 1.0 in Q16
+#define FIX_Q15_ONE    32767    // < Largest Q15 value (~1.0)
+#define FIX_RECIP_MAX  320      // < fixRecip() table covers 1 - 320
+
+/**
+ * Degrees to angle units (integer degrees, evaluated at compile time
+ * for constants)
+ */
+#define FIX_DEG(d) ((uint16_t)((int32_t)(d) * 65536 / 360))
+
+// ========== ARITHMETIC ==========
+
+/**
+ * Q16 multiply (64-bit intermediate, rounded)
+ */
+static inline q16_t fixMul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b + 0x8000) >> 16);
+}
+
+/**
+ * Q16 divide using the hardware divider
+ * 
+ * returns a / b in Q16, saturated to the q16_t range if it does not
+ * fit or b is 0
+ */
+q16_t fixDiv(q16_t a, q16_t b);
+
+/**
+ * Reciprocal of an integer in Q16: 65536 / n (rounded)
+ * 
+ * n 1 - FIX_RECIP_MAX from a table, larger values are divided
+ * 
+ * Meant for edge slopes: dx / dy = dx × fixRecip(dy) >> 16.
+ */
+q16_t fixRecip(uint32_t n);
+
+// ========== SQUARE ROOT ==========
+
+/**
+ * Integer square root, rounded down
+ */
+uint16_t isqrt32(uint32_t x);
+
+/**
+ * Q16 square root (0 for negative input)
+ */
+q16_t fixSqrt(q16_t x);
+
+// ========== TRIGONOMETRY ==========
+
+/**
+ * Sine in Q15
+ * 
+ * angle 65536 = full turn
+ * 
+ * Maximum error about 1 LSB (0.00003).
+ */
+int16_t fixSin(uint16_t angle);
+
+/**
+ * Cosine in Q15
+ */
+static inline int16_t fixCos(uint16_t angle) {
+    return fixSin((uint16_t)(angle + 0x4000));
+}
+
+/**
+ * Angle of the vector (x, y)
+ * 
+ * returns Angle, 65536 = full turn, 0 along +x, 0x4000 along +y;
+ *         0 for (0, 0)
+ * 
+ * Error below 0.01°.
+ */
+uint16_t fixAtan2(int32_t y, int32_t x);
+
+// ========== COMPILE-TIME HELPERS ==========
+
+#define FIX_PI 3.14159265358979323846
+
+/**
+ * Sine for table generation
+ * 
+ * Taylor series after reducing x to [-pi, pi]; 12 terms are accurate
+ * far beyond Q15 resolution.
+ */
+static constexpr double fixConstSin(double x) {
+    while (x > FIX_PI) x -= 2 * FIX_PI;
+    while (x < -FIX_PI) x += 2 * FIX_PI;
+    double term = x;
+    double sum = x;
+    for (int i = 1; i < 12; i++) {
+        term *= -x * x / ((2 * i) * (2 * i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+static constexpr double fixConstCos(double x) {
+    return fixConstSin(x + FIX_PI / 2);
+}
+
+/**
+ * Square root for table generation (Newton iteration)
+ */
+static constexpr double fixConstSqrt(double x) {
+    double r = x > 1 ? x : 1;
+    for (int i = 0; i < 40; i++) {
+        r = 0.5 * (r + x / r);
+    }
+    return r;
+}
+
+/**
+ * Arc tangent for table generation
+ * 
+ * Series x - x³/3 + x⁵/5 ... for |x| <= 0.5, otherwise the identity
+ * atan(x) = 2 atan(x / (1 + sqrt(1 + x²))) to get there first.
+ */
+static constexpr double fixConstAtan(double x) {
+    if (x > 0.5 || x < -0.5) {
+        return 2 * fixConstAtan(x / (1 + fixConstSqrt(1 + x * x)));
+    }
+    double power = x;
+    double sum = 0;
+    for (int i = 0; i < 40; i++) {
+        sum += (i & 1 ? -power : power) / (2 * i + 1);
+        power *= x * x;
+    }
+    return sum;
+}
+
+/**
+ * Round a double to Q15 (for tables)
+ */
+static constexpr int16_t fixConstQ15(double v) {
+    double scaled = v * 32767.0;
+    return (int16_t)(scaled >= 0 ? scaled + 0.5 : scaled - 0.5);
+}
+
+#endif // FIXMATH_H
@@ -0,0 +1,248 @@
+/**
+ * font.cpp
+ * Implementation of the sparse bitmap fonts
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "font.h"
+#include "bytes.h"
+
+// ========== UTF-8 ==========
+
+uint32_t utf8Next(const char*& text) {
+    const uint8_t* p = (const uint8_t*)text;
+    uint8_t lead = p[0];
+    if (lead < 0x80) {
+        if (lead) text++;
+        return lead;
+    }
+    
+    uint8_t length;
+    uint32_t cp;
+    uint32_t min;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 2;
+        cp = lead & 0x1F;
+        min = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 3;
+        cp = lead & 0x0F;
+        min = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 4;
+        cp = lead & 0x07;
+        min = 0x10000;
+    } else {
+        text++;  // Continuation byte or 0xF8-0xFF without a lead
+        return UTF8_REPLACEMENT;
+    }
+    
+    // A missing continuation byte (the terminator included) ends the sequence early
+    for (uint8_t i = 1; i < length; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            text++;
+            return UTF8_REPLACEMENT;
+        }
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        text++;
+        return UTF8_REPLACEMENT;
+    }
+    text += length;
+    return cp;
+}
+
+// ========== FONT ==========
+
+Font::Font()
+    : _lineHeight(0), _ascent(0), _rangeCount(0), _glyphCount(0), _kernCount(0),
+      _fallback(FONT_NO_GLYPH), _ranges(nullptr), _glyphs(nullptr), _kernKeys(nullptr),
+      _kernAdjust(nullptr), _bitmaps(nullptr) {
+}
+
+bool Font::open(const uint8_t* data, size_t size) {
+    _glyphCount = 0;
+    if (size < FONT_HEADER_SIZE || ((uintptr_t)data & 3) || memcmp(data, "FNT1", 4) != 0) return false;
+    uint16_t lineHeight = read16(data + 4);
+    uint16_t ascent = read16(data + 6);
+    uint16_t ranges = read16(data + 8);
+    uint16_t glyphs = read16(data + 10);
+    uint16_t kerns = read16(data + 12);
+    uint16_t fallback = read16(data + 14);
+    uint32_t bitmapSize = read32(data + 16);
+    if (ranges == 0 || glyphs == 0 || glyphs == FONT_NO_GLYPH) return false;
+    if (fallback != FONT_NO_GLYPH && fallback >= glyphs) return false;
+    
+    // Tables are read in place: the sizes must add up
+    uint32_t kernSize = kerns * 4u + ((kerns + 3u) & ~3u);
+    size_t need = FONT_HEADER_SIZE + ranges * 8u + glyphs * 8u + kernSize + bitmapSize;
+    if (need > size) return false;
+    
+    const Range* r = (const Range*)(data + FONT_HEADER_SIZE);
+    const FontGlyph* g = (const FontGlyph*)(r + ranges);
+    const uint32_t* keys = (const uint32_t*)(g + glyphs);
+    const int8_t* adjust = (const int8_t*)(keys + kerns);
+    const uint8_t* bitmaps = (const uint8_t*)keys + kernSize;
+    
+    // Ranges sorted and not overlapping, every glyph inside the font
+    for (uint16_t i = 0; i < ranges; i++) {
+        if (r[i].count == 0 || r[i].glyph + r[i].count > glyphs) return false;
+        if (i > 0 && r[i].first < r[i - 1].first + r[i - 1].count) return false;
+    }
+    for (uint16_t i = 0; i < glyphs; i++) {
+        uint32_t bits = (uint32_t)g[i].w * g[i].h;
+        if (g[i].w > FONT_MAX_WIDTH) return false;
+        if ((g[i].bitmap & 0xFFFFFF) + (bits + 7) / 8 > bitmapSize) return false;
+    }
+    for (uint16_t i = 1; i < kerns; i++) {
+        if (keys[i] <= keys[i - 1]) return false;
+    }
+    
+    _lineHeight = lineHeight;
+    _ascent = ascent;
+    _rangeCount = ranges;
+    _kernCount = kerns;
+    _fallback = fallback;
+    _ranges = r;
+    _glyphs = g;
+    _kernKeys = keys;
+    _kernAdjust = adjust;
+    _bitmaps = bitmaps;
+    _glyphCount = glyphs;
+    return true;
+}
+
+uint16_t Font::glyphIndex(uint32_t codepoint) const {
+    // Last range starting at or before the code point
+    int32_t lo = 0;
+    int32_t hi = (int32_t)_rangeCount - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        const Range& r = _ranges[mid];
+        if (codepoint < r.first) {
+            hi = mid - 1;
+        } else if (codepoint - r.first >= r.count) {
+            lo = mid + 1;
+        } else {
+            return r.glyph + (codepoint - r.first);
+        }
+    }
+    return FONT_NO_GLYPH;
+}
+
+uint16_t Font::glyphOrFallback(uint32_t codepoint) const {
+    uint16_t index = glyphIndex(codepoint);
+    return index != FONT_NO_GLYPH ? index : _fallback;
+}
+
+int8_t Font::kerning(uint16_t left, uint16_t right) const {
+    uint32_t key = ((uint32_t)left << 16) | right;
+    int32_t lo = 0;
+    int32_t hi = (int32_t)_kernCount - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if (_kernKeys[mid] < key) lo = mid + 1;
+        else if (_kernKeys[mid] > key) hi = mid - 1;
+        else return _kernAdjust[mid];
+    }
+    return 0;
+}
+
+int16_t Font::textWidth(const char* text) const {
+    if (_glyphCount == 0) return 0;
+    int16_t width = 0;
+    uint16_t previous = FONT_NO_GLYPH;
+    uint32_t cp;
+    while ((cp = utf8Next(text)) != 0) {
+        uint16_t index = glyphOrFallback(cp);
+        if (index == FONT_NO_GLYPH) continue;
+        if (previous != FONT_NO_GLYPH) width += kerning(previous, index);
+        width += _glyphs[index].advance();
+        previous = index;
+    }
+    return width;
+}
+
+// ========== SPANS ==========
+
+/**
+ * Spans of one glyph row: one per stretch of set bits
+ */
+static uint32_t rowSpans(const uint8_t* bits, uint32_t bit, uint8_t w, int16_t x, int16_t y,
+                         uint16_t color, Span* out) {
+    uint32_t n = 0;
+    uint8_t col = 0;
+    while (col < w) {
+        // Skip clear bits, a whole byte at a time when possible
+        while (col < w) {
+            uint32_t b = bit + col;
+            if ((b & 7) == 0 && col + 8 <= w && bits[b >> 3] == 0) {
+                col += 8;
+            } else if (bits[b >> 3] & (0x80 >> (b & 7))) {
+                break;
+            } else {
+                col++;
+            }
+        }
+        if (col >= w) break;
+        uint8_t start = col;
+        while (col < w && (bits[(bit + col) >> 3] & (0x80 >> ((bit + col) & 7)))) {
+            col++;
+        }
+        out[n].x = x + start;
+        out[n].y = y;
+        out[n].w = col - start;
+        out[n].color = color;
+        n++;
+    }
+    return n;
+}
+
+uint32_t Font::glyphRowSpans(uint16_t index, uint8_t row, int16_t x, int16_t y, uint16_t color,
+                             Span* spans) const {
+    const FontGlyph& g = _glyphs[index];
+    if (row >= g.h) return 0;
+    const uint8_t* bits = _bitmaps + (g.bitmap & 0xFFFFFF);
+    return rowSpans(bits, (uint32_t)row * g.w, g.w, x + g.x, y + g.y + row, color, spans);
+}
+
+int16_t Font::drawText(ST7789& display, int16_t x, int16_t y, const char* text,
+                       uint16_t color) const {
+    if (_glyphCount == 0) return x;
+    const Rect& clip = display.clipRect();
+    Span spans[FONT_SPAN_BATCH];
+    uint32_t count = 0;
+    uint16_t previous = FONT_NO_GLYPH;
+    uint32_t cp;
+    
+    while ((cp = utf8Next(text)) != 0) {
+        uint16_t index = glyphOrFallback(cp);
+        if (index == FONT_NO_GLYPH) continue;
+        if (previous != FONT_NO_GLYPH) x += kerning(previous, index);
+        previous = index;
+        const FontGlyph& g = _glyphs[index];
+        int16_t gx = x + g.x;
+        int16_t gy = y + g.y;
+        x += g.advance();
+        if (gx >= clip.x + clip.w || gx + g.w <= clip.x || gy >= clip.y + clip.h ||
+            gy + g.h <= clip.y) {
+            continue;
+        }
+        
+        // Row by row, flushing when the next row might not fit
+        const uint8_t* bits = _bitmaps + (g.bitmap & 0xFFFFFF);
+        uint32_t rowMax = FONT_ROW_SPANS(g.w);
+        for (uint8_t row = 0; row < g.h; row++) {
+            if (count + rowMax > FONT_SPAN_BATCH) {
+                display.drawSpans(spans, count);
+                count = 0;
+            }
+            count += rowSpans(bits, (uint32_t)row * g.w, g.w, gx, gy + row, color, spans + count);
+        }
+    }
+    if (count) display.drawSpans(spans, count);
+    return x;
+}
@@ -0,0 +1,195 @@
+/**
+ * font.h
+ * Sparse Unicode bitmap fonts and UTF-8 text
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Draws UTF-8 strings with fonts made by tools/fontenc.py from BDF
+ * files. A font covers any set of code points (Latin-1 letters for
+ * SSIDs, arrows and symbols, thousands of CJK glyphs) and stays in
+ * flash; nothing is copied to RAM.
+ * 
+ * Glyph lookup goes through a sorted table of code point ranges (one
+ * entry per run of consecutive code points, usually one per Unicode
+ * block used), found by binary search: O(log ranges), a handful of
+ * steps even with thousands of glyphs. Kerning pairs are a sorted
+ * table of (left glyph, right glyph) keys, also binary searched.
+ * 
+ * Glyphs are 1 bit per pixel, trimmed to their ink, with their own
+ * offset and advance, so the font can be proportional. Text is drawn
+ * transparently: every row of a glyph becomes one span per stretch
+ * of ink, and the spans of a string go to the driver in batches
+ * (drawSpans()), so no pixel buffer is needed and the background is
+ * left as it is.
+ * 
+ * Format (little endian, 4-byte aligned tables):
+ * 
+ *   header   "FNT1", line height, ascent, range count, glyph count,
+ *            kerning pair count, fallback glyph (FONT_NO_GLYPH: none),
+ *            bitmap size (uint32)
+ *   ranges   range count × (uint32 first code point, uint16 count,
+ *            uint16 first glyph), sorted
+ *   glyphs   glyph count × (uint32 bitmap offset | advance << 24,
+ *            uint8 width, height, int8 x, y from the pen and line top)
+ *   kerning  pair count × uint32 (left glyph << 16 | right glyph),
+ *            sorted; then pair count × int8 adjustment, padded to 4
+ *   bitmaps  per glyph: rows top to bottom, MSB first, bit-packed,
+ *            starting on a byte
+ * 
+ * example:
+ * 
+ * Font font;
+ * if (font.open(demo_fnt, sizeof(demo_fnt))) {
+ *     font.drawText(display, 10, 10, "Café Wi-Fi → 5 GHz", COLOR_WHITE);
+ * }
+ * 
+ */
+
+#ifndef FONT_H
+#define FONT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+
+#define FONT_HEADER_SIZE 20
+#define FONT_NO_GLYPH    0xFFFF   // < Glyph index for "not in the font"
+#define FONT_SPAN_BATCH  64       // < Spans collected before each drawSpans() (512 bytes of stack)
+#define FONT_MAX_WIDTH   127      // < Widest glyph: one row is at most FONT_SPAN_BATCH spans
+
+#define FONT_ROW_SPANS(w) (((w) + 1) / 2)   // < Most spans in a glyph row w pixels wide
+
+#define UTF8_REPLACEMENT 0xFFFD   // < Code point returned for malformed UTF-8
+
+/**
+ * Decode the next code point of a UTF-8 string
+ * 
+ * text Position in the string; moved past the character
+ * 
+ * returns the code point, 0 at the end of the string (text is not
+ * moved), or UTF8_REPLACEMENT for a malformed sequence (text moves
+ * one byte, so decoding resumes at the next one)
+ * 
+ * 
+ * Overlong forms, surrogates and values above U+10FFFF are
+ * malformed.
+ */
+uint32_t utf8Next(const char*& text);
+
+/**
+ * Glyph as stored in the font
+ */
+struct FontGlyph {
+    uint32_t bitmap;   // < Offset into the bitmaps (bits 0-23), advance (bits 24-31)
+    uint8_t w, h;      // < Size of the ink in pixels
+    int8_t x, y;       // < Top-left corner of the ink from the pen and the line top
+    
+    uint8_t advance() const { return bitmap >> 24; }
+};
+
+/**
+ * Bitmap font in flash
+ */
+class Font {
+public:
+    Font();
+    
+    /**
+     * Check a font and use it
+     * 
+     * data Font made by fontenc.py, 4-byte aligned; must stay valid
+     * size Size in bytes
+     * 
+     * returns false if the data is not a valid font (or has a glyph
+     * wider than FONT_MAX_WIDTH)
+     */
+    bool open(const uint8_t* data, size_t size);
+    
+    /**
+     * Glyph index of a code point
+     * 
+     * returns FONT_NO_GLYPH if the font does not have it
+     */
+    uint16_t glyphIndex(uint32_t codepoint) const;
+    
+    /**
+     * Glyph index to draw for a code point: its own, or the fallback
+     * glyph (U+FFFD or '?') if it has none (may be FONT_NO_GLYPH)
+     */
+    uint16_t glyphOrFallback(uint32_t codepoint) const;
+    
+    const FontGlyph& glyph(uint16_t index) const { return _glyphs[index]; }
+    
+    /**
+     * Kerning between two glyphs, in pixels (added to the advance of
+     * the left one; 0 if the pair has none)
+     */
+    int8_t kerning(uint16_t left, uint16_t right) const;
+    
+    /**
+     * Width of a string in pixels (advances and kerning)
+     */
+    int16_t textWidth(const char* text) const;
+    
+    /**
+     * Draw a string on one line
+     * 
+     * x Pen position at the start
+     * y Top of the line (the baseline is ascent() lower)
+     * text UTF-8 string (null terminated)
+     * color Text color (RGB565); the background is not touched
+     * 
+     * returns the pen position after the string
+     * 
+     * 
+     * Clipped to the display's clip rectangle; glyphs outside it cost
+     * only their lookup.
+     */
+    int16_t drawText(ST7789& display, int16_t x, int16_t y, const char* text, uint16_t color) const;
+    
+    /**
+     * Spans of one row of a glyph
+     * 
+     * index Glyph index
+     * row Row of the glyph's ink (0 - height - 1)
+     * x Pen position
+     * y Top of the line
+     * color Span color
+     * spans Where to write the spans (room for FONT_ROW_SPANS(width))
+     * 
+     * returns the number of spans written
+     * 
+     * 
+     * For renderers that draw several glyphs row by row (TextLayout).
+     */
+    uint32_t glyphRowSpans(uint16_t index, uint8_t row, int16_t x, int16_t y, uint16_t color,
+                           Span* spans) const;
+    
+    uint16_t lineHeight() const { return _lineHeight; }
+    uint16_t ascent() const { return _ascent; }
+    uint16_t glyphCount() const { return _glyphCount; }
+    uint16_t rangeCount() const { return _rangeCount; }
+    uint16_t kerningCount() const { return _kernCount; }
+
+private:
+    struct Range {
+        uint32_t first;    // < First code point
+        uint16_t count;    // < Consecutive code points
+        uint16_t glyph;    // < Glyph index of the first one
+    };
+    
+    uint16_t _lineHeight;
+    uint16_t _ascent;
+    uint16_t _rangeCount;
+    uint16_t _glyphCount;
+    uint16_t _kernCount;
+    uint16_t _fallback;
+    const Range* _ranges;
+    const FontGlyph* _glyphs;
+    const uint32_t* _kernKeys;
+    const int8_t* _kernAdjust;
+    const uint8_t* _bitmaps;
+};
+
+#endif // FONT_H
@@ -0,0 +1,39 @@
+/**
+ * font5x7.h
+ * Small bitmap font for text rendering
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Classic 5×7 pixel font covering printable ASCII (0x20 - 0x7E).
+ * Each glyph is stored as 5 column bytes. In every byte bit 0 is the
+ * top pixel and bit 6 the bottom one, bit 7 is always empty.
+ * 
+ * Glyphs are normally drawn in a 6×8 cell so there is one empty
+ * column and one empty row between characters.
+ * 
+ * example:
+ * 
+ * const uint8_t* glyph = FONT5X7[c - FONT5X7_FIRST];
+ * bool on = glyph[col] & (1 << row);
+ * 
+ */
+
+#ifndef FONT5X7_H
+#define FONT5X7_H
+
+#include <stdint.h>
+
+#define FONT5X7_WIDTH   5     // < Glyph width in pixels
+#define FONT5X7_HEIGHT  7     // < Glyph height in pixels
+#define FONT5X7_FIRST   0x20  // < First character in the table (space)
+#define FONT5X7_LAST    0x7E  // < Last character in the table (tilde)
+
+/**
+ * Glyph table, one entry per character from FONT5X7_FIRST to FONT5X7_LAST
+ * 
+ * Stored in flash (const), so it does not use any RAM.
+ */
+extern const uint8_t FONT5X7[FONT5X7_LAST - FONT5X7_FIRST + 1][FONT5X7_WIDTH];
+
+#endif // FONT5X7_H
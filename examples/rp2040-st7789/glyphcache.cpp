@@ -0,0 +1,144 @@
+/**
+ * glyphcache.cpp
+ * Implementation of the glyph cache
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "glyphcache.h"
+#include "font5x7.h"
+
+GlyphCache::GlyphCache(uint16_t* memory, uint32_t pixels, uint8_t scale)
+    : _memory(memory), _scale(scale < 1 ? 1 : (scale > 4 ? 4 : scale)), _slots(0),
+      _cellPixels(0), _used(0), _stats() {
+    _cellPixels = cellWidth() * cellHeight();
+    uint32_t slots = pixels / _cellPixels;
+    _slots = (uint8_t)(slots > GLYPH_CACHE_MAX_SLOTS ? GLYPH_CACHE_MAX_SLOTS : slots);
+    clear();
+}
+
+void GlyphCache::clear() {
+    _used = 0;
+    _mru = NONE;
+    _lru = NONE;
+    memset(_buckets, NONE, sizeof(_buckets));
+}
+
+void GlyphCache::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void GlyphCache::renderGlyph(char c, uint16_t fg, uint16_t bg, uint8_t scale, uint16_t* dst) {
+    uint8_t ch = (uint8_t)c;
+    if (ch < FONT5X7_FIRST || ch > FONT5X7_LAST) ch = '?';
+    const uint8_t* glyph = FONT5X7[ch - FONT5X7_FIRST];
+    uint16_t width = 6 * scale;
+    
+    // One row of the font at a time, each pixel and row repeated scale times
+    for (uint8_t y = 0; y < 8; y++) {
+        uint16_t* row = dst + y * scale * width;
+        for (uint8_t x = 0; x < 6; x++) {
+            uint8_t bits = (x < FONT5X7_WIDTH) ? glyph[x] : 0;
+            uint16_t color = (bits & (1 << y)) ? fg : bg;
+            for (uint8_t s = 0; s < scale; s++) {
+                row[x * scale + s] = color;
+            }
+        }
+        for (uint8_t s = 1; s < scale; s++) {
+            memcpy(row + s * width, row, width * sizeof(uint16_t));
+        }
+    }
+}
+
+// ========== LOOKUP ==========
+
+uint32_t GlyphCache::bucketOf(uint8_t c, uint32_t colors) {
+    uint32_t h = c * 0x9E3779B1u ^ colors * 0x85EBCA77u;
+    h ^= h >> 15;
+    return h & (GLYPH_CACHE_BUCKETS - 1);
+}
+
+void GlyphCache::unlink(uint8_t slot) {
+    if (_newer[slot] != NONE) _older[_newer[slot]] = _older[slot];
+    else _mru = _older[slot];
+    if (_older[slot] != NONE) _newer[_older[slot]] = _newer[slot];
+    else _lru = _newer[slot];
+}
+
+void GlyphCache::pushFront(uint8_t slot) {
+    _newer[slot] = NONE;
+    _older[slot] = _mru;
+    if (_mru != NONE) _newer[_mru] = slot;
+    _mru = slot;
+    if (_lru == NONE) _lru = slot;
+}
+
+/**
+ * Take a slot out of its bucket's chain
+ */
+void GlyphCache::unbucket(uint8_t slot) {
+    uint8_t* link = &_buckets[bucketOf(_chars[slot], _colors[slot])];
+    while (*link != slot) {
+        link = &_chain[*link];
+    }
+    *link = _chain[slot];
+}
+
+const uint16_t* GlyphCache::glyph(char c, uint16_t fg, uint16_t bg) {
+    if (_slots < 2) return nullptr;
+    uint8_t ch = (uint8_t)c;
+    if (ch < FONT5X7_FIRST || ch > FONT5X7_LAST) ch = '?';
+    uint32_t colors = ((uint32_t)fg << 16) | bg;
+    uint32_t bucket = bucketOf(ch, colors);
+    
+    for (uint8_t slot = _buckets[bucket]; slot != NONE; slot = _chain[slot]) {
+        if (_chars[slot] == ch && _colors[slot] == colors) {
+            _stats.hits++;
+            if (slot != _mru) {
+                unlink(slot);
+                pushFront(slot);
+            }
+            return slotPixels(slot);
+        }
+    }
+    
+    // Miss: a free slot while there is one, then the least recently used
+    _stats.misses++;
+    uint8_t slot;
+    if (_used < _slots) {
+        slot = _used++;
+    } else {
+        slot = _lru;
+        unlink(slot);
+        unbucket(slot);
+        _stats.evictions++;
+    }
+    _chars[slot] = ch;
+    _colors[slot] = colors;
+    _chain[slot] = _buckets[bucket];
+    _buckets[bucket] = slot;
+    pushFront(slot);
+    
+    renderGlyph(ch, fg, bg, _scale, slotPixels(slot));
+    return slotPixels(slot);
+}
+
+// ========== DRAWING ==========
+
+int16_t GlyphCache::drawText(ST7789& display, int16_t x, int16_t y, const char* text,
+                             uint16_t fg, uint16_t bg) {
+    const Rect& clip = display.clipRect();
+    int16_t w = cellWidth();
+    int16_t h = cellHeight();
+    bool rowVisible = y < clip.y + clip.h && y + h > clip.y;
+    
+    for (; *text; text++, x += w) {
+        if (!rowVisible || x + w <= clip.x || x >= clip.x + clip.w) continue;
+        const uint16_t* pixels = glyph(*text, fg, bg);
+        if (!pixels) continue;
+        // Waits for the previous cell, which the lookup above left alone
+        display.drawBufferAsync(x, y, w, h, pixels);
+    }
+    return x;
+}
@@ -0,0 +1,156 @@
+/**
+ * glyphcache.h
+ * LRU cache of rendered glyphs in RAM
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Drawing a character the usual way means reading its columns from
+ * the font in flash and expanding them into a block of RGB565 pixels,
+ * every time. GlyphCache keeps the expanded blocks of recently drawn
+ * characters in a fixed RAM arena, keyed by character and color
+ * pair, so a label that is redrawn (a value next to it changed, a
+ * screen came back) is sent by DMA straight from the cache: no font
+ * reads, no expansion.
+ * 
+ * The arena is cut into equal slots, one glyph cell each (6×8 pixels
+ * times the scale, squared: 96 bytes at scale 1, 384 at scale 2).
+ * When it is full, the least recently used glyph is replaced. A
+ * lookup is a hash of (character, foreground, background) into a
+ * bucket table, then a short chain walk; the recency order is a
+ * doubly linked list of slot numbers, so hits and replacements cost
+ * the same small constant.
+ * 
+ * drawText() sends every glyph with drawBufferAsync() and goes on
+ * with the next lookup while it is sent. The glyph being sent is the
+ * most recently used one, so the next lookup never replaces it (the
+ * cache needs at least 2 slots).
+ * 
+ * Hits, misses and replacements are counted, so the arena can be
+ * sized from the hit rate of the real screens.
+ * 
+ * example:
+ * 
+ * static uint16_t arena[64 * 48];                         // 64 glyphs at scale 1
+ * static GlyphCache glyphs(arena, sizeof(arena) / 2);
+ * glyphs.drawText(display, 10, 10, "RSSI -67 dBm", COLOR_WHITE, COLOR_BLACK);
+ * 
+ */
+
+#ifndef GLYPHCACHE_H
+#define GLYPHCACHE_H
+
+#include <stdint.h>
+#include "st7789.h"
+
+#define GLYPH_CACHE_MAX_SLOTS 128   // < Most glyphs one cache holds (bookkeeping is sized for this)
+#define GLYPH_CACHE_BUCKETS   256   // < Hash buckets (power of two)
+
+/**
+ * Cache counters since construction or the last resetStats()
+ */
+struct GlyphCacheStats {
+    uint32_t hits;           // < Glyphs found in the cache
+    uint32_t misses;         // < Glyphs rendered from the font
+    uint32_t evictions;      // < Misses that replaced another glyph
+};
+
+/**
+ * LRU cache of 5×7 font glyphs rendered in RGB565
+ */
+class GlyphCache {
+public:
+    /**
+     * memory Arena, cut into slots of one glyph cell each
+     * pixels Size of memory in pixels
+     * scale Glyph scale (1 - 4); cells are 6 × scale by 8 × scale pixels
+     */
+    GlyphCache(uint16_t* memory, uint32_t pixels, uint8_t scale = 1);
+    
+    /**
+     * Rendered cell of a character
+     * 
+     * c Character; anything outside the font is shown as '?'
+     * fg Text color (RGB565)
+     * bg Background color (RGB565)
+     * 
+     * returns the cell's pixels in the arena (cellWidth() × cellHeight(),
+     * row by row), or nullptr if the cache has fewer than 2 slots
+     * 
+     * 
+     * The pointer is valid until slots() - 1 other glyphs have been
+     * looked up.
+     */
+    const uint16_t* glyph(char c, uint16_t fg, uint16_t bg);
+    
+    /**
+     * Draw a string on one line, cell by cell
+     * 
+     * x X coordinate of the first cell's top-left corner
+     * y Y coordinate of the first cell's top-left corner
+     * text Characters to draw (null terminated)
+     * fg Text color (RGB565)
+     * bg Background color (RGB565)
+     * 
+     * returns the X coordinate after the last cell
+     * 
+     * 
+     * Clipped to the display's clip rectangle; cells right of it are
+     * not looked up. The last cell may still be on its way when this
+     * returns, like drawBufferAsync().
+     */
+    int16_t drawText(ST7789& display, int16_t x, int16_t y, const char* text, uint16_t fg,
+                     uint16_t bg);
+    
+    /**
+     * Render a cell from the font without the cache
+     * 
+     * dst cellWidth() × cellHeight() pixels
+     * 
+     * 
+     * What a miss does; also the uncached way of drawing text.
+     */
+    static void renderGlyph(char c, uint16_t fg, uint16_t bg, uint8_t scale, uint16_t* dst);
+    
+    /**
+     * Forget all glyphs (the counters are kept)
+     */
+    void clear();
+    
+    const GlyphCacheStats& stats() const { return _stats; }
+    void resetStats();
+    
+    uint8_t slots() const { return _slots; }
+    uint8_t scale() const { return _scale; }
+    uint16_t cellWidth() const { return 6 * _scale; }
+    uint16_t cellHeight() const { return 8 * _scale; }
+
+private:
+    static const uint8_t NONE = 0xFF;   // < End of a list
+    
+    uint16_t* _memory;
+    uint8_t _scale;
+    uint8_t _slots;
+    uint16_t _cellPixels;
+    uint8_t _used;                      // < Slots holding a glyph (filled in order before replacing)
+    GlyphCacheStats _stats;
+    
+    // Per slot
+    uint8_t _chars[GLYPH_CACHE_MAX_SLOTS];
+    uint32_t _colors[GLYPH_CACHE_MAX_SLOTS];    // < fg << 16 | bg
+    uint8_t _chain[GLYPH_CACHE_MAX_SLOTS];      // < Next slot in the same bucket
+    uint8_t _newer[GLYPH_CACHE_MAX_SLOTS];      // < Recency list, towards _mru
+    uint8_t _older[GLYPH_CACHE_MAX_SLOTS];      // < Recency list, towards _lru
+    uint8_t _mru;
+    uint8_t _lru;
+    
+    uint8_t _buckets[GLYPH_CACHE_BUCKETS];      // < First slot of each bucket
+    
+    static uint32_t bucketOf(uint8_t c, uint32_t colors);
+    uint16_t* slotPixels(uint8_t slot) const { return _memory + slot * _cellPixels; }
+    void unlink(uint8_t slot);
+    void pushFront(uint8_t slot);
+    void unbucket(uint8_t slot);
+};
+
+#endif // GLYPHCACHE_H
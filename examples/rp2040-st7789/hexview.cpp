@@ -0,0 +1,294 @@
+/**
+ * hexview.cpp
+ * Implementation of the hex dump viewer
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "hexview.h"
+#include "font5x7.h"
+#include <string.h>
+
+/**
+ * Foreground / background color of each role (RGB565)
+ */
+static const uint16_t HEX_ROLE_FG[HexView::ROLE_COUNT] = {
+    0x07FF,  // Offset: cyan
+    0xFFFF,  // Hex: white
+    0x0000,  // Selected hex: black
+    0x07E0,  // ASCII: green
+    0x0000   // Selected ASCII: black
+};
+static const uint16_t HEX_ROLE_BG[HexView::ROLE_COUNT] = {
+    0x0000,  // Offset: on black
+    0x0000,  // Hex: on black
+    0xFFE0,  // Selected hex: on yellow
+    0x0000,  // ASCII: on black
+    0xFFE0   // Selected ASCII: on yellow
+};
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/**
+ * Constructor implementation
+ * 
+ * 
+ * Pre-renders the hex digit glyphs. RAM only: the display is not
+ * touched until setData() and refresh() are called, so a viewer can
+ * be constructed before the display is initialized.
+ */
+HexView::HexView(ST7789& display)
+    : _display(display), _data(nullptr), _size(0) {
+    buildGlyphCache();
+    resetView(nullptr, 0);
+}
+
+/**
+ * Render '0'-'F' for every hex role into RAM
+ * 
+ * Each glyph is stored as 8 rows of 6 pixels, ready to be copied
+ * row by row into the line buffer.
+ */
+void HexView::buildGlyphCache() {
+    for (int role = 0; role < ROLE_ASCII; role++) {
+        for (int digit = 0; digit < 16; digit++) {
+            const uint8_t* glyph = FONT5X7[HEX_DIGITS[digit] - FONT5X7_FIRST];
+            uint16_t* dst = _hexGlyphs[role][digit];
+            for (int y = 0; y < HEX_CELL_H; y++) {
+                for (int x = 0; x < HEX_CELL_W; x++) {
+                    bool on = x < FONT5X7_WIDTH && (glyph[x] & (1 << y));
+                    dst[y * HEX_CELL_W + x] = on ? HEX_ROLE_FG[role] : HEX_ROLE_BG[role];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Set viewed buffer
+ * 
+ * 
+ * The offset column gets as many digits as the largest offset needs
+ * (at least 5), so a 1 MB buffer shows 5 digits and leaves room for
+ * the 8 hex bytes and the ASCII column in 40 cells.
+ */
+void HexView::setData(const uint8_t* data, size_t size) {
+    resetView(data, size);
+    _display.setScrollArea(0, 0);
+}
+
+/**
+ * Point the view at a buffer and forget the screen content (RAM only)
+ */
+void HexView::resetView(const uint8_t* data, size_t size) {
+    _data = data;
+    _size = size;
+    _rowCount = (size + HEX_BYTES_PER_ROW - 1) / HEX_BYTES_PER_ROW;
+    
+    _offsetDigits = 5;
+    while (_offsetDigits < 7 && size > (1UL << (4 * _offsetDigits))) {
+        _offsetDigits++;
+    }
+    
+    _topRow = 0;
+    _drawnTopRow = 0;
+    _physTop = 0;
+    _hasSelection = false;
+    _cellsDrawn = 0;
+    _windowsSent = 0;
+    
+    // Screen content is unknown: invalidate the shadow; refresh() sends the scroll start
+    memset(_shadow, 0, sizeof(_shadow));
+    _scrollPending = true;
+}
+
+void HexView::scrollTo(size_t offset) {
+    size_t row = offset / HEX_BYTES_PER_ROW;
+    size_t maxTop = (_rowCount > HEX_ROWS) ? _rowCount - HEX_ROWS : 0;
+    _topRow = (row > maxTop) ? maxTop : row;
+}
+
+void HexView::scrollBy(int rows) {
+    if (rows < 0 && (size_t)-rows > _topRow) {
+        _topRow = 0;
+    } else {
+        scrollTo((_topRow + rows) * HEX_BYTES_PER_ROW);
+    }
+}
+
+void HexView::pageDown() {
+    scrollBy(HEX_ROWS);
+}
+
+void HexView::pageUp() {
+    scrollBy(-HEX_ROWS);
+}
+
+void HexView::setSelection(size_t start, size_t end) {
+    _selStart = start;
+    _selEnd = end;
+    _hasSelection = true;
+}
+
+void HexView::clearSelection() {
+    _hasSelection = false;
+}
+
+/**
+ * Format one buffer row into 40 cells
+ * 
+ * 
+ * Layout (5 offset digits):
+ * 
+ *   OOOOO_HH_HH_HH_HH_HH_HH_HH_HH_AAAAAAAA__
+ * 
+ * Rows past the end of the buffer, and missing bytes of the last
+ * row, are blank.
+ */
+void HexView::formatRow(size_t row, Cell* out) const {
+    for (int i = 0; i < HEX_COLS; i++) {
+        out[i].ch = ' ';
+        out[i].role = ROLE_ASCII;
+    }
+    if (row >= _rowCount) return;
+    
+    size_t offset = row * HEX_BYTES_PER_ROW;
+    
+    // ========== OFFSET ==========
+    for (int i = 0; i < _offsetDigits; i++) {
+        int shift = 4 * (_offsetDigits - 1 - i);
+        out[i].ch = HEX_DIGITS[(offset >> shift) & 0xF];
+        out[i].role = ROLE_OFFSET;
+    }
+    
+    // ========== HEX AND ASCII ==========
+    Cell* hex = out + _offsetDigits + 1;
+    Cell* ascii = hex + HEX_BYTES_PER_ROW * 3;
+    for (int i = 0; i < HEX_BYTES_PER_ROW && offset + i < _size; i++) {
+        uint8_t value = _data[offset + i];
+        bool selected = _hasSelection && offset + i >= _selStart && offset + i <= _selEnd;
+        uint8_t hexRole = selected ? ROLE_HEX_SELECTED : ROLE_HEX;
+        
+        hex[i * 3].ch = HEX_DIGITS[value >> 4];
+        hex[i * 3].role = hexRole;
+        hex[i * 3 + 1].ch = HEX_DIGITS[value & 0xF];
+        hex[i * 3 + 1].role = hexRole;
+        
+        ascii[i].ch = (value >= FONT5X7_FIRST && value <= FONT5X7_LAST) ? value : '.';
+        ascii[i].role = selected ? ROLE_ASCII_SELECTED : ROLE_ASCII;
+    }
+}
+
+/**
+ * Update display
+ * 
+ * 
+ * 1. Hardware scroll: if the top row moved by less than one screen,
+ *    rotate the frame memory mapping by the same number of rows.
+ *    Rows that stay visible keep their pixels, and their shadow
+ *    entries (stored by physical row) stay correct.
+ * 2. Diff: format every visible row and compare it with the shadow
+ *    of the physical row it lands on. Only differing cells are dirty.
+ * 3. Draw dirty cells, coalesced into runs per row.
+ */
+void HexView::refresh() {
+    // ========== HARDWARE SCROLL ==========
+    if (_topRow != _drawnTopRow) {
+        bool down = _topRow > _drawnTopRow;
+        size_t delta = down ? _topRow - _drawnTopRow : _drawnTopRow - _topRow;
+        if (delta < HEX_ROWS) {
+            if (down) {
+                _physTop = (_physTop + delta) % HEX_ROWS;
+            } else {
+                _physTop = (_physTop + HEX_ROWS - delta) % HEX_ROWS;
+            }
+            _scrollPending = true;
+        }
+        _drawnTopRow = _topRow;
+    }
+    if (_scrollPending) {
+        _display.setScrollStart(_physTop * HEX_CELL_H);
+        _scrollPending = false;
+    }
+    
+    // ========== DIFF ==========
+    Cell line[HEX_COLS];
+    for (int row = 0; row < HEX_ROWS; row++) {
+        uint8_t phys = (_physTop + row) % HEX_ROWS;
+        formatRow(_topRow + row, line);
+        
+        uint64_t dirty = 0;
+        for (int col = 0; col < HEX_COLS; col++) {
+            Cell& shadow = _shadow[phys][col];
+            if (shadow.ch != line[col].ch || shadow.role != line[col].role) {
+                shadow = line[col];
+                dirty |= 1ULL << col;
+            }
+        }
+        _dirty[phys] = dirty;
+    }
+    
+    // ========== DRAW RUNS ==========
+    for (uint8_t row = 0; row < HEX_ROWS; row++) {
+        uint64_t dirty = _dirty[row];
+        uint8_t col = 0;
+        while (dirty && col < HEX_COLS) {
+            if (!(dirty & (1ULL << col))) {
+                col++;
+                continue;
+            }
+            
+            uint8_t from = col;
+            uint8_t to = col;
+            for (uint8_t next = col + 1; next < HEX_COLS; next++) {
+                if (dirty & (1ULL << next)) {
+                    if (next - to - 1 > HEX_MERGE_GAP) break;
+                    to = next;
+                }
+            }
+            
+            drawRun(row, from, to);
+            col = to + 1;
+        }
+    }
+}
+
+/**
+ * Render cells from..to of a physical row and send them
+ * 
+ * 
+ * Hex digits in the offset/hex roles are copied from the glyph cache,
+ * everything else is expanded from the font.
+ */
+void HexView::drawRun(uint8_t row, uint8_t from, uint8_t to) {
+    uint16_t width = (to - from + 1) * HEX_CELL_W;
+    
+    for (uint8_t col = from; col <= to; col++) {
+        const Cell& cell = _shadow[row][col];
+        uint16_t* dst = &_lineBuf[(col - from) * HEX_CELL_W];
+        const char* digit = (cell.role < ROLE_ASCII) ? strchr(HEX_DIGITS, cell.ch) : nullptr;
+        
+        if (digit && *digit) {
+            // ========== CACHED HEX DIGIT ==========
+            const uint16_t* src = _hexGlyphs[cell.role][digit - HEX_DIGITS];
+            for (uint8_t y = 0; y < HEX_CELL_H; y++) {
+                memcpy(dst + y * width, src + y * HEX_CELL_W, HEX_CELL_W * sizeof(uint16_t));
+            }
+        } else {
+            // ========== FONT LOOKUP ==========
+            const uint8_t* glyph = FONT5X7[cell.ch - FONT5X7_FIRST];
+            uint16_t fg = HEX_ROLE_FG[cell.role];
+            uint16_t bg = HEX_ROLE_BG[cell.role];
+            for (uint8_t x = 0; x < HEX_CELL_W; x++) {
+                uint8_t bits = (x < FONT5X7_WIDTH) ? glyph[x] : 0;
+                for (uint8_t y = 0; y < HEX_CELL_H; y++) {
+                    dst[y * width + x] = (bits & (1 << y)) ? fg : bg;
+                }
+            }
+        }
+    }
+    
+    _display.drawBuffer(from * HEX_CELL_W, row * HEX_CELL_H, width, HEX_CELL_H, _lineBuf);
+    _cellsDrawn += to - from + 1;
+    _windowsSent++;
+}
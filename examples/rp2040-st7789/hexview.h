@@ -0,0 +1,216 @@
+/**
+ * hexview.h
+ * Hex/ASCII dump viewer for large capture buffers
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Shows a byte buffer (in RAM or memory-mapped flash) as a classic
+ * hex dump, 8 bytes per row:
+ * 
+ *   0F3A8 DE AD BE EF 00 01 02 03 ....
+ * 
+ * The buffer can be any size: only the 40 visible rows are ever
+ * formatted, straight from the source pointer, so paging through
+ * 1 MB costs the same as paging through 1 KB.
+ * 
+ * 
+ * Drawing is incremental:
+ * - A shadow copy of the characters and colors currently on screen is
+ *   kept. refresh() formats the visible rows, compares them with the
+ *   shadow and redraws only the cells that differ. When a captured
+ *   byte changes from 0x3F to 0x3E, only one nibble cell (plus its
+ *   ASCII cell) is sent.
+ * - The 16 hex digits are pre-rendered into RAM once per color, so
+ *   drawing a hex cell is a copy instead of a font lookup.
+ * - Scrolling by less than a screen uses the hardware vertical scroll:
+ *   only the rows that scroll into view are formatted and drawn.
+ * 
+ * example:
+ * 
+ * HexView view(display);
+ * view.setData(captureBuffer, captureLength);
+ * view.refresh();
+ * view.pageDown();
+ * view.refresh();
+ * 
+ */
+
+#ifndef HEXVIEW_H
+#define HEXVIEW_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+
+/**
+ * Layout constants
+ * 
+ * Cells use the 5×7 font in 6×8 pixels, like the terminal.
+ */
+#define HEX_CELL_W         6                              // < Cell width in pixels
+#define HEX_CELL_H         8                              // < Cell height in pixels
+#define HEX_COLS           (SCREEN_WIDTH / HEX_CELL_W)    // < Cells per row (40)
+#define HEX_ROWS           (SCREEN_HEIGHT / HEX_CELL_H)   // < Visible rows (40)
+#define HEX_BYTES_PER_ROW  8                              // < Bytes shown per row
+
+/**
+ * Clean cells allowed inside a coalesced run (see TERM_MERGE_GAP)
+ */
+#define HEX_MERGE_GAP 2
+
+/**
+ * Hex dump viewer widget
+ * 
+ * 
+ * Takes over the whole screen and the hardware scroll region.
+ * Uses about 13 KB of RAM (shadow grid, glyph cache, line buffer),
+ * independent of the size of the viewed buffer.
+ */
+class HexView {
+public:
+    /**
+     * Color roles
+     * 
+     * Each cell has one of these. Hex digits of the first three roles
+     * are served from the glyph cache.
+     */
+    enum Role {
+        ROLE_OFFSET,        // < Row offset column
+        ROLE_HEX,           // < Hex byte
+        ROLE_HEX_SELECTED,  // < Hex byte inside the selection
+        ROLE_ASCII,         // < ASCII column and separators
+        ROLE_ASCII_SELECTED,// < ASCII character inside the selection
+        ROLE_COUNT
+    };
+    
+    /**
+     * Constructor - creates viewer for a display
+     * 
+     * display Display to draw on (may not be initialized yet: the
+     *         constructor does not touch it)
+     * 
+     * Call setData() before the first refresh().
+     */
+    HexView(ST7789& display);
+    
+    /**
+     * Set buffer to view
+     * 
+     * data Pointer to the bytes (RAM or XIP flash address)
+     * size Number of bytes
+     * 
+     * 
+     * Resets the view to offset 0, clears the selection and marks the
+     * whole screen for redraw. The buffer is not copied - it must stay
+     * valid while the viewer uses it.
+     */
+    void setData(const uint8_t* data, size_t size);
+    
+    /**
+     * Scroll so that the row containing offset is at the top
+     * 
+     * offset Byte offset into the buffer
+     */
+    void scrollTo(size_t offset);
+    
+    /**
+     * Scroll by a number of rows (negative = up)
+     * 
+     * rows Number of rows to move
+     */
+    void scrollBy(int rows);
+    
+    /**
+     * Scroll by one screen down / up
+     */
+    void pageDown();
+    void pageUp();
+    
+    /**
+     * Highlight a range of bytes
+     * 
+     * start First selected byte offset
+     * end Last selected byte offset (inclusive)
+     */
+    void setSelection(size_t start, size_t end);
+    
+    /**
+     * Remove the highlight
+     */
+    void clearSelection();
+    
+    /**
+     * Bring the display up to date
+     * 
+     * 
+     * Applies a pending hardware scroll, formats the visible rows from
+     * the source buffer and redraws the cells that differ from what is
+     * on screen. Call it after changing the view, and whenever the
+     * underlying data may have changed (e.g. a capture is running).
+     */
+    void refresh();
+    
+    /**
+     * Byte offset of the first visible row
+     */
+    size_t topOffset() const { return _topRow * HEX_BYTES_PER_ROW; }
+    
+    /**
+     * Statistics since setData()
+     * 
+     * cellsDrawn() Number of cells sent to the display
+     * windowsSent() Number of drawBuffer() calls
+     */
+    uint32_t cellsDrawn() const { return _cellsDrawn; }
+    uint32_t windowsSent() const { return _windowsSent; }
+
+private:
+    /**
+     * One character cell on screen
+     * 
+     * The shadow grid holds the cells as they were last drawn.
+     * ch = 0 marks a cell whose screen content is unknown.
+     */
+    struct Cell {
+        uint8_t ch;    // < Character code (0x20 - 0x7E), 0 = invalid
+        uint8_t role;  // < Color role
+    };
+    
+    ST7789& _display;  // < Display to draw on
+    
+    // ========== SOURCE ==========
+    const uint8_t* _data;  // < Viewed buffer
+    size_t _size;          // < Buffer size in bytes
+    size_t _rowCount;      // < Number of rows in the buffer
+    uint8_t _offsetDigits; // < Hex digits used for the offset column
+    
+    // ========== VIEW ==========
+    size_t _topRow;        // < Buffer row shown at the top
+    size_t _drawnTopRow;   // < Buffer row at the top after the last refresh()
+    uint8_t _physTop;      // < Frame memory row holding the top row
+    bool _scrollPending;   // < setScrollStart() needed
+    size_t _selStart;      // < First selected byte
+    size_t _selEnd;        // < Last selected byte (inclusive)
+    bool _hasSelection;    // < Selection active
+    
+    // ========== SCREEN STATE ==========
+    Cell _shadow[HEX_ROWS][HEX_COLS];  // < Cells on screen, physical row order
+    uint64_t _dirty[HEX_ROWS];         // < Cells to redraw in this refresh
+    
+    // ========== RENDERING ==========
+    // Pre-rendered hex digits '0'-'F' for the offset/hex roles
+    uint16_t _hexGlyphs[ROLE_ASCII][16][HEX_CELL_W * HEX_CELL_H];
+    uint16_t _lineBuf[HEX_COLS * HEX_CELL_W * HEX_CELL_H];
+    
+    // ========== STATISTICS ==========
+    uint32_t _cellsDrawn;
+    uint32_t _windowsSent;
+    
+    void buildGlyphCache();
+    void resetView(const uint8_t* data, size_t size);
+    void formatRow(size_t row, Cell* out) const;
+    void drawRun(uint8_t row, uint8_t from, uint8_t to);
+};
+
+#endif // HEXVIEW_H
@@ -0,0 +1,858 @@
+/**
+ * jpeg.cpp
+ * Implementation of the streaming JPEG decoder
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "jpeg.h"
+#include "fixmath.h"
+#include "worker.h"
+
+// ========== TABLES ==========
+
+/**
+ * Natural (row-major) position of the k-th coefficient in zigzag order
+ */
+static const uint8_t JPEG_ZIGZAG[64] = {
+     0,  1,  8, 16,  9,  2,  3, 10,
+    17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34,
+    27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36,
+    29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46,
+    53, 60, 61, 54, 47, 55, 62, 63
+};
+
+/**
+ * AAN IDCT scale factors, Q14
+ * 
+ * The AAN IDCT leaves out a scale factor per coefficient,
+ * s(u) × s(v) with s(0) = 1 and s(k) = √2 cos(kπ/16). It is applied
+ * once per image by folding it into the quantization table, so the
+ * transform itself needs fewer multiplications.
+ */
+struct JpegAanTable {
+    int32_t v[64];
+};
+
+static constexpr JpegAanTable makeAanTable() {
+    JpegAanTable table = {};
+    for (int u = 0; u < 8; u++) {
+        for (int v = 0; v < 8; v++) {
+            double su = u ? fixConstSqrt(2) * fixConstCos(u * FIX_PI / 16) : 1.0;
+            double sv = v ? fixConstSqrt(2) * fixConstCos(v * FIX_PI / 16) : 1.0;
+            table.v[u * 8 + v] = (int32_t)(16384.0 * su * sv + 0.5);
+        }
+    }
+    return table;
+}
+
+static constexpr JpegAanTable JPEG_AAN = makeAanTable();
+
+/**
+ * YCbCr → RGB lookup tables (JFIF, full range)
+ * 
+ *   R = Y + 1.402 (Cr - 128)
+ *   G = Y - 0.344136 (Cb - 128) - 0.714136 (Cr - 128)
+ *   B = Y + 1.772 (Cb - 128)
+ * 
+ * The green terms are stored × 256 and added before rounding. The
+ * clamp table maps -256 ... 511 to 0 ... 255.
+ */
+struct JpegColorTables {
+    int16_t crR[256];
+    int16_t cbB[256];
+    int16_t cbG[256];
+    int16_t crG[256];
+    uint8_t clamp[768];
+    uint16_t gray[256];   // < Grayscale value → RGB565
+};
+
+static constexpr int16_t jpegRound(double v) {
+    return (int16_t)(v >= 0 ? v + 0.5 : v - 0.5);
+}
+
+static constexpr JpegColorTables makeColorTables() {
+    JpegColorTables t = {};
+    for (int i = 0; i < 256; i++) {
+        t.crR[i] = jpegRound(1.402 * (i - 128));
+        t.cbB[i] = jpegRound(1.772 * (i - 128));
+        t.cbG[i] = jpegRound(-0.344136 * (i - 128) * 256);
+        t.crG[i] = jpegRound(-0.714136 * (i - 128) * 256);
+        t.gray[i] = (uint16_t)(((i & 0xF8) << 8) | ((i & 0xFC) << 3) | (i >> 3));
+    }
+    for (int i = 0; i < 768; i++) {
+        int v = i - 256;
+        t.clamp[i] = (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+    return t;
+}
+
+static constexpr JpegColorTables JPEG_COLOR = makeColorTables();
+
+#define JPEG_CLAMP(v) (JPEG_COLOR.clamp[(v) + 256])
+
+// ========== HEADERS ==========
+
+JpegDecoder::JpegDecoder(ST7789& display)
+    : _display(display), _data(nullptr), _end(nullptr), _scan(nullptr), _error(JPEG_OK),
+      _width(0), _height(0), _components(0), _hMax(1), _vMax(1), _restartInterval(0),
+      _pos(nullptr), _bits(0), _bitCount(0), _marker(false),
+      _x(0), _y(0), _visX0(0), _visX1(0), _visW(0), _pixelIndex(0),
+      _coefBuf(nullptr), _jobHalf(0), _jobPixels(nullptr) {
+}
+
+bool JpegDecoder::open(const uint8_t* data, size_t size) {
+    _data = data;
+    _end = data + size;
+    _scan = nullptr;
+    _error = JPEG_OK;
+    _width = _height = 0;
+    _components = 0;
+    _restartInterval = 0;
+    for (int i = 0; i < 4; i++) {
+        _quantLoaded[i] = false;
+        _huff[i].maxCode[0] = -2;  // Marks the table as not loaded
+    }
+    
+    if (!parseHeaders()) {
+        if (_error == JPEG_OK) _error = JPEG_ERR_FORMAT;
+        _scan = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void JpegDecoder::setDualCore(int16_t* coefficients) {
+    _coefBuf = coefficients;
+}
+
+/**
+ * Walk the marker segments up to the start of the scan
+ * 
+ * 
+ * Every segment is 0xFF, marker code, 16-bit length (including the
+ * length itself), payload. SOS is followed by the entropy coded data,
+ * which is where decoding starts.
+ */
+bool JpegDecoder::parseHeaders() {
+    const uint8_t* p = _data;
+    if (_end - p < 4 || p[0] != 0xFF || p[1] != 0xD8) return false;
+    p += 2;
+    
+    while (p < _end) {
+        if (*p != 0xFF) return false;
+        while (p < _end && *p == 0xFF) p++;  // Fill bytes
+        if (p >= _end) return false;
+        uint8_t marker = *p++;
+        
+        if (marker == 0xD8 || marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue;
+        if (marker == 0xD9) return false;  // EOI before any scan
+        if (_end - p < 2) return false;
+        
+        uint16_t length = (p[0] << 8) | p[1];
+        if (length < 2 || _end - p < length) return false;
+        const uint8_t* seg = p + 2;
+        uint16_t segLength = length - 2;
+        
+        switch (marker) {
+        case 0xC0:  // Baseline
+        case 0xC1:  // Extended sequential, Huffman
+            if (!readSOF(seg, segLength)) return false;
+            break;
+        case 0xC4:
+            if (!readDHT(seg, segLength)) return false;
+            break;
+        case 0xDB:
+            if (!readDQT(seg, segLength)) return false;
+            break;
+        case 0xDD:
+            if (segLength < 2) return false;
+            _restartInterval = (seg[0] << 8) | seg[1];
+            break;
+        case 0xDA:
+            if (!readSOS(seg, segLength)) return false;
+            _scan = p + length;
+            return true;
+        case 0xEE:
+            // Adobe transform 0: RGB or CMYK samples, not YCbCr
+            if (segLength >= 12 && memcmp(seg, "Adobe", 5) == 0 && seg[11] == 0) {
+                _error = JPEG_ERR_UNSUPPORTED;
+                return false;
+            }
+            break;
+        default:
+            if ((marker >= 0xC2 && marker <= 0xCF) && marker != 0xC4 && marker != 0xC8 &&
+                marker != 0xCC) {
+                _error = JPEG_ERR_UNSUPPORTED;  // Progressive, lossless, arithmetic
+                return false;
+            }
+            break;  // APPn, COM, ...: skip
+        }
+        p += length;
+    }
+    return false;
+}
+
+/**
+ * Quantization tables
+ * 
+ * Stored in natural order, already multiplied by the AAN scale
+ * factors (Q14 → result carries 2 extra fraction bits for the IDCT).
+ */
+bool JpegDecoder::readDQT(const uint8_t* p, uint16_t length) {
+    while (length > 0) {
+        uint8_t precision = p[0] >> 4;
+        uint8_t id = p[0] & 0x0F;
+        uint16_t size = 1 + (precision ? 128 : 64);
+        if (id > 3 || precision > 1 || length < size) return false;
+        
+        for (int k = 0; k < 64; k++) {
+            uint32_t q = precision ? ((p[1 + 2 * k] << 8) | p[2 + 2 * k]) : p[1 + k];
+            uint8_t n = JPEG_ZIGZAG[k];
+            _quant[id][n] = (int32_t)((q * JPEG_AAN.v[n] + 2048) >> 12);
+        }
+        _quantLoaded[id] = true;
+        p += size;
+        length -= size;
+    }
+    return true;
+}
+
+bool JpegDecoder::readDHT(const uint8_t* p, uint16_t length) {
+    while (length > 17) {
+        uint8_t tableClass = p[0] >> 4;
+        uint8_t id = p[0] & 0x0F;
+        if (tableClass > 1 || id > 1) {
+            _error = JPEG_ERR_UNSUPPORTED;
+            return false;
+        }
+        
+        uint16_t total = 0;
+        for (int i = 0; i < 16; i++) total += p[1 + i];
+        if (total > 256 || length < 17 + total) return false;
+        
+        if (!buildHuffman(_huff[tableClass * 2 + id], p + 1, p + 17)) return false;
+        p += 17 + total;
+        length -= 17 + total;
+    }
+    return length == 0;
+}
+
+/**
+ * Canonical Huffman codes (JPEG spec annex C)
+ * 
+ * 
+ * Codes are assigned in order of length, counting up, and shifted
+ * left by one when moving to the next length. Codes of up to 9 bits
+ * fill all fast table entries that start with them.
+ * 
+ * returns false if the counts describe more codes than fit
+ */
+bool JpegDecoder::buildHuffman(HuffTable& table, const uint8_t* counts, const uint8_t* symbols) {
+    memset(table.fast, 0, sizeof(table.fast));
+    int32_t code = 0;
+    uint16_t k = 0;
+    
+    for (int length = 1; length <= 16; length++) {
+        table.valOffset[length] = (int32_t)k - code;
+        if (code + counts[length - 1] > (1 << length)) return false;
+        for (int i = 0; i < counts[length - 1]; i++) {
+            table.values[k] = symbols[k];
+            if (length <= JPEG_HUFF_FAST_BITS) {
+                int shift = JPEG_HUFF_FAST_BITS - length;
+                for (int j = 0; j < (1 << shift); j++) {
+                    table.fast[(code << shift) | j] = (uint16_t)((length << 8) | symbols[k]);
+                }
+            }
+            code++;
+            k++;
+        }
+        table.maxCode[length] = counts[length - 1] ? code - 1 : -1;
+        code <<= 1;
+    }
+    table.maxCode[0] = -1;
+    table.maxCode[17] = INT32_MAX;
+    return true;
+}
+
+/**
+ * Frame header: size, components and their sampling factors
+ */
+bool JpegDecoder::readSOF(const uint8_t* p, uint16_t length) {
+    if (length < 6) return false;
+    if (p[0] != 8) {
+        _error = JPEG_ERR_UNSUPPORTED;
+        return false;
+    }
+    _height = (p[1] << 8) | p[2];
+    _width = (p[3] << 8) | p[4];
+    _components = p[5];
+    if (_width == 0 || _height == 0) {
+        _error = JPEG_ERR_SIZE;
+        return false;
+    }
+    if (_components != 1 && _components != 3) {
+        _error = JPEG_ERR_UNSUPPORTED;
+        return false;
+    }
+    if (length < 6 + 3 * _components) return false;
+    
+    for (uint8_t i = 0; i < _components; i++) {
+        Component& c = _comp[i];
+        c.id = p[6 + 3 * i];
+        c.h = p[7 + 3 * i] >> 4;
+        c.v = p[7 + 3 * i] & 0x0F;
+        c.quant = p[8 + 3 * i] & 0x03;
+    }
+    
+    if (_components == 1) {
+        // A single component scan has one block per MCU, whatever
+        // the sampling factors say
+        _comp[0].h = _comp[0].v = 1;
+    } else {
+        // Luma 1 or 2 in each direction, chroma not subsampled twice
+        bool lumaOk = _comp[0].h >= 1 && _comp[0].h <= 2 && _comp[0].v >= 1 && _comp[0].v <= 2;
+        bool chromaOk = _comp[1].h == 1 && _comp[1].v == 1 && _comp[2].h == 1 && _comp[2].v == 1;
+        if (!lumaOk || !chromaOk) {
+            _error = JPEG_ERR_UNSUPPORTED;
+            return false;
+        }
+    }
+    _hMax = _comp[0].h;
+    _vMax = _comp[0].v;
+    return true;
+}
+
+/**
+ * Scan header: which Huffman tables each component uses
+ */
+bool JpegDecoder::readSOS(const uint8_t* p, uint16_t length) {
+    if (_components == 0 || length < 1) return false;
+    uint8_t count = p[0];
+    if (count != _components) {
+        _error = JPEG_ERR_UNSUPPORTED;  // Non-interleaved scans
+        return false;
+    }
+    if (length < 4 + 2 * count) return false;
+    
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t id = p[1 + 2 * i];
+        uint8_t tables = p[2 + 2 * i];
+        Component* c = nullptr;
+        for (uint8_t j = 0; j < _components; j++) {
+            if (_comp[j].id == id) c = &_comp[j];
+        }
+        if (!c || (tables >> 4) > 1 || (tables & 0x0F) > 1) return false;
+        c->dcTable = tables >> 4;
+        c->acTable = tables & 0x0F;
+        
+        if (!_quantLoaded[c->quant]) return false;
+        if (_huff[c->dcTable].maxCode[0] == -2 || _huff[2 + c->acTable].maxCode[0] == -2) {
+            return false;
+        }
+    }
+    
+    // Spectral selection 0-63 and no successive approximation
+    const uint8_t* s = p + 1 + 2 * count;
+    if (s[0] != 0 || s[1] != 63 || s[2] != 0) {
+        _error = JPEG_ERR_UNSUPPORTED;
+        return false;
+    }
+    return true;
+}
+
+// ========== BIT READER ==========
+
+void JpegDecoder::resetBits() {
+    _bits = 0;
+    _bitCount = 0;
+    _marker = false;
+}
+
+/**
+ * Top up the bit buffer to at least 25 bits
+ * 
+ * 
+ * In entropy coded data a 0xFF byte is followed by a stuffed 0x00,
+ * which is skipped. Any other byte after 0xFF is a marker: reading
+ * stops there and zeros are fed instead, the marker is handled by
+ * restart() or ends the image.
+ */
+void JpegDecoder::fillBits() {
+    while (_bitCount <= 24) {
+        uint32_t byte = 0;
+        if (!_marker && _pos < _end) {
+            byte = *_pos;
+            if (byte == 0xFF) {
+                uint8_t next = (_pos + 1 < _end) ? _pos[1] : 0xD9;
+                if (next == 0x00) {
+                    _pos += 2;
+                } else {
+                    _marker = true;
+                    byte = 0;
+                }
+            } else {
+                _pos++;
+            }
+        }
+        _bits |= byte << (24 - _bitCount);
+        _bitCount += 8;
+    }
+}
+
+uint32_t JpegDecoder::getBits(uint8_t n) {
+    if (n == 0) return 0;
+    if (_bitCount < n) fillBits();
+    uint32_t value = _bits >> (32 - n);
+    _bits <<= n;
+    _bitCount -= n;
+    return value;
+}
+
+/**
+ * Decode one Huffman symbol, -1 for an invalid code
+ */
+int32_t JpegDecoder::decodeHuffman(const HuffTable& table) {
+    if (_bitCount < 16) fillBits();
+    
+    uint16_t entry = table.fast[_bits >> (32 - JPEG_HUFF_FAST_BITS)];
+    if (entry) {
+        uint8_t length = entry >> 8;
+        _bits <<= length;
+        _bitCount -= length;
+        return entry & 0xFF;
+    }
+    
+    for (int length = JPEG_HUFF_FAST_BITS + 1; length <= 16; length++) {
+        int32_t code = (int32_t)(_bits >> (32 - length));
+        if (code <= table.maxCode[length]) {
+            _bits <<= length;
+            _bitCount -= length;
+            return table.values[code + table.valOffset[length]];
+        }
+    }
+    return -1;
+}
+
+/**
+ * Sign-extend an n-bit coefficient (JPEG spec F.2.2.1)
+ * 
+ * Values with the top bit clear are negative: 0 ... 2^(n-1) - 1 map
+ * to -(2^n - 1) ... -2^(n-1).
+ */
+static inline int32_t jpegExtend(uint32_t value, uint8_t n) {
+    return value < (1u << (n - 1)) ? (int32_t)value - (1 << n) + 1 : (int32_t)value;
+}
+
+/**
+ * Decode the coefficients of one 8×8 block
+ * 
+ * coef Receives 64 coefficients in natural order
+ * dcOnly Set to true if all AC coefficients are zero
+ */
+bool JpegDecoder::decodeBlock(Component& c, int16_t* coef, bool* dcOnly) {
+    memset(coef, 0, 64 * sizeof(int16_t));
+    
+    // ========== DC ==========
+    int32_t s = decodeHuffman(_huff[c.dcTable]);
+    if (s < 0 || s > 11) return false;
+    if (s) c.dcPred += (int16_t)jpegExtend(getBits(s), s);
+    coef[0] = c.dcPred;
+    *dcOnly = true;
+    
+    // ========== AC ==========
+    const HuffTable& ac = _huff[2 + c.acTable];
+    for (int k = 1; k < 64;) {
+        int32_t rs = decodeHuffman(ac);
+        if (rs < 0) return false;
+        uint8_t run = rs >> 4;
+        uint8_t size = rs & 0x0F;
+        
+        if (size) {
+            k += run;
+            if (k > 63) return false;
+            coef[JPEG_ZIGZAG[k]] = (int16_t)jpegExtend(getBits(size), size);
+            *dcOnly = false;
+            k++;
+        } else if (run == 15) {
+            k += 16;  // ZRL: 16 zeros
+        } else {
+            break;    // EOB
+        }
+    }
+    return true;
+}
+
+/**
+ * Restart marker: byte align, skip RSTn, reset DC predictions
+ */
+bool JpegDecoder::restart() {
+    resetBits();
+    while (_pos + 1 < _end && !(_pos[0] == 0xFF && _pos[1] >= 0xD0 && _pos[1] <= 0xD7)) {
+        _pos++;
+    }
+    if (_pos + 1 >= _end) return false;
+    _pos += 2;
+    for (uint8_t i = 0; i < _components; i++) {
+        _comp[i].dcPred = 0;
+    }
+    return true;
+}
+
+// ========== IDCT ==========
+
+#define JPEG_FIX_1_082 277   // < 1.082392200 × 256
+#define JPEG_FIX_1_414 362   // < 1.414213562 × 256
+#define JPEG_FIX_1_847 473   // < 1.847759065 × 256
+#define JPEG_FIX_2_613 669   // < 2.613125930 × 256
+
+#define JPEG_MUL(v, c) (((v) * (c) + 128) >> 8)
+
+/**
+ * 8×8 inverse DCT
+ * 
+ * 
+ * AAN algorithm (Arai, Agui, Nakajima), the same as libjpeg's "ifast"
+ * IDCT: 5 multiplications per 1-D transform. Columns first into a
+ * 32-bit workspace, then rows. The dequantized input carries 2 extra
+ * fraction bits; the final shift by 5 removes them and the 1/8 of the
+ * 2-D transform. Columns or rows without AC values are filled with
+ * their DC value directly.
+ */
+void JpegDecoder::idctBlock(const int16_t* coef, bool dcOnly, const int32_t* quant, uint8_t* out) {
+    if (dcOnly) {
+        int32_t v = ((coef[0] * quant[0] + 16) >> 5) + 128;
+        memset(out, v < 0 ? 0 : (v > 255 ? 255 : v), 64);
+        return;
+    }
+    
+    int32_t ws[64];
+    
+    // ========== COLUMNS ==========
+    for (int col = 0; col < 8; col++) {
+        const int16_t* in = coef + col;
+        const int32_t* q = quant + col;
+        int32_t* w = ws + col;
+        
+        if (!(in[8] | in[16] | in[24] | in[32] | in[40] | in[48] | in[56])) {
+            int32_t dc = in[0] * q[0];
+            for (int i = 0; i < 8; i++) w[8 * i] = dc;
+            continue;
+        }
+        
+        // Even part
+        int32_t tmp0 = in[0] * q[0];
+        int32_t tmp1 = in[16] * q[16];
+        int32_t tmp2 = in[32] * q[32];
+        int32_t tmp3 = in[48] * q[48];
+        
+        int32_t tmp10 = tmp0 + tmp2;
+        int32_t tmp11 = tmp0 - tmp2;
+        int32_t tmp13 = tmp1 + tmp3;
+        int32_t tmp12 = JPEG_MUL(tmp1 - tmp3, JPEG_FIX_1_414) - tmp13;
+        
+        tmp0 = tmp10 + tmp13;
+        tmp3 = tmp10 - tmp13;
+        tmp1 = tmp11 + tmp12;
+        tmp2 = tmp11 - tmp12;
+        
+        // Odd part
+        int32_t tmp4 = in[8] * q[8];
+        int32_t tmp5 = in[24] * q[24];
+        int32_t tmp6 = in[40] * q[40];
+        int32_t tmp7 = in[56] * q[56];
+        
+        int32_t z13 = tmp6 + tmp5;
+        int32_t z10 = tmp6 - tmp5;
+        int32_t z11 = tmp4 + tmp7;
+        int32_t z12 = tmp4 - tmp7;
+        
+        tmp7 = z11 + z13;
+        tmp11 = JPEG_MUL(z11 - z13, JPEG_FIX_1_414);
+        int32_t z5 = JPEG_MUL(z10 + z12, JPEG_FIX_1_847);
+        tmp10 = JPEG_MUL(z12, JPEG_FIX_1_082) - z5;
+        tmp12 = JPEG_MUL(z10, -JPEG_FIX_2_613) + z5;
+        
+        tmp6 = tmp12 - tmp7;
+        tmp5 = tmp11 - tmp6;
+        tmp4 = tmp10 + tmp5;
+        
+        w[0] = tmp0 + tmp7;
+        w[56] = tmp0 - tmp7;
+        w[8] = tmp1 + tmp6;
+        w[48] = tmp1 - tmp6;
+        w[16] = tmp2 + tmp5;
+        w[40] = tmp2 - tmp5;
+        w[32] = tmp3 + tmp4;
+        w[24] = tmp3 - tmp4;
+    }
+    
+    // ========== ROWS ==========
+    for (int row = 0; row < 8; row++) {
+        const int32_t* w = ws + 8 * row;
+        uint8_t* o = out + 8 * row;
+        
+        if (!(w[1] | w[2] | w[3] | w[4] | w[5] | w[6] | w[7])) {
+            int32_t v = ((w[0] + 16) >> 5) + 128;
+            memset(o, v < 0 ? 0 : (v > 255 ? 255 : v), 8);
+            continue;
+        }
+        
+        int32_t tmp10 = w[0] + w[4];
+        int32_t tmp11 = w[0] - w[4];
+        int32_t tmp13 = w[2] + w[6];
+        int32_t tmp12 = JPEG_MUL(w[2] - w[6], JPEG_FIX_1_414) - tmp13;
+        
+        int32_t tmp0 = tmp10 + tmp13;
+        int32_t tmp3 = tmp10 - tmp13;
+        int32_t tmp1 = tmp11 + tmp12;
+        int32_t tmp2 = tmp11 - tmp12;
+        
+        int32_t z13 = w[5] + w[3];
+        int32_t z10 = w[5] - w[3];
+        int32_t z11 = w[1] + w[7];
+        int32_t z12 = w[1] - w[7];
+        
+        int32_t tmp7 = z11 + z13;
+        tmp11 = JPEG_MUL(z11 - z13, JPEG_FIX_1_414);
+        int32_t z5 = JPEG_MUL(z10 + z12, JPEG_FIX_1_847);
+        tmp10 = JPEG_MUL(z12, JPEG_FIX_1_082) - z5;
+        tmp12 = JPEG_MUL(z10, -JPEG_FIX_2_613) + z5;
+        
+        int32_t tmp6 = tmp12 - tmp7;
+        int32_t tmp5 = tmp11 - tmp6;
+        int32_t tmp4 = tmp10 + tmp5;
+        
+        int32_t v[8] = {
+            tmp0 + tmp7, tmp1 + tmp6, tmp2 + tmp5, tmp3 - tmp4,
+            tmp3 + tmp4, tmp2 - tmp5, tmp1 - tmp6, tmp0 - tmp7
+        };
+        for (int i = 0; i < 8; i++) {
+            int32_t p = ((v[i] + 16) >> 5) + 128;
+            o[i] = (uint8_t)(p < 0 ? 0 : (p > 255 ? 255 : p));
+        }
+    }
+}
+
+// ========== OUTPUT ==========
+
+/**
+ * Convert one MCU to RGB565 in the row buffer
+ * 
+ * 
+ * blocks holds the decoded 8×8 blocks in scan order: luma blocks row
+ * by row, then Cb, then Cr. Chroma covers the whole MCU and is
+ * stretched by repeating samples (2× per direction if subsampled).
+ * Only the visible columns are converted.
+ */
+void JpegDecoder::outputMcu(const uint8_t* blocks, uint16_t mcuX, uint16_t* pixels) {
+    uint16_t mcuW = mcuWidth();
+    uint16_t left = mcuX * mcuW;
+    uint16_t from = left > _visX0 ? left : _visX0;
+    uint16_t to = (left + mcuW) < _visX1 ? (left + mcuW) : _visX1;
+    uint8_t hShift = _hMax - 1;  // 0 or 1
+    uint8_t vShift = _vMax - 1;
+    const uint8_t* cb = blocks + 64 * _hMax * _vMax;
+    const uint8_t* cr = cb + 64;
+    
+    for (uint16_t ly = 0; ly < mcuHeight(); ly++) {
+        uint16_t* out = pixels + ly * _visW + (from - _visX0);
+        const uint8_t* lumaRow = blocks + 64 * ((ly >> 3) * _hMax) + (ly & 7) * 8;
+        const uint8_t* cbRow = cb + (ly >> vShift) * 8;
+        const uint8_t* crRow = cr + (ly >> vShift) * 8;
+        
+        for (uint16_t x = from; x < to; x++) {
+            uint16_t lx = x - left;
+            uint8_t luma = lumaRow[64 * (lx >> 3) + (lx & 7)];
+            
+            if (_components == 1) {
+                *out++ = JPEG_COLOR.gray[luma];
+                continue;
+            }
+            
+            uint8_t u = cbRow[lx >> hShift];
+            uint8_t v = crRow[lx >> hShift];
+            int32_t r = JPEG_CLAMP(luma + JPEG_COLOR.crR[v]);
+            int32_t g = JPEG_CLAMP(luma + ((JPEG_COLOR.cbG[u] + JPEG_COLOR.crG[v] + 128) >> 8));
+            int32_t b = JPEG_CLAMP(luma + JPEG_COLOR.cbB[u]);
+            *out++ = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+        }
+    }
+}
+
+/**
+ * Send the visible lines of one MCU row by DMA
+ */
+void JpegDecoder::flushRow(uint16_t mcuRow, uint16_t* pixels) {
+    int32_t top = _y + mcuRow * mcuHeight();
+    int32_t lines = mcuHeight();
+    if (mcuRow * mcuHeight() + lines > _height) lines = _height - mcuRow * mcuHeight();
+    
+    int32_t skip = top < 0 ? -top : 0;
+    if (top + lines > SCREEN_HEIGHT) lines = SCREEN_HEIGHT - top;
+    if (lines <= skip) return;
+    
+    _display.drawBufferAsync(_x + _visX0, top + skip, _visW, lines - skip,
+                             pixels + skip * _visW);
+}
+
+/**
+ * IDCT and color conversion of one stored MCU row (dual core mode)
+ */
+void JpegDecoder::transformRow(uint8_t half, uint16_t* pixels) {
+    uint8_t blocks[6 * 64];
+    const int16_t* coef = _coefBuf + half * JPEG_MAX_ROW_BLOCKS * 64;
+    const uint8_t* dcOnly = _blockDcOnly[half];
+    uint16_t mcuFirst = _visX0 / mcuWidth();
+    uint16_t mcuLast = (_visX1 - 1) / mcuWidth();
+    
+    for (uint16_t mcu = mcuFirst; mcu <= mcuLast; mcu++) {
+        uint8_t b = 0;
+        for (uint8_t ci = 0; ci < _components; ci++) {
+            const int32_t* quant = _quant[_comp[ci].quant];
+            for (uint8_t n = 0; n < _comp[ci].h * _comp[ci].v; n++) {
+                idctBlock(coef, *dcOnly++, quant, blocks + 64 * b++);
+                coef += 64;
+            }
+        }
+        outputMcu(blocks, mcu, pixels);
+    }
+}
+
+void JpegDecoder::transformJob(void* arg) {
+    JpegDecoder* self = (JpegDecoder*)arg;
+    self->transformRow(self->_jobHalf, self->_jobPixels);
+}
+
+// ========== DECODE ==========
+
+/**
+ * Decode loop
+ * 
+ * 
+ * Single core, for each MCU row:
+ *   Huffman + IDCT + color for each MCU → pixel buffer → DMA
+ *   (DMA of row n runs while row n + 1 is decoded)
+ * 
+ * Dual core, for each MCU row n:
+ *   core 0: Huffman decode row n into coefficient buffer n & 1
+ *   core 0: wait for core 1 (row n - 1), start DMA of row n - 1
+ *   core 1: IDCT + color of row n, while core 0 goes on with n + 1
+ */
+bool JpegDecoder::decode(int16_t x, int16_t y) {
+    if (!_scan) {
+        _error = JPEG_ERR_FORMAT;
+        return false;
+    }
+    
+    // ========== VISIBLE AREA ==========
+    _x = x;
+    _y = y;
+    int32_t x0 = x < 0 ? -x : 0;
+    int32_t x1 = (int32_t)SCREEN_WIDTH - x < _width ? (int32_t)SCREEN_WIDTH - x : _width;
+    if (x1 <= x0 || y >= SCREEN_HEIGHT || y + _height <= 0) return true;
+    _visX0 = x0;
+    _visX1 = x1;
+    _visW = x1 - x0;
+    
+    uint16_t mcuW = mcuWidth();
+    uint16_t mcuH = mcuHeight();
+    uint16_t mcuCols = (_width + mcuW - 1) / mcuW;
+    uint16_t mcuRows = (_height + mcuH - 1) / mcuH;
+    uint16_t mcuFirst = _visX0 / mcuW;
+    uint16_t mcuLast = (_visX1 - 1) / mcuW;
+    bool dual = _coefBuf != nullptr;
+    
+    _pos = _scan;
+    resetBits();
+    for (uint8_t i = 0; i < _components; i++) {
+        _comp[i].dcPred = 0;
+    }
+    if (dual) workerStart();
+    
+    int16_t coef[64];
+    uint8_t blocks[6 * 64];
+    uint32_t mcuCount = 0;
+    bool pending = false;       // A row is being transformed on core 1
+    uint16_t pendingRow = 0;
+    bool ok = true;
+    
+    for (uint16_t row = 0; row < mcuRows && ok; row++) {
+        int32_t top = y + row * mcuH;
+        if (top >= SCREEN_HEIGHT) break;  // Rest is below the screen
+        bool rowVisible = top + mcuH > 0;
+        uint8_t half = row & 1;
+        uint16_t* pixels = dual ? _pixels[half] : _pixels[_pixelIndex];
+        uint16_t stored = 0;
+        
+        // ========== ENTROPY DECODING ==========
+        for (uint16_t mcu = 0; mcu < mcuCols && ok; mcu++) {
+            if (_restartInterval && mcuCount && mcuCount % _restartInterval == 0) {
+                if (!restart()) {
+                    ok = false;
+                    break;
+                }
+            }
+            mcuCount++;
+            
+            bool visible = rowVisible && mcu >= mcuFirst && mcu <= mcuLast;
+            uint8_t b = 0;
+            for (uint8_t ci = 0; ci < _components && ok; ci++) {
+                Component& c = _comp[ci];
+                for (uint8_t n = 0; n < c.h * c.v; n++) {
+                    if (dual && visible && stored >= JPEG_MAX_ROW_BLOCKS) {
+                        _error = JPEG_ERR_UNSUPPORTED;  // Row does not fit the coefficient buffer
+                        ok = false;
+                        break;
+                    }
+                    int16_t* dst = (dual && visible)
+                        ? _coefBuf + (half * JPEG_MAX_ROW_BLOCKS + stored) * 64 : coef;
+                    bool dcOnly;
+                    if (!decodeBlock(c, dst, &dcOnly)) {
+                        ok = false;
+                        break;
+                    }
+                    if (visible) {
+                        if (dual) {
+                            _blockDcOnly[half][stored++] = dcOnly;
+                        } else {
+                            idctBlock(coef, dcOnly, _quant[c.quant], blocks + 64 * b);
+                        }
+                    }
+                    b++;
+                }
+            }
+            if (ok && visible && !dual) outputMcu(blocks, mcu, pixels);
+        }
+        if (!ok || !rowVisible) continue;
+        
+        // ========== OUTPUT ==========
+        if (!dual) {
+            flushRow(row, pixels);
+            _pixelIndex ^= 1;
+            continue;
+        }
+        if (pending) {
+            workerWait();
+            flushRow(pendingRow, _pixels[pendingRow & 1]);
+        }
+        _jobHalf = half;
+        _jobPixels = pixels;
+        workerSubmit(transformJob, this);
+        pending = true;
+        pendingRow = row;
+    }
+    
+    if (pending) {
+        workerWait();
+        flushRow(pendingRow, _pixels[pendingRow & 1]);
+    }
+    _display.waitIdle();
+    
+    if (!ok) _error = JPEG_ERR_FORMAT;
+    return ok;
+}
@@ -0,0 +1,216 @@
+/**
+ * jpeg.h
+ * Streaming baseline JPEG decoder
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Decodes a JPEG held in memory (usually flash) straight onto the
+ * display. The image is never decoded as a whole: one MCU row (8 or
+ * 16 lines, depending on the chroma subsampling) is decoded into a
+ * line buffer, sent by DMA, and the next row is decoded while the
+ * previous one is on its way to the panel.
+ * 
+ * Supported: baseline (SOF0) and extended sequential Huffman (SOF1)
+ * 8-bit images, grayscale or YCbCr with 4:4:4, 4:2:2, 4:4:0 or 4:2:0
+ * subsampling, restart markers. Not supported: progressive and
+ * arithmetic coded files (error JPEG_ERR_UNSUPPORTED).
+ * 
+ * Per block the work is:
+ * 1. Huffman decoding of the coefficients (table lookup of 9 bits,
+ *    bit-by-bit only for rare long codes)
+ * 2. Integer IDCT (AAN algorithm, 5 multiplications per 8 points,
+ *    dequantization folded into the quantization table). Blocks
+ *    with only a DC coefficient - very common - skip it.
+ * 3. YCbCr → RGB565 with lookup tables
+ * 
+ * Images larger than the screen are cropped: every block still has
+ * to be Huffman decoded, but blocks outside the screen skip steps 2
+ * and 3.
+ * 
+ * With setDualCore(), step 1 runs on core 0 and steps 2 and 3 on
+ * core 1 (see worker.h), one MCU row behind.
+ * 
+ * example:
+ * 
+ * JpegDecoder jpeg(display);
+ * if (jpeg.open(photo_jpg, sizeof(photo_jpg))) {
+ *     jpeg.decode(0, 0);
+ * }
+ * 
+ */
+
+#ifndef JPEG_H
+#define JPEG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+
+#define JPEG_MAX_COMPONENTS 3
+#define JPEG_HUFF_FAST_BITS 9   // < Codes up to 9 bits decode in one lookup
+
+/**
+ * Blocks of one MCU row that can be on screen
+ * 
+ * The most of all accepted samplings: 4:4:0 MCUs are 8 pixels wide
+ * with 4 blocks (4 × 32 = 128), more than 4:2:0 with 6 blocks per 16
+ * pixels (102). A row partly scrolled in can touch one MCU more than
+ * the screen is wide.
+ */
+#define JPEG_MAX_ROW_BLOCKS (4 * (SCREEN_WIDTH / 8 + 2))
+
+/**
+ * Coefficient buffer for setDualCore(), in int16_t elements
+ * 
+ * Two MCU rows: core 0 fills one while core 1 transforms the other.
+ */
+#define JPEG_DUAL_CORE_WORDS (2 * JPEG_MAX_ROW_BLOCKS * 64)
+
+/**
+ * Why open() or decode() failed
+ */
+enum JpegError {
+    JPEG_OK,
+    JPEG_ERR_FORMAT,       // < Not a JPEG or damaged
+    JPEG_ERR_UNSUPPORTED,  // < Progressive, arithmetic, 12-bit, ...
+    JPEG_ERR_SIZE          // < Image wider than 65535 pixels / no size
+};
+
+/**
+ * JPEG decoder
+ * 
+ * 
+ * All memory is inside the object (about 22 KB: line buffers, Huffman
+ * and quantization tables), so make it static or global rather than a
+ * local variable.
+ */
+class JpegDecoder {
+public:
+    JpegDecoder(ST7789& display);
+    
+    /**
+     * Parse the headers
+     * 
+     * data JPEG file in memory; must stay valid until decode() returns
+     * size Size in bytes
+     * 
+     * returns false if the file cannot be decoded, see error()
+     */
+    bool open(const uint8_t* data, size_t size);
+    
+    /**
+     * Image size (after open())
+     */
+    uint16_t width() const { return _width; }
+    uint16_t height() const { return _height; }
+    
+    /**
+     * Enable decoding on both cores
+     * 
+     * coefficients Buffer of JPEG_DUAL_CORE_WORDS elements, or nullptr
+     *              to decode on core 0 only
+     */
+    void setDualCore(int16_t* coefficients);
+    
+    /**
+     * Decode the image onto the display
+     * 
+     * x, y Screen position of the top-left corner (may be negative)
+     * 
+     * returns false if the data was damaged (the part decoded up to
+     * that point stays on screen)
+     */
+    bool decode(int16_t x, int16_t y);
+    
+    /**
+     * Reason for the last failure
+     */
+    JpegError error() const { return _error; }
+
+private:
+    /**
+     * Huffman table
+     * 
+     * fast: indexed by the next 9 bits, (length << 8) | symbol, or 0
+     * if the code is longer. Longer codes are found by comparing the
+     * code with the largest code of each length (JPEG spec F.2.2.3).
+     */
+    struct HuffTable {
+        uint16_t fast[1 << JPEG_HUFF_FAST_BITS];
+        int32_t maxCode[18];     // < Largest code of each length, -1 if none
+        int32_t valOffset[17];   // < values index = code + valOffset[length]
+        uint8_t values[256];
+    };
+    
+    /**
+     * Image component (Y, Cb or Cr)
+     */
+    struct Component {
+        uint8_t id;
+        uint8_t h, v;            // < Sampling factors
+        uint8_t quant;           // < Quantization table
+        uint8_t dcTable, acTable;
+        int16_t dcPred;          // < DC of the previous block
+    };
+    
+    ST7789& _display;
+    const uint8_t* _data;
+    const uint8_t* _end;
+    const uint8_t* _scan;        // < Start of the entropy coded data
+    JpegError _error;
+    
+    uint16_t _width, _height;
+    uint8_t _components;
+    uint8_t _hMax, _vMax;
+    uint16_t _restartInterval;
+    
+    Component _comp[JPEG_MAX_COMPONENTS];
+    HuffTable _huff[4];          // < DC 0, DC 1, AC 0, AC 1
+    int32_t _quant[4][64];       // < Dequantization × IDCT scale factors
+    bool _quantLoaded[4];
+    
+    // ========== BIT READER ==========
+    const uint8_t* _pos;
+    uint32_t _bits;              // < Left aligned bit buffer
+    int8_t _bitCount;
+    bool _marker;                // < Hit a marker, feeding zeros
+    
+    // ========== OUTPUT ==========
+    int16_t _x, _y;              // < Screen position of the image
+    uint16_t _visX0, _visX1;     // < Visible image columns [x0, x1)
+    uint16_t _visW;
+    uint16_t _pixels[2][16 * SCREEN_WIDTH];  // < Two MCU rows of RGB565
+    uint8_t _pixelIndex;
+    
+    // ========== DUAL CORE ==========
+    int16_t* _coefBuf;           // < Two rows of coefficient blocks
+    uint8_t _blockDcOnly[2][JPEG_MAX_ROW_BLOCKS];
+    uint8_t _jobHalf;           // < Row handed to core 1
+    uint16_t* _jobPixels;
+    
+    bool parseHeaders();
+    bool readDQT(const uint8_t* p, uint16_t length);
+    bool readDHT(const uint8_t* p, uint16_t length);
+    bool readSOF(const uint8_t* p, uint16_t length);
+    bool readSOS(const uint8_t* p, uint16_t length);
+    bool buildHuffman(HuffTable& table, const uint8_t* counts, const uint8_t* symbols);
+    
+    void resetBits();
+    void fillBits();
+    uint32_t getBits(uint8_t n);
+    int32_t decodeHuffman(const HuffTable& table);
+    bool decodeBlock(Component& c, int16_t* coef, bool* dcOnly);
+    bool restart();
+    
+    uint8_t mcuWidth() const { return 8 * _hMax; }
+    uint8_t mcuHeight() const { return 8 * _vMax; }
+    
+    void idctBlock(const int16_t* coef, bool dcOnly, const int32_t* quant, uint8_t* out);
+    void outputMcu(const uint8_t* blocks, uint16_t mcuX, uint16_t* pixels);
+    void transformRow(uint8_t half, uint16_t* pixels);
+    void flushRow(uint16_t mcuRow, uint16_t* pixels);
+    static void transformJob(void* arg);
+};
+
+#endif // JPEG_H
@@ -25,6 +25,9 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "st7789.h"
+#include "splash.h"
+#include "splash_spl.h"
+#include "bench.h"
 
 /**
  * 
@@ -43,14 +46,36 @@
 #define SPI_PORT spi0                    // < SPI peripheral instance (spi0 or spi1)
 #define SPI_BAUDRATE (32 * 1000 * 1000)  // < SPI speed: 32 MHz
 
+/**
+ * 
+ * Set to 1 to run the performance benchmarks (bench.cpp) once at
+ * startup. Results are printed to USB serial.
+ */
+#define RUN_BENCHMARKS 0
+
+/**
+ * 
+ * Milliseconds to keep the boot splash up before the demo draws over
+ * it. 0 starts the demo as soon as the splash is sent; the hold adds
+ * to every boot, so only set it to look at the splash itself.
+ */
+#define SPLASH_HOLD_MS 0
+
 /**
  * Program flow:
- * 1. Initialize USB serial output
- * 2. Create ST7789 display object
- * 3. Initialize display hardware
+ * 1. Bring up the display and start sending the boot splash
+ * 2. Initialize USB serial output while the splash is sent
+ * 3. Wait for the splash and report when it became visible
  * 4. Enter infinite loop cycling through colors
  */
 int main() {
+    // ========== BOOT SPLASH ==========
+    // First thing after reset: the panel is up about 10 ms later and
+    // the DMA sends the splash while the rest of main() runs
+    ST7789 display(SPI_PORT, PIN_CS, PIN_DC, PIN_RST, PIN_SCK, PIN_MOSI);
+    static BootSplash splash(display);  // Static: its control blocks would not fit the stack
+    bool splashShown = splash.start(SPI_BAUDRATE, splash_spl, sizeof(splash_spl));
+    
     // ========== SERIAL INITIALIZATION ==========
     stdio_init_all();  // Initialize USB serial for debugging
     
@@ -58,15 +83,23 @@ int main() {
     printf("Hardware: Raspberry Pi Pico + ST7789 LCD\n");
     
     // ========== DISPLAY INITIALIZATION ==========
-    // Create display object with pin configuration
-    ST7789 display(SPI_PORT, PIN_CS, PIN_DC, PIN_RST, PIN_SCK, PIN_MOSI);
-    
-    // Initialize hardware (SPI + display controller)
-    display.init(SPI_BAUDRATE);
+    if (splashShown) {
+        splash.wait();  // Splash sent, display on, SPI free again
+        if (SPLASH_HOLD_MS > 0) sleep_ms(SPLASH_HOLD_MS);
+        printf("Boot splash: panel ready at %lu us, first visible pixel at %lu us after boot\n",
+               splash.panelReadyUs(), splash.firstPixelUs());
+    } else {
+        display.init(SPI_BAUDRATE);  // No valid splash: the full initialization
+    }
     
     printf("Display initialized! (%dx%d pixels)\n", SCREEN_WIDTH, SCREEN_HEIGHT);
     printf("SPI baudrate: %d Hz\n", SPI_BAUDRATE);
     
+#if RUN_BENCHMARKS
+    sleep_ms(3000);  // Give the USB serial port time to connect
+    runBenchmarks(display);
+#endif
+    
     // ========== COLOR ARRAY ==========
     /**
      * Array of colors for cycling animation
@@ -0,0 +1,146 @@
+/**
+ * pipeline.cpp
+ * Implementation of the line pipeline
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "pipeline.h"
+#include "arena.h"
+
+static LinePipeline* s_pipeline = nullptr;   // < Pipeline the DMA interrupt belongs to
+
+LinePipeline::LinePipeline(ST7789& display, uint16_t* memory, uint32_t pixels, uint8_t buffers)
+    : _display(display), _memory(memory), _bufferPixels(0), _buffers(0), _dma(-1), _stats(),
+      _totalUnderruns(0), _area(), _lines(0), _pieces(0), _ready(0), _sent(0), _busy(false),
+      _idleSince(0) {
+    if (buffers >= 2 && buffers <= PIPE_MAX_BUFFERS) {
+        _buffers = buffers;
+        _bufferPixels = pixels / buffers;
+    }
+}
+
+uint32_t LinePipeline::piecePixels(uint32_t piece) const {
+    uint32_t top = piece * _lines;
+    uint32_t lines = (_area.h - top < _lines) ? _area.h - top : _lines;
+    return lines * _area.w;
+}
+
+/**
+ * Hand a piece to the DMA (interrupts off or in the handler)
+ */
+void LinePipeline::startPiece(uint32_t piece) {
+    _busy = true;
+    dma_channel_transfer_from_buffer_now(_dma, buffer(piece), piecePixels(piece));
+}
+
+// ========== INTERRUPT ==========
+
+void LinePipeline::onDmaIrq() {
+    LinePipeline* self = s_pipeline;
+    if (!self || !dma_channel_get_irq1_status(self->_dma)) return;
+    dma_channel_acknowledge_irq1(self->_dma);
+    self->onDmaDone();
+}
+
+/**
+ * A piece is on its way (its last pixels are in the SPI FIFO): start
+ * the next one if it is ready, otherwise the bus is about to idle
+ */
+void LinePipeline::onDmaDone() {
+    uint32_t sent = _sent + 1;
+    _sent = sent;
+    if (sent < _ready) {
+        startPiece(sent);
+        return;
+    }
+    _busy = false;
+    if (sent < _pieces) {
+        _stats.underruns++;
+        _idleSince = time_us_32();
+    }
+}
+
+// ========== PRODUCER ==========
+
+bool LinePipeline::run(const Rect& area, RasterFn produce, void* context, uint16_t lines) {
+    memset(&_stats, 0, sizeof(_stats));
+    Rect v = rectIntersect(area, _display.clipRect());
+    if (rectEmpty(v)) return true;
+    if (_buffers == 0 || _bufferPixels < (uint32_t)v.w) return false;
+    
+    uint32_t fit = _bufferPixels / v.w;
+    _lines = (lines == 0 || lines > fit) ? (uint16_t)(fit > (uint32_t)v.h ? v.h : fit) : lines;
+    _area = v;
+    _pieces = (v.h + _lines - 1) / _lines;
+    _ready = 0;
+    _sent = 0;
+    _busy = false;
+    
+    _dma = dma_claim_unused_channel(true);  // Only for the run: pipelines are often short-lived
+    uint32_t t0 = time_us_32();
+    _display.beginPixels(v.x, v.y, v.w, v.h);  // Window, DC high, CS low, 16-bit frames
+    
+    dma_channel_config c = dma_channel_get_default_config(_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, spi_get_dreq(_display.spi(), true));
+    dma_channel_configure(_dma, &c, &spi_get_hw(_display.spi())->dr, nullptr, 0, false);
+    
+    s_pipeline = this;
+    dma_channel_acknowledge_irq1(_dma);
+    dma_channel_set_irq1_enabled(_dma, true);
+    irq_add_shared_handler(DMA_IRQ_1, onDmaIrq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+    
+    FrameArena* arena = FrameArena::current();
+    for (uint32_t piece = 0; piece < _pieces; piece++) {
+        // The buffer is free once the piece _buffers before it was sent
+        if (piece - _sent >= _buffers) {
+            uint32_t tw = time_us_32();
+            while (piece - _sent >= _buffers) {
+                tight_loop_contents();
+            }
+            _stats.bufferWaitUs += time_us_32() - tw;
+        }
+        
+        Rect r = { v.x, (int16_t)(v.y + piece * _lines), v.w,
+                   (int16_t)(piecePixels(piece) / v.w) };
+        uint32_t tp = time_us_32();
+        uint32_t mark = arena ? arena->mark() : 0;
+        produce(context, buffer(piece), r);
+        if (arena) arena->rewind(mark);  // The piece's temporaries
+        _stats.produceUs += time_us_32() - tp;
+        
+        // Publish; if the bus went idle waiting for this piece, restart it
+        __dmb();
+        uint32_t save = save_and_disable_interrupts();
+        _ready = piece + 1;
+        if (!_busy) {
+            if (piece > 0) _stats.idleUs += time_us_32() - _idleSince;
+            startPiece(piece);
+        }
+        restore_interrupts(save);
+    }
+    
+    while (_sent < _pieces) {
+        tight_loop_contents();
+    }
+    dma_channel_set_irq1_enabled(_dma, false);
+    irq_remove_handler(DMA_IRQ_1, onDmaIrq);
+    s_pipeline = nullptr;
+    dma_channel_unclaim(_dma);
+    _dma = -1;
+    _display.waitIdle();  // Last pixels leave the SPI, CS high
+    
+    _stats.pieces = _pieces;
+    _stats.us = time_us_32() - t0;
+    _totalUnderruns += _stats.underruns;
+    return true;
+}
@@ -0,0 +1,129 @@
+/**
+ * pipeline.h
+ * Line pipeline: produce into one buffer while the DMA sends another
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Every renderer that makes pixels on the fly (gradients, decoders,
+ * tile maps, text) needs the same loop: fill a buffer while the DMA
+ * sends the one before, through one display window. LinePipeline is
+ * that loop once. It cuts the area into pieces of a few lines, calls
+ * a producer for each piece (the same render function as Rasterizer
+ * takes) and hands the pieces to its own DMA channel.
+ * 
+ * The hand-over is driven by the DMA interrupt: when a piece has been
+ * sent, the interrupt handler starts the next one right away if the
+ * producer has finished it. The SPI FIFO still holds 8 pixels (4 µs at
+ * 32 MHz) when the interrupt fires, more than the interrupt latency,
+ * so the bus never stops while the producer is ahead. With N buffers
+ * the producer may run up to N - 1 pieces ahead, which absorbs
+ * pieces that take longer than the SPI (a line with many glyphs, a
+ * decoder's slow block).
+ * 
+ * When the producer falls behind, the interrupt finds the next piece
+ * not ready and the bus goes idle: an underrun. Underruns and the bus
+ * time lost to them are counted, as is the time the producer waited
+ * for a free buffer (the SPI was the bottleneck). Underruns mean the
+ * producer is too slow on average, or its slow pieces need more
+ * buffers.
+ * 
+ * The producer runs on the calling core, in thread context; the
+ * interrupt is enabled on that core while run() is active.
+ * 
+ * example:
+ * 
+ * static uint16_t memory[3 * 2 * SCREEN_WIDTH];         // 3 buffers of 2 lines
+ * static LinePipeline pipe(display, memory, sizeof(memory) / 2, 3);
+ * pipe.run({ 0, 0, 240, 320 }, drawTiles, &map);
+ * printf("%lu underruns\n", pipe.stats().underruns);
+ * 
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include "st7789.h"
+#include "raster.h"
+
+#define PIPE_MAX_BUFFERS 8
+
+/**
+ * Numbers for the last run() call
+ */
+struct PipelineStats {
+    uint32_t us;             // < Whole call, until the last pixel left the SPI
+    uint32_t pieces;         // < Pieces produced and sent
+    uint32_t produceUs;      // < In the producer
+    uint32_t bufferWaitUs;   // < Producer waiting for a free buffer (SPI bound)
+    uint32_t underruns;      // < Times the bus went idle because the next piece was not ready
+    uint32_t idleUs;         // < Bus time lost to underruns
+};
+
+/**
+ * Multi-buffered producer → DMA pipeline over one display window
+ */
+class LinePipeline {
+public:
+    /**
+     * memory Buffer memory, split into equal buffers
+     * pixels Size of memory in pixels
+     * buffers Number of buffers (2 - PIPE_MAX_BUFFERS)
+     */
+    LinePipeline(ST7789& display, uint16_t* memory, uint32_t pixels, uint8_t buffers);
+    
+    /**
+     * Produce and send an area
+     * 
+     * area Screen area (clipped to the display's clip rectangle; the
+     *      producer is only asked for the visible part)
+     * produce Producer, called for each piece in order with the
+     *         piece's rectangle
+     * context Passed to produce
+     * lines Lines per piece, 0 for as many as fit a buffer
+     * 
+     * returns false if not even one line of the area fits a buffer
+     * 
+     * 
+     * Returns when the last pixel has left the SPI, so the display can
+     * be used straight away.
+     */
+    bool run(const Rect& area, RasterFn produce, void* context, uint16_t lines = 0);
+    
+    /**
+     * Numbers for the last run() call
+     */
+    const PipelineStats& stats() const { return _stats; }
+    
+    /**
+     * Underruns over all run() calls
+     */
+    uint32_t totalUnderruns() const { return _totalUnderruns; }
+
+private:
+    ST7789& _display;
+    uint16_t* _memory;
+    uint32_t _bufferPixels;
+    uint8_t _buffers;
+    int _dma;                   // < DMA channel, claimed for the duration of run()
+    PipelineStats _stats;
+    uint32_t _totalUnderruns;
+    
+    // The run in progress
+    Rect _area;
+    uint16_t _lines;
+    uint32_t _pieces;
+    volatile uint32_t _ready;   // < Pieces produced (thread, with interrupts off)
+    volatile uint32_t _sent;    // < Pieces sent (interrupt)
+    volatile bool _busy;        // < DMA running (interrupt, and thread with interrupts off)
+    uint32_t _idleSince;        // < When the last underrun began
+    
+    uint16_t* buffer(uint32_t piece) const { return _memory + (piece % _buffers) * _bufferPixels; }
+    uint32_t piecePixels(uint32_t piece) const;
+    void startPiece(uint32_t piece);
+    void onDmaDone();
+    static void onDmaIrq();
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,191 @@
+/**
+ * raster.cpp
+ * Implementation of the parallel renderer
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "raster.h"
+#include "worker.h"
+#include "arena.h"
+
+#define RASTER_STRIP_PIXELS (RASTER_STRIP_LINES * SCREEN_WIDTH)
+
+/**
+ * Strip buffers, two per core, each pair in the scratch bank of the
+ * core that renders into it (1920 bytes per bank; the 2 KB stack of
+ * each core takes most of the rest)
+ */
+static uint16_t __scratch_y("raster") s_strips0[2][RASTER_STRIP_PIXELS];
+static uint16_t __scratch_x("raster") s_strips1[2][RASTER_STRIP_PIXELS];
+
+/**
+ * Run the render function; what it takes from the frame arena of its
+ * core is given back afterwards
+ */
+static inline void callRender(RasterFn render, void* context, uint16_t* pixels, const Rect& r) {
+    FrameArena* arena = FrameArena::current();
+    uint32_t mark = arena ? arena->mark() : 0;
+    render(context, pixels, r);
+    if (arena) arena->rewind(mark);
+}
+
+Rasterizer::Rasterizer(ST7789& display)
+    : _display(display), _cores(2), _stats(), _area(), _render(nullptr), _context(nullptr),
+      _framebuffer(nullptr), _split(RASTER_BANDS), _strips(0), _stripsDone1(0), _stripsFreed(0) {
+}
+
+// ========== STRIP MODE ==========
+
+/**
+ * Strip s is rendered by core s & 1 into that core's buffer
+ * (s >> 1) & 1, so a buffer comes back every fourth strip
+ */
+uint16_t* Rasterizer::stripBuffer(uint32_t strip) {
+    return (strip & 1) ? s_strips1[(strip >> 1) & 1] : s_strips0[(strip >> 1) & 1];
+}
+
+Rect Rasterizer::stripArea(uint32_t strip, uint16_t lines) const {
+    int16_t top = (int16_t)(strip * lines);
+    int16_t h = (_area.h - top < lines) ? (int16_t)(_area.h - top) : (int16_t)lines;
+    Rect r = { _area.x, (int16_t)(_area.y + top), _area.w, h };
+    return r;
+}
+
+void Rasterizer::renderStrip(uint32_t strip, uint8_t core) {
+    Rect r = stripArea(strip, RASTER_STRIP_LINES);
+    uint32_t t0 = time_us_32();
+    callRender(_render, _context, stripBuffer(strip), r);
+    _stats.renderUs[core] += time_us_32() - t0;
+    _stats.pieces[core]++;
+}
+
+bool Rasterizer::renderStrips(const Rect& area, RasterFn render, void* context) {
+    if (area.w > SCREEN_WIDTH) return false;
+    
+    memset(&_stats, 0, sizeof(_stats));
+    if (rectEmpty(area)) return true;
+    _area = area;
+    _render = render;
+    _context = context;
+    _strips = (area.h + RASTER_STRIP_LINES - 1) / RASTER_STRIP_LINES;
+    _stripsDone1 = 0;
+    _stripsFreed = 0;
+    
+    _display.waitIdle();  // Strip buffers may still be on the DMA
+    uint32_t t0 = time_us_32();
+    uint8_t step = _cores;
+    if (_cores == 2) workerSubmit(stripJob, this);
+    
+    // Core 0 sends strip after strip as soon as it is ready and the
+    // SPI is free, and renders its own strips in between
+    uint32_t sent = 0;
+    uint32_t own = 0;
+    while (sent < _strips) {
+        bool ready = ((sent & 1) && _cores == 2) ? sent < _stripsDone1 : sent < own;
+        if (ready && !_display.isBusy()) {
+            __dmb();  // Strip contents are read after the counter
+            Rect r = stripArea(sent, RASTER_STRIP_LINES);
+            _display.drawBufferAsync(r.x, r.y, r.w, r.h, stripBuffer(sent));
+            __dmb();
+            _stripsFreed = sent;  // Starting a transfer ended the one before
+            sent++;
+        } else if (own < _strips && own < _stripsFreed + 4) {
+            renderStrip(own, 0);
+            own += step;
+        } else {
+            uint32_t tw = time_us_32();
+            tight_loop_contents();
+            _stats.waitUs[0] += time_us_32() - tw;
+        }
+    }
+    
+    workerWait();
+    _stats.us = time_us_32() - t0;
+    return true;
+}
+
+void Rasterizer::stripJob(void* arg) {
+    static_cast<Rasterizer*>(arg)->renderOwnStrips(1);
+}
+
+/**
+ * Core 1: the odd strips, each once its buffer is off the DMA
+ */
+void Rasterizer::renderOwnStrips(uint8_t core) {
+    for (uint32_t strip = core; strip < _strips; strip += 2) {
+        if (strip >= _stripsFreed + 4) {
+            uint32_t tw = time_us_32();
+            while (strip >= _stripsFreed + 4) {
+                tight_loop_contents();
+            }
+            _stats.waitUs[core] += time_us_32() - tw;
+        }
+        __dmb();  // Buffer is written after the DMA let go of it
+        renderStrip(strip, core);
+        __dmb();
+        _stripsDone1 = strip + 1;
+    }
+}
+
+// ========== FRAME BUFFER MODE ==========
+
+/**
+ * One core's share of the rows
+ */
+void Rasterizer::renderFramePart(uint8_t core) {
+    uint32_t t0 = time_us_32();
+    if (_cores == 1) {
+        callRender(_render, _context, _framebuffer, _area);
+        _stats.pieces[core]++;
+    } else if (_split == RASTER_BANDS) {
+        int16_t half = _area.h / 2;
+        Rect r = { _area.x, _area.y, _area.w, half };
+        if (core == 1) {
+            r.y += half;
+            r.h = _area.h - half;
+        }
+        callRender(_render, _context, _framebuffer + (uint32_t)(r.y - _area.y) * _area.w, r);
+        _stats.pieces[core]++;
+    } else {
+        uint32_t strips = (_area.h + RASTER_FRAME_LINES - 1) / RASTER_FRAME_LINES;
+        for (uint32_t strip = core; strip < strips; strip += 2) {
+            Rect r = stripArea(strip, RASTER_FRAME_LINES);
+            callRender(_render, _context, _framebuffer + (uint32_t)(r.y - _area.y) * _area.w, r);
+            _stats.pieces[core]++;
+        }
+    }
+    _stats.renderUs[core] += time_us_32() - t0;
+}
+
+void Rasterizer::frameJob(void* arg) {
+    static_cast<Rasterizer*>(arg)->renderFramePart(1);
+}
+
+bool Rasterizer::renderFrame(uint16_t* framebuffer, const Rect& area, RasterSplit split,
+                             RasterFn render, void* context) {
+    memset(&_stats, 0, sizeof(_stats));
+    if (rectEmpty(area)) return false;
+    _area = area;
+    _render = render;
+    _context = context;
+    _framebuffer = framebuffer;
+    _split = split;
+    
+    _display.waitIdle();  // Not counted: the previous transfer's time
+    uint32_t t0 = time_us_32();
+    if (_cores == 2) workerSubmit(frameJob, this);
+    renderFramePart(0);
+    
+    // Barrier: core 1's rows are written before they are sent
+    uint32_t tw = time_us_32();
+    workerWait();
+    _stats.waitUs[0] = time_us_32() - tw;
+    
+    _display.drawBufferAsync(area.x, area.y, area.w, area.h, framebuffer);
+    _stats.us = time_us_32() - t0;
+    return true;
+}
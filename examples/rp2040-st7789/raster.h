@@ -0,0 +1,165 @@
+/**
+ * raster.h
+ * Render a screen area on both cores
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * The caller supplies a render function that draws any rectangle of
+ * the area into a pixel buffer (sprites, text, a decoded image, ...).
+ * Rasterizer cuts the area into pieces and runs the function on core
+ * 0 and core 1 (worker.h) at the same time. Two modes:
+ * 
+ *   strips       No frame buffer. The area is rendered in strips of
+ *                RASTER_STRIP_LINES lines; the cores take turns
+ *                (even strips on core 0, odd strips on core 1) and
+ *                core 0 sends the strips in order by DMA while both
+ *                keep rendering. Each core renders into its own two
+ *                strip buffers in its own 4 KB scratch bank
+ *                (SCRATCH_Y for core 0, SCRATCH_X for core 1, next to
+ *                the stacks), so the cores and the DMA work in
+ *                different RAM banks.
+ *   frame buffer The caller's buffer holds the whole area. Core 1
+ *                renders the bottom half (RASTER_BANDS) or every
+ *                second strip of RASTER_FRAME_LINES lines
+ *                (RASTER_STRIPS, better when the work is not spread
+ *                evenly), core 0 the rest. Both meet at a barrier,
+ *                then one DMA transfer sends the buffer.
+ * 
+ * The render function runs on both cores at once, so it must only
+ * write to the buffer it is given and only read shared data.
+ * 
+ * example:
+ * 
+ * static void drawScene(void* context, uint16_t* pixels, const Rect& area) {
+ *     // area.w × area.h pixels, row by row, for the screen area given
+ * }
+ * 
+ * static Rasterizer raster(display);
+ * raster.renderStrips({ 0, 0, 240, 320 }, drawScene, &scene);
+ * 
+ */
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdint.h>
+#include "st7789.h"
+#include "rect.h"
+
+#define RASTER_STRIP_LINES 2   // < Strip height in strip mode (two strips per core fit a scratch bank)
+#define RASTER_FRAME_LINES 8   // < Strip height for RASTER_STRIPS in frame buffer mode
+
+/**
+ * How the frame buffer is split between the cores
+ */
+enum RasterSplit {
+    RASTER_BANDS,   // < Top half on core 0, bottom half on core 1
+    RASTER_STRIPS   // < Strips taken in turns
+};
+
+/**
+ * Render function
+ * 
+ * context The pointer given to the render call
+ * pixels area.w × area.h RGB565 pixels to fill, row by row
+ * area Screen rectangle these pixels belong to
+ */
+typedef void (*RasterFn)(void* context, uint16_t* pixels, const Rect& area);
+
+/**
+ * Where the time went in the last render call
+ * 
+ * Index 0 is core 0, index 1 core 1. In strip mode core 0 waits for
+ * strips from core 1 or for the SPI, core 1 for a free buffer; in
+ * frame buffer mode core 0 waits at the barrier. us minus renderUs is
+ * the overhead of splitting and synchronizing.
+ */
+struct RasterStats {
+    uint32_t us;            // < Whole call (without waiting for an earlier transfer)
+    uint32_t renderUs[2];   // < In the render function
+    uint32_t waitUs[2];     // < Waiting for the other side
+    uint32_t pieces[2];     // < Strips or bands rendered
+};
+
+/**
+ * Parallel renderer
+ */
+class Rasterizer {
+public:
+    Rasterizer(ST7789& display);
+    
+    /**
+     * Use core 1 or not
+     * 
+     * cores 2 (default) or 1; with 1 everything runs on core 0 the same
+     *       way, for comparison
+     */
+    void setCores(uint8_t cores) { _cores = (cores == 1) ? 1 : 2; }
+    
+    /**
+     * Render and send an area strip by strip
+     * 
+     * area Screen area, at most SCREEN_WIDTH wide (clipped like
+     *      drawBufferAsync())
+     * render Render function
+     * context Passed to render
+     * 
+     * returns false if the area is too wide
+     * 
+     * 
+     * Returns once the last strip is on the DMA.
+     */
+    bool renderStrips(const Rect& area, RasterFn render, void* context);
+    
+    /**
+     * Render into a frame buffer, then send it
+     * 
+     * framebuffer area.w × area.h pixels
+     * area Screen area (clipped like drawBufferAsync())
+     * split How the rows are shared between the cores
+     * render Render function
+     * context Passed to render
+     * 
+     * returns false if the area is empty
+     * 
+     * 
+     * Waits for a running transfer first (it may still be reading the
+     * buffer) and returns with the buffer on the DMA, like
+     * drawBufferAsync(): call waitIdle() before touching it.
+     */
+    bool renderFrame(uint16_t* framebuffer, const Rect& area, RasterSplit split,
+                     RasterFn render, void* context);
+    
+    /**
+     * Numbers for the last render call
+     */
+    const RasterStats& stats() const { return _stats; }
+
+private:
+    ST7789& _display;
+    uint8_t _cores;
+    RasterStats _stats;
+    
+    // The call being rendered
+    Rect _area;
+    RasterFn _render;
+    void* _context;
+    uint16_t* _framebuffer;
+    RasterSplit _split;
+    uint16_t _strips;
+    
+    volatile uint32_t _stripsDone1;   // < Strips rendered by core 1 (written by core 1)
+    volatile uint32_t _stripsFreed;   // < Strips whose buffers are free again (written by core 0)
+    
+    uint16_t* stripBuffer(uint32_t strip);
+    Rect stripArea(uint32_t strip, uint16_t lines) const;
+    void renderStrip(uint32_t strip, uint8_t core);
+    void renderOwnStrips(uint8_t core);
+    static void stripJob(void* arg);
+    
+    void renderFramePart(uint8_t core);
+    static void frameJob(void* arg);
+};
+
+#endif // RASTER_H
@@ -0,0 +1,71 @@
+/**
+ * rect.h
+ * Screen rectangle type and helpers
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * A rectangle is a top-left corner plus a size. Signed coordinates so
+ * that things partly off screen (an element sliding in from the left)
+ * can be described; clip with rectIntersect() before drawing.
+ * A width or height of 0 or less means empty.
+ * 
+ */
+
+#ifndef RECT_H
+#define RECT_H
+
+#include <stdint.h>
+
+/**
+ * Rectangle on screen
+ */
+struct Rect {
+    int16_t x, y;  // < Top-left corner
+    int16_t w, h;  // < Size in pixels
+};
+
+static inline bool rectEmpty(const Rect& r) {
+    return r.w <= 0 || r.h <= 0;
+}
+
+static inline int32_t rectArea(const Rect& r) {
+    return rectEmpty(r) ? 0 : (int32_t)r.w * r.h;
+}
+
+/**
+ * Overlapping part of two rectangles (empty if they do not overlap)
+ */
+static inline Rect rectIntersect(const Rect& a, const Rect& b) {
+    int16_t x0 = a.x > b.x ? a.x : b.x;
+    int16_t y0 = a.y > b.y ? a.y : b.y;
+    int16_t x1 = (a.x + a.w) < (b.x + b.w) ? (a.x + a.w) : (b.x + b.w);
+    int16_t y1 = (a.y + a.h) < (b.y + b.h) ? (a.y + a.h) : (b.y + b.h);
+    Rect r = { x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+    return r;
+}
+
+/**
+ * Smallest rectangle containing both (an empty one is ignored)
+ */
+static inline Rect rectUnion(const Rect& a, const Rect& b) {
+    if (rectEmpty(a)) return b;
+    if (rectEmpty(b)) return a;
+    int16_t x0 = a.x < b.x ? a.x : b.x;
+    int16_t y0 = a.y < b.y ? a.y : b.y;
+    int16_t x1 = (a.x + a.w) > (b.x + b.w) ? (a.x + a.w) : (b.x + b.w);
+    int16_t y1 = (a.y + a.h) > (b.y + b.h) ? (a.y + a.h) : (b.y + b.h);
+    Rect r = { x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+    return r;
+}
+
+/**
+ * True if inner lies completely inside outer
+ */
+static inline bool rectContains(const Rect& outer, const Rect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w &&
+           inner.y + inner.h <= outer.y + outer.h;
+}
+
+#endif // RECT_H
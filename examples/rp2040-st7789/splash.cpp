@@ -0,0 +1,141 @@
+/**
+ * splash.cpp
+ * Implementation of the boot splash
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "splash.h"
+#include "bytes.h"
+
+#define SPLASH_FILL 0x80000000u   // < Run count flag: one color repeated
+
+static BootSplash* s_splash = nullptr;   // < Splash the DMA interrupt belongs to
+
+BootSplash::BootSplash(ST7789& display)
+    : _display(display), _control(-1), _data(-1), _done(false), _started(false), _startUs(0),
+      _panelReadyUs(0), _firstPixelUs(0), _blocks() {
+}
+
+bool BootSplash::start(uint32_t baudrate, const uint8_t* image, size_t size) {
+    _startUs = time_us_32();
+    
+    // ========== CHECK THE PICTURE ==========
+    if (_started || size < SPLASH_HEADER_SIZE || memcmp(image, "SPL1", 4) != 0) return false;
+    uint16_t x = read16(image + 4);
+    uint16_t y = read16(image + 6);
+    uint16_t w = read16(image + 8);
+    uint16_t h = read16(image + 10);
+    uint16_t runs = read16(image + 12);
+    uint16_t poolSize = read16(image + 14);
+    if (w == 0 || h == 0 || x + w > SCREEN_WIDTH || y + h > SCREEN_HEIGHT) return false;
+    if (runs == 0 || runs > SPLASH_MAX_RUNS) return false;
+    if (SPLASH_HEADER_SIZE + runs * 8u + poolSize * 2u > size) return false;
+    
+    const uint8_t* runData = image + SPLASH_HEADER_SIZE;
+    const uint16_t* pool = (const uint16_t*)(runData + runs * 8u);
+    uint32_t pixels = 0;
+    for (uint16_t i = 0; i < runs; i++) {
+        uint32_t count = read32(runData + i * 8) & ~SPLASH_FILL;
+        uint32_t first = read32(runData + i * 8 + 4);
+        bool fill = read32(runData + i * 8) & SPLASH_FILL;
+        if (count == 0 || count > (uint32_t)w * h || first >= poolSize) return false;
+        if (!fill && count > poolSize - first) return false;
+        pixels += count;
+    }
+    if (pixels != (uint32_t)w * h) return false;
+    
+    // ========== PANEL ==========
+    _started = true;
+    _display.initQuick(baudrate);
+    _panelReadyUs = time_us_32();
+    
+    // ========== CONTROL BLOCKS ==========
+    // The data channel sends 16-bit pixels to the SPI when it has room
+    // and chains to the control channel after every run. IRQ_QUIET: no
+    // interrupt per run, only for the null trigger at the end.
+    spi_inst_t* spi = _display.spi();
+    _control = dma_claim_unused_channel(true);
+    _data = dma_claim_unused_channel(true);
+    
+    dma_channel_config c = dma_channel_get_default_config(_data);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, spi_get_dreq(spi, true));
+    channel_config_set_chain_to(&c, _control);
+    channel_config_set_irq_quiet(&c, true);
+    channel_config_set_read_increment(&c, false);
+    uint32_t fillCtrl = channel_config_get_ctrl_value(&c);
+    channel_config_set_read_increment(&c, true);
+    uint32_t literalCtrl = channel_config_get_ctrl_value(&c);
+    
+    volatile void* dr = &spi_get_hw(spi)->dr;
+    for (uint16_t i = 0; i < runs; i++) {
+        uint32_t count = read32(runData + i * 8);
+        uint32_t first = read32(runData + i * 8 + 4);
+        _blocks[i].ctrl = (count & SPLASH_FILL) ? fillCtrl : literalCtrl;
+        _blocks[i].read = pool + first;
+        _blocks[i].write = dr;
+        _blocks[i].count = count & ~SPLASH_FILL;
+    }
+    // End: a zero count is a null trigger, which only raises the
+    // data channel's interrupt
+    _blocks[runs].ctrl = fillCtrl;
+    _blocks[runs].read = nullptr;
+    _blocks[runs].write = dr;
+    _blocks[runs].count = 0;
+    
+    // The control channel writes the 4 words of a block to the data
+    // channel's alias 1 registers; the write ring of 16 bytes brings it
+    // back to CTRL for the next block
+    c = dma_channel_get_default_config(_control);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, 4);
+    
+    s_splash = this;
+    dma_channel_acknowledge_irq1(_data);
+    dma_channel_set_irq1_enabled(_data, true);
+    irq_add_shared_handler(DMA_IRQ_1, onDmaIrq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+    
+    // ========== START ==========
+    _display.beginPixels(x, y, w, h);  // Window, DC high, CS low, 16-bit frames
+    dma_channel_configure(_control, &c, &dma_hw->ch[_data].al1_ctrl, _blocks, 4, true);
+    return true;
+}
+
+/**
+ * Last run sent: close the window and switch the display on
+ */
+void BootSplash::onDmaIrq() {
+    BootSplash* self = s_splash;
+    if (!self || !dma_channel_get_irq1_status(self->_data)) return;
+    dma_channel_acknowledge_irq1(self->_data);
+    
+    self->_display.waitIdle();  // Last pixels leave the SPI, CS high
+    self->_display.setDisplayOn(true);
+    self->_firstPixelUs = time_us_32();
+    self->_done = true;
+}
+
+void BootSplash::wait() {
+    if (!_started) return;
+    while (!_done) {
+        tight_loop_contents();
+    }
+    if (_data < 0) return;  // Already cleaned up
+    
+    dma_channel_set_irq1_enabled(_data, false);
+    irq_remove_handler(DMA_IRQ_1, onDmaIrq);
+    s_splash = nullptr;
+    dma_channel_unclaim(_control);
+    dma_channel_unclaim(_data);
+    _control = -1;
+    _data = -1;
+}
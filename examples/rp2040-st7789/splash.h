@@ -0,0 +1,138 @@
+/**
+ * splash.h
+ * Boot splash streamed from flash by DMA
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Gets a picture on the panel as early as possible after reset.
+ * start() is meant to be the first thing main() does: it brings the
+ * panel up with the shortest waits (ST7789::initQuick()), then hands
+ * the whole picture to the DMA and returns. USB, stdio and the rest
+ * of the firmware start while the picture is sent; when the last
+ * pixel is out, a DMA interrupt switches the display on.
+ * 
+ * The picture is made with tools/splashenc.py and stays in flash. It
+ * is a list of runs, each one a count of pixels that are either all
+ * one color (a fill) or copied from a pool of pixels (literal). The
+ * DMA plays the runs itself with two channels: a control channel
+ * writes one control block per run into the data channel's
+ * registers, the data channel sends the run to the SPI (reading the
+ * one fill color over and over, or walking the literal pixels in
+ * flash) and chains back to the control channel. No CPU time is
+ * spent after start(); the control blocks take SPLASH_MAX_RUNS ×
+ * 16 bytes of RAM.
+ * 
+ * Format (little endian, 16 byte header):
+ * 
+ *   header  "SPL1", x, y, width, height, run count, pool size
+ *   runs    run count × (uint32 count, bit 31 set for a fill;
+ *           uint32 index of the first pixel in the pool)
+ *   pool    pool size × uint16 RGB565 pixels
+ * 
+ * The runs cover width × height pixels, row by row, and may cross
+ * rows.
+ * 
+ * The display must not be used until done() is true (wait()): the
+ * interrupt handler still owns the SPI.
+ * 
+ * example:
+ * 
+ * int main() {
+ *     static BootSplash splash(display);
+ *     splash.start(32000000, splash_spl, sizeof(splash_spl));
+ *     stdio_init_all();
+ *     ...
+ *     splash.wait();
+ *     printf("first pixel %lu us after boot\n", splash.firstPixelUs());
+ * }
+ * 
+ */
+
+#ifndef SPLASH_H
+#define SPLASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+
+#define SPLASH_HEADER_SIZE 16
+#define SPLASH_MAX_RUNS    255   // < Control blocks (16 bytes of RAM each), the end marker not counted
+
+/**
+ * Boot splash player
+ */
+class BootSplash {
+public:
+    BootSplash(ST7789& display);
+    
+    /**
+     * Bring the panel up and start sending the picture
+     * 
+     * baudrate SPI baud rate in Hz
+     * image Picture made by splashenc.py, in flash
+     * size Size of image in bytes
+     * 
+     * returns false if the picture is not valid (nothing was touched;
+     * call display.init() instead)
+     * 
+     * 
+     * Takes about 10 ms after power-on (the panel's reset and sleep-out
+     * times) and returns while the DMA is still sending.
+     */
+    bool start(uint32_t baudrate, const uint8_t* image, size_t size);
+    
+    /**
+     * Picture sent and display switched on
+     */
+    bool done() const { return _done; }
+    
+    /**
+     * Wait for done(), then give back the DMA channels and interrupt
+     */
+    void wait();
+    
+    /**
+     * When the picture became visible (display switched on), in µs
+     * since the timer started at boot
+     * 
+     * 
+     * The timer starts in the SDK runtime setup, a few milliseconds
+     * after reset (boot ROM and flash setup come first); those are not
+     * counted.
+     */
+    uint32_t firstPixelUs() const { return _firstPixelUs; }
+    
+    /**
+     * When start() was called and when the panel was ready for pixels,
+     * in µs since the timer started at boot
+     */
+    uint32_t startUs() const { return _startUs; }
+    uint32_t panelReadyUs() const { return _panelReadyUs; }
+
+private:
+    /**
+     * One run as the data channel's alias 1 registers: CTRL, READ_ADDR,
+     * WRITE_ADDR, TRANS_COUNT_TRIG (writing the count starts the run)
+     */
+    struct Block {
+        uint32_t ctrl;
+        const void* read;
+        volatile void* write;
+        uint32_t count;
+    };
+    
+    ST7789& _display;
+    int _control;                // < DMA channel writing the blocks
+    int _data;                   // < DMA channel sending the pixels
+    volatile bool _done;
+    bool _started;
+    uint32_t _startUs;
+    uint32_t _panelReadyUs;
+    volatile uint32_t _firstPixelUs;
+    Block _blocks[SPLASH_MAX_RUNS + 1];
+    
+    static void onDmaIrq();
+};
+
+#endif // SPLASH_H
@@ -9,6 +9,19 @@
 #include "pico/stdlib.h"
 #include "hardware/spi.h"
 #include "hardware/gpio.h"
+#include "hardware/dma.h"
+#include "hardware/watchdog.h"
+#include "hardware/structs/vreg_and_chip_reset.h"
+
+/**
+ * Rectangle from drawing call arguments; sizes beyond the int16_t
+ * range are cut, they could not be on screen anyway
+ */
+static inline Rect makeRect(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    Rect r = { x, y, (int16_t)(w > INT16_MAX ? INT16_MAX : w),
+               (int16_t)(h > INT16_MAX ? INT16_MAX : h) };
+    return r;
+}
 
 /**
  * Constructor implementation
@@ -19,8 +32,11 @@
  */
 ST7789::ST7789(spi_inst_t* spi, uint8_t cs, uint8_t dc, uint8_t rst, 
                uint8_t sck, uint8_t mosi) 
-    : _spi(spi), _cs(cs), _dc(dc), _rst(rst), _sck(sck), _mosi(mosi) {
+    : _spi(spi), _cs(cs), _dc(dc), _rst(rst), _sck(sck), _mosi(mosi),
+      _dma(-1), _dmaActive(false), _clipDepth(0), _streaming(false), _streamClipped(false),
+      _stream(), _streamVisible(), _streamPos(0), _batchWindow() {
     // Member initializer list handles all assignments
+    _clip[0] = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
 }
 
 /**
@@ -35,6 +51,7 @@ ST7789::ST7789(spi_inst_t* spi, uint8_t cs, uint8_t dc, uint8_t rst,
  * The CS (Chip Select) pin must be toggled for each transaction.
  */
 void ST7789::writeCommand(uint8_t cmd) {
+    waitIdle();        // Let a running DMA transfer finish first
     gpio_put(_dc, 0);  // DC LOW = Command mode
     gpio_put(_cs, 0);  // CS LOW = Start transaction
     spi_write_blocking(_spi, &cmd, 1);  // Send command byte
@@ -85,19 +102,25 @@ void ST7789::writeDataBuf(const uint8_t* buf, size_t len) {
  * Each coordinate is sent as 2 bytes (16-bit big-endian)
  */
 void ST7789::setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    // Parameters are sent in one CS cycle per command: toggling CS for
+    // every byte would cost more than the bytes themselves
+    uint8_t buf[4];
+    
     // Column Address Set (X coordinates)
     writeCommand(ST7789_CASET);
-    writeData(x0 >> 8);        // X start high byte
-    writeData(x0 & 0xFF);      // X start low byte
-    writeData(x1 >> 8);        // X end high byte
-    writeData(x1 & 0xFF);      // X end low byte
+    buf[0] = x0 >> 8;          // X start high byte
+    buf[1] = x0 & 0xFF;        // X start low byte
+    buf[2] = x1 >> 8;          // X end high byte
+    buf[3] = x1 & 0xFF;        // X end low byte
+    writeDataBuf(buf, 4);
     
     // Row Address Set (Y coordinates)
     writeCommand(ST7789_RASET);
-    writeData(y0 >> 8);        // Y start high byte
-    writeData(y0 & 0xFF);      // Y start low byte
-    writeData(y1 >> 8);        // Y end high byte
-    writeData(y1 & 0xFF);      // Y end low byte
+    buf[0] = y0 >> 8;          // Y start high byte
+    buf[1] = y0 & 0xFF;        // Y start low byte
+    buf[2] = y1 >> 8;          // Y end high byte
+    buf[3] = y1 & 0xFF;        // Y end low byte
+    writeDataBuf(buf, 4);
     
     // Prepare for pixel data
     writeCommand(ST7789_RAMWR);
@@ -133,18 +156,7 @@ void ST7789::setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
  * 
  */
 void ST7789::init(uint32_t baudrate) {
-    // ========== SPI INITIALIZATION ==========
-    spi_init(_spi, baudrate);  // Configure SPI peripheral
-    gpio_set_function(_sck, GPIO_FUNC_SPI);   // SCK as SPI clock
-    gpio_set_function(_mosi, GPIO_FUNC_SPI);  // MOSI as SPI data out
-    
-    // ========== GPIO INITIALIZATION ==========
-    gpio_init(_cs);   // Initialize CS pin
-    gpio_init(_dc);   // Initialize DC pin
-    gpio_init(_rst);  // Initialize RST pin
-    gpio_set_dir(_cs, GPIO_OUT);   // CS as output
-    gpio_set_dir(_dc, GPIO_OUT);   // DC as output
-    gpio_set_dir(_rst, GPIO_OUT);  // RST as output
+    initBus(baudrate);
     
     // ========== HARDWARE RESET ==========
     gpio_put(_rst, 1);   // RST HIGH
@@ -162,6 +174,84 @@ void ST7789::init(uint32_t baudrate) {
     writeCommand(ST7789_SLPOUT);
     sleep_ms(120);  // SLPOUT requires 120ms minimum
     
+    configurePanel();
+    
+    // ========== DISPLAY ON ==========
+    writeCommand(ST7789_DISPON);
+    sleep_ms(100);  // Allow display to stabilize
+}
+
+/**
+ * Fast bring-up for the boot path
+ * 
+ * 
+ * Same steps as init() with the datasheet minimum waits instead of
+ * generous ones:
+ * - RESX low for at least 10 µs
+ * - 5 ms after reset before the first command, but 120 ms if the
+ *   panel was already out of sleep (the RP2040 was reset while the
+ *   panel kept its power: RUN pin, debugger, watchdog or reboot)
+ * - 5 ms after SLPOUT before the next command
+ * No SWRESET: the hardware reset did the same. The display is left
+ * off, so the undefined frame memory after power-on is never shown.
+ */
+void ST7789::initQuick(uint32_t baudrate) {
+    initBus(baudrate);
+    
+    uint32_t cause = vreg_and_chip_reset_hw->chip_reset;
+    bool powerOn = (cause & VREG_AND_CHIP_RESET_CHIP_RESET_HAD_POR_BITS) && !watchdog_caused_reboot();
+    gpio_put(_rst, 0);   // RST LOW - trigger reset
+    sleep_us(20);
+    gpio_put(_rst, 1);   // RST HIGH - release reset
+    sleep_ms(powerOn ? 5 : 120);
+    
+    writeCommand(ST7789_SLPOUT);
+    sleep_ms(5);
+    
+    configurePanel();
+}
+
+void ST7789::setDisplayOn(bool on) {
+    writeCommand(on ? ST7789_DISPON : ST7789_DISPOFF);
+}
+
+/**
+ * SPI, DMA channel and control pins (shared by init() and initQuick())
+ */
+void ST7789::initBus(uint32_t baudrate) {
+    // ========== SPI INITIALIZATION ==========
+    spi_init(_spi, baudrate);  // Configure SPI peripheral
+    gpio_set_function(_sck, GPIO_FUNC_SPI);   // SCK as SPI clock
+    gpio_set_function(_mosi, GPIO_FUNC_SPI);  // MOSI as SPI data out
+    
+    // ========== DMA CHANNEL ==========
+    // Used by drawBufferAsync(). Paced by the SPI TX request (DREQ), so
+    // the DMA only writes when the SPI FIFO has room.
+    if (_dma < 0) {
+        _dma = dma_claim_unused_channel(true);
+    }
+    dma_channel_config dmaConfig = dma_channel_get_default_config(_dma);
+    channel_config_set_transfer_data_size(&dmaConfig, DMA_SIZE_16);
+    channel_config_set_read_increment(&dmaConfig, true);    // Walk the buffer
+    channel_config_set_write_increment(&dmaConfig, false);  // Always SPI data register
+    channel_config_set_dreq(&dmaConfig, spi_get_dreq(_spi, true));
+    dma_channel_configure(_dma, &dmaConfig, &spi_get_hw(_spi)->dr, NULL, 0, false);
+    
+    // ========== GPIO INITIALIZATION ==========
+    gpio_init(_cs);   // Initialize CS pin
+    gpio_init(_dc);   // Initialize DC pin
+    gpio_init(_rst);  // Initialize RST pin
+    gpio_set_dir(_cs, GPIO_OUT);   // CS as output
+    gpio_set_dir(_dc, GPIO_OUT);   // DC as output
+    gpio_set_dir(_rst, GPIO_OUT);  // RST as output
+    gpio_put(_cs, 1);              // No transaction yet
+    gpio_put(_rst, 1);             // Not in reset
+}
+
+/**
+ * Pixel format, orientation and inversion (after SLPOUT)
+ */
+void ST7789::configurePanel() {
     // ========== COLOR MODE CONFIGURATION ==========
     // Set to 16-bit RGB565 format
     // 0x55 = 16-bit/pixel (5-6-5 bit RGB)
@@ -180,10 +270,6 @@ void ST7789::init(uint32_t baudrate) {
     // - Try ST7789_INVOFF (0x20) instead of ST7789_INVON (0x21)
     // - Or comment out this line entirely
     writeCommand(ST7789_INVOFF);
-    
-    // ========== DISPLAY ON ==========
-    writeCommand(ST7789_DISPON);
-    sleep_ms(100);  // Allow display to stabilize
 }
 
 /**
@@ -202,7 +288,7 @@ void ST7789::fillScreen(uint16_t color) {
  * 
  * 
  * Drawing process:
- * 1. Validate and clip coordinates to screen bounds
+ * 1. Clip the rectangle to the clip rectangle
  * 2. Convert RGB565 color to 2-byte array (big-endian)
  * 3. Set drawing window to rectangle bounds
  * 4. Send color data for each pixel in the rectangle
@@ -215,14 +301,16 @@ void ST7789::fillScreen(uint16_t color) {
  *          For large rectangles, this can be slow. A buffered
  *          version would be faster but requires more RAM.
  */
-void ST7789::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
-    // ========== BOUNDARY CHECKING ==========
-    // Prevent drawing outside screen bounds
-    if (x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return;
-    
-    // Clip rectangle if it extends beyond screen
-    if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
-    if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+void ST7789::fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    // ========== CLIPPING ==========
+    // Only the part inside the clip rectangle (never larger than the
+    // screen) is sent
+    Rect r = rectIntersect(makeRect(x, y, w, h), clipRect());
+    if (rectEmpty(r)) return;
+    x = r.x;
+    y = r.y;
+    w = r.w;
+    h = r.h;
     
     // ========== COLOR PREPARATION ==========
     // Convert 16-bit color to 2-byte array (big-endian format)
@@ -260,9 +348,10 @@ void ST7789::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c
  * Very slow for drawing many pixels. Consider buffering
  *          pixel data if performance is critical.
  */
-void ST7789::drawPixel(uint16_t x, uint16_t y, uint16_t color) {
-    // Boundary check - ignore out of bounds pixels
-    if (x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return;
+void ST7789::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    // Clip check - ignore pixels outside the clip rectangle
+    const Rect& clip = clipRect();
+    if (x < clip.x || y < clip.y || x >= clip.x + clip.w || y >= clip.y + clip.h) return;
     
     // Convert color to 2-byte array
     uint8_t colorBuf[2];
@@ -272,4 +361,472 @@ void ST7789::drawPixel(uint16_t x, uint16_t y, uint16_t color) {
     // Set 1×1 pixel window and send color
     setWindow(x, y, x, y);
     writeDataBuf(colorBuf, 2);
-}
\ No newline at end of file
+}
+
+/**
+ * Draw block of pixels from buffer
+ * 
+ * 
+ * The ST7789 expects each pixel high byte first. A uint16_t in RP2040
+ * memory is stored low byte first, so sending the buffer as bytes
+ * would swap them. Switching the SPI to 16-bit frames makes the
+ * hardware send each pixel MSB first, exactly as the display wants.
+ * 
+ * When whole rows are visible (clipped at the top or bottom only) the
+ * visible rows are still one contiguous piece of the buffer.
+ */
+void ST7789::drawBuffer(int16_t x, int16_t y, uint16_t w, uint16_t h,
+                        const uint16_t* pixels) {
+    Rect visible = rectIntersect(makeRect(x, y, w, h), clipRect());
+    if (rectEmpty(visible)) return;
+    
+    const uint16_t* first = pixels + (uint32_t)(visible.y - y) * w + (visible.x - x);
+    if (visible.w != w) {
+        sendClipped(visible, w, first);
+        return;
+    }
+    
+    setWindow(visible.x, visible.y, visible.x + visible.w - 1, visible.y + visible.h - 1);
+    
+    gpio_put(_dc, 1);  // DC HIGH = Data mode
+    gpio_put(_cs, 0);  // CS LOW = Start transaction
+    spi_set_format(_spi, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    spi_write16_blocking(_spi, first, (size_t)w * visible.h);
+    spi_set_format(_spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    gpio_put(_cs, 1);  // CS HIGH = End transaction
+}
+
+/**
+ * Send a block cut at the left or right
+ * 
+ * 
+ * One window for the visible part; each row is a separate piece of
+ * the buffer, so the rows are written one after the other in the same
+ * CS cycle.
+ */
+void ST7789::sendClipped(const Rect& visible, uint16_t w, const uint16_t* pixels) {
+    setWindow(visible.x, visible.y, visible.x + visible.w - 1, visible.y + visible.h - 1);
+    
+    gpio_put(_dc, 1);  // DC HIGH = Data mode
+    gpio_put(_cs, 0);  // CS LOW = Start transaction
+    spi_set_format(_spi, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    for (int16_t row = 0; row < visible.h; row++) {
+        spi_write16_blocking(_spi, pixels, visible.w);
+        pixels += w;
+    }
+    spi_set_format(_spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    gpio_put(_cs, 1);  // CS HIGH = End transaction
+}
+
+/**
+ * Define vertical scroll region
+ * 
+ * 
+ * VSCRDEF takes three 16-bit values: top fixed area, vertical
+ * scroll area and bottom fixed area. They must add up to 320.
+ */
+void ST7789::setScrollArea(uint16_t top, uint16_t bottom) {
+    uint16_t scroll = SCREEN_HEIGHT - top - bottom;
+    uint8_t buf[6] = {
+        (uint8_t)(top >> 8),    (uint8_t)(top & 0xFF),     // Top fixed area
+        (uint8_t)(scroll >> 8), (uint8_t)(scroll & 0xFF),  // Scroll area
+        (uint8_t)(bottom >> 8), (uint8_t)(bottom & 0xFF)   // Bottom fixed area
+    };
+    
+    writeCommand(ST7789_VSCRDEF);
+    writeDataBuf(buf, 6);
+}
+
+/**
+ * Set vertical scroll start line
+ * 
+ * 
+ * VSCRSADD tells the display which frame memory line to show at the
+ * top of the scroll area. Nothing is copied inside the display, the
+ * read-out pointer is simply moved.
+ */
+void ST7789::setScrollStart(uint16_t line) {
+    uint8_t buf[2] = { (uint8_t)(line >> 8), (uint8_t)(line & 0xFF) };
+    
+    writeCommand(ST7789_VSCRSADD);
+    writeDataBuf(buf, 2);
+}
+
+/**
+ * Start async block transfer
+ * 
+ * 
+ * Same setup as drawBuffer(): window, DC high, CS low, 16-bit SPI
+ * frames. Then the DMA channel is started and CS is left low. The
+ * transaction is closed by waitIdle().
+ */
+void ST7789::drawBufferAsync(int16_t x, int16_t y, uint16_t w, uint16_t h,
+                             const uint16_t* pixels) {
+    Rect visible = rectIntersect(makeRect(x, y, w, h), clipRect());
+    if (rectEmpty(visible)) return;
+    
+    const uint16_t* first = pixels + (uint32_t)(visible.y - y) * w + (visible.x - x);
+    if (visible.w != w) {
+        sendClipped(visible, w, first);  // Rows with gaps: no single DMA transfer
+        return;
+    }
+    
+    setWindow(visible.x, visible.y, visible.x + visible.w - 1, visible.y + visible.h - 1);
+    
+    gpio_put(_dc, 1);  // DC HIGH = Data mode
+    gpio_put(_cs, 0);  // CS LOW = Start transaction
+    spi_set_format(_spi, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    dma_channel_transfer_from_buffer_now(_dma, first, (uint32_t)w * visible.h);
+    _dmaActive = true;
+}
+
+/**
+ * Open a streaming window
+ * 
+ * 
+ * Same setup as drawBufferAsync() without starting the DMA. Marking
+ * the transfer active means waitIdle() closes the window; waiting on a
+ * channel that was never started returns at once.
+ * 
+ * The display window is only the visible part; writePixelsAsync()
+ * counts pixels in the whole window to know which ones to skip.
+ */
+void ST7789::beginPixels(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    waitIdle();  // Ends the previous window
+    
+    _stream = makeRect(x, y, w, h);
+    _streamVisible = rectIntersect(_stream, clipRect());
+    _streamClipped = _streamVisible.w != _stream.w || _streamVisible.h != _stream.h;
+    _streamPos = 0;
+    
+    if (!rectEmpty(_streamVisible)) {  // Otherwise every pixel is skipped
+        setWindow(_streamVisible.x, _streamVisible.y, _streamVisible.x + _streamVisible.w - 1,
+                  _streamVisible.y + _streamVisible.h - 1);
+        
+        gpio_put(_dc, 1);  // DC HIGH = Data mode
+        gpio_put(_cs, 0);  // CS LOW = Start transaction
+        spi_set_format(_spi, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+        _dmaActive = true;
+    }
+    _streaming = true;
+}
+
+/**
+ * Queue the next piece
+ * 
+ * 
+ * Only the DMA is waited for: the words still in the SPI FIFO go out
+ * in the same format and order, so the SPI keeps running while the
+ * channel restarts and only pauses if the next piece is late.
+ */
+void ST7789::writePixelsAsync(const uint16_t* pixels, uint32_t count) {
+    if (!_streaming || count == 0) return;
+    
+    if (!_streamClipped) {
+        dma_channel_wait_for_finish_blocking(_dma);
+        dma_channel_transfer_from_buffer_now(_dma, pixels, count);
+        return;
+    }
+    
+    // Clipped: send the visible span of each row the piece touches.
+    // The previous piece may have had nothing visible in this one, so
+    // wait for it here to keep its buffer promise.
+    dma_channel_wait_for_finish_blocking(_dma);
+    uint32_t pos = _streamPos;
+    _streamPos += count;
+    if (rectEmpty(_streamVisible)) return;
+    
+    int32_t width = _stream.w;
+    int32_t row = pos / width;
+    int32_t col = pos % width;
+    int32_t left = _streamVisible.x - _stream.x;
+    int32_t right = left + _streamVisible.w;
+    int32_t top = _streamVisible.y - _stream.y;
+    int32_t bottom = top + _streamVisible.h;
+    while (count) {
+        int32_t n = width - col;
+        if ((uint32_t)n > count) n = count;
+        if (row >= top && row < bottom) {
+            int32_t from = col > left ? col : left;
+            int32_t to = col + n < right ? col + n : right;
+            if (from < to) {
+                dma_channel_wait_for_finish_blocking(_dma);  // Earlier span of this piece
+                dma_channel_transfer_from_buffer_now(_dma, pixels + (from - col), to - from);
+            }
+        }
+        pixels += n;
+        count -= n;
+        col = 0;
+        row++;
+    }
+}
+
+// ========== BATCHES ==========
+
+/**
+ * Pixels of one color sent per SPI call in a batch
+ */
+#define BATCH_CHUNK 32
+
+/**
+ * Sort by row, then column (Shell sort: in place, no recursion, and
+ * for 1000 points a few thousand comparisons, far below the time the
+ * SPI needs for them)
+ */
+template <typename T>
+static void sortByRow(T* items, uint32_t count) {
+    static const uint16_t gaps[] = { 701, 301, 132, 57, 23, 10, 4, 1 };
+    for (uint16_t gap : gaps) {
+        for (uint32_t i = gap; i < count; i++) {
+            T item = items[i];
+            int32_t key = (int32_t)item.y * 65536 + item.x;
+            uint32_t j = i;
+            while (j >= gap && (int32_t)items[j - gap].y * 65536 + items[j - gap].x > key) {
+                items[j] = items[j - gap];
+                j -= gap;
+            }
+            items[j] = item;
+        }
+    }
+}
+
+/**
+ * Start a batch
+ * 
+ * 
+ * Commands and their data are told apart by DC alone, so CS can stay
+ * low for the whole batch. spi_write_blocking() returns once the last
+ * bit is out, which makes switching DC between calls safe.
+ */
+void ST7789::beginBatch() {
+    waitIdle();
+    _batchWindow.w = 0;
+    gpio_put(_cs, 0);  // CS LOW = Start transaction
+}
+
+void ST7789::endBatch() {
+    gpio_put(_cs, 1);  // CS HIGH = End transaction
+}
+
+void ST7789::batchWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    uint8_t buf[4];
+    bool known = _batchWindow.w != 0;
+    
+    if (!known || x0 != _batchWindow.x || x1 != _batchWindow.x + _batchWindow.w - 1) {
+        uint8_t cmd = ST7789_CASET;
+        gpio_put(_dc, 0);  // DC LOW = Command mode
+        spi_write_blocking(_spi, &cmd, 1);
+        buf[0] = x0 >> 8;
+        buf[1] = x0 & 0xFF;
+        buf[2] = x1 >> 8;
+        buf[3] = x1 & 0xFF;
+        gpio_put(_dc, 1);  // DC HIGH = Data mode
+        spi_write_blocking(_spi, buf, 4);
+    }
+    if (!known || y0 != _batchWindow.y || y1 != _batchWindow.y + _batchWindow.h - 1) {
+        uint8_t cmd = ST7789_RASET;
+        gpio_put(_dc, 0);
+        spi_write_blocking(_spi, &cmd, 1);
+        buf[0] = y0 >> 8;
+        buf[1] = y0 & 0xFF;
+        buf[2] = y1 >> 8;
+        buf[3] = y1 & 0xFF;
+        gpio_put(_dc, 1);
+        spi_write_blocking(_spi, buf, 4);
+    }
+    _batchWindow = { (int16_t)x0, (int16_t)y0, (int16_t)(x1 - x0 + 1), (int16_t)(y1 - y0 + 1) };
+    
+    uint8_t cmd = ST7789_RAMWR;
+    gpio_put(_dc, 0);
+    spi_write_blocking(_spi, &cmd, 1);
+    gpio_put(_dc, 1);  // Pixel data follows
+}
+
+void ST7789::batchColor(uint16_t color, uint32_t count) {
+    uint8_t buf[BATCH_CHUNK * 2];
+    uint32_t n = count < BATCH_CHUNK ? count : BATCH_CHUNK;
+    for (uint32_t i = 0; i < n; i++) {
+        buf[2 * i] = color >> 8;        // High byte first
+        buf[2 * i + 1] = color & 0xFF;
+    }
+    while (count > 0) {
+        n = count < BATCH_CHUNK ? count : BATCH_CHUNK;
+        spi_write_blocking(_spi, buf, 2 * n);
+        count -= n;
+    }
+}
+
+uint32_t ST7789::fillRects(const Rect* rects, uint32_t count, uint16_t color) {
+    uint32_t windows = 0;
+    beginBatch();
+    for (uint32_t i = 0; i < count; i++) {
+        Rect r = rectIntersect(rects[i], clipRect());
+        if (rectEmpty(r)) continue;
+        
+        batchWindow(r.x, r.y, r.x + r.w - 1, r.y + r.h - 1);
+        batchColor(color, (uint32_t)r.w * r.h);
+        windows++;
+    }
+    endBatch();
+    return windows;
+}
+
+/**
+ * Draw many single pixels
+ * 
+ * 
+ * After sorting, each run of pixels at consecutive columns of a row
+ * becomes one window: a scatter plot costs one short window per
+ * point, a line of touching pixels one window per row.
+ */
+uint32_t ST7789::drawPixels(Point* points, uint32_t count) {
+    sortByRow(points, count);
+    
+    const Rect& clip = clipRect();
+    uint32_t windows = 0;
+    uint32_t i = 0;
+    beginBatch();
+    while (i < count) {
+        const Point& p = points[i];
+        if (p.x < clip.x || p.y < clip.y || p.x >= clip.x + clip.w || p.y >= clip.y + clip.h) {
+            i++;
+            continue;
+        }
+        
+        // Extent of the run: next columns of the same row (repeated
+        // positions are skipped), up to the clip edge
+        int16_t last = p.x;
+        uint32_t end = i + 1;
+        while (end < count && points[end].y == p.y && points[end].x <= last + 1 &&
+               points[end].x < clip.x + clip.w) {
+            last = points[end].x;
+            end++;
+        }
+        
+        batchWindow(p.x, p.y, last, p.y);
+        uint8_t buf[BATCH_CHUNK * 2];
+        uint32_t n = 0;
+        int16_t x = p.x - 1;
+        for (uint32_t j = i; j < end; j++) {
+            if (points[j].x == x) continue;  // Same position again
+            x = points[j].x;
+            buf[n++] = points[j].color >> 8;
+            buf[n++] = points[j].color & 0xFF;
+            if (n == sizeof(buf)) {
+                spi_write_blocking(_spi, buf, n);
+                n = 0;
+            }
+        }
+        if (n > 0) spi_write_blocking(_spi, buf, n);
+        windows++;
+        i = end;
+    }
+    endBatch();
+    return windows;
+}
+
+/**
+ * Draw many horizontal runs
+ * 
+ * 
+ * Spans are clipped one by one; a following span of the same row is
+ * merged into the window if it starts no later than one past its end.
+ * The part of it left of that point is already covered and dropped.
+ */
+uint32_t ST7789::drawSpans(Span* spans, uint32_t count) {
+    sortByRow(spans, count);
+    
+    const Rect& clip = clipRect();
+    int32_t clipX1 = clip.x + clip.w;
+    uint32_t windows = 0;
+    uint32_t i = 0;
+    beginBatch();
+    while (i < count) {
+        const Span& s = spans[i];
+        int32_t x0 = s.x > clip.x ? s.x : clip.x;
+        int32_t x1 = s.x + s.w < clipX1 ? s.x + s.w : clipX1;
+        if (s.y < clip.y || s.y >= clip.y + clip.h || x0 >= x1) {
+            i++;
+            continue;
+        }
+        
+        // Extent of the merged window
+        int32_t end = x1;
+        uint32_t last = i + 1;
+        while (last < count && spans[last].y == s.y && spans[last].x <= end) {
+            int32_t e = spans[last].x + spans[last].w;
+            if (e > end) end = e < clipX1 ? e : clipX1;
+            last++;
+        }
+        
+        batchWindow(x0, s.y, end - 1, s.y);
+        int32_t x = x0;
+        for (uint32_t j = i; j < last; j++) {
+            int32_t e = spans[j].x + spans[j].w;
+            if (e > end) e = end;
+            if (e > x) {
+                batchColor(spans[j].color, e - x);
+                x = e;
+            }
+        }
+        windows++;
+        i = last;
+    }
+    endBatch();
+    return windows;
+}
+
+/**
+ * Push a clip rectangle
+ * 
+ * 
+ * The stack holds the intersected rectangles, so clipRect() is a
+ * lookup and nested clips never grow past their parent.
+ */
+bool ST7789::pushClip(const Rect& r) {
+    if (_clipDepth + 1 >= ST7789_CLIP_DEPTH) return false;
+    
+    _clip[_clipDepth + 1] = rectIntersect(r, _clip[_clipDepth]);
+    _clipDepth++;
+    return true;
+}
+
+void ST7789::popClip() {
+    if (_clipDepth > 0) _clipDepth--;
+}
+
+void ST7789::resetClip() {
+    _clipDepth = 0;
+}
+
+/**
+ * Finish async transfer
+ * 
+ * 
+ * The DMA is done when its last word is in the SPI FIFO, not when it
+ * has left the wire, so we also wait for the SPI to go idle before
+ * releasing CS. The SPI receives a word for every word sent; nobody
+ * reads them during DMA, so the RX FIFO is drained and its overrun
+ * flag cleared here.
+ */
+void ST7789::waitIdle() {
+    _streaming = false;
+    if (!_dmaActive) return;
+    
+    dma_channel_wait_for_finish_blocking(_dma);
+    while (spi_is_busy(_spi)) {
+        tight_loop_contents();
+    }
+    while (spi_is_readable(_spi)) {
+        (void)spi_get_hw(_spi)->dr;
+    }
+    spi_get_hw(_spi)->icr = SPI_SSPICR_RORIC_BITS;
+    
+    spi_set_format(_spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    gpio_put(_cs, 1);  // CS HIGH = End transaction
+    _dmaActive = false;
+}
+
+bool ST7789::isBusy() {
+    return _dmaActive && (dma_channel_is_busy(_dma) || spi_is_busy(_spi));
+}
@@ -10,7 +10,7 @@
  * TFT LCD controller with 240x320 pixel resolution, using 16-bit RGB565
  * color format.
  * 
- *
+ * 
  * The display requires the following connections:
  * - CS (Chip Select): selects the device on SPI bus
  * - DC (Data/Command): switches between command and data mode
@@ -31,6 +31,7 @@
 
 #include <stdint.h>
 #include "hardware/spi.h"
+#include "rect.h"
 
 /**
  * ST7789Commands ST7789 Command Definitions
@@ -51,8 +52,11 @@
 #define ST7789_RASET     0x2B  // < Row Address Set - defines Y range
 #define ST7789_RAMWR     0x2C  // < RAM Write - starts pixel data transfer
 #define ST7789_DISPON    0x29  // < Display On - turns on the display
+#define ST7789_DISPOFF   0x28  // < Display Off - frame memory kept, not shown
 #define ST7789_INVON     0x21  // < Inversion On - inverts display colors for better quality
 #define ST7789_INVOFF    0x20  // < Inversion Off - disables color inversion
+#define ST7789_VSCRDEF   0x33  // < Vertical Scrolling Definition - fixed/scroll areas
+#define ST7789_VSCRSADD  0x37  // < Vertical Scroll Start Address - first line shown
 
 /**
  * Constants defining the physical display resolution
@@ -60,6 +64,8 @@
 #define SCREEN_WIDTH  240  // < Screen width in pixels
 #define SCREEN_HEIGHT 320  // < Screen height in pixels
 
+#define ST7789_CLIP_DEPTH 8  // < Nested clip rectangles, the screen included
+
 /**
  * 16-bit RGB565 format colors
  * 
@@ -79,6 +85,23 @@
 #define COLOR_CYAN    0x07FF  ///< Cyan (R=0, G=63, B=31)
 #define COLOR_ORANGE  0xFD20  ///< Orange (R=31, G=40, B=0)
 
+/**
+ * One pixel for ST7789::drawPixels()
+ */
+struct Point {
+    int16_t x, y;     // < Position
+    uint16_t color;   // < RGB565 color
+};
+
+/**
+ * Horizontal run of one color for ST7789::drawSpans()
+ */
+struct Span {
+    int16_t x, y;     // < Leftmost pixel
+    uint16_t w;       // < Length in pixels
+    uint16_t color;   // < RGB565 color
+};
+
 /**
  * Driver class for ST7789 TFT LCD display
  * 
@@ -134,6 +157,34 @@ public:
      */
     void init(uint32_t baudrate = 32000000);
     
+    /**
+     * Minimal bring-up for showing something as early as possible
+     * 
+     * baudrate SPI baud rate in Hz
+     * 
+     * 
+     * Hardware reset, SLPOUT and the same pixel format, orientation
+     * and inversion as init(), with the shortest waits the datasheet
+     * allows: about 10 ms after power-on instead of about 700 ms. The
+     * display is left off; write the first picture, then call
+     * setDisplayOn(true). Use instead of init(), not after it.
+     */
+    void initQuick(uint32_t baudrate = 32000000);
+    
+    /**
+     * Show or hide the frame memory
+     * 
+     * on true for DISPON, false for DISPOFF (the panel shows white or
+     *    black, depending on the panel, and keeps its frame memory)
+     */
+    void setDisplayOn(bool on);
+    
+    /**
+     * SPI instance, for code that runs its own DMA into the SPI data
+     * register inside a beginPixels() window (splash.h)
+     */
+    spi_inst_t* spi() const { return _spi; }
+    
     /**
      * Fill entire screen with specified color
      * 
@@ -141,7 +192,8 @@ public:
      * 
      * 
      * This is a convenience function that fills the entire screen
-     * by calling fillRect() with full screen dimensions.
+     * by calling fillRect() with full screen dimensions, so only the
+     * clip rectangle is filled while one is set.
      * 
      */
     void fillScreen(uint16_t color);
@@ -149,24 +201,22 @@ public:
     /**
      * Fill rectangular area with specified color
      * 
-     * x X coordinate of top-left corner (0-239)
-     * y Y coordinate of top-left corner (0-319)
+     * x X coordinate of top-left corner (may be off screen)
+     * y Y coordinate of top-left corner (may be off screen)
      * w Width of rectangle in pixels
      * h Height of rectangle in pixels
      * color RGB565 color value
      * 
      * 
-     * Draws a filled rectangle at specified position. Automatically clips
-     * the rectangle if it extends beyond screen boundaries. Uses SPI
+     * Draws a filled rectangle at specified position. Only the part
+     * inside the clip rectangle (see pushClip()) is sent. Uses SPI
      * to send color data pixel by pixel.
      * 
-     * Coordinates outside screen bounds are ignored
-     * 
      * Large rectangles may take significant time to draw.
      *          For full screen, use fillScreen() instead.
      * 
      */
-    void fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+    void fillRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color);
     
     /**
      * Draw single pixel at specified position
@@ -176,15 +226,231 @@ public:
      * color RGB565 color value
      * 
      * 
-     * Sets a single pixel to the specified color. This is the slowest
-     * drawing method as it requires full SPI transaction overhead for
-     * just one pixel.
+     * Sets a single pixel to the specified color, unless it lies
+     * outside the clip rectangle. This is the slowest drawing method
+     * as it requires full SPI transaction overhead for just one pixel.
      * 
      * For drawing multiple pixels, use fillRect() instead
      * 
      */
-    void drawPixel(uint16_t x, uint16_t y, uint16_t color);
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    
+    /**
+     * Draw rectangular block of pixels from a buffer
+     * 
+     * x X coordinate of top-left corner (0-239)
+     * y Y coordinate of top-left corner (0-319)
+     * w Width of block in pixels
+     * h Height of block in pixels
+     * pixels RGB565 pixels, row by row (w × h entries)
+     * 
+     * 
+     * Sets the window once and streams the whole buffer in a single
+     * CS cycle. The SPI is switched to 16-bit frames for the transfer,
+     * so pixels are sent straight from memory without byte swapping.
+     * 
+     * This is the fast path for anything more complex than a solid
+     * color: render into a small RAM buffer, then send it here.
+     * 
+     * Only the part inside the clip rectangle is sent, row by row
+     * from the buffer; x and y may be off screen.
+     */
+    void drawBuffer(int16_t x, int16_t y, uint16_t w, uint16_t h,
+                    const uint16_t* pixels);
+    
+    /**
+     * Start sending a block of pixels by DMA and return immediately
+     * 
+     * x X coordinate of top-left corner (0-239)
+     * y Y coordinate of top-left corner (0-319)
+     * w Width of block in pixels
+     * h Height of block in pixels
+     * pixels RGB565 pixels, row by row (w × h entries)
+     * 
+     * 
+     * Same result as drawBuffer(), but the DMA controller feeds the
+     * SPI while the CPU continues. The usual pattern is double
+     * buffering: prepare the next block in a second buffer while this
+     * one is being sent.
+     * 
+     * The buffer must not be modified until the transfer is done.
+     * Any other driver call first waits for the transfer (waitIdle()).
+     * 
+     * Clipped like drawBuffer(). A block cut at the top or bottom is
+     * still one DMA transfer; one cut at the left or right edge has
+     * gaps between its rows and is sent before returning.
+     * 
+     */
+    void drawBufferAsync(int16_t x, int16_t y, uint16_t w, uint16_t h,
+                         const uint16_t* pixels);
+    
+    /**
+     * Open a window for pixels sent in pieces by writePixelsAsync()
+     * 
+     * x X coordinate of top-left corner (0-239)
+     * y Y coordinate of top-left corner (0-319)
+     * w Width of window in pixels
+     * h Height of window in pixels
+     * 
+     * 
+     * The window takes w × h pixels in as many pieces as convenient,
+     * all in one CS cycle, so pixels generated a line at a time cost
+     * no window commands after the first. Closed like
+     * drawBufferAsync(): by waitIdle() or any other driver call.
+     * 
+     * Pixels outside the clip rectangle are skipped. Callers that can
+     * should clip first (clipRect()) and only generate what is visible.
+     */
+    void beginPixels(int16_t x, int16_t y, uint16_t w, uint16_t h);
+    
+    /**
+     * Send the next piece of a beginPixels() window by DMA
+     * 
+     * pixels RGB565 pixels
+     * count Number of pixels
+     * 
+     * 
+     * Waits until the DMA has taken the previous piece, starts this one
+     * and returns. The previous piece's buffer is free again, so two
+     * buffers are enough to keep the SPI busy.
+     */
+    void writePixelsAsync(const uint16_t* pixels, uint32_t count);
+    
+    // ========== BATCHES ==========
+    
+    /**
+     * Fill many rectangles with one color
+     * 
+     * rects Rectangles (clipped like fillRect())
+     * count Number of rectangles
+     * color RGB565 color value
+     * 
+     * returns the number of display windows sent
+     * 
+     * 
+     * All rectangles go out in one CS session, and a window coordinate
+     * pair that did not change since the previous rectangle is not
+     * sent again: a column of grid lines shares its rows, a row of
+     * them its columns. Drawn in array order.
+     */
+    uint32_t fillRects(const Rect* rects, uint32_t count, uint16_t color);
+    
+    /**
+     * Draw many single pixels
+     * 
+     * points Pixels; sorted in place by row, then column
+     * count Number of pixels
+     * 
+     * returns the number of display windows sent
+     * 
+     * 
+     * One CS session for the whole batch. Pixels next to each other in
+     * a row share one window, and pixels in the same row only resend
+     * the column pair (6 bytes instead of 11 for a window of its own),
+     * so sorting pays for itself many times over. Pixels outside the
+     * clip rectangle are skipped; if one position appears more than
+     * once, which color wins is undefined.
+     */
+    uint32_t drawPixels(Point* points, uint32_t count);
+    
+    /**
+     * Draw many horizontal runs
+     * 
+     * spans Runs; sorted in place by row, then column
+     * count Number of runs
+     * 
+     * returns the number of display windows sent
+     * 
+     * 
+     * Like drawPixels() for runs: spans that touch or overlap in a row
+     * are merged into one window (each keeps its color), and the row
+     * pair is only sent when the row changes. Where spans overlap, the
+     * one that starts further left wins.
+     */
+    uint32_t drawSpans(Span* spans, uint32_t count);
+    
+    // ========== CLIPPING ==========
+    
+    /**
+     * Restrict drawing to a rectangle inside the current one
+     * 
+     * r Rectangle; the new clip is its overlap with the current clip
+     * 
+     * returns false (clip unchanged) if ST7789_CLIP_DEPTH rectangles
+     * are already pushed
+     * 
+     * 
+     * Every drawing call clips its spans against the innermost
+     * rectangle before sending, so a widget can draw at its own
+     * coordinates and only the visible part reaches the SPI. Pair
+     * every successful push with a popClip().
+     */
+    bool pushClip(const Rect& r);
+    
+    /**
+     * Return to the clip before the last pushClip()
+     * 
+     * 
+     * The screen itself is never popped.
+     */
+    void popClip();
+    
+    /**
+     * Drop every pushed clip (back to the whole screen)
+     */
+    void resetClip();
+    
+    /**
+     * The current clip rectangle (may be empty)
+     */
+    const Rect& clipRect() const { return _clip[_clipDepth]; }
+    
+    /**
+     * Wait until a drawBufferAsync() transfer has finished
+     * 
+     * 
+     * Returns immediately if no transfer is running. Called
+     * automatically by every other drawing method.
+     */
+    void waitIdle();
     
+    /**
+     * Check whether a drawBufferAsync() transfer is still running
+     * 
+     * returns true while DMA is still sending pixels
+     */
+    bool isBusy();
+    
+    /**
+     * Define the hardware vertical scroll region
+     * 
+     * top Number of fixed lines at the top of the screen
+     * bottom Number of fixed lines at the bottom of the screen
+     * 
+     * 
+     * The lines in between (SCREEN_HEIGHT - top - bottom) form the
+     * scroll area. Its content can be rotated with setScrollStart()
+     * without sending any pixel data. Use setScrollArea(0, 0) to
+     * scroll the whole screen.
+     * 
+     */
+    void setScrollArea(uint16_t top, uint16_t bottom);
+    
+    /**
+     * Set first frame memory line shown at the top of the scroll area
+     * 
+     * line Frame memory line (top ... SCREEN_HEIGHT - bottom - 1)
+     * 
+     * 
+     * Moving the start line by N scrolls the picture up by N lines:
+     * memory lines wrap around inside the scroll area, so the line that
+     * leaves the top reappears at the bottom. Only 2 bytes are sent.
+     * 
+     * Drawing coordinates always address frame memory, not the
+     * position on the glass. Callers that scroll must map their rows.
+     */
+    void setScrollStart(uint16_t line);
+
 private:
     spi_inst_t* _spi;  // < Pointer to SPI instance (spi0 or spi1)
     uint8_t _cs;       // < Chip Select pin number
@@ -192,6 +458,30 @@ private:
     uint8_t _rst;      // < Reset pin number
     uint8_t _sck;      // < SPI Clock pin number
     uint8_t _mosi;     // < SPI MOSI pin number
+    int _dma;          // < DMA channel used for async transfers
+    bool _dmaActive;   // < Async transfer started, CS still low
+    
+    Rect _clip[ST7789_CLIP_DEPTH];  // < [0] is the screen
+    uint8_t _clipDepth;             // < Index of the current clip
+    
+    // beginPixels() window, for skipping clipped pixels
+    bool _streaming;       // < Window open for writePixelsAsync()
+    bool _streamClipped;   // < Window only partly visible
+    Rect _stream;          // < Whole window
+    Rect _streamVisible;   // < Part inside the clip (may be empty)
+    uint32_t _streamPos;   // < Pixels of the window written so far
+    
+    Rect _batchWindow;     // < Window last set in a batch (w = 0: none)
+    
+    /**
+     * SPI, DMA channel and control pins
+     */
+    void initBus(uint32_t baudrate);
+    
+    /**
+     * COLMOD, MADCTL and inversion, after SLPOUT
+     */
+    void configurePanel();
     
     /**
      * Send command byte to display
@@ -203,6 +493,9 @@ private:
      * then pulls CS HIGH. This is the fundamental method for sending
      * ST7789 commands.
      * 
+     * Every transaction starts with a command, so this is also where
+     * a running async transfer is waited for.
+     * 
      * This is a private method used internally by public functions
      */
     void writeCommand(uint8_t cmd);
@@ -235,6 +528,32 @@ private:
      */
     void writeDataBuf(const uint8_t* buf, size_t len);
     
+    /**
+     * Start a batch: one CS session for the calls below
+     */
+    void beginBatch();
+    
+    /**
+     * End a batch (CS HIGH)
+     */
+    void endBatch();
+    
+    /**
+     * Open a window inside a batch for pixels from RAMWR on
+     * 
+     * x0, y0, x1, y1 Window corners (inclusive, on screen)
+     * 
+     * 
+     * Only sends CASET and RASET when they differ from the last window
+     * of the batch; the controller keeps both until changed.
+     */
+    void batchWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+    
+    /**
+     * Send count pixels of one color inside a batch window
+     */
+    void batchColor(uint16_t color, uint32_t count);
+    
     /**
      * Set drawing window (region of interest)
      * 
@@ -255,6 +574,17 @@ private:
      * This is a private method used internally by public functions
      */
     void setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+    
+    /**
+     * Send the visible part of a pixel block, row by row
+     * 
+     * visible Clipped block (inside the screen, not empty)
+     * w Width of the whole block (buffer row length)
+     * pixels First visible pixel of the first visible row
+     * 
+     * This is a private method used internally by public functions
+     */
+    void sendClipped(const Rect& visible, uint16_t w, const uint16_t* pixels);
 };
 
 #endif // ST7789_H
\ No newline at end of file
@@ -0,0 +1,191 @@
+/**
+ * stripchart.cpp
+ * Implementation of the strip chart widget
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "stripchart.h"
+
+StripChart::StripChart(ST7789& display, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                       StripMode mode)
+    : _display(display), _mode(mode), _x(x), _y(y), _w(w), _h(h),
+      _minValue(0), _maxValue(100), _background(COLOR_BLACK),
+      _seriesCount(0), _head(0), _count(0), _sliceIndex(0) {
+    if (_mode == STRIP_SCROLL) {
+        _x = 0;
+        _w = SCREEN_WIDTH;
+    }
+    
+    // Sweep: time along x, values along y. Scroll: the other way round.
+    _length = (_mode == STRIP_SWEEP) ? _w : _h;
+    _span = (_mode == STRIP_SWEEP) ? _h : _w;
+    if (_length > STRIP_MAX_HISTORY) _length = STRIP_MAX_HISTORY;
+    if (_span > STRIP_MAX_SLICE) _span = STRIP_MAX_SLICE;
+}
+
+int StripChart::addSeries(uint16_t color, StripStyle style) {
+    if (_seriesCount == STRIP_MAX_SERIES) return -1;
+    _colors[_seriesCount] = color;
+    _styles[_seriesCount] = style;
+    return _seriesCount++;
+}
+
+void StripChart::setRange(int16_t minValue, int16_t maxValue) {
+    _minValue = minValue;
+    _maxValue = maxValue > minValue ? maxValue : minValue + 1;
+}
+
+void StripChart::setBackground(uint16_t color) {
+    _background = color;
+}
+
+void StripChart::begin() {
+    if (_mode == STRIP_SCROLL) {
+        _display.setScrollArea(_y, SCREEN_HEIGHT - _y - _h);
+        _display.setScrollStart(_y);
+    }
+    _display.fillRect(_x, _y, _w, _h, _background);
+    _head = 0;
+    _count = 0;
+}
+
+/**
+ * Map a value to a position along the slice
+ * 
+ * Position 0 is the first pixel sent: the top of a sweep column, or
+ * the left end of a scroll line. Sweep columns therefore put large
+ * values at small positions (top), scroll lines small values (left).
+ */
+uint16_t StripChart::valueToPos(int16_t value) const {
+    if (value < _minValue) value = _minValue;
+    if (value > _maxValue) value = _maxValue;
+    uint32_t offset = (uint32_t)(value - _minValue) * (_span - 1) /
+                      (uint32_t)(_maxValue - _minValue);
+    return (_mode == STRIP_SWEEP) ? (_span - 1 - offset) : offset;
+}
+
+/**
+ * Render the slice at ring position pos
+ * 
+ * 
+ * Background first, then each series in order (later series on top):
+ * - filled: span between the baseline and the value
+ * - line: span between the previous sample and this one, so steep
+ *   changes show as a connected vertical stroke
+ */
+void StripChart::renderSlice(uint16_t* buf, uint16_t pos, bool hasPrevious) {
+    for (uint16_t i = 0; i < _span; i++) {
+        buf[i] = _background;
+    }
+    
+    // The previous sample is one column to the left (sweep) or one
+    // line further down (scroll)
+    uint16_t prevPos;
+    if (_mode == STRIP_SWEEP) {
+        prevPos = (pos == 0) ? _length - 1 : pos - 1;
+    } else {
+        prevPos = (pos + 1) % _length;
+    }
+    int16_t zero = (_minValue > 0) ? _minValue : (_maxValue < 0 ? _maxValue : 0);
+    uint16_t base = valueToPos(zero);
+    
+    for (uint8_t s = 0; s < _seriesCount; s++) {
+        uint16_t p = valueToPos(_history[s][pos]);
+        uint16_t from, to;
+        
+        if (_styles[s] == STRIP_FILLED) {
+            from = p < base ? p : base;
+            to = p < base ? base : p;
+        } else {
+            uint16_t q = hasPrevious ? valueToPos(_history[s][prevPos]) : p;
+            from = p < q ? p : q;
+            to = p < q ? q : p;
+        }
+        
+        for (uint16_t i = from; i <= to; i++) {
+            buf[i] = _colors[s];
+        }
+    }
+}
+
+/**
+ * Send a rendered slice to its place on screen
+ * 
+ * Sweep: a 1 × h column. Scroll: a w × 1 line of the scroll band.
+ * Sent by DMA; the caller alternates between the two slice buffers.
+ */
+void StripChart::sendSlice(uint16_t pos, const uint16_t* buf) {
+    if (_mode == STRIP_SWEEP) {
+        _display.drawBufferAsync(_x + pos, _y, 1, _span, buf);
+    } else {
+        _display.drawBufferAsync(_x, _y + pos, _span, 1, buf);
+    }
+}
+
+/**
+ * Add a sample
+ * 
+ * 
+ * Sweep: the cursor advances one column to the right (wrapping), the
+ *        new column is drawn and the column after it is cleared.
+ * Scroll: the newest line moves one line up in the scroll band
+ *        (wrapping), the display scroll start follows it, and only
+ *        that line is drawn.
+ */
+void StripChart::push(const int16_t* values) {
+    if (_count > 0) {
+        if (_mode == STRIP_SWEEP) {
+            _head = (_head + 1) % _length;
+        } else {
+            _head = (_head == 0) ? _length - 1 : _head - 1;
+        }
+    }
+    
+    for (uint8_t s = 0; s < _seriesCount; s++) {
+        _history[s][_head] = values[s];
+    }
+    
+    uint16_t* buf = _sliceBuf[_sliceIndex];
+    renderSlice(buf, _head, _count > 0);
+    if (_count < _length) _count++;
+    
+    if (_mode == STRIP_SCROLL) {
+        _display.setScrollStart(_y + _head);
+    }
+    sendSlice(_head, buf);
+    _sliceIndex ^= 1;
+    
+    // ========== SWEEP GAP ==========
+    if (_mode == STRIP_SWEEP && _length > 1) {
+        uint16_t* gap = _sliceBuf[_sliceIndex];
+        for (uint16_t i = 0; i < _span; i++) {
+            gap[i] = _background;
+        }
+        sendSlice((_head + 1) % _length, gap);
+        _sliceIndex ^= 1;
+    }
+}
+
+/**
+ * Redraw every slice from the history
+ */
+void StripChart::redraw() {
+    _display.fillRect(_x, _y, _w, _h, _background);
+    
+    // A full sweep chart keeps the gap column after the cursor empty
+    uint16_t first = (_mode == STRIP_SWEEP && _count == _length) ? 1 : 0;
+    for (uint16_t i = first; i < _count; i++) {
+        // Oldest to newest, in time order
+        uint16_t pos;
+        if (_mode == STRIP_SWEEP) {
+            pos = (_head + _length - (_count - 1) + i) % _length;
+        } else {
+            pos = (_head + (_count - 1) - i) % _length;
+        }
+        uint16_t* buf = _sliceBuf[_sliceIndex];
+        renderSlice(buf, pos, i > 0);
+        sendSlice(pos, buf);
+        _sliceIndex ^= 1;
+    }
+}
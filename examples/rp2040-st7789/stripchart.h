@@ -0,0 +1,173 @@
+/**
+ * stripchart.h
+ * Strip chart for live time series (RSSI, packet rate, battery, ...)
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Every new sample costs the same, however long the history is: the
+ * chart never redraws old samples, it only draws one new "slice" (the
+ * line of pixels for the newest point in time).
+ * 
+ * Two modes:
+ * 
+ * STRIP_SWEEP - time runs left to right like an ECG monitor. The
+ *   newest sample is drawn as one column at a moving cursor, and the
+ *   column ahead of it is cleared to show where the sweep is. When
+ *   the cursor reaches the right edge it starts again at the left.
+ *   Works in any rectangle.
+ * 
+ * STRIP_SCROLL - time runs top to bottom, newest sample at the top,
+ *   like a chart recorder. The history moves with the ST7789 hardware
+ *   vertical scroll, so the chart looks like a continuously scrolling
+ *   graph while still only one line is sent per sample. The panel can
+ *   only scroll whole lines, so this mode always uses the full screen
+ *   width.
+ * 
+ * Up to four series share a chart, each drawn as a line (joined to
+ * the previous sample) or filled down to the baseline.
+ * 
+ * example:
+ * 
+ * StripChart chart(display, 0, 200, 240, 120, STRIP_SWEEP);
+ * chart.addSeries(COLOR_GREEN, STRIP_LINE);
+ * chart.addSeries(COLOR_BLUE, STRIP_FILLED);
+ * chart.setRange(-100, 0);
+ * chart.begin();
+ * int16_t values[2] = { rssi, packetRate };
+ * chart.push(values);
+ * 
+ */
+
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+#include <stdint.h>
+#include "st7789.h"
+
+#define STRIP_MAX_SERIES  4              // < Series per chart
+#define STRIP_MAX_HISTORY SCREEN_HEIGHT  // < Longest time axis in pixels
+#define STRIP_MAX_SLICE   SCREEN_HEIGHT  // < Longest value axis in pixels
+
+/**
+ * Direction of the time axis
+ */
+enum StripMode {
+    STRIP_SWEEP,   // < Time left to right, wrapping cursor
+    STRIP_SCROLL   // < Time top to bottom, hardware scroll
+};
+
+/**
+ * How a series is drawn
+ */
+enum StripStyle {
+    STRIP_LINE,    // < Line joining consecutive samples
+    STRIP_FILLED   // < Area between the baseline and the sample
+};
+
+/**
+ * Strip chart widget
+ * 
+ * 
+ * Keeps the last samples of every series in a ring buffer, one entry
+ * per time slice on screen, so the chart can be redrawn (e.g. after
+ * changing the range) without the caller storing anything.
+ */
+class StripChart {
+public:
+    /**
+     * Constructor - creates chart in a screen rectangle
+     * 
+     * display Display to draw on
+     * x, y Top-left corner
+     * w, h Size in pixels
+     * mode STRIP_SWEEP or STRIP_SCROLL
+     * 
+     * In STRIP_SCROLL mode x and w are ignored (full width).
+     */
+    StripChart(ST7789& display, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+               StripMode mode);
+    
+    /**
+     * Add a data series
+     * 
+     * color Color of the series
+     * style STRIP_LINE or STRIP_FILLED
+     * 
+     * returns Series index (order of values in push()), or -1 if full
+     */
+    int addSeries(uint16_t color, StripStyle style);
+    
+    /**
+     * Set value range shown on the value axis
+     * 
+     * minValue Value at the bottom (sweep) / left edge (scroll)
+     * maxValue Value at the top (sweep) / right edge (scroll)
+     * 
+     * Filled series are filled towards 0, or towards the nearest edge
+     * if 0 is outside the range. Call redraw() to apply to the history.
+     */
+    void setRange(int16_t minValue, int16_t maxValue);
+    
+    /**
+     * Set background color (takes effect at the next begin() or redraw())
+     */
+    void setBackground(uint16_t color);
+    
+    /**
+     * Clear the chart and the history
+     * 
+     * In STRIP_SCROLL mode this also sets up the hardware scroll area.
+     */
+    void begin();
+    
+    /**
+     * Add one sample per series and draw it
+     * 
+     * values One value per series, in addSeries() order
+     * 
+     * Returns once the slice is handed to DMA.
+     */
+    void push(const int16_t* values);
+    
+    /**
+     * Redraw the whole history from the ring buffer
+     */
+    void redraw();
+    
+    /**
+     * Number of time slices (history length) of this chart
+     */
+    uint16_t length() const { return _length; }
+
+private:
+    ST7789& _display;
+    StripMode _mode;
+    uint16_t _x, _y, _w, _h;
+    uint16_t _length;          // < Time axis length in pixels
+    uint16_t _span;            // < Value axis length in pixels
+    int16_t _minValue, _maxValue;
+    uint16_t _background;
+    
+    // ========== SERIES ==========
+    uint8_t _seriesCount;
+    uint16_t _colors[STRIP_MAX_SERIES];
+    StripStyle _styles[STRIP_MAX_SERIES];
+    
+    // ========== HISTORY ==========
+    // Ring buffer indexed by slice position: history[s][p] is the value
+    // drawn at time slice p (column in sweep mode, band line in scroll).
+    int16_t _history[STRIP_MAX_SERIES][STRIP_MAX_HISTORY];
+    uint16_t _head;            // < Slice position of the newest sample
+    uint16_t _count;           // < Valid samples in the ring
+    
+    // ========== RENDERING ==========
+    uint16_t _sliceBuf[2][STRIP_MAX_SLICE];  // < Double buffered slices
+    uint8_t _sliceIndex;
+    
+    uint16_t valueToPos(int16_t value) const;
+    void renderSlice(uint16_t* buf, uint16_t pos, bool hasPrevious);
+    void sendSlice(uint16_t pos, const uint16_t* buf);
+};
+
+#endif // STRIPCHART_H
@@ -0,0 +1,599 @@
+/**
+ * terminal.cpp
+ * Implementation of the VT100/ANSI terminal emulator
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "terminal.h"
+#include "font5x7.h"
+#include <string.h>
+
+/**
+ * ANSI 16 color palette in RGB565
+ * 
+ * Index 0-7 are the normal colors (SGR 30-37 / 40-47), 8-15 the
+ * bright ones (SGR 90-97 / 100-107, or bold + normal color).
+ */
+static const uint16_t TERM_PALETTE[16] = {
+    0x0000,  // 0 Black
+    0xA800,  // 1 Red
+    0x0540,  // 2 Green
+    0xAAA0,  // 3 Yellow (brown)
+    0x0015,  // 4 Blue
+    0xA815,  // 5 Magenta
+    0x0555,  // 6 Cyan
+    0xAD55,  // 7 White (light gray)
+    0x52AA,  // 8 Bright black (dark gray)
+    0xFAAA,  // 9 Bright red
+    0x57EA,  // 10 Bright green
+    0xFFEA,  // 11 Bright yellow
+    0x52BF,  // 12 Bright blue
+    0xFABF,  // 13 Bright magenta
+    0x57FF,  // 14 Bright cyan
+    0xFFFF   // 15 Bright white
+};
+
+#define TERM_DEFAULT_FG 7  // < Light gray text
+#define TERM_DEFAULT_BG 0  // < on black
+
+/**
+ * Constructor implementation
+ * 
+ * 
+ * Only stores the display reference. The grid is set up by reset().
+ */
+Terminal::Terminal(ST7789& display)
+    : _display(display), _implicitCR(true) {
+}
+
+/**
+ * Reset terminal
+ * 
+ * 
+ * The whole screen becomes one scroll area and the scroll offset is
+ * returned to 0, so physical and logical rows match again.
+ */
+void Terminal::reset() {
+    _top = 0;
+    _cx = _cy = 0;
+    _savedX = _savedY = 0;
+    _wrapPending = false;
+    _cursorVisible = true;
+    _drawnCursor = false;
+    _drawnCx = _drawnCy = 0;
+    _fg = TERM_DEFAULT_FG;
+    _bg = TERM_DEFAULT_BG;
+    _bold = _reverse = false;
+    updateAttr();
+    _state = STATE_GROUND;
+    _paramCount = 0;
+    _privateMode = false;
+    _cellsDrawn = _windowsSent = _scrolls = 0;
+    
+    // Blank grid, every cell dirty so flush() repaints everything
+    for (int row = 0; row < TERM_ROWS; row++) {
+        for (int col = 0; col < TERM_COLS; col++) {
+            _cells[row][col].ch = ' ';
+            _cells[row][col].attr = _attr;
+        }
+        _dirty[row] = (1ULL << TERM_COLS) - 1;
+    }
+    
+    _display.setScrollArea(0, 0);
+    _scrollPending = true;
+}
+
+void Terminal::setImplicitCR(bool enable) {
+    _implicitCR = enable;
+}
+
+void Terminal::print(const char* str) {
+    write(str, strlen(str));
+}
+
+void Terminal::write(const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        write(data[i]);
+    }
+}
+
+/**
+ * Process one received byte
+ * 
+ * 
+ * Small state machine: ground state handles text and control
+ * characters, ESC switches to the escape state, ESC [ to the CSI
+ * state which collects parameters until a final byte (0x40-0x7E).
+ */
+void Terminal::write(char ch) {
+    uint8_t c = (uint8_t)ch;
+    
+    // CAN and SUB abort any escape sequence (VT100 behaviour)
+    if (c == 0x18 || c == 0x1A) {
+        _state = STATE_GROUND;
+        return;
+    }
+    
+    switch (_state) {
+    case STATE_GROUND:
+        if (c == 0x1B) {
+            _state = STATE_ESCAPE;
+        } else if (c >= 0x20) {
+            putChar(c);
+        } else {
+            // ========== CONTROL CHARACTERS ==========
+            switch (c) {
+            case '\r':
+                moveCursor(0, _cy);
+                break;
+            case '\n':
+            case '\v':
+            case '\f':
+                if (_implicitCR) moveCursor(0, _cy);
+                lineFeed();
+                break;
+            case '\b':
+                moveCursor(_cx - 1, _cy);
+                break;
+            case '\t':
+                moveCursor((_cx + 8) & ~7, _cy);
+                break;
+            default:
+                break;  // BEL and others are ignored
+            }
+        }
+        break;
+    
+    case STATE_ESCAPE:
+        handleEscape(c);
+        break;
+    
+    case STATE_CSI:
+        handleCSI(c);
+        break;
+    }
+}
+
+/**
+ * Write printable character at cursor position
+ * 
+ * 
+ * Uses deferred wrap like a real VT100: writing into the last column
+ * leaves the cursor there, and the wrap happens only when the next
+ * character arrives. This way "40 characters + CR LF" does not
+ * produce an empty line.
+ */
+void Terminal::putChar(uint8_t c) {
+    // Bytes outside the font (UTF-8, 8-bit codes) are shown as '?'
+    if (c > FONT5X7_LAST) c = '?';
+    
+    if (_wrapPending) {
+        moveCursor(0, _cy);
+        lineFeed();
+    }
+    
+    setCell(physRow(_cy), _cx, c, _attr);
+    
+    if (_cx == TERM_COLS - 1) {
+        _wrapPending = true;
+    } else {
+        _cx++;
+    }
+}
+
+/**
+ * Update one cell
+ * 
+ * 
+ * This is where dirty tracking happens: the dirty bit is only set if
+ * the cell really changes. Rewriting identical text (e.g. a status
+ * line redrawn every second) costs no display traffic at all.
+ */
+void Terminal::setCell(uint8_t row, uint8_t col, uint8_t ch, uint8_t attr) {
+    Cell& cell = _cells[row][col];
+    if (cell.ch == ch && cell.attr == attr) return;
+    
+    cell.ch = ch;
+    cell.attr = attr;
+    _dirty[row] |= 1ULL << col;
+}
+
+/**
+ * Blank cells from..to (inclusive) on a physical row
+ * 
+ * Erased cells take the current background color, as on xterm.
+ */
+void Terminal::clearCells(uint8_t row, uint8_t from, uint8_t to) {
+    uint8_t attr = (_bg << 4) | TERM_DEFAULT_FG;
+    for (uint8_t col = from; col <= to; col++) {
+        setCell(row, col, ' ', attr);
+    }
+}
+
+/**
+ * Move cursor down one row, scrolling at the bottom
+ */
+void Terminal::lineFeed() {
+    _wrapPending = false;
+    if (_cy == TERM_ROWS - 1) {
+        scrollUp();
+    } else {
+        _cy++;
+    }
+}
+
+/**
+ * Move cursor up one row, scrolling down at the top
+ */
+void Terminal::reverseLineFeed() {
+    _wrapPending = false;
+    if (_cy == 0) {
+        scrollDown();
+    } else {
+        _cy--;
+    }
+}
+
+/**
+ * Scroll the screen content up by one row
+ * 
+ * 
+ * No pixels are moved: the logical-to-physical row mapping rotates by
+ * one, the row that scrolled off the top becomes the new bottom row
+ * and is cleared. flush() later moves the display's scroll start
+ * address to match (VSCRSADD).
+ */
+void Terminal::scrollUp() {
+    uint8_t freed = _top;
+    _top = (_top + 1) % TERM_ROWS;
+    clearCells(freed, 0, TERM_COLS - 1);
+    _scrollPending = true;
+}
+
+/**
+ * Scroll the screen content down by one row
+ */
+void Terminal::scrollDown() {
+    _top = (_top + TERM_ROWS - 1) % TERM_ROWS;
+    clearCells(_top, 0, TERM_COLS - 1);
+    _scrollPending = true;
+}
+
+/**
+ * Move cursor to absolute position, clamped to the screen
+ */
+void Terminal::moveCursor(int col, int row) {
+    if (col < 0) col = 0;
+    if (col >= TERM_COLS) col = TERM_COLS - 1;
+    if (row < 0) row = 0;
+    if (row >= TERM_ROWS) row = TERM_ROWS - 1;
+    
+    _cx = col;
+    _cy = row;
+    _wrapPending = false;
+}
+
+/**
+ * Recompute the cell attribute from the SGR state
+ * 
+ * Bold brightens the 8 normal foreground colors, reverse swaps
+ * foreground and background.
+ */
+void Terminal::updateAttr() {
+    uint8_t fg = _fg;
+    uint8_t bg = _bg;
+    if (_bold && fg < 8) fg += 8;
+    if (_reverse) {
+        uint8_t tmp = fg;
+        fg = bg;
+        bg = tmp;
+    }
+    _attr = (bg << 4) | fg;
+}
+
+/**
+ * Character after ESC
+ */
+void Terminal::handleEscape(uint8_t c) {
+    _state = STATE_GROUND;
+    
+    switch (c) {
+    case '[':
+        _state = STATE_CSI;
+        _paramCount = 0;
+        _params[0] = 0;
+        _privateMode = false;
+        break;
+    case 'c':
+        reset();
+        break;
+    case '7':
+        _savedX = _cx;
+        _savedY = _cy;
+        break;
+    case '8':
+        moveCursor(_savedX, _savedY);
+        break;
+    case 'D':
+        lineFeed();
+        break;
+    case 'E':
+        moveCursor(0, _cy);
+        lineFeed();
+        break;
+    case 'M':
+        reverseLineFeed();
+        break;
+    default:
+        break;  // Unsupported, ignore
+    }
+}
+
+/**
+ * Return CSI parameter, or fallback if missing or zero
+ * 
+ * ANSI treats an omitted parameter and 0 the same for most commands
+ * ("CSI A" = "CSI 0 A" = "CSI 1 A").
+ */
+uint16_t Terminal::param(uint8_t index, uint16_t fallback) const {
+    if (index >= _paramCount || _params[index] == 0) return fallback;
+    return _params[index];
+}
+
+/**
+ * Character inside a CSI sequence
+ * 
+ * 
+ * Parameter bytes are digits and ';'. The first byte in the
+ * 0x40-0x7E range ends the sequence and selects the command.
+ */
+void Terminal::handleCSI(uint8_t c) {
+    // ========== PARAMETER COLLECTION ==========
+    if (c >= '0' && c <= '9') {
+        if (_paramCount == 0) _paramCount = 1;
+        uint16_t& p = _params[_paramCount - 1];
+        if (p < 10000) p = p * 10 + (c - '0');
+        return;
+    }
+    if (c == ';') {
+        if (_paramCount == 0) _paramCount = 1;
+        if (_paramCount < TERM_MAX_PARAMS) _params[_paramCount++] = 0;
+        return;
+    }
+    if (c == '?') {
+        _privateMode = true;
+        return;
+    }
+    if (c < 0x40 || c > 0x7E) {
+        return;  // Intermediate bytes are ignored
+    }
+    
+    // ========== FINAL BYTE ==========
+    _state = STATE_GROUND;
+    
+    switch (c) {
+    case 'A':
+        moveCursor(_cx, _cy - param(0, 1));
+        break;
+    case 'B':
+        moveCursor(_cx, _cy + param(0, 1));
+        break;
+    case 'C':
+        moveCursor(_cx + param(0, 1), _cy);
+        break;
+    case 'D':
+        moveCursor(_cx - param(0, 1), _cy);
+        break;
+    case 'E':
+        moveCursor(0, _cy + param(0, 1));
+        break;
+    case 'F':
+        moveCursor(0, _cy - param(0, 1));
+        break;
+    case 'G':
+        moveCursor(param(0, 1) - 1, _cy);
+        break;
+    case 'd':
+        moveCursor(_cx, param(0, 1) - 1);
+        break;
+    case 'H':
+    case 'f':
+        // Parameters are 1-based row;column
+        moveCursor(param(1, 1) - 1, param(0, 1) - 1);
+        break;
+    
+    case 'J': {
+        // 0 = cursor to end, 1 = start to cursor, 2 = whole screen
+        uint16_t mode = _paramCount ? _params[0] : 0;
+        if (mode == 0) {
+            clearCells(physRow(_cy), _cx, TERM_COLS - 1);
+            for (int row = _cy + 1; row < TERM_ROWS; row++) {
+                clearCells(physRow(row), 0, TERM_COLS - 1);
+            }
+        } else if (mode == 1) {
+            for (int row = 0; row < _cy; row++) {
+                clearCells(physRow(row), 0, TERM_COLS - 1);
+            }
+            clearCells(physRow(_cy), 0, _cx);
+        } else {
+            for (int row = 0; row < TERM_ROWS; row++) {
+                clearCells(row, 0, TERM_COLS - 1);
+            }
+        }
+        break;
+    }
+    
+    case 'K': {
+        // 0 = cursor to end of line, 1 = start to cursor, 2 = whole line
+        uint16_t mode = _paramCount ? _params[0] : 0;
+        uint8_t row = physRow(_cy);
+        if (mode == 0) {
+            clearCells(row, _cx, TERM_COLS - 1);
+        } else if (mode == 1) {
+            clearCells(row, 0, _cx);
+        } else {
+            clearCells(row, 0, TERM_COLS - 1);
+        }
+        break;
+    }
+    
+    case 'm':
+        handleSGR();
+        break;
+    case 's':
+        _savedX = _cx;
+        _savedY = _cy;
+        break;
+    case 'u':
+        moveCursor(_savedX, _savedY);
+        break;
+    case 'h':
+    case 'l':
+        // Only DECTCEM (cursor visibility) is supported
+        if (_privateMode && param(0, 0) == 25) {
+            _cursorVisible = (c == 'h');
+        }
+        break;
+    default:
+        break;  // Unsupported, ignore
+    }
+}
+
+/**
+ * Select Graphic Rendition (CSI ... m)
+ * 
+ * Every parameter is applied in order, "CSI m" alone means reset.
+ */
+void Terminal::handleSGR() {
+    if (_paramCount == 0) {
+        _params[0] = 0;
+        _paramCount = 1;
+    }
+    
+    for (uint8_t i = 0; i < _paramCount; i++) {
+        uint16_t p = _params[i];
+        if (p == 0) {
+            _fg = TERM_DEFAULT_FG;
+            _bg = TERM_DEFAULT_BG;
+            _bold = _reverse = false;
+        } else if (p == 1) {
+            _bold = true;
+        } else if (p == 7) {
+            _reverse = true;
+        } else if (p == 22) {
+            _bold = false;
+        } else if (p == 27) {
+            _reverse = false;
+        } else if (p >= 30 && p <= 37) {
+            _fg = p - 30;
+        } else if (p == 39) {
+            _fg = TERM_DEFAULT_FG;
+        } else if (p >= 40 && p <= 47) {
+            _bg = p - 40;
+        } else if (p == 49) {
+            _bg = TERM_DEFAULT_BG;
+        } else if (p >= 90 && p <= 97) {
+            _fg = p - 90 + 8;
+        } else if (p >= 100 && p <= 107) {
+            _bg = p - 100 + 8;
+        }
+    }
+    updateAttr();
+}
+
+/**
+ * Send pending changes to the display
+ * 
+ * 
+ * 1. Apply hardware scroll (one command, however many line feeds)
+ * 2. Mark old and new cursor cells dirty if the cursor moved
+ * 3. For each row, group dirty cells into runs and draw each run
+ *    with a single window
+ */
+void Terminal::flush() {
+    // ========== HARDWARE SCROLL ==========
+    if (_scrollPending) {
+        _display.setScrollStart(_top * TERM_CELL_H);
+        _scrollPending = false;
+        _scrolls++;
+    }
+    
+    // ========== CURSOR ==========
+    uint8_t cursorRow = physRow(_cy);
+    if (_drawnCursor != _cursorVisible || _drawnCx != _cx || _drawnCy != cursorRow) {
+        if (_drawnCursor) _dirty[_drawnCy] |= 1ULL << _drawnCx;
+        if (_cursorVisible) _dirty[cursorRow] |= 1ULL << _cx;
+        _drawnCursor = _cursorVisible;
+        _drawnCx = _cx;
+        _drawnCy = cursorRow;
+    }
+    
+    // ========== DIRTY RUNS ==========
+    for (uint8_t row = 0; row < TERM_ROWS; row++) {
+        uint64_t dirty = _dirty[row];
+        if (!dirty) continue;
+        _dirty[row] = 0;
+        
+        uint8_t col = 0;
+        while (col < TERM_COLS) {
+            // Skip clean cells
+            if (!(dirty & (1ULL << col))) {
+                col++;
+                continue;
+            }
+            
+            // Extend the run while the next dirty cell is close enough
+            uint8_t from = col;
+            uint8_t to = col;
+            for (uint8_t next = col + 1; next < TERM_COLS; next++) {
+                if (dirty & (1ULL << next)) {
+                    if (next - to - 1 > TERM_MERGE_GAP) break;
+                    to = next;
+                }
+            }
+            
+            drawRun(row, from, to);
+            col = to + 1;
+        }
+    }
+}
+
+/**
+ * Render cells from..to of a physical row and send them
+ * 
+ * 
+ * The run is rendered into _lineBuf as a (cells × 6) by 8 pixel
+ * block, then sent with one drawBuffer() call.
+ */
+void Terminal::drawRun(uint8_t row, uint8_t from, uint8_t to) {
+    uint16_t width = (to - from + 1) * TERM_CELL_W;
+    
+    for (uint8_t col = from; col <= to; col++) {
+        const Cell& cell = _cells[row][col];
+        uint16_t fg = TERM_PALETTE[cell.attr & 0x0F];
+        uint16_t bg = TERM_PALETTE[cell.attr >> 4];
+        
+        // The cursor is shown as an inverted cell
+        if (_drawnCursor && row == _drawnCy && col == _drawnCx) {
+            uint16_t tmp = fg;
+            fg = bg;
+            bg = tmp;
+        }
+        
+        const uint8_t* glyph = FONT5X7[cell.ch - FONT5X7_FIRST];
+        uint16_t* dst = &_lineBuf[(col - from) * TERM_CELL_W];
+        
+        // Glyph columns, then the spacing column
+        for (uint8_t x = 0; x < TERM_CELL_W; x++) {
+            uint8_t bits = (x < FONT5X7_WIDTH) ? glyph[x] : 0;
+            for (uint8_t y = 0; y < TERM_CELL_H; y++) {
+                dst[y * width + x] = (bits & (1 << y)) ? fg : bg;
+            }
+        }
+    }
+    
+    _display.drawBuffer(from * TERM_CELL_W, row * TERM_CELL_H, width, TERM_CELL_H, _lineBuf);
+    _cellsDrawn += to - from + 1;
+    _windowsSent++;
+}
@@ -0,0 +1,244 @@
+/**
+ * terminal.h
+ * VT100/ANSI terminal emulator on top of the ST7789 driver
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Turns the display into a serial console. Bytes received from a
+ * target (UART, USB CDC, ...) are fed into write(), which interprets
+ * printable characters, control characters and the common ANSI escape
+ * sequences (colors, cursor movement, erase).
+ * 
+ * 
+ * The screen is a grid of 40×40 character cells (6×8 pixels each,
+ * using the 5×7 font). Drawing is deferred:
+ * - write() only updates the cell grid in RAM and sets a dirty bit
+ *   for every cell whose character or color actually changed
+ * - flush() sends the dirty cells to the display. Neighbouring dirty
+ *   cells on a row are coalesced into one window, so a full line of
+ *   text costs one setWindow() instead of 40
+ * 
+ * Line feeds at the bottom of the screen use the ST7789 hardware
+ * vertical scroll: the display just starts reading its memory 8 lines
+ * further down, and only the newly exposed row is redrawn. Several
+ * line feeds between two flush() calls result in a single scroll
+ * command.
+ * 
+ * 
+ * Supported sequences:
+ * - Control: CR, LF, BS, TAB, BEL (ignored)
+ * - ESC c (reset), ESC 7 / ESC 8 (save/restore cursor),
+ *   ESC D (index), ESC M (reverse index), ESC E (next line)
+ * - CSI n A/B/C/D/E/F/G/d, CSI row;col H/f (cursor movement)
+ * - CSI n J, CSI n K (erase display / line)
+ * - CSI ... m (SGR: reset, bold, reverse, 16 fg/bg colors)
+ * - CSI s / CSI u (save/restore cursor), CSI ?25 h/l (cursor on/off)
+ * 
+ * example:
+ * 
+ * Terminal term(display);
+ * term.reset();
+ * term.print("\x1b[32mOK\x1b[0m boot complete\n");
+ * term.flush();
+ * 
+ */
+
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+
+/**
+ * Character cell geometry
+ * 
+ * 5×7 glyphs with one pixel of spacing to the right and below.
+ */
+#define TERM_CELL_W  6                               // < Cell width in pixels
+#define TERM_CELL_H  8                               // < Cell height in pixels
+#define TERM_COLS    (SCREEN_WIDTH / TERM_CELL_W)    // < Columns (40)
+#define TERM_ROWS    (SCREEN_HEIGHT / TERM_CELL_H)   // < Rows (40)
+
+/**
+ * Maximum number of numeric parameters in one CSI sequence
+ */
+#define TERM_MAX_PARAMS 8
+
+/**
+ * Clean cells allowed inside a coalesced run
+ * 
+ * Two dirty runs separated by at most this many clean cells are sent
+ * as one window. Redrawing a couple of unchanged cells is cheaper than
+ * the command overhead of a second setWindow().
+ */
+#define TERM_MERGE_GAP 2
+
+/**
+ * Terminal emulator widget
+ * 
+ * 
+ * Owns the character grid and the ANSI parser state. All memory is
+ * static (about 7 KB for the grid and the line buffer), nothing is
+ * allocated at runtime.
+ * 
+ * The terminal takes over the whole screen and the hardware scroll
+ * region. Do not draw to the display directly while it is in use.
+ */
+class Terminal {
+public:
+    /**
+     * Constructor - creates terminal on an initialized display
+     * 
+     * display Display to draw on (init() must already be called)
+     * 
+     * Call reset() before the first write() to set up the screen.
+     */
+    Terminal(ST7789& display);
+    
+    /**
+     * Reset terminal to power-on state
+     * 
+     * 
+     * Clears the grid, homes the cursor, restores default colors,
+     * resets the hardware scroll and marks every cell dirty, so the
+     * next flush() repaints the whole screen.
+     */
+    void reset();
+    
+    /**
+     * Feed received bytes into the terminal
+     * 
+     * data Pointer to received bytes
+     * len Number of bytes
+     * 
+     * 
+     * Only the cell grid in RAM is updated. Call flush() to make the
+     * changes visible - typically once per received block of data.
+     */
+    void write(const char* data, size_t len);
+    
+    /**
+     * Feed a single byte into the terminal
+     * 
+     * c Received byte
+     */
+    void write(char c);
+    
+    /**
+     * Feed a zero-terminated string into the terminal
+     * 
+     * str String to write
+     */
+    void print(const char* str);
+    
+    /**
+     * Send all pending changes to the display
+     * 
+     * 
+     * Applies a pending hardware scroll, then redraws every dirty cell.
+     * Dirty cells on a row are grouped into runs, each run is rendered
+     * into a line buffer and sent with one drawBuffer() call.
+     */
+    void flush();
+    
+    /**
+     * Choose what a line feed does
+     * 
+     * enable true = LF also returns to column 0 (default)
+     *        false = LF only moves down, as on a real VT100
+     * 
+     * Most embedded targets print "\n" only, so implicit CR is on
+     * by default.
+     */
+    void setImplicitCR(bool enable);
+    
+    /**
+     * Statistics since the last reset()
+     * 
+     * cellsDrawn() Number of cells sent to the display
+     * windowsSent() Number of drawBuffer() calls (one per run)
+     * scrolls() Number of hardware scroll commands
+     */
+    uint32_t cellsDrawn() const { return _cellsDrawn; }
+    uint32_t windowsSent() const { return _windowsSent; }
+    uint32_t scrolls() const { return _scrolls; }
+
+private:
+    /**
+     * One character cell
+     * 
+     * attr holds the foreground palette index in the low nibble and
+     * the background palette index in the high nibble.
+     */
+    struct Cell {
+        uint8_t ch;    // < Character code (0x20 - 0x7E)
+        uint8_t attr;  // < Colors: bg << 4 | fg
+    };
+    
+    /**
+     * Escape sequence parser states
+     */
+    enum ParserState {
+        STATE_GROUND,  // < Normal text
+        STATE_ESCAPE,  // < After ESC
+        STATE_CSI      // < After ESC [
+    };
+    
+    ST7789& _display;  // < Display to draw on
+    
+    // ========== SCREEN STATE ==========
+    // Rows are stored in frame memory order. Logical row 0 (top of the
+    // visible screen) is physical row _top, see physRow().
+    Cell _cells[TERM_ROWS][TERM_COLS];  // < Character grid
+    uint64_t _dirty[TERM_ROWS];         // < One dirty bit per cell
+    uint8_t _top;                       // < Physical row shown at the top
+    bool _scrollPending;                // < setScrollStart() needed
+    
+    // ========== CURSOR AND ATTRIBUTES ==========
+    uint8_t _cx, _cy;            // < Cursor column and logical row
+    uint8_t _savedX, _savedY;    // < Saved cursor position
+    bool _wrapPending;           // < Next character wraps to a new line
+    bool _cursorVisible;         // < Cursor shown as an inverted cell
+    uint8_t _drawnCx, _drawnCy;  // < Where the cursor was drawn (physical)
+    bool _drawnCursor;           // < Whether the cursor is drawn there
+    uint8_t _fg, _bg;            // < Current SGR colors (0-15)
+    bool _bold, _reverse;        // < Current SGR flags
+    uint8_t _attr;               // < Cell attribute derived from the above
+    bool _implicitCR;            // < LF also does CR
+    
+    // ========== PARSER ==========
+    ParserState _state;                  // < Current parser state
+    uint16_t _params[TERM_MAX_PARAMS];   // < CSI numeric parameters
+    uint8_t _paramCount;                 // < Parameters collected so far
+    bool _privateMode;                   // < CSI sequence started with '?'
+    
+    // ========== STATISTICS ==========
+    uint32_t _cellsDrawn;
+    uint32_t _windowsSent;
+    uint32_t _scrolls;
+    
+    // ========== RENDERING ==========
+    // Large enough for a full row of cells
+    uint16_t _lineBuf[TERM_COLS * TERM_CELL_W * TERM_CELL_H];
+    
+    uint8_t physRow(uint8_t row) const { return (_top + row) % TERM_ROWS; }
+    
+    void putChar(uint8_t c);
+    void setCell(uint8_t row, uint8_t col, uint8_t ch, uint8_t attr);
+    void clearCells(uint8_t row, uint8_t from, uint8_t to);
+    void lineFeed();
+    void reverseLineFeed();
+    void scrollUp();
+    void scrollDown();
+    void moveCursor(int col, int row);
+    void updateAttr();
+    void handleEscape(uint8_t c);
+    void handleCSI(uint8_t c);
+    void handleSGR();
+    uint16_t param(uint8_t index, uint16_t fallback) const;
+    void drawRun(uint8_t row, uint8_t from, uint8_t to);
+};
+
+#endif // TERMINAL_H
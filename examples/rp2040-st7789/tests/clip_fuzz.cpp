@@ -0,0 +1,491 @@
+/**
+ * clip_fuzz.cpp
+ * Random drawing under random clip stacks, checked against a reference
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Each iteration clears the panel, builds a random clip stack (pushes
+ * past ST7789_CLIP_DEPTH, pops past the screen) and makes a few random
+ * drawing calls partly or wholly off the clip and the screen. A
+ * reference applies the same calls to its own copy of the frame
+ * memory, writing only inside the clip; the two must be equal.
+ * 
+ * The traffic of every call is checked as well: each window the
+ * driver opens lies inside the visible part of the call, none gets
+ * more pixels than it holds, and exactly the visible pixels are sent.
+ * Batches (fillRects(), drawPixels(), drawSpans()) overlap and cross
+ * the clip; their window count is checked against the merging rules.
+ * 
+ * usage: clip_fuzz [iterations] [seed]
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hostpanel.h"
+#include "st7789.h"
+#include "fill.h"
+
+#define PIN_CS   17
+#define PIN_DC   16
+#define PIN_RST  20
+#define PIN_SCK  18
+#define PIN_MOSI 19
+
+#define OPS_PER_ITERATION 6
+#define MAX_BUFFER (400 * 400)   // < Largest drawBuffer() source
+#define MAX_BATCH  200             // < Largest batch
+
+static ST7789 s_display(spi0, PIN_CS, PIN_DC, PIN_RST, PIN_SCK, PIN_MOSI);
+static uint16_t s_expected[SCREEN_HEIGHT][SCREEN_WIDTH];
+static uint16_t s_saved[SCREEN_HEIGHT][SCREEN_WIDTH];
+static uint16_t s_buffer[MAX_BUFFER];
+static bool s_covered[SCREEN_HEIGHT][SCREEN_WIDTH];   // < Visible pixels of a batch
+
+// Reference clip stack
+static Rect s_clips[ST7789_CLIP_DEPTH];
+static uint8_t s_depth;
+
+static uint32_t s_seed;
+static uint32_t s_iteration;
+static const char* s_op;
+
+// ========== HELPERS ==========
+
+/**
+ * xorshift32: the same sequence on every host
+ */
+static uint32_t random32() {
+    s_seed ^= s_seed << 13;
+    s_seed ^= s_seed >> 17;
+    s_seed ^= s_seed << 5;
+    return s_seed;
+}
+
+static int32_t randomIn(int32_t lo, int32_t hi) {
+    return lo + (int32_t)(random32() % (uint32_t)(hi - lo + 1));
+}
+
+static const Rect& clip() {
+    return s_clips[s_depth];
+}
+
+static bool inClip(int32_t x, int32_t y) {
+    const Rect& c = clip();
+    return x >= c.x && y >= c.y && x < c.x + c.w && y < c.y + c.h;
+}
+
+static void fail(const char* what) {
+    const Rect& c = clip();
+    printf("FAIL iteration %u, %s: %s (clip %d,%d %dx%d, depth %u)\n", s_iteration, s_op, what,
+           c.x, c.y, c.w, c.h, s_depth);
+    exit(1);
+}
+
+/**
+ * The traffic since the last check fits the visible part of a call
+ * and sends each of its pixels once
+ */
+static void checkTraffic(const Rect& drawn) {
+    Rect visible = rectIntersect(drawn, clip());
+    const PanelTraffic& t = panelTraffic();
+    
+    if (t.formatErrors) fail("SPI frame size does not match the write");
+    if (t.strayBytes) fail("bytes sent with CS high");
+    if (t.wrapped) fail("more pixels than the window holds");
+    if (t.pixels != (uint32_t)rectArea(visible)) {
+        char what[64];
+        snprintf(what, sizeof(what), "%u pixels sent, %d visible", t.pixels, rectArea(visible));
+        fail(what);
+    }
+    for (uint32_t i = 0; i < t.windows && i < PANEL_LOG_SIZE; i++) {
+        const PanelWindow& w = t.log[i];
+        if (!rectContains(visible, w.area)) fail("window outside the visible part");
+    }
+    panelResetTraffic();
+}
+
+static void expectPixel(int32_t x, int32_t y, uint16_t color) {
+    if (inClip(x, y)) s_expected[y][x] = color;
+}
+
+/**
+ * The traffic since the last check sends each pixel of s_covered once,
+ * in one-row windows inside the clip, one per run of touching pixels
+ * in a row (what drawPixels() and drawSpans() merge); returned is the
+ * driver's window count
+ */
+static void checkBatchTraffic(uint32_t returned) {
+    const PanelTraffic& t = panelTraffic();
+    uint32_t pixels = 0;
+    uint32_t runs = 0;
+    for (int32_t y = 0; y < SCREEN_HEIGHT; y++) {
+        for (int32_t x = 0; x < SCREEN_WIDTH; x++) {
+            if (!s_covered[y][x]) continue;
+            pixels++;
+            if (x == 0 || !s_covered[y][x - 1]) runs++;
+        }
+    }
+    
+    if (t.formatErrors) fail("SPI frame size does not match the write");
+    if (t.strayBytes) fail("bytes sent with CS high");
+    if (t.wrapped) fail("more pixels than the window holds");
+    if (t.pixels != pixels) fail("pixels sent differ from the visible ones");
+    if (t.windows != runs) fail("windows do not match the runs of visible pixels");
+    if (returned != t.windows) fail("returned window count");
+    for (uint32_t i = 0; i < t.windows && i < PANEL_LOG_SIZE; i++) {
+        const PanelWindow& w = t.log[i];
+        if (!rectContains(clip(), w.area) || w.area.h != 1) fail("window not a row inside the clip");
+    }
+    panelResetTraffic();
+}
+
+// ========== CLIP STACK ==========
+
+static void push(const Rect& r) {
+    bool fits = s_depth + 1 < ST7789_CLIP_DEPTH;
+    if (s_display.pushClip(r) != fits) fail("pushClip() result");
+    if (fits) {
+        s_clips[s_depth + 1] = rectIntersect(r, s_clips[s_depth]);
+        s_depth++;
+    }
+}
+
+static void pop() {
+    s_display.popClip();
+    if (s_depth > 0) s_depth--;
+}
+
+static void randomClipStack() {
+    s_op = "clip stack";
+    s_display.resetClip();
+    s_depth = 0;
+    s_clips[0] = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    
+    int32_t pushes = randomIn(0, ST7789_CLIP_DEPTH + 1);
+    for (int32_t i = 0; i < pushes; i++) {
+        Rect r = { (int16_t)randomIn(-50, 260), (int16_t)randomIn(-50, 340),
+                   (int16_t)randomIn(-10, 300), (int16_t)randomIn(-10, 380) };
+        push(r);
+        if (random32() % 4 == 0) pop();
+    }
+    if (random32() % 8 == 0) {
+        for (int32_t i = randomIn(1, 3); i > 0; i--) pop();
+    }
+    
+    const Rect& c = s_display.clipRect();
+    if (c.x != clip().x || c.y != clip().y || c.w != clip().w || c.h != clip().h) fail("clipRect()");
+}
+
+/**
+ * Put the reference stack back on the display (after an unclipped run)
+ */
+static void restoreClipStack() {
+    s_display.resetClip();
+    for (uint8_t i = 1; i <= s_depth; i++) s_display.pushClip(s_clips[i]);
+}
+
+// ========== OPERATIONS ==========
+
+static Rect randomRect(int32_t maxW, int32_t maxH) {
+    if (random32() % 3 == 0) {  // Small, mostly on screen
+        return { (int16_t)randomIn(-20, 250), (int16_t)randomIn(-20, 330),
+                 (int16_t)randomIn(0, 30), (int16_t)randomIn(0, 30) };
+    }
+    return { (int16_t)randomIn(-300, 300), (int16_t)randomIn(-350, 350),
+             (int16_t)randomIn(0, maxW), (int16_t)randomIn(0, maxH) };
+}
+
+static void opFillRect() {
+    s_op = "fillRect()";
+    Rect r = randomRect(350, 400);
+    uint16_t color = random32();
+    
+    s_display.fillRect(r.x, r.y, r.w, r.h, color);
+    checkTraffic(r);
+    for (int32_t y = r.y; y < r.y + r.h; y++) {
+        for (int32_t x = r.x; x < r.x + r.w; x++) expectPixel(x, y, color);
+    }
+}
+
+static void opDrawPixel() {
+    s_op = "drawPixel()";
+    for (int32_t i = 0; i < 20; i++) {
+        Rect r = { (int16_t)randomIn(-5, SCREEN_WIDTH + 5), (int16_t)randomIn(-5, SCREEN_HEIGHT + 5), 1, 1 };
+        uint16_t color = random32();
+        
+        s_display.drawPixel(r.x, r.y, color);
+        checkTraffic(r);
+        expectPixel(r.x, r.y, color);
+    }
+}
+
+/**
+ * drawBuffer(), drawBufferAsync() (both go through sendClipped() when
+ * rows are cut) or beginPixels() with writePixelsAsync() in random
+ * pieces that start and end anywhere in a row
+ */
+static void opBuffer(uint8_t mode) {
+    static const char* names[] = { "drawBuffer()", "drawBufferAsync()", "writePixelsAsync()" };
+    s_op = names[mode];
+    Rect r = randomRect(350, 400);
+    if ((int32_t)r.w * r.h > MAX_BUFFER) r.h = MAX_BUFFER / (r.w ? r.w : 1);
+    uint32_t count = (uint32_t)r.w * r.h;
+    for (uint32_t i = 0; i < count; i++) s_buffer[i] = random32();
+    
+    if (mode == 0) {
+        s_display.drawBuffer(r.x, r.y, r.w, r.h, s_buffer);
+    } else if (mode == 1) {
+        s_display.drawBufferAsync(r.x, r.y, r.w, r.h, s_buffer);
+    } else {
+        s_display.beginPixels(r.x, r.y, r.w, r.h);
+        for (uint32_t i = 0; i < count; ) {
+            uint32_t n = randomIn(1, 300);
+            if (n > count - i) n = count - i;
+            s_display.writePixelsAsync(s_buffer + i, n);
+            i += n;
+        }
+    }
+    s_display.waitIdle();
+    checkTraffic(r);
+    
+    for (int32_t y = r.y; y < r.y + r.h; y++) {
+        for (int32_t x = r.x; x < r.x + r.w; x++) {
+            expectPixel(x, y, s_buffer[(y - r.y) * r.w + (x - r.x)]);
+        }
+    }
+}
+
+/**
+ * Overlapping rectangles in one color: one window per visible
+ * rectangle, exactly its visible part, in array order
+ */
+static void opFillRects() {
+    s_op = "fillRects()";
+    Rect rects[16];
+    uint32_t count = randomIn(0, 16);
+    for (uint32_t i = 0; i < count; i++) rects[i] = randomRect(150, 150);
+    uint16_t color = random32();
+    
+    uint32_t windows = s_display.fillRects(rects, count, color);
+    const PanelTraffic& t = panelTraffic();
+    if (t.formatErrors || t.strayBytes || t.wrapped) fail("SPI traffic");
+    uint32_t visible = 0;
+    uint32_t pixels = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        Rect r = rectIntersect(rects[i], clip());
+        if (rectEmpty(r)) continue;
+        if (visible < PANEL_LOG_SIZE) {
+            const Rect& w = t.log[visible].area;
+            if (w.x != r.x || w.y != r.y || w.w != r.w || w.h != r.h) fail("window is not the visible part");
+        }
+        visible++;
+        pixels += rectArea(r);
+    }
+    if (windows != visible || t.windows != visible) fail("window count");
+    if (t.pixels != pixels) fail("pixels sent differ from the visible ones");
+    panelResetTraffic();
+    
+    for (uint32_t i = 0; i < count; i++) {
+        const Rect& r = rects[i];
+        for (int32_t y = r.y; y < r.y + r.h; y++) {
+            for (int32_t x = r.x; x < r.x + r.w; x++) expectPixel(x, y, color);
+        }
+    }
+}
+
+/**
+ * Scattered pixels and short clusters that form runs, around and
+ * across the clip; no position twice (which color wins is undefined)
+ */
+static void opDrawPixels() {
+    s_op = "drawPixels()";
+    static Point points[MAX_BATCH];
+    uint32_t count = 0;
+    uint32_t wanted = randomIn(0, MAX_BATCH);
+    while (count < wanted) {
+        int32_t x0 = randomIn(-10, SCREEN_WIDTH + 10);
+        int32_t y0 = randomIn(-5, SCREEN_HEIGHT + 5);
+        for (int32_t n = randomIn(1, 20); n > 0 && count < wanted; n--) {
+            Point p = { (int16_t)(x0 + randomIn(0, 12)), (int16_t)(y0 + randomIn(0, 2)), (uint16_t)random32() };
+            bool seen = false;
+            for (uint32_t i = 0; i < count && !seen; i++) seen = points[i].x == p.x && points[i].y == p.y;
+            if (!seen) points[count++] = p;
+        }
+    }
+    
+    memset(s_covered, 0, sizeof(s_covered));
+    for (uint32_t i = 0; i < count; i++) {
+        if (inClip(points[i].x, points[i].y)) s_covered[points[i].y][points[i].x] = true;
+        expectPixel(points[i].x, points[i].y, points[i].color);
+    }
+    checkBatchTraffic(s_display.drawPixels(points, count));
+}
+
+/**
+ * Spans stacked on a few rows so they touch and overlap, some past
+ * the clip and the screen; no two start at the same pixel (which one
+ * wins is undefined). The one that starts further left must win, so
+ * the reference paints them right to left.
+ */
+static void opDrawSpans() {
+    s_op = "drawSpans()";
+    static Span spans[MAX_BATCH];
+    uint32_t count = 0;
+    uint32_t wanted = randomIn(0, 40);
+    int32_t y0 = randomIn(-3, SCREEN_HEIGHT);
+    while (count < wanted) {
+        Span s = { (int16_t)randomIn(-60, SCREEN_WIDTH + 10), (int16_t)(y0 + randomIn(0, 3)),
+                   (uint16_t)randomIn(0, 90), (uint16_t)random32() };
+        bool seen = false;
+        for (uint32_t i = 0; i < count && !seen; i++) seen = spans[i].x == s.x && spans[i].y == s.y;
+        if (!seen) spans[count++] = s;
+    }
+    
+    // Reference before the call, which sorts the array
+    memset(s_covered, 0, sizeof(s_covered));
+    static bool painted[MAX_BATCH];
+    for (uint32_t n = 0; n < count; n++) {
+        uint32_t right = count;
+        for (uint32_t i = 0; i < count; i++) {
+            if (!painted[i] && (right == count || spans[i].x > spans[right].x)) right = i;
+        }
+        painted[right] = true;
+        const Span& s = spans[right];
+        for (int32_t x = s.x; x < s.x + s.w; x++) {
+            if (inClip(x, s.y)) s_covered[s.y][x] = true;
+            expectPixel(x, s.y, s.color);
+        }
+    }
+    memset(painted, 0, sizeof(painted));
+    checkBatchTraffic(s_display.drawSpans(spans, count));
+}
+
+static void fill(bool gradient, const Rect& r, uint16_t c0, uint16_t c1, uint8_t type, uint8_t size) {
+    if (gradient) {
+        fillRectGradient(s_display, r.x, r.y, r.w, r.h, c0, c1, (GradientType)type);
+    } else {
+        fillRectPattern(s_display, r.x, r.y, r.w, r.h, c0, c1, (PatternType)type, size);
+    }
+    s_display.waitIdle();
+}
+
+/**
+ * Gradients depend on the rectangle, not on the clip: the reference
+ * is the same fill without a clip (only the screen), masked to the clip
+ */
+static void opFill(bool gradient) {
+    s_op = gradient ? "fillRectGradient()" : "fillRectPattern()";
+    Rect r = { (int16_t)randomIn(-100, 200), (int16_t)randomIn(-100, 300),
+               (int16_t)randomIn(1, 300), (int16_t)randomIn(1, 300) };
+    uint16_t c0 = random32();
+    uint16_t c1 = random32();
+    uint8_t type = gradient ? randomIn(GRADIENT_HORIZONTAL, GRADIENT_RADIAL)
+                            : randomIn(PATTERN_CHECKER, PATTERN_CROSSHATCH);
+    uint8_t size = randomIn(1, 12);
+    
+    fill(gradient, r, c0, c1, type, size);
+    checkTraffic(r);
+    memcpy(s_saved, panelMemory, sizeof(panelMemory));
+    
+    s_display.resetClip();
+    fill(gradient, r, c0, c1, type, size);
+    panelResetTraffic();
+    restoreClipStack();
+    
+    for (int32_t y = r.y; y < r.y + r.h; y++) {
+        for (int32_t x = r.x; x < r.x + r.w; x++) {
+            if (inClip(x, y)) s_expected[y][x] = panelMemory[y][x];
+        }
+    }
+    memcpy(panelMemory, s_saved, sizeof(panelMemory));
+}
+
+// ========== FIXED CASES ==========
+
+/**
+ * Spans that overlap where the first one reaches the clip's right
+ * edge: one window per row, and the span that starts further left
+ * keeps the overlap
+ */
+static void spansAtEdge(const Rect& c) {
+    s_op = "drawSpans() at the clip edge";
+    memset(panelMemory, 0, sizeof(panelMemory));
+    s_display.resetClip();
+    s_depth = 0;
+    s_clips[0] = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+    push(c);
+    panelResetTraffic();
+    
+    int16_t x1 = c.x + c.w;
+    Span spans[] = {
+        { (int16_t)(x1 - 40), 10, 40, 0x1111 },
+        { (int16_t)(x1 - 30), 10, 10, 0x2222 },
+        { (int16_t)(x1 - 20), 11, 60, 0x3333 },
+        { (int16_t)(x1 - 5), 11, 30, 0x4444 },
+    };
+    if (s_display.drawSpans(spans, 4) != 2) fail("more than one window per row");
+    if (panelTraffic().pixels != 60) fail("pixels sent");
+    panelResetTraffic();
+    
+    for (int32_t x = x1 - 40; x < x1; x++) {
+        if (panelMemory[10][x] != 0x1111) fail("overlap drawn by the later span (row 10)");
+    }
+    for (int32_t x = x1 - 20; x < x1; x++) {
+        if (panelMemory[11][x] != 0x3333) fail("overlap drawn by the later span (row 11)");
+    }
+}
+
+// ========== MAIN ==========
+
+int main(int argc, char** argv) {
+    uint32_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 0) : 2000;
+    s_seed = argc > 2 ? strtoul(argv[2], nullptr, 0) : 1;
+    if (s_seed == 0) s_seed = 1;
+    
+    panelInit(PIN_CS, PIN_DC);
+    s_display.init();
+    
+    s_iteration = 0;
+    spansAtEdge({ 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT });
+    spansAtEdge({ 20, 0, 180, SCREEN_HEIGHT });
+    
+    for (s_iteration = 0; s_iteration < iterations; s_iteration++) {
+        memset(panelMemory, 0, sizeof(panelMemory));
+        memset(s_expected, 0, sizeof(s_expected));
+        randomClipStack();
+        panelResetTraffic();
+        
+        for (uint8_t i = 0; i < OPS_PER_ITERATION; i++) {
+            switch (randomIn(0, 9)) {
+                case 0: opFillRect(); break;
+                case 1: opDrawPixel(); break;
+                case 2: opBuffer(0); break;
+                case 3: opBuffer(1); break;
+                case 4: opBuffer(2); break;
+                case 5: opFill(true); break;
+                case 6: opFill(false); break;
+                case 7: opFillRects(); break;
+                case 8: opDrawPixels(); break;
+                default: opDrawSpans(); break;
+            }
+        }
+        
+        s_op = "frame memory";
+        for (int32_t y = 0; y < SCREEN_HEIGHT; y++) {
+            for (int32_t x = 0; x < SCREEN_WIDTH; x++) {
+                if (panelMemory[y][x] != s_expected[y][x]) {
+                    char what[64];
+                    snprintf(what, sizeof(what), "pixel %d,%d is %04X, expected %04X", x, y,
+                             panelMemory[y][x], s_expected[y][x]);
+                    fail(what);
+                }
+            }
+        }
+    }
+    
+    printf("clip_fuzz: %u iterations passed (seed %s)\n", iterations, argc > 2 ? argv[2] : "1");
+    return 0;
+}
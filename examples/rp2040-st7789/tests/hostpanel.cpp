@@ -0,0 +1,211 @@
+/**
+ * hostpanel.cpp
+ * Implementation of the ST7789 model and the SDK calls behind it
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <chrono>
+#include <string.h>
+#include "hostpanel.h"
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/gpio.h"
+#include "hardware/dma.h"
+
+#define CMD_CASET 0x2A
+#define CMD_RASET 0x2B
+#define CMD_RAMWR 0x2C
+
+uint16_t panelMemory[SCREEN_HEIGHT][SCREEN_WIDTH];
+spi_inst_t host_spi[2];
+
+static PanelTraffic s_traffic;
+static uint8_t s_csPin = 0xFF;
+static uint8_t s_dcPin = 0xFF;
+static bool s_cs = true;       // < CS level (low = selected)
+static bool s_dc = false;      // < DC level (low = command)
+static uint32_t s_bits = 8;    // < SPI frame size
+
+// Command decoder
+static uint8_t s_command;
+static uint8_t s_params[4];
+static uint8_t s_paramCount;
+static uint16_t s_x0, s_x1, s_y0, s_y1;    // < Window, inclusive
+static uint16_t s_x, s_y;                  // < Next pixel
+static uint32_t s_windowPixels;            // < Pixels in the window
+static int32_t s_logIndex = -1;            // < Current RAMWR in the log
+static uint8_t s_highByte;
+static bool s_haveHighByte;
+
+// DMA channel 0, the only one the driver claims
+static dma_channel_config s_dmaConfig;
+static volatile void* s_dmaWrite;
+
+// ========== PANEL ==========
+
+static void panelPixel(uint16_t color) {
+    if (s_logIndex >= 0 && s_logIndex < PANEL_LOG_SIZE) s_traffic.log[s_logIndex].pixels++;
+    s_traffic.pixels++;
+    if (++s_windowPixels > (uint32_t)(s_x1 - s_x0 + 1) * (s_y1 - s_y0 + 1)) s_traffic.wrapped++;
+    
+    if (s_x < SCREEN_WIDTH && s_y < SCREEN_HEIGHT) panelMemory[s_y][s_x] = color;
+    
+    if (s_x++ == s_x1) {
+        s_x = s_x0;
+        if (s_y++ == s_y1) s_y = s_y0;
+    }
+}
+
+static void panelByte(uint8_t b) {
+    if (s_cs) {
+        s_traffic.strayBytes++;
+        return;
+    }
+    
+    if (!s_dc) {
+        s_command = b;
+        s_paramCount = 0;
+        if (b == CMD_RAMWR) {
+            s_x = s_x0;
+            s_y = s_y0;
+            s_windowPixels = 0;
+            s_haveHighByte = false;
+            s_logIndex = (int32_t)s_traffic.windows++;
+            if (s_logIndex < PANEL_LOG_SIZE) {
+                PanelWindow& w = s_traffic.log[s_logIndex];
+                w.area = { (int16_t)s_x0, (int16_t)s_y0, (int16_t)(s_x1 - s_x0 + 1), (int16_t)(s_y1 - s_y0 + 1) };
+                w.pixels = 0;
+            }
+        }
+        return;
+    }
+    
+    if (s_command == CMD_RAMWR) {
+        if (!s_haveHighByte) {
+            s_highByte = b;
+            s_haveHighByte = true;
+        } else {
+            panelPixel((uint16_t)(s_highByte << 8 | b));
+            s_haveHighByte = false;
+        }
+        return;
+    }
+    
+    if (s_paramCount < 4) s_params[s_paramCount++] = b;
+    if (s_paramCount == 4 && (s_command == CMD_CASET || s_command == CMD_RASET)) {
+        uint16_t from = s_params[0] << 8 | s_params[1];
+        uint16_t to = s_params[2] << 8 | s_params[3];
+        if (s_command == CMD_CASET) {
+            s_x0 = from;
+            s_x1 = to;
+        } else {
+            s_y0 = from;
+            s_y1 = to;
+        }
+    }
+}
+
+static void panelWord(uint16_t w) {
+    panelByte(w >> 8);
+    panelByte(w & 0xFF);
+}
+
+void panelInit(uint8_t cs, uint8_t dc) {
+    s_csPin = cs;
+    s_dcPin = dc;
+    s_cs = true;
+    s_bits = 8;
+    s_logIndex = -1;
+    memset(panelMemory, 0, sizeof(panelMemory));
+    panelResetTraffic();
+}
+
+void panelResetTraffic() {
+    memset(&s_traffic, 0, sizeof(s_traffic));
+    s_logIndex = -1;
+}
+
+const PanelTraffic& panelTraffic() {
+    return s_traffic;
+}
+
+// ========== SDK: TIME, GPIO ==========
+
+uint64_t time_us_64() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void gpio_put(uint32_t gpio, bool value) {
+    if (gpio == s_csPin) s_cs = value;
+    if (gpio == s_dcPin) s_dc = value;
+}
+
+// ========== SDK: SPI ==========
+
+uint32_t spi_init(spi_inst_t* spi, uint32_t baudrate) {
+    (void)spi;
+    s_bits = 8;
+    return baudrate;
+}
+
+void spi_set_format(spi_inst_t* spi, uint32_t bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    (void)spi;
+    (void)cpol;
+    (void)cpha;
+    (void)order;
+    s_bits = bits;
+}
+
+int spi_write_blocking(spi_inst_t* spi, const uint8_t* src, size_t len) {
+    (void)spi;
+    if (s_bits != 8) s_traffic.formatErrors++;
+    for (size_t i = 0; i < len; i++) panelByte(src[i]);
+    return (int)len;
+}
+
+int spi_write16_blocking(spi_inst_t* spi, const uint16_t* src, size_t len) {
+    (void)spi;
+    if (s_bits != 16) s_traffic.formatErrors++;
+    for (size_t i = 0; i < len; i++) panelWord(src[i]);
+    return (int)len;
+}
+
+// ========== SDK: DMA ==========
+
+int dma_claim_unused_channel(bool required) {
+    (void)required;
+    return 0;
+}
+
+dma_channel_config dma_channel_get_default_config(uint32_t channel) {
+    (void)channel;
+    dma_channel_config c = { DMA_SIZE_32, true, false, 0x3F };
+    return c;
+}
+
+void dma_channel_configure(uint32_t channel, const dma_channel_config* config, volatile void* write,
+                           const volatile void* read, uint32_t count, bool trigger) {
+    s_dmaConfig = *config;
+    s_dmaWrite = write;
+    if (trigger) dma_channel_transfer_from_buffer_now(channel, read, count);
+}
+
+/**
+ * Runs the whole transfer; only the SPI data register as a target
+ * with 16-bit reads is modeled
+ */
+void dma_channel_transfer_from_buffer_now(uint32_t channel, const volatile void* read, uint32_t count) {
+    (void)channel;
+    bool toSpi = s_dmaWrite == &spi0->hw.dr || s_dmaWrite == &spi1->hw.dr;
+    if (!toSpi || s_dmaConfig.size != DMA_SIZE_16 || s_bits != 16) {
+        s_traffic.formatErrors++;
+        return;
+    }
+    const volatile uint16_t* words = (const volatile uint16_t*)read;
+    for (uint32_t i = 0; i < count; i++) {
+        panelWord(*words);
+        if (s_dmaConfig.readIncrement) words++;
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * hostpanel.h
+ * ST7789 model behind the SDK stand-ins, for the host tests
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * The stubs in stubs/ route SPI writes and DMA transfers to the SPI
+ * data register here, one byte at a time, as the panel would see them
+ * on the wire. Commands are decoded while CS is low: CASET and RASET
+ * set the window, RAMWR starts writing it from the top-left corner,
+ * and pixels fill it row by row into panelMemory, wrapping back to
+ * the start when the window is full (as the panel does).
+ * 
+ * Every RAMWR is logged with its window and the number of pixels
+ * written into it, so a test can check where the driver sent pixels
+ * and how many, not only what ended up in memory.
+ * 
+ */
+
+#ifndef HOSTPANEL_H
+#define HOSTPANEL_H
+
+#include <stdint.h>
+#include "rect.h"
+#include "st7789.h"
+
+#define PANEL_LOG_SIZE 64   // < Windows kept in the log
+
+/**
+ * One RAMWR: the window it wrote and how much
+ */
+struct PanelWindow {
+    Rect area;          // < Window set by CASET/RASET (inclusive ends made a size)
+    uint32_t pixels;    // < Pixels written into it
+};
+
+/**
+ * Traffic since panelInit() or the last panelResetTraffic()
+ */
+struct PanelTraffic {
+    uint32_t windows;        // < RAMWR commands
+    uint32_t pixels;         // < Pixels written
+    uint32_t wrapped;        // < Pixels past the end of their window
+    uint32_t strayBytes;     // < Bytes sent while CS was high
+    uint32_t formatErrors;   // < 8-bit writes in 16-bit mode or the reverse
+    PanelWindow log[PANEL_LOG_SIZE];  // < The first PANEL_LOG_SIZE windows
+};
+
+extern uint16_t panelMemory[SCREEN_HEIGHT][SCREEN_WIDTH];
+
+/**
+ * Connect the model to the driver's control pins and clear everything
+ */
+void panelInit(uint8_t cs, uint8_t dc);
+
+void panelResetTraffic();
+const PanelTraffic& panelTraffic();
+
+#endif // HOSTPANEL_H
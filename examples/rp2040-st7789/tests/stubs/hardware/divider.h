@@ -0,0 +1,21 @@
+/**
+ * hardware/divider.h
+ * Host stand-in for the Pico SDK: hardware divider
+ * dielburg
+ * 17/10/2026
+ */
+
+#ifndef HOST_HARDWARE_DIVIDER_H
+#define HOST_HARDWARE_DIVIDER_H
+
+#include <stdint.h>
+
+typedef uint64_t divmod_result_t;  // < Quotient in the low word, remainder in the high word
+
+static inline divmod_result_t hw_divider_divmod_u32(uint32_t a, uint32_t b) {
+    return ((uint64_t)(a % b) << 32) | (a / b);
+}
+static inline uint32_t to_quotient_u32(divmod_result_t r) { return (uint32_t)r; }
+static inline uint32_t to_remainder_u32(divmod_result_t r) { return (uint32_t)(r >> 32); }
+
+#endif // HOST_HARDWARE_DIVIDER_H
@@ -0,0 +1,39 @@
+/**
+ * hardware/dma.h
+ * Host stand-in for the Pico SDK: DMA, run at once into the panel model
+ * dielburg
+ * 17/10/2026
+ */
+
+#ifndef HOST_HARDWARE_DMA_H
+#define HOST_HARDWARE_DMA_H
+
+#include <stdint.h>
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+typedef struct {
+    enum dma_channel_transfer_size size;
+    bool readIncrement;
+    bool writeIncrement;
+    uint32_t dreq;
+} dma_channel_config;
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config* c, enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+static inline void channel_config_set_read_increment(dma_channel_config* c, bool incr) { c->readIncrement = incr; }
+static inline void channel_config_set_write_increment(dma_channel_config* c, bool incr) { c->writeIncrement = incr; }
+static inline void channel_config_set_dreq(dma_channel_config* c, uint32_t dreq) { c->dreq = dreq; }
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(uint32_t channel);
+void dma_channel_configure(uint32_t channel, const dma_channel_config* config, volatile void* write,
+                           const volatile void* read, uint32_t count, bool trigger);
+void dma_channel_transfer_from_buffer_now(uint32_t channel, const volatile void* read, uint32_t count);
+
+// Transfers run to the end when they are started
+static inline void dma_channel_wait_for_finish_blocking(uint32_t channel) { (void)channel; }
+static inline bool dma_channel_is_busy(uint32_t channel) { (void)channel; return false; }
+
+#endif // HOST_HARDWARE_DMA_H
@@ -0,0 +1,24 @@
+/**
+ * hardware/gpio.h
+ * Host stand-in for the Pico SDK: GPIO, wired to the panel model
+ * dielburg
+ * 17/10/2026
+ */
+
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include <stdint.h>
+
+#define GPIO_OUT 1
+#define GPIO_IN  0
+
+enum gpio_function { GPIO_FUNC_SPI = 1, GPIO_FUNC_SIO = 5 };
+
+static inline void gpio_init(uint32_t gpio) { (void)gpio; }
+static inline void gpio_set_dir(uint32_t gpio, bool out) { (void)gpio; (void)out; }
+static inline void gpio_set_function(uint32_t gpio, enum gpio_function fn) { (void)gpio; (void)fn; }
+
+void gpio_put(uint32_t gpio, bool value);
+
+#endif // HOST_HARDWARE_GPIO_H
@@ -0,0 +1,45 @@
+/**
+ * hardware/spi.h
+ * Host stand-in for the Pico SDK: SPI, wired to the panel model
+ * dielburg
+ * 17/10/2026
+ */
+
+#ifndef HOST_HARDWARE_SPI_H
+#define HOST_HARDWARE_SPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    volatile uint32_t dr;    // < Data register (the DMA's write address)
+    volatile uint32_t icr;   // < Interrupt clear register
+} spi_hw_t;
+
+typedef struct spi_inst {
+    spi_hw_t hw;
+} spi_inst_t;
+
+extern spi_inst_t host_spi[2];
+#define spi0 (&host_spi[0])
+#define spi1 (&host_spi[1])
+
+#define SPI_SSPICR_RORIC_BITS 0x00000001
+
+typedef enum { SPI_CPOL_0, SPI_CPOL_1 } spi_cpol_t;
+typedef enum { SPI_CPHA_0, SPI_CPHA_1 } spi_cpha_t;
+typedef enum { SPI_LSB_FIRST, SPI_MSB_FIRST } spi_order_t;
+
+uint32_t spi_init(spi_inst_t* spi, uint32_t baudrate);
+void spi_set_format(spi_inst_t* spi, uint32_t bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+int spi_write_blocking(spi_inst_t* spi, const uint8_t* src, size_t len);
+int spi_write16_blocking(spi_inst_t* spi, const uint16_t* src, size_t len);
+
+static inline spi_hw_t* spi_get_hw(spi_inst_t* spi) { return &spi->hw; }
+static inline uint32_t spi_get_dreq(spi_inst_t* spi, bool tx) { return (spi == spi1 ? 18 : 16) + !tx; }
+
+// Every write completes before it returns and nothing is received
+static inline bool spi_is_busy(const spi_inst_t* spi) { (void)spi; return false; }
+static inline bool spi_is_readable(const spi_inst_t* spi) { (void)spi; return false; }
+
+#endif // HOST_HARDWARE_SPI_H
@@ -0,0 +1,25 @@
+/**
+ * hardware/structs/vreg_and_chip_reset.h
+ * Host stand-in for the Pico SDK: reset cause register
+ * dielburg
+ * 17/10/2026
+ */
+
+#ifndef HOST_HARDWARE_STRUCTS_VREG_AND_CHIP_RESET_H
+#define HOST_HARDWARE_STRUCTS_VREG_AND_CHIP_RESET_H
+
+#include <stdint.h>
+
+#define VREG_AND_CHIP_RESET_CHIP_RESET_HAD_POR_BITS 0x00000100
+
+typedef struct {
+    uint32_t vreg;
+    uint32_t bod;
+    uint32_t chip_reset;
+} vreg_and_chip_reset_hw_t;
+
+// Always a power-on reset
+static vreg_and_chip_reset_hw_t host_vreg_and_chip_reset = { 0, 0, VREG_AND_CHIP_RESET_CHIP_RESET_HAD_POR_BITS };
+#define vreg_and_chip_reset_hw (&host_vreg_and_chip_reset)
+
+#endif // HOST_HARDWARE_STRUCTS_VREG_AND_CHIP_RESET_H
@@ -0,0 +1,13 @@
+/**
+ * hardware/watchdog.h
+ * Host stand-in for the Pico SDK: watchdog
+ * dielburg
+ * 17/10/2026
+ */
+
+#ifndef HOST_HARDWARE_WATCHDOG_H
+#define HOST_HARDWARE_WATCHDOG_H
+
+static inline bool watchdog_caused_reboot() { return false; }
+
+#endif // HOST_HARDWARE_WATCHDOG_H
@@ -0,0 +1,22 @@
+/**
+ * pico/stdlib.h
+ * Host stand-in for the Pico SDK: timing
+ * dielburg
+ * 17/10/2026
+ */
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Waits return at once: the panel model has no timing
+static inline void sleep_ms(uint32_t ms) { (void)ms; }
+static inline void sleep_us(uint64_t us) { (void)us; }
+static inline void tight_loop_contents() {}
+
+uint64_t time_us_64();
+static inline uint32_t time_us_32() { return (uint32_t)time_us_64(); }
+
+#endif // HOST_PICO_STDLIB_H
@@ -0,0 +1,282 @@
+/**
+ * textlayout.cpp
+ * Implementation of the text layout cache
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "textlayout.h"
+#include "arena.h"
+
+#define LAYOUT_NO_BREAK 0xFFFF
+
+TextLayoutCache::TextLayoutCache(const Font& font, TextLayout* entries, uint8_t count)
+    : _font(font), _entries(entries), _count(count), _clock(0), _stats() {
+    clear();
+}
+
+void TextLayoutCache::clear() {
+    for (uint8_t i = 0; i < _count; i++) {
+        _entries[i].lastUsed = 0;  // Empty
+    }
+}
+
+void TextLayoutCache::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+// ========== SHAPING ==========
+
+/**
+ * State of the line being filled
+ */
+struct LineState {
+    uint16_t first;        // < First glyph
+    int16_t pen;           // < Pen position
+    int16_t contentEnd;    // < Pen after the last glyph that is not a space
+    uint16_t previous;     // < Previous glyph, for kerning
+    uint16_t breakGlyph;   // < Glyphs before this index stay if the line breaks at the last opportunity
+    int16_t breakWidth;    // < Line width at that break
+    int16_t breakPen;      // < Where the next line starts on this one
+};
+
+/**
+ * End a line with the glyphs from its first up to end
+ * 
+ * returns false if there is no room for another line
+ */
+static bool endLine(TextLayout& out, LineState& line, uint16_t end, int16_t width) {
+    TextLine& l = out.lines[out.lineCount++];
+    l.first = line.first;
+    l.count = end - line.first;
+    l.x = 0;
+    l.width = width;
+    if (width > out.width) out.width = width;
+    line.first = end;
+    line.breakGlyph = LAYOUT_NO_BREAK;
+    return out.lineCount < LAYOUT_MAX_LINES;
+}
+
+/**
+ * End the last line (if there is room and it has anything, otherwise
+ * drop its glyphs) and align the lines: in the box, or in the widest
+ * line when not wrapping
+ */
+static void finishLayout(const Font& font, TextLayout& out, uint16_t width, TextAlign align,
+                         LineState& line, bool lastLine) {
+    if (!lastLine) {
+        out.glyphCount = line.first;  // Glyphs that got no line
+    } else if (line.first < out.glyphCount || line.contentEnd > 0 || out.lineCount == 0) {
+        endLine(out, line, out.glyphCount, line.contentEnd);
+    }
+    int16_t box = width > 0 ? (int16_t)width : out.width;
+    for (uint8_t i = 0; i < out.lineCount; i++) {
+        TextLine& l = out.lines[i];
+        if (align == ALIGN_CENTER) l.x = (box - l.width) / 2;
+        else if (align == ALIGN_RIGHT) l.x = box - l.width;
+    }
+    out.height = out.lineCount * font.lineHeight();
+}
+
+void TextLayoutCache::shape(const Font& font, const char* text, uint16_t width, TextAlign align,
+                            TextLayout& out) {
+    out.truncated = false;
+    out.lineCount = 0;
+    out.glyphCount = 0;
+    out.width = 0;
+    out.boxWidth = width;
+    out.align = align;
+    LineState line = { 0, 0, 0, FONT_NO_GLYPH, LAYOUT_NO_BREAK, 0, 0 };
+    uint32_t cp;
+    
+    while ((cp = utf8Next(text)) != 0) {
+        if (cp == '\n') {
+            if (!endLine(out, line, out.glyphCount, line.contentEnd)) {
+                out.truncated = *text != 0;
+                break;
+            }
+            line.pen = line.contentEnd = 0;
+            line.previous = FONT_NO_GLYPH;
+            continue;
+        }
+        uint16_t index = font.glyphOrFallback(cp);
+        if (index == FONT_NO_GLYPH) continue;
+        const FontGlyph& g = font.glyph(index);
+        int16_t x = line.pen;
+        if (line.previous != FONT_NO_GLYPH) x += font.kerning(line.previous, index);
+        line.previous = index;
+        
+        if (cp == ' ') {
+            // Break opportunity; spaces never wrap, they hang past the edge
+            line.pen = x + g.advance();
+            line.breakGlyph = out.glyphCount;
+            line.breakWidth = line.contentEnd;
+            line.breakPen = line.pen;
+            continue;
+        }
+        
+        // Wrap when the ink would cross the edge
+        if (width > 0 && x + g.x + g.w > (int16_t)width && x > 0) {
+            if (line.breakGlyph != LAYOUT_NO_BREAK && line.breakWidth > 0) {
+                // At the last opportunity: the word so far moves down
+                uint16_t moved = line.breakGlyph;
+                int16_t shift = line.breakPen;
+                if (!endLine(out, line, moved, line.breakWidth)) {
+                    out.truncated = true;
+                    finishLayout(font, out, width, align, line, false);
+                    return;
+                }
+                for (uint16_t i = moved; i < out.glyphCount; i++) {
+                    out.x[i] -= shift;
+                }
+                x -= shift;
+                line.contentEnd -= shift;
+            }
+            if (x + g.x + g.w > (int16_t)width && x > 0) {
+                // A word wider than the box: break before this glyph
+                if (!endLine(out, line, out.glyphCount, line.contentEnd)) {
+                    out.truncated = true;
+                    finishLayout(font, out, width, align, line, false);
+                    return;
+                }
+                x = 0;
+                line.contentEnd = 0;
+            }
+        }
+        
+        if (g.w > 0 && g.h > 0) {
+            if (out.glyphCount == LAYOUT_MAX_GLYPHS) {
+                out.truncated = true;
+                break;
+            }
+            out.glyphs[out.glyphCount] = index;
+            out.x[out.glyphCount] = x;
+            out.glyphCount++;
+        }
+        line.pen = x + g.advance();
+        line.contentEnd = line.pen;
+        if (cp == '-') {
+            line.breakGlyph = out.glyphCount;
+            line.breakWidth = line.pen;
+            line.breakPen = line.pen;
+        }
+    }
+    finishLayout(font, out, width, align, line, out.lineCount < LAYOUT_MAX_LINES);
+}
+
+// ========== CACHE ==========
+
+/**
+ * FNV-1a over the text; counts its length
+ */
+static uint32_t hashText(const char* text, uint16_t& length) {
+    uint32_t h = 2166136261u;
+    const char* p = text;
+    while (*p) {
+        h = (h ^ (uint8_t)*p++) * 16777619u;
+    }
+    length = (uint16_t)(p - text);
+    return h;
+}
+
+const TextLayout& TextLayoutCache::layout(const char* text, uint16_t width, TextAlign align) {
+    uint16_t length;
+    uint32_t hash = hashText(text, length);
+    _clock++;
+    
+    TextLayout* victim = &_entries[0];
+    for (uint8_t i = 0; i < _count; i++) {
+        TextLayout& e = _entries[i];
+        if (e.lastUsed != 0 && e.hash == hash && e.length == length && e.boxWidth == width &&
+            e.align == align) {
+            e.lastUsed = _clock;
+            _stats.hits++;
+            return e;
+        }
+        if (e.lastUsed < victim->lastUsed) victim = &e;
+    }
+    
+    _stats.misses++;
+    uint32_t t0 = time_us_32();
+    shape(_font, text, width, align, *victim);
+    _stats.shapeUs += time_us_32() - t0;
+    victim->hash = hash;
+    victim->length = length;
+    victim->lastUsed = _clock;
+    return *victim;
+}
+
+// ========== DRAWING ==========
+
+void TextLayoutCache::draw(ST7789& display, int16_t x, int16_t y, const TextLayout& layout,
+                           uint16_t color) const {
+    const Rect& clip = display.clipRect();
+    
+    // All spans in one list from the frame arena, or batches on the stack without one
+    Span batch[FONT_SPAN_BATCH];
+    Span* spans = batch;
+    uint32_t room = FONT_SPAN_BATCH;
+    uint32_t count = 0;
+    bool growing = false;
+    FrameArena* arena = FrameArena::current();
+    uint32_t mark = arena ? arena->mark() : 0;
+    if (arena) {
+        Span* list = arena->allocArray<Span>(LAYOUT_SPAN_CHUNK);
+        if (list) {
+            spans = list;
+            room = LAYOUT_SPAN_CHUNK;
+            growing = true;
+        }
+    }
+    
+    for (uint8_t i = 0; i < layout.lineCount; i++) {
+        const TextLine& l = layout.lines[i];
+        int16_t top = y + i * _font.lineHeight();
+        int16_t left = x + l.x;
+        if (l.count == 0) continue;
+        
+        // Rows the line's glyphs cover, from the line top
+        int16_t rowFrom = INT16_MAX;
+        int16_t rowTo = INT16_MIN;
+        for (uint16_t k = l.first; k < l.first + l.count; k++) {
+            const FontGlyph& g = _font.glyph(layout.glyphs[k]);
+            if (g.y < rowFrom) rowFrom = g.y;
+            if (g.y + g.h > rowTo) rowTo = g.y + g.h;
+        }
+        if (top + rowFrom < clip.y) rowFrom = clip.y - top;
+        if (top + rowTo > clip.y + clip.h) rowTo = clip.y + clip.h - top;
+        
+        // Row by row across the line, so the spans come in screen order
+        for (int16_t row = rowFrom; row < rowTo; row++) {
+            for (uint16_t k = l.first; k < l.first + l.count; k++) {
+                uint16_t index = layout.glyphs[k];
+                const FontGlyph& g = _font.glyph(index);
+                if (row < g.y || row >= g.y + g.h) continue;
+                if (count + FONT_ROW_SPANS(g.w) > room) {
+                    if (growing &&
+                        arena->grow(spans, room * sizeof(Span), LAYOUT_SPAN_CHUNK * sizeof(Span))) {
+                        room += LAYOUT_SPAN_CHUNK;
+                    } else {
+                        // Arena full: send what there is and reuse the list
+                        growing = false;
+                        display.drawSpans(spans, count);
+                        count = 0;
+                    }
+                }
+                count += _font.glyphRowSpans(index, row - g.y, left + layout.x[k], top, color,
+                                             spans + count);
+            }
+        }
+    }
+    if (count) display.drawSpans(spans, count);
+    if (arena) arena->rewind(mark);
+}
+
+const TextLayout& TextLayoutCache::drawText(ST7789& display, const Rect& box, const char* text,
+                                            TextAlign align, uint16_t color) {
+    const TextLayout& l = layout(text, box.w > 0 ? box.w : 0, align);
+    draw(display, box.x, box.y, l, color);
+    return l;
+}
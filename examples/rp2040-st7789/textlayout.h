@@ -0,0 +1,172 @@
+/**
+ * textlayout.h
+ * Wrapped and aligned text, shaped once and cached
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Laying out a paragraph (decoding UTF-8, looking up glyphs and
+ * kerning, finding where the lines break, aligning them) costs far
+ * more than drawing it, and the result only changes when the text
+ * does. TextLayoutCache shapes a string into a TextLayout once: the
+ * glyph indices with their x offsets, and the lines with their width
+ * and alignment offset. Layouts are kept in a small array of entries
+ * keyed by a hash of the text, the box width and the alignment, so a
+ * label that is drawn again every frame is only hashed and found.
+ * 
+ * Lines break after spaces and hyphens; a word wider than the box is
+ * broken between characters. '\n' starts a new line. Spaces at the
+ * end of a line do not count for its width or alignment, and only
+ * glyphs with ink are stored.
+ * 
+ * A layout is drawn line by line, pixel row by pixel row across all
+ * glyphs of the line, so each row's spans reach drawSpans() in order
+ * and the ones that touch share a window. With a FrameArena on the
+ * drawing core, the spans of the whole layout are collected there and
+ * sent with one drawSpans() call; without one (or when it is full)
+ * they go in batches of FONT_SPAN_BATCH from the stack.
+ * 
+ * The key is a 32-bit FNV-1a hash plus the text's length; two
+ * different strings of the same length and hash would share a
+ * layout (about one chance in 4 billion per pair).
+ * 
+ * example:
+ * 
+ * static TextLayout entries[8];                       // About 4.8 KB
+ * static TextLayoutCache text(font, entries, 8);
+ * Rect box = { 20, 100, 200, 120 };
+ * text.drawText(display, box, "Connect to Café Wi-Fi?", ALIGN_CENTER, COLOR_WHITE);
+ * 
+ */
+
+#ifndef TEXTLAYOUT_H
+#define TEXTLAYOUT_H
+
+#include <stdint.h>
+#include "st7789.h"
+#include "font.h"
+
+#define LAYOUT_MAX_GLYPHS 128   // < Glyphs with ink per layout
+#define LAYOUT_MAX_LINES  8     // < Lines per layout
+#define LAYOUT_SPAN_CHUNK 128   // < Spans taken from the frame arena at a time (1 KB)
+
+enum TextAlign {
+    ALIGN_LEFT,
+    ALIGN_CENTER,
+    ALIGN_RIGHT
+};
+
+/**
+ * One line of a layout
+ */
+struct TextLine {
+    uint16_t first;    // < First glyph of the line
+    uint16_t count;    // < Glyphs on the line
+    int16_t x;         // < Offset from the box's left edge (alignment)
+    int16_t width;     // < Width in pixels, trailing spaces not counted
+};
+
+/**
+ * A shaped string
+ */
+struct TextLayout {
+    // Key
+    uint32_t hash;
+    uint16_t length;      // < Text length in bytes
+    uint16_t boxWidth;    // < Wrap width, 0 for no wrapping
+    uint8_t align;
+    
+    bool truncated;       // < Text did not fit LAYOUT_MAX_GLYPHS or LAYOUT_MAX_LINES
+    uint8_t lineCount;
+    uint16_t glyphCount;
+    int16_t width;        // < Widest line
+    int16_t height;       // < Lines × line height
+    uint32_t lastUsed;    // < For replacing the least recently used entry
+    
+    uint16_t glyphs[LAYOUT_MAX_GLYPHS];   // < Glyph indices
+    int16_t x[LAYOUT_MAX_GLYPHS];         // < Pen position of each glyph on its line
+    TextLine lines[LAYOUT_MAX_LINES];
+};
+
+/**
+ * Counters since construction or the last resetStats()
+ */
+struct TextLayoutStats {
+    uint32_t hits;       // < Layouts found in the cache
+    uint32_t misses;     // < Layouts shaped
+    uint32_t shapeUs;    // < Time spent shaping
+};
+
+/**
+ * Cache of text layouts for one font
+ */
+class TextLayoutCache {
+public:
+    /**
+     * entries Layout storage (600 bytes each)
+     * count Number of entries (1 - 255)
+     */
+    TextLayoutCache(const Font& font, TextLayout* entries, uint8_t count);
+    
+    /**
+     * Layout of a string, shaped now or found in the cache
+     * 
+     * text UTF-8 string (null terminated)
+     * width Box width to wrap at, 0 for no wrapping (lines end only at '\n')
+     * align Alignment of the lines in the box (in the widest line's
+     *       width when not wrapping)
+     * 
+     * returns the layout; valid until count - 1 other layouts have
+     * been shaped
+     */
+    const TextLayout& layout(const char* text, uint16_t width, TextAlign align = ALIGN_LEFT);
+    
+    /**
+     * Draw a layout
+     * 
+     * x Left edge of the box
+     * y Top of the first line
+     * layout Layout made with this cache's font
+     * color Text color (RGB565); the background is not touched
+     * 
+     * 
+     * Lines outside the display's clip rectangle are skipped. Span
+     * memory taken from FrameArena::current() is given back before
+     * returning.
+     */
+    void draw(ST7789& display, int16_t x, int16_t y, const TextLayout& layout, uint16_t color) const;
+    
+    /**
+     * Lay out and draw a string in a box
+     * 
+     * box Left edge, top and width of the box (the height is not used;
+     *     clip with pushClip() if the text may be taller)
+     * 
+     * returns the layout, for its height
+     */
+    const TextLayout& drawText(ST7789& display, const Rect& box, const char* text, TextAlign align,
+                               uint16_t color);
+    
+    /**
+     * Shape a string without the cache (what a miss does)
+     */
+    static void shape(const Font& font, const char* text, uint16_t width, TextAlign align,
+                      TextLayout& out);
+    
+    /**
+     * Forget all layouts (the counters are kept)
+     */
+    void clear();
+    
+    const TextLayoutStats& stats() const { return _stats; }
+    void resetStats();
+
+private:
+    const Font& _font;
+    TextLayout* _entries;
+    uint8_t _count;
+    uint32_t _clock;            // < Use counter for lastUsed
+    TextLayoutStats _stats;
+};
+
+#endif // TEXTLAYOUT_H
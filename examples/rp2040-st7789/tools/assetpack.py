@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+assetpack.py
+Pack asset files into one read-only asset pack for AssetPack (assetpack.h)
+dielburg
+17/10/2026
+
+The pack is written to its own flash partition (see the README) and
+read in place through XIP: the firmware gets pointers straight into
+flash, so pictures go to the display by DMA without a copy and
+fonts, clips and splashes open where they lie.
+
+Each asset gets a name, by default its file name ("testcard.jpg").
+Names are found by a 32-bit FNV-1a hash in a sorted table; two names
+with the same hash are refused, so rename one of them. The format
+comes from the extension:
+
+    .jpg .jpeg  JPEG (JpegDecoder)
+    .dlt        delta animation (DeltaPlayer)
+    .vid        video clip (VideoPlayer)
+    .spl        boot splash (BootSplash)
+    .fnt        font (Font)
+    .png .ppm   converted to RGB565 pixels, drawn with AssetPack::drawImage()
+    others      raw bytes
+
+Every asset starts on a 4-byte boundary. No packages beyond the
+standard library are needed.
+
+usage:
+
+    assetpack.py output.pak [name=]file ...
+    assetpack.py --demo output.pak
+
+--demo  Pack the files in ../assets and a set of generated icons
+"""
+
+import os
+import struct
+import sys
+
+from deltaenc import read_frame, rgb565
+
+MAGIC = b"PAK1"
+HEADER_SIZE = 16
+ENTRY_SIZE = 16
+ALIGN = 4
+
+RAW, RGB565, JPEG, DELTA, VIDEO, SPLASH, FONT = range(7)
+FORMATS = {".jpg": JPEG, ".jpeg": JPEG, ".dlt": DELTA, ".vid": VIDEO, ".spl": SPLASH,
+           ".fnt": FONT, ".png": RGB565, ".ppm": RGB565}
+FORMAT_NAMES = ["raw", "rgb565", "jpeg", "delta", "video", "splash", "font"]
+
+
+def name_hash(name):
+    """FNV-1a over the UTF-8 bytes of the name (assetHash() in assetpack.h)"""
+    h = 2166136261
+    for b in name.encode("utf-8"):
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+class Asset:
+    def __init__(self, name, kind, data, width=0, height=0):
+        self.name, self.kind, self.data = name, kind, data
+        self.width, self.height = width, height
+
+
+def image_asset(name, width, height, pixels):
+    if width > 0xFFFF or height > 0xFFFF:
+        raise SystemExit("%s: picture too large" % name)
+    return Asset(name, RGB565, struct.pack("<%dH" % len(pixels), *pixels), width, height)
+
+
+def read_asset(spec):
+    name, _, path = spec.rpartition("=")
+    ext = os.path.splitext(path)[1]
+    name = name or os.path.basename(path)
+    kind = FORMATS.get(ext.lower(), RAW)
+    if kind == RGB565:
+        return image_asset(name, *read_frame(path))
+    with open(path, "rb") as f:
+        return Asset(name, kind, f.read())
+
+
+# ========== DEMO ==========
+
+def demo_icons():
+    """16 round 32x32 icons in different colors, and a 240x64 banner"""
+    icons = []
+    size = 32
+    for n in range(16):
+        r, g, b = [(int(127 + 127 * ((n * 5 + k * 16) % 48 - 24) / 24)) & 0xFF for k in range(3)]
+        pixels = []
+        for y in range(size):
+            for x in range(size):
+                d = (2 * x - size + 1) ** 2 + (2 * y - size + 1) ** 2   # Distance² × 4
+                if d > (size - 2) ** 2:
+                    pixels.append(0)
+                elif d > (size - 8) ** 2:
+                    pixels.append(rgb565(240, 240, 240))   # Ring
+                elif abs(x - y) <= n % 4 or abs(x + y - size + 1) <= n // 4:
+                    pixels.append(rgb565(r // 3, g // 3, b // 3))   # Cross
+                else:
+                    pixels.append(rgb565(r, g, b))
+        icons.append(image_asset("icons/%02d" % n, size, size, pixels))
+    width, height = 240, 64
+    banner = [rgb565(x * 255 // width, y * 255 // height, 160) for y in range(height)
+              for x in range(width)]
+    icons.append(image_asset("banner", width, height, banner))
+    return icons
+
+
+def demo_assets():
+    folder = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "assets")
+    files = sorted(f for f in os.listdir(folder) if not f.endswith(".pak"))
+    return [read_asset(os.path.join(folder, f)) for f in files] + demo_icons()
+
+
+# ========== PACKING ==========
+
+def pack(assets):
+    by_hash = {}
+    for a in assets:
+        h = name_hash(a.name)
+        if h in by_hash:
+            other = by_hash[h].name
+            raise SystemExit("%s and %s have the same hash" % (other, a.name) if other != a.name
+                             else "%s is in the pack twice" % a.name)
+        by_hash[h] = a
+    if not 0 < len(by_hash) < 0x10000:
+        raise SystemExit("%d assets; a pack has 1 to 65535" % len(by_hash))
+    order = sorted(by_hash)
+
+    names = bytearray()
+    name_offsets = []
+    for h in order:
+        name_offsets.append(len(names))
+        names += by_hash[h].name.encode("utf-8") + b"\0"
+    names += b"\0" * (-len(names) % ALIGN)
+    if len(names) > 0xFFFF:
+        raise SystemExit("names take more than 64 KB")
+
+    offset = HEADER_SIZE + len(order) * (4 + ENTRY_SIZE) + len(names)
+    entries = bytearray()
+    data = bytearray()
+    for h, name_offset in zip(order, name_offsets):
+        a = by_hash[h]
+        entries += struct.pack("<IIHBBHH", offset + len(data), len(a.data), name_offset, a.kind, 0,
+                               a.width, a.height)
+        data += a.data + b"\0" * (-len(a.data) % ALIGN)
+    total = offset + len(data)
+    header = struct.pack("<4sHHII", MAGIC, len(order), 0, total, len(names))
+    hashes = struct.pack("<%dI" % len(order), *order)
+    return header + hashes + entries + names + data, [by_hash[h] for h in order]
+
+
+def main(args):
+    demo = False
+    while args and args[0].startswith("--"):
+        option = args.pop(0)
+        if option == "--demo":
+            demo = True
+        else:
+            raise SystemExit("unknown option " + option)
+    if len(args) < (1 if demo else 2):
+        raise SystemExit(__doc__)
+
+    assets = demo_assets() if demo else []
+    assets += [read_asset(spec) for spec in args[1:]]
+    data, packed = pack(assets)
+    with open(args[0], "wb") as f:
+        f.write(data)
+    print("%s: %d assets, %d bytes (index %d bytes)" % (
+        args[0], len(packed), len(data), HEADER_SIZE + len(packed) * (4 + ENTRY_SIZE)))
+    for a in packed:
+        size = "%dx%d" % (a.width, a.height) if a.kind == RGB565 else ""
+        print("  %-16s %-7s %8d %s" % (a.name, FORMAT_NAMES[a.kind], len(a.data), size))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+"""
+bin2c.py
+Turn a binary file into a C header with a const byte array
+dielburg
+17/10/2026
+
+The array is const, so the linker keeps it in flash and the
+firmware reads it in place (XIP) without copying it to RAM. It is
+word aligned, so the DMA can copy it 32 bits at a time.
+
+usage: bin2c.py input output name
+
+example:
+
+    bin2c.py assets/testcard.jpg testcard_jpg.h testcard_jpg
+
+gives
+
+    static const uint8_t testcard_jpg[10442] __attribute__((aligned(4))) = { 0xff, ... };
+"""
+
+import os
+import sys
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.stderr.write("usage: bin2c.py input output name\n")
+        return 1
+
+    source, target, name = sys.argv[1:]
+    with open(source, "rb") as f:
+        data = f.read()
+
+    guard = name.upper() + "_H"
+    lines = [
+        "// Generated by bin2c.py from %s - do not edit" % os.path.basename(source),
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "#include <stdint.h>",
+        "",
+        "static const uint8_t %s[%d] __attribute__((aligned(4))) = {" % (name, len(data)),
+    ]
+    for i in range(0, len(data), 16):
+        chunk = data[i:i + 16]
+        lines.append("    " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += ["};", "", "#endif // %s" % guard, ""]
+
+    with open(target, "w") as f:
+        f.write("\n".join(lines))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,368 @@
+#!/usr/bin/env python3
+"""
+deltaenc.py
+Encode frames into a delta animation for DeltaPlayer (delta.h)
+dielburg
+17/10/2026
+
+Every frame after the first is compared with the one before it. The
+changed pixels are collected into rectangles (8x8 tiles, joined into
+bands and trimmed), and only those rectangles are stored, run-length
+coded, with palette indices if the animation has 256 colors or
+fewer. A last "loop" frame leads from the last frame back to the
+first one.
+
+Input frames are PNG (8-bit gray, RGB, RGBA or palette) or binary
+PPM files, all the same size. No packages beyond the standard
+library are needed.
+
+usage:
+
+    deltaenc.py [--ms N] [--no-loop] output.dlt frame0.png frame1.png ...
+    deltaenc.py --demo output.dlt
+
+--ms       Frame time in milliseconds (default 33, about 30 fps)
+--no-loop  Leave out the loop frame
+--demo     Generate the built-in test animation (bouncing pet over a
+           gradient, 240x320, 48 frames) instead of reading files
+"""
+
+import struct
+import sys
+import zlib
+
+TILE = 8
+# Cost of one more rectangle in SPI bytes: window commands, SPI format
+# switch and DMA start take about 15 us, 60 bytes' time at 32 MHz
+WINDOW_COST = 64
+MAX_RUN = 128
+
+
+# ========== INPUT ==========
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def read_ppm(data):
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b"P6" or int(fields[3]) != 255:
+        raise ValueError("only binary 8-bit PPM (P6) is supported")
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[pos + 1:pos + 1 + width * height * 3]
+    return width, height, [rgb565(*pixels[i:i + 3]) for i in range(0, len(pixels), 3)]
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(data):
+    pos = 8
+    idat = b""
+    palette = []
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"PLTE":
+            palette = [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+        elif kind == b"IDAT":
+            idat += body
+        pos += 12 + length
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}.get(color)
+    if depth != 8 or interlace or channels is None:
+        raise ValueError("only 8-bit non-interlaced PNG is supported")
+
+    raw = zlib.decompress(idat)
+    stride = width * channels
+    prev = bytearray(stride)
+    out = []
+    for y in range(height):
+        kind = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - channels] if i >= channels else 0
+            b = prev[i]
+            c = prev[i - channels] if i >= channels else 0
+            if kind == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif kind == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif kind == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif kind == 4:
+                line[i] = (line[i] + paeth(a, b, c)) & 0xFF
+        for x in range(width):
+            p = line[x * channels:(x + 1) * channels]
+            if color == 3:
+                out.append(rgb565(*palette[p[0]]))
+            elif color in (0, 4):
+                out.append(rgb565(p[0], p[0], p[0]))
+            else:
+                out.append(rgb565(p[0], p[1], p[2]))
+        prev = line
+    return width, height, out
+
+
+def read_frame(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] == b"\x89PNG\r\n\x1a\n":
+        return read_png(data)
+    return read_ppm(data)
+
+
+# ========== DEMO ==========
+
+def demo_frames():
+    """Ball-shaped pet bouncing over a gradient, blinking now and then"""
+    width, height, count = 240, 320, 48
+    ground = 270
+    background = []
+    for y in range(height):
+        if y < ground:
+            t = y * 255 // ground
+            background.append(rgb565(40 + t // 3, 60 + t // 2, 200 - t // 2))
+        else:
+            background.append(rgb565(60, 140 - (y - ground), 60))
+
+    frames = []
+    for n in range(count):
+        phase = n / count
+        bounce = 4 * phase * (1 - phase)            # 0 - 1 - 0 parabola
+        radius = 34
+        squash = 8 if n in (0, count - 1) else 0    # Flattened on impact
+        cx = 120
+        cy = ground - radius + squash - int(150 * bounce)
+        rx, ry = radius + squash, radius - squash
+        blink = n % 24 in (10, 11)
+
+        pixels = []
+        for y in range(height):
+            row = [background[y]] * width
+            # Shadow shrinks as the pet goes up
+            if ground + 4 <= y <= ground + 12:
+                sw = int(40 - 20 * bounce)
+                dy = (y - ground - 8) / 4
+                half = int(sw * max(0.0, 1 - dy * dy) ** 0.5)
+                for x in range(cx - half, cx + half):
+                    row[x] = rgb565(30, 70, 30)
+            dy = y - cy
+            if abs(dy) <= ry:
+                half = int(rx * (1 - (dy / ry) ** 2) ** 0.5)
+                for x in range(cx - half, cx + half + 1):
+                    row[x] = rgb565(250, 180, 40)
+                for ex in (cx - 12, cx + 12):
+                    ey = cy - 8
+                    if blink:
+                        if y == ey:
+                            for x in range(ex - 5, ex + 6):
+                                row[x] = rgb565(20, 20, 20)
+                    elif (y - ey) ** 2 <= 36:
+                        half = int((36 - (y - ey) ** 2) ** 0.5)
+                        for x in range(ex - half, ex + half + 1):
+                            row[x] = rgb565(20, 20, 20)
+            pixels += row
+        frames.append(pixels)
+    return width, height, frames
+
+
+# ========== DELTA ==========
+
+def changed_rects(prev, cur, width, height):
+    """Rectangles covering every pixel that differs between two frames"""
+    if prev is None:
+        return [(0, 0, width, height)]
+
+    tiles_x = (width + TILE - 1) // TILE
+    tiles_y = (height + TILE - 1) // TILE
+    changed = [[False] * tiles_x for _ in range(tiles_y)]
+    for y in range(height):
+        base = y * width
+        row = changed[y // TILE]
+        for x in range(width):
+            if prev[base + x] != cur[base + x]:
+                row[x // TILE] = True
+
+    # Runs of changed tiles per tile row, joined downwards if the
+    # run below spans the same tiles
+    rects = []
+    open_runs = {}
+    for ty in range(tiles_y + 1):
+        runs = []
+        if ty < tiles_y:
+            tx = 0
+            while tx < tiles_x:
+                if changed[ty][tx]:
+                    start = tx
+                    while tx < tiles_x and changed[ty][tx]:
+                        tx += 1
+                    runs.append((start, tx))
+                tx += 1
+        next_open = {}
+        for run in runs:
+            next_open[run] = open_runs.pop(run, ty)
+        for (x0, x1), y0 in open_runs.items():
+            rects.append([x0 * TILE, y0 * TILE, min(x1 * TILE, width), min(ty * TILE, height)])
+        open_runs = next_open
+
+    # Trim each rectangle to the pixels that actually changed
+    trimmed = []
+    for x0, y0, x1, y1 in rects:
+        xs = [x for y in range(y0, y1) for x in range(x0, x1)
+              if prev[y * width + x] != cur[y * width + x]]
+        ys = [y for y in range(y0, y1)
+              if any(prev[y * width + x] != cur[y * width + x] for x in range(x0, x1))]
+        trimmed.append([min(xs), min(ys), max(xs) + 1, max(ys) + 1])
+
+    # Join rectangles whose bounding box costs less than drawing both
+    merged = True
+    while merged:
+        merged = False
+        for i in range(len(trimmed)):
+            for j in range(i + 1, len(trimmed)):
+                a, b = trimmed[i], trimmed[j]
+                box = [min(a[0], b[0]), min(a[1], b[1]), max(a[2], b[2]), max(a[3], b[3])]
+                area = lambda r: (r[2] - r[0]) * (r[3] - r[1])
+                if 2 * area(box) <= 2 * (area(a) + area(b)) + WINDOW_COST:
+                    trimmed[i] = box
+                    del trimmed[j]
+                    merged = True
+                    break
+            if merged:
+                break
+    return [(x0, y0, x1 - x0, y1 - y0) for x0, y0, x1, y1 in trimmed]
+
+
+def encode_runs(values, pixel_bytes):
+    """Run-length code a list of pixel values (see delta.h)"""
+    out = bytearray()
+    literal = []
+
+    def pixel(v):
+        return bytes([v]) if pixel_bytes == 1 else struct.pack("<H", v)
+
+    def flush():
+        while literal:
+            chunk = literal[:MAX_RUN]
+            del literal[:MAX_RUN]
+            out.append(len(chunk) - 1)
+            for v in chunk:
+                out.extend(pixel(v))
+
+    i = 0
+    while i < len(values):
+        run = 1
+        while i + run < len(values) and run < MAX_RUN and values[i + run] == values[i]:
+            run += 1
+        if run >= 3:
+            flush()
+            out.append(0x7F + run)
+            out.extend(pixel(values[i]))
+        else:
+            literal.extend(values[i:i + run])
+        i += run
+    flush()
+    return out
+
+
+def encode_frame(prev, cur, width, height, index):
+    rects = changed_rects(prev, cur, width, height)
+    out = bytearray(struct.pack("<H", len(rects)))
+    pixel_bytes = 1 if index else 2
+    for x, y, w, h in rects:
+        out += struct.pack("<HHHH", x, y, w, h)
+        values = [cur[(y + r) * width + x + c] for r in range(h) for c in range(w)]
+        if index:
+            values = [index[v] for v in values]
+        out += encode_runs(values, pixel_bytes)
+    return out, rects
+
+
+def main(args):
+    frame_ms = 33
+    loop = True
+    demo = False
+    while args and args[0].startswith("--"):
+        option = args.pop(0)
+        if option == "--ms":
+            frame_ms = int(args.pop(0))
+        elif option == "--no-loop":
+            loop = False
+        elif option == "--demo":
+            demo = True
+        else:
+            raise SystemExit("unknown option " + option)
+    if not args or (not demo and len(args) < 2):
+        raise SystemExit(__doc__)
+
+    output = args[0]
+    if demo:
+        width, height, frames = demo_frames()
+    else:
+        frames = []
+        for path in args[1:]:
+            width, height, pixels = read_frame(path)
+            if frames and len(pixels) != len(frames[0]):
+                raise SystemExit(path + ": frame size differs")
+            frames.append(pixels)
+    if width > 240 or height > 320:
+        raise SystemExit("frames are larger than the screen (240x320)")
+
+    colors = sorted(set(v for f in frames for v in f))
+    index = {v: i for i, v in enumerate(colors)} if len(colors) <= 256 else None
+    palette = colors if index else []
+
+    body = bytearray()
+    for v in palette:
+        body += struct.pack("<H", v)
+    prev = None
+    stats = []
+    for n, cur in enumerate(frames):
+        data, rects = encode_frame(prev, cur, width, height, index)
+        body += data
+        stats.append((len(data), sum(w * h for _, _, w, h in rects), len(rects)))
+        prev = cur
+    loop_offset = 0
+    if loop and len(frames) > 1:
+        loop_offset = 20 + len(body)
+        data, rects = encode_frame(frames[-1], frames[0], width, height, index)
+        body += data
+        stats.append((len(data), sum(w * h for _, _, w, h in rects), len(rects)))
+
+    header = struct.pack("<4sHHHHHHI", b"DLT1", width, height, len(frames), frame_ms,
+                         len(palette), 0, loop_offset)
+    with open(output, "wb") as f:
+        f.write(header + body)
+
+    raw = width * height * 2
+    deltas = stats[1:] or stats
+    print("%s: %dx%d, %d frames, %s" % (output, width, height, len(frames),
+          "%d colors" % len(palette) if palette else "RGB565"))
+    print("size %d bytes (raw frames: %d bytes)" % (20 + len(body), raw * len(frames)))
+    print("delta frames: %d bytes, %d pixels, %.1f rects on average" % (
+        sum(s[0] for s in deltas) // len(deltas), sum(s[1] for s in deltas) // len(deltas),
+        sum(s[2] for s in deltas) / len(deltas)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
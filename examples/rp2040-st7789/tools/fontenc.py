@@ -0,0 +1,311 @@
+#!/usr/bin/env python3
+"""
+fontenc.py
+Convert BDF bitmap fonts to the sparse font format of Font (font.h)
+dielburg
+17/10/2026
+
+Glyphs are stored trimmed to their ink, one bit per pixel, in code
+point order. Runs of consecutive code points become one entry of a
+sorted range table, so a font with a few hundred glyphs in a dozen
+Unicode blocks needs a dozen ranges, and one with thousands of CJK
+glyphs not many more. Several BDF files can be merged (the first one
+that has a code point wins), for example a Latin font with a symbol
+font.
+
+Kerning pairs come from a text file, one pair per line:
+
+    AV -2
+    U+0054 U+006F -1     # "To"
+
+usage:
+
+    fontenc.py [--ranges LIST] [--kern FILE] output.fnt font.bdf [more.bdf ...]
+    fontenc.py --demo output.fnt
+
+--ranges  Code points to keep, e.g. 20-7E,A0-FF,2190-2193 (hex; default all)
+--kern    Kerning pairs
+--demo    Generate the built-in demo font (the 5x7 font at twice the size,
+          proportional, with Latin-1 letters, arrows and a few symbols)
+"""
+
+import os
+import re
+import struct
+import sys
+import unicodedata
+
+MAGIC = b"FNT1"
+NO_GLYPH = 0xFFFF
+
+
+class Glyph:
+    def __init__(self, advance, x, y, rows):
+        """rows: list of strings of '#' and '.', top to bottom; x, y:
+        top-left corner relative to the pen and the line top"""
+        self.advance = advance
+        self.x, self.y = x, y
+        self.rows = rows
+
+    def trimmed(self):
+        """Same glyph cut down to the rows and columns with ink"""
+        ink = [(r, c) for r, row in enumerate(self.rows) for c, p in enumerate(row) if p == "#"]
+        if not ink:
+            return Glyph(self.advance, 0, 0, [])
+        top = min(r for r, _ in ink)
+        bottom = max(r for r, _ in ink)
+        left = min(c for _, c in ink)
+        right = max(c for _, c in ink)
+        rows = [row[left:right + 1].ljust(right - left + 1, ".") for row in self.rows[top:bottom + 1]]
+        return Glyph(self.advance, self.x + left, self.y + top, rows)
+
+
+# ========== BDF ==========
+
+def read_bdf(path):
+    """(ascent, descent, {code point: Glyph})"""
+    glyphs = {}
+    ascent = descent = None
+    with open(path, encoding="latin-1") as f:
+        lines = iter(f.read().splitlines())
+    bbox = (0, 0, 0, 0)
+    for line in lines:
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == "FONT_ASCENT":
+            ascent = int(words[1])
+        elif words[0] == "FONT_DESCENT":
+            descent = int(words[1])
+        elif words[0] == "FONTBOUNDINGBOX":
+            bbox = tuple(int(v) for v in words[1:5])
+        elif words[0] == "STARTCHAR":
+            code, advance, box, rows = -1, 0, bbox, []
+            for line in lines:
+                words = line.split()
+                if not words:
+                    continue
+                if words[0] == "ENCODING":
+                    code = int(words[1])
+                elif words[0] == "DWIDTH":
+                    advance = int(words[1])
+                elif words[0] == "BBX":
+                    box = tuple(int(v) for v in words[1:5])
+                elif words[0] == "BITMAP":
+                    for line in lines:
+                        if line.strip() == "ENDCHAR":
+                            break
+                        bits = bin(int(line.strip(), 16))[2:].zfill(len(line.strip()) * 4)
+                        rows.append("".join("#" if b == "1" else "." for b in bits[:box[0]]))
+                    break
+            if code >= 0:
+                w, h, xoff, yoff = box
+                glyphs[code] = (advance, xoff, yoff, h, rows)
+    if ascent is None:
+        ascent = bbox[1] + bbox[3]
+    if descent is None:
+        descent = -bbox[3]
+    # Glyph tops relative to the line top (the font's ascent above the baseline)
+    return ascent, descent, {code: Glyph(adv, xoff, ascent - (yoff + h), rows)
+                             for code, (adv, xoff, yoff, h, rows) in glyphs.items()}
+
+
+# ========== DEMO ==========
+
+def read_font5x7():
+    """Columns of ../font5x7.cpp as {character: 7 rows}"""
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "font5x7.cpp")
+    glyphs = {}
+    with open(path) as f:
+        for m in re.finditer(r"\{(0x[0-9A-F]{2}(?:,\s*0x[0-9A-F]{2}){4})\},\s*// 0x([0-9A-F]{2})", f.read()):
+            cols = [int(v, 16) for v in m.group(1).split(",")]
+            glyphs[chr(int(m.group(2), 16))] = ["".join("#" if cols[c] >> r & 1 else "." for c in range(5))
+                                                 for r in range(7)]
+    return glyphs
+
+
+# Marks over (rows 0-1 of the 3 above a capital) or under (rows 10-11) the letter
+MARKS = {
+    "0300": ([".#...", "..#.."], False),   # Grave
+    "0301": (["...#.", "..#.."], False),   # Acute
+    "0302": (["..#..", ".#.#."], False),   # Circumflex
+    "0303": ([".##.#", "#.##."], False),   # Tilde
+    "0308": ([".....", ".#.#."], False),   # Diaeresis
+    "030A": (["..#..", ".#.#.", "..#.."], False),   # Ring
+    "0327": (["..#..", ".##.."], True),    # Cedilla
+}
+
+SYMBOLS = {
+    0x00A7: [".###.", "#....", ".##..", "#..#.", ".##..", "...#.", "###.."],   # Section sign
+    0x00B0: [".##..", "#..#.", "#..#.", ".##..", ".....", ".....", "....."],   # Degree
+    0x00B1: ["..#..", "..#..", "#####", "..#..", "..#..", ".....", "#####"],   # Plus-minus
+    0x00B5: [".....", ".....", "#..#.", "#..#.", "#..#.", "###.#", "#...."],   # Micro
+    0x00B7: [".....", ".....", ".....", "..#..", ".....", ".....", "....."],   # Middle dot
+    0x00D7: [".....", "#...#", ".#.#.", "..#..", ".#.#.", "#...#", "....."],   # Multiplication
+    0x00DF: [".##..", "#..#.", "#.#..", "#..#.", "#..#.", "#.##.", "#...."],   # Sharp s
+    0x2022: [".....", ".....", ".###.", ".###.", ".###.", ".....", "....."],   # Bullet
+    0x20AC: ["..###", ".#...", "####.", ".#...", "####.", ".#...", "..###"],   # Euro
+    0x2190: [".....", "..#..", ".#...", "#####", ".#...", "..#..", "....."],   # Arrows
+    0x2191: ["..#..", ".###.", "#.#.#", "..#..", "..#..", "..#..", "..#.."],
+    0x2192: [".....", "..#..", "...#.", "#####", "...#.", "..#..", "....."],
+    0x2193: ["..#..", "..#..", "..#..", "..#..", "#.#.#", ".###.", "..#.."],
+    0x2713: [".....", "....#", "...#.", "#.#..", ".#...", ".....", "....."],   # Check mark
+    0xFFFD: ["#####", "#...#", "#...#", "#...#", "#...#", "#...#", "#####"],   # Replacement
+}
+
+DEMO_KERNING = ["AV", "VA", "AT", "TA", "AY", "YA", "AW", "WA", "LT", "LV", "LY", "Ta", "Te",
+                "To", "Ty", "Va", "Ve", "Vo", "Ya", "Ye", "Yo", "P.", "T.", "V.", "Y.", "F.",
+                "T,", "V,", "Y,", "r.", "r,"]
+
+
+def demo_font():
+    """(ascent, descent, glyphs, kerning) of the demo font"""
+    scale = 2
+    base = read_font5x7()
+    cells = {}   # Code point: 12 rows of 5 (3 above the capitals, 7, 2 under)
+    for ch, rows in base.items():
+        cells[ord(ch)] = ["....."] * 3 + rows + ["....."] * 2
+    for code, rows in SYMBOLS.items():
+        cells[code] = ["....."] * 3 + rows + ["....."] * 2
+    for code in range(0xC0, 0x100):
+        parts = unicodedata.decomposition(chr(code)).split()
+        if len(parts) != 2 or parts[1] not in MARKS or chr(int(parts[0], 16)) not in base:
+            continue
+        letter = chr(int(parts[0], 16))
+        mark, under = MARKS[parts[1]]
+        rows = ["....."] * 3 + list(base[letter]) + ["....."] * 2
+        if under:
+            rows[10:12] = mark
+        elif letter.isupper():
+            rows[0:len(mark)] = mark
+        else:
+            rows[3:5] = mark[-2:]                 # Replaces the dot of i
+        cells[code] = rows
+    glyphs = {}
+    for code, rows in cells.items():
+        scaled = ["".join(p * scale for p in row) for row in rows for _ in range(scale)]
+        g = Glyph(0, 0, 0, scaled).trimmed()
+        width = len(g.rows[0]) if g.rows else 2 * scale
+        g.x = 0                                    # Proportional: no left bearing
+        g.advance = width + scale                  # One font pixel between letters
+        glyphs[code] = g
+    kerning = {(ord(p[0]), ord(p[1])): -scale // 2 for p in DEMO_KERNING}   # Half a font pixel
+    return 10 * scale, 3 * scale, glyphs, kerning
+
+
+# ========== ENCODING ==========
+
+def parse_ranges(text):
+    ranges = []
+    for part in text.split(","):
+        lo, _, hi = part.partition("-")
+        ranges.append((int(lo, 16), int(hi or lo, 16)))
+    return ranges
+
+
+def read_kerning(path):
+    pairs = {}
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            words = line.split("#")[0].split()
+            if not words:
+                continue
+            if len(words) == 2 and len(words[0]) == 2:
+                left, right = ord(words[0][0]), ord(words[0][1])
+            elif len(words) == 3:
+                left, right = (int(w[2:], 16) if w.startswith("U+") else ord(w) for w in words[:2])
+            else:
+                raise SystemExit("bad kerning line: " + line.strip())
+            pairs[(left, right)] = int(words[-1])
+    return pairs
+
+
+def pack_bits(rows):
+    bits = "".join(row.replace("#", "1").replace(".", "0") for row in rows)
+    bits += "0" * (-len(bits) % 8)
+    return bytes(int(bits[i:i + 8], 2) for i in range(0, len(bits), 8))
+
+
+def encode(ascent, descent, glyphs, kerning):
+    codes = sorted(glyphs)
+    index = {code: i for i, code in enumerate(codes)}
+    ranges = []
+    for code in codes:
+        if ranges and ranges[-1][0] + ranges[-1][1] == code:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([code, 1, index[code]])
+
+    table = bytearray()
+    bitmaps = bytearray()
+    for code in codes:
+        g = glyphs[code]
+        width = len(g.rows[0]) if g.rows else 0
+        if not (0 <= g.advance <= 255 and -128 <= g.x <= 127 and -128 <= g.y <= 127 and width <= 127):
+            raise SystemExit("glyph U+%04X is too large" % code)
+        data = pack_bits(g.rows)
+        table += struct.pack("<IBBbb", len(bitmaps) | g.advance << 24, width, len(g.rows), g.x, g.y)
+        bitmaps += data
+    if len(bitmaps) >= 1 << 24:
+        raise SystemExit("more than 16 MB of bitmaps")
+
+    pairs = sorted((index[l] << 16 | index[r], v) for (l, r), v in kerning.items()
+                   if l in index and r in index and v != 0)
+    fallback = index.get(0xFFFD, index.get(ord("?"), NO_GLYPH))
+    header = struct.pack("<4sHHHHHHI", MAGIC, ascent + descent, ascent, len(ranges), len(codes),
+                         len(pairs), fallback, len(bitmaps))
+    data = header
+    data += b"".join(struct.pack("<IHH", *r) for r in ranges)
+    data += table
+    data += b"".join(struct.pack("<I", key) for key, _ in pairs)
+    adjust = b"".join(struct.pack("<b", v) for _, v in pairs)
+    data += adjust + b"\0" * (-len(adjust) % 4)
+    return data + bitmaps, len(ranges), len(pairs), len(bitmaps)
+
+
+def main(args):
+    keep = None
+    kerning = {}
+    demo = False
+    while args and args[0].startswith("--"):
+        option = args.pop(0)
+        if option == "--ranges":
+            keep = parse_ranges(args.pop(0))
+        elif option == "--kern":
+            kerning = read_kerning(args.pop(0))
+        elif option == "--demo":
+            demo = True
+        else:
+            raise SystemExit("unknown option " + option)
+    if len(args) < (1 if demo else 2):
+        raise SystemExit(__doc__)
+
+    if demo:
+        ascent, descent, glyphs, demo_kerning = demo_font()
+        kerning = {**demo_kerning, **kerning}
+    else:
+        glyphs = {}
+        ascent = descent = 0
+        for path in args[1:]:
+            a, d, more = read_bdf(path)
+            ascent, descent = max(ascent, a), max(descent, d)
+            for code, g in more.items():
+                glyphs.setdefault(code, g)
+        glyphs = {code: g.trimmed() for code, g in glyphs.items()}
+    if keep:
+        glyphs = {code: g for code, g in glyphs.items() if any(lo <= code <= hi for lo, hi in keep)}
+    if not glyphs or len(glyphs) >= NO_GLYPH:
+        raise SystemExit("%d glyphs; a font has 1 to 65534" % len(glyphs))
+
+    data, ranges, pairs, bitmaps = encode(ascent, descent, glyphs, kerning)
+    with open(args[0], "wb") as f:
+        f.write(data)
+    print("%s: %d glyphs in %d ranges, %d kerning pairs, line height %d" % (
+        args[0], len(glyphs), ranges, pairs, ascent + descent))
+    print("size %d bytes (%d of bitmaps, %.1f bytes per glyph in all)" % (
+        len(data), bitmaps, len(data) / len(glyphs)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+splashenc.py
+Encode a picture as a boot splash for BootSplash (splash.h)
+dielburg
+17/10/2026
+
+The picture is centered on a full screen of background color and cut
+into runs, in screen order: a stretch of at least --min-fill equal
+pixels becomes a fill (one color in the pool), everything else goes
+into the pool as it is. The DMA needs a 16-byte control block in RAM
+per run, so if there are more than 255 runs, the shortest fill is
+doubled until they fit (more of the picture is stored as it is).
+
+Input is PNG (8-bit gray, RGB, RGBA or palette) or binary PPM, at
+most 240x320. No packages beyond the standard library are needed.
+
+usage:
+
+    splashenc.py [--bg RRGGBB] [--min-fill N] output.spl picture.png
+    splashenc.py --demo output.spl
+
+--bg        Background color (default: the picture's top-left pixel)
+--min-fill  Shortest run stored as a fill (default 16)
+--demo      Generate the built-in splash instead of reading a file
+"""
+
+import struct
+import sys
+
+from deltaenc import read_frame, rgb565
+
+WIDTH, HEIGHT = 240, 320
+MAX_RUNS = 255
+FILL = 0x80000000
+
+
+# ========== DEMO ==========
+
+# Columns of the 5x7 font (font5x7.cpp), bit 0 at the top
+GLYPHS = {
+    "S": (0x46, 0x49, 0x49, 0x49, 0x31),
+    "T": (0x01, 0x01, 0x7F, 0x01, 0x01),
+    "7": (0x01, 0x71, 0x09, 0x05, 0x03),
+    "8": (0x36, 0x49, 0x49, 0x49, 0x36),
+    "9": (0x06, 0x49, 0x49, 0x29, 0x1E),
+}
+
+
+def demo_picture():
+    """Name in large letters over a bar of colors, on dark blue"""
+    scale, text = 5, "ST7789"
+    width = len(text) * 6 * scale - scale
+    height = 7 * scale + 3 * scale + 8
+    background = rgb565(10, 14, 40)
+    pixels = [background] * (width * height)
+    for row in range(7 * scale):
+        t = row * 255 // (7 * scale - 1)
+        color = rgb565(255, 120 + t // 2, 40 + t // 4)   # Orange to yellow
+        for n, ch in enumerate(text):
+            for col in range(5 * scale):
+                if GLYPHS[ch][col // scale] >> (row // scale) & 1:
+                    pixels[row * width + n * 6 * scale + col] = color
+    bar = [rgb565(230, 60, 60), rgb565(240, 160, 40), rgb565(240, 230, 60),
+           rgb565(80, 200, 90), rgb565(60, 140, 240), rgb565(160, 90, 220)]
+    for row in range(height - 8, height):
+        for col in range(width):
+            pixels[row * width + col] = bar[col * len(bar) // width]
+    return width, height, pixels, background
+
+
+# ========== RUNS ==========
+
+def place(width, height, pixels, background):
+    """The picture centered on a full screen"""
+    screen = [background] * (WIDTH * HEIGHT)
+    x0, y0 = (WIDTH - width) // 2, (HEIGHT - height) // 2
+    for y in range(height):
+        screen[(y0 + y) * WIDTH + x0:(y0 + y) * WIDTH + x0 + width] = \
+            pixels[y * width:(y + 1) * width]
+    return screen
+
+
+def make_runs(pixels, min_fill):
+    """List of (fill, count, values); values is one color for a fill"""
+    runs = []
+    literal = []
+    i = 0
+    while i < len(pixels):
+        j = i
+        while j < len(pixels) and pixels[j] == pixels[i]:
+            j += 1
+        if j - i >= min_fill:
+            if literal:
+                runs.append((False, len(literal), literal))
+                literal = []
+            runs.append((True, j - i, [pixels[i]]))
+        else:
+            literal += pixels[i:j]
+        i = j
+    if literal:
+        runs.append((False, len(literal), literal))
+    return runs
+
+
+def encode(runs):
+    pool = []
+    colors = {}
+    table = bytearray()
+    for fill, count, values in runs:
+        if fill:
+            if values[0] not in colors:
+                colors[values[0]] = len(pool)
+                pool.append(values[0])
+            table += struct.pack("<II", count | FILL, colors[values[0]])
+        else:
+            table += struct.pack("<II", count, len(pool))
+            pool += values
+    if len(pool) > 0xFFFF:
+        raise SystemExit("too many literal pixels (%d, at most 65535): the picture needs "
+                         "larger areas of one color, or a smaller size" % len(pool))
+    header = struct.pack("<4sHHHHHH", b"SPL1", 0, 0, WIDTH, HEIGHT, len(runs), len(pool))
+    return header + table + struct.pack("<%dH" % len(pool), *pool), len(pool)
+
+
+def main(args):
+    background = None
+    min_fill = 16
+    demo = False
+    while args and args[0].startswith("--"):
+        option = args.pop(0)
+        if option == "--bg":
+            v = int(args.pop(0), 16)
+            background = rgb565(v >> 16, (v >> 8) & 0xFF, v & 0xFF)
+        elif option == "--min-fill":
+            min_fill = max(1, int(args.pop(0)))
+        elif option == "--demo":
+            demo = True
+        else:
+            raise SystemExit("unknown option " + option)
+    if len(args) != (1 if demo else 2):
+        raise SystemExit(__doc__)
+
+    if demo:
+        width, height, pixels, demo_background = demo_picture()
+        background = demo_background if background is None else background
+    else:
+        width, height, pixels = read_frame(args[1])
+        background = pixels[0] if background is None else background
+    if width > WIDTH or height > HEIGHT:
+        raise SystemExit("picture is larger than the screen (240x320)")
+
+    screen = place(width, height, pixels, background)
+    runs = make_runs(screen, min_fill)
+    while len(runs) > MAX_RUNS:
+        min_fill *= 2
+        runs = make_runs(screen, min_fill)
+    data, pool = encode(runs)
+    with open(args[0], "wb") as f:
+        f.write(data)
+
+    fills = sum(1 for r in runs if r[0])
+    print("%s: %dx%d picture, %d runs (%d fills of %d+ pixels), %d pool pixels" % (
+        args[0], width, height, len(runs), fills, min_fill, pool))
+    print("size %d bytes (raw screen: %d bytes), %d bytes of control blocks in RAM" % (
+        len(data), WIDTH * HEIGHT * 2, (len(runs) + 1) * 16))
+    print("%.1f ms to send at 32 MHz" % (WIDTH * HEIGHT * 16 / 32e6 * 1000))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
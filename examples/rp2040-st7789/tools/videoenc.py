@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""
+videoenc.py
+Encode frames into a video clip for VideoPlayer (video.h)
+dielburg
+17/10/2026
+
+Frames are cut into 4x4 blocks. A block that still looks like what
+the decoder has on screen (within the tolerance) is skipped, the
+others are stored as one solid color, two colors and a mask, or 16
+raw pixels, whichever is the cheapest that stays within the
+tolerance. Changed blocks in a band of 4 lines are joined into spans
+(one display window each); small gaps are filled in rather than
+paying for another window.
+
+The first frame is always stored whole, so a looping clip restarts
+cleanly. The encoder keeps the frames as the decoder will see them,
+so the small errors of lossy blocks do not pile up.
+
+Input frames are PNG or binary PPM files (see deltaenc.py), all the
+same size, width and height multiples of 4.
+
+usage:
+
+    videoenc.py [--ms N] [--tolerance N] output.vid frame0.png frame1.png ...
+    videoenc.py --demo output.vid
+
+--ms         Frame time in milliseconds (default 33, about 30 fps)
+--tolerance  Largest error per color channel, 0-255 scale (default 16,
+             0 = lossless)
+--demo       Generate the built-in test clip (color bars with scrolling
+             shading, then a ball bouncing over a slide, 240x320,
+             48 frames)
+"""
+
+import struct
+import sys
+
+from deltaenc import read_frame, rgb565
+
+BLOCK = 4
+MAX_SPANS = 16
+MAX_OP = 64
+# Gap of unchanged blocks worth filling in instead of starting another
+# window: 2 blocks are 64 SPI bytes, about the cost of a window
+GAP_BLOCKS = 2
+
+
+# ========== BLOCKS ==========
+
+def channels(v):
+    return (v >> 11) & 0x1F, (v >> 5) & 0x3F, v & 0x1F
+
+
+def error(a, b):
+    """Largest channel difference between two pixels, 0-255 scale"""
+    ra, ga, ba = channels(a)
+    rb, gb, bb = channels(b)
+    return max(abs(ra - rb) * 8, abs(ga - gb) * 4, abs(ba - bb) * 8)
+
+
+def block_error(a, b):
+    if a == b:
+        return 0
+    return max(error(x, y) for x, y in zip(a, b))
+
+
+def mean(pixels):
+    n = len(pixels)
+    r = g = b = 0
+    for v in pixels:
+        pr, pg, pb = channels(v)
+        r += pr
+        g += pg
+        b += pb
+    return ((r + n // 2) // n << 11) | ((g + n // 2) // n << 5) | (b + n // 2) // n
+
+
+def fit_block(pixels, tolerance):
+    """Cheapest coding within the tolerance: (kind, data, decoded pixels)"""
+    first = pixels[0]
+    if all(v == first for v in pixels):
+        return "solid", first, [first] * 16
+    color = mean(pixels)
+    if all(error(v, color) <= tolerance for v in pixels):
+        return "solid", color, [color] * 16
+
+    luma = [2 * r + g + b for r, g, b in map(channels, pixels)]
+    threshold = sum(luma) / 16
+    high = [l > threshold for l in luma]
+    if any(high) and not all(high):
+        colors = (mean([v for v, h in zip(pixels, high) if not h]),
+                  mean([v for v, h in zip(pixels, high) if h]))
+        decoded = [colors[h] for h in high]
+        if block_error(pixels, decoded) <= tolerance:
+            mask = sum(1 << i for i, h in enumerate(high) if h)
+            return "two", (colors[0], colors[1], mask), decoded
+    return "raw", pixels, pixels
+
+
+def get_block(frame, width, bx, by):
+    pixels = []
+    for row in range(BLOCK):
+        start = (by + row) * width + bx
+        pixels += frame[start:start + BLOCK]
+    return pixels
+
+
+def put_block(frame, width, bx, by, pixels):
+    for row in range(BLOCK):
+        start = (by + row) * width + bx
+        frame[start:start + BLOCK] = pixels[row * BLOCK:row * BLOCK + BLOCK]
+
+
+# ========== SPANS AND OPS ==========
+
+def find_spans(changed):
+    """Group changed block columns into at most MAX_SPANS (first, count)"""
+    spans = []
+    for bx in changed:
+        if spans and bx - (spans[-1][0] + spans[-1][1]) <= GAP_BLOCKS:
+            spans[-1][1] = bx + 1 - spans[-1][0]
+        else:
+            spans.append([bx, 1])
+    while len(spans) > MAX_SPANS:
+        gaps = [spans[i + 1][0] - spans[i][0] - spans[i][1] for i in range(len(spans) - 1)]
+        i = gaps.index(min(gaps))
+        spans[i][1] = spans[i + 1][0] + spans[i + 1][1] - spans[i][0]
+        del spans[i + 1]
+    return spans
+
+
+def encode_ops(blocks):
+    """Ops for one span from a list of (kind, data)"""
+    out = bytearray()
+    i = 0
+    while i < len(blocks):
+        kind, data = blocks[i]
+        j = i + 1
+        if kind == "solid":
+            while j < len(blocks) and j - i < MAX_OP and blocks[j] == blocks[i]:
+                j += 1
+            if j - i > 1:
+                out += struct.pack("<BH", 0x40 | (j - i - 1), data)
+                i = j
+                continue
+            # Different solid colors, up to the next run of one color
+            while (j < len(blocks) and j - i < MAX_OP and blocks[j][0] == "solid"
+                   and not (j + 1 < len(blocks) and blocks[j + 1] == blocks[j])):
+                j += 1
+            out.append(j - i - 1)
+            for _, color in blocks[i:j]:
+                out += struct.pack("<H", color)
+        else:
+            while j < len(blocks) and j - i < MAX_OP and blocks[j][0] == kind:
+                j += 1
+            if kind == "two":
+                out.append(0x80 | (j - i - 1))
+                for _, (c0, c1, mask) in blocks[i:j]:
+                    out += struct.pack("<HHH", c0, c1, mask)
+            else:
+                out.append(0xC0 | (j - i - 1))
+                for _, pixels in blocks[i:j]:
+                    out += struct.pack("<16H", *pixels)
+        i = j
+    return out
+
+
+def encode_frame(shown, cur, width, height, tolerance):
+    """
+    Encode cur against what the decoder shows (None = nothing yet)
+
+    returns (data, shown after this frame, SPI pixels)
+    """
+    after = list(shown) if shown else [0] * (width * height)
+    out = bytearray()
+    pixels = 0
+    columns = width // BLOCK
+    for by in range(0, height, BLOCK):
+        changed = []
+        for c in range(columns):
+            block = get_block(cur, width, c * BLOCK, by)
+            if shown is None or block_error(block, get_block(shown, width, c * BLOCK, by)) > tolerance:
+                changed.append(c)
+        spans = find_spans(changed)
+        out.append(len(spans))
+        for first, count in spans:
+            blocks = []
+            for c in range(first, first + count):
+                kind, data, decoded = fit_block(get_block(cur, width, c * BLOCK, by), tolerance)
+                blocks.append((kind, data))
+                put_block(after, width, c * BLOCK, by, decoded)
+            out += struct.pack("<BB", first, count)
+            out += encode_ops(blocks)
+            pixels += count * BLOCK * BLOCK
+    return out, after, pixels
+
+
+# ========== DEMO ==========
+
+def demo_frames():
+    """Color bars with scrolling shading, then a ball bouncing over a slide"""
+    width, height = 240, 320
+    bars = [(230, 230, 230), (230, 230, 40), (40, 230, 230), (40, 230, 40),
+            (230, 40, 230), (230, 40, 40), (40, 40, 230), (30, 30, 30)]
+    frames = []
+
+    # Part 1: shading scrolls up through the bars, so every block
+    # changes every frame (worst case for the SPI)
+    for n in range(16):
+        pixels = []
+        for y in range(height):
+            shade = 64 + ((y + 8 * n) % 64) * 3
+            pixels += [rgb565(r * shade >> 8, g * shade >> 8, b * shade >> 8)
+                       for r, g, b in (bars[x // 30] for x in range(width))]
+        frames.append(pixels)
+
+    # Part 2: static slide with small moving parts
+    slide = []
+    for y in range(height):
+        if y < 40:
+            slide += [rgb565(20, 60, 140)] * width
+        else:
+            t = (y - 40) * 255 // (height - 40)
+            slide += [rgb565(240 - t // 3, 240 - t // 4, 230)] * width
+    for n in range(32):
+        pixels = list(slide)
+        cx = 40 + abs((n * 9) % 320 - 160)
+        cy = 80 + abs((n * 13) % 360 - 180)
+        for y in range(cy - 24, cy + 25):
+            half = int((24 * 24 - (y - cy) ** 2) ** 0.5)
+            start = y * width
+            pixels[start + cx - half:start + cx + half + 1] = [rgb565(230, 80, 40)] * (2 * half + 1)
+        done = (n + 1) * (width - 40) // 32
+        for y in range(292, 300):
+            start = y * width
+            pixels[start + 20:start + 20 + done] = [rgb565(40, 180, 60)] * done
+        frames.append(pixels)
+    return width, height, frames
+
+
+def main(args):
+    frame_ms = 33
+    tolerance = 16
+    demo = False
+    while args and args[0].startswith("--"):
+        option = args.pop(0)
+        if option == "--ms":
+            frame_ms = int(args.pop(0))
+        elif option == "--tolerance":
+            tolerance = int(args.pop(0))
+        elif option == "--demo":
+            demo = True
+        else:
+            raise SystemExit("unknown option " + option)
+    if not args or (not demo and len(args) < 2):
+        raise SystemExit(__doc__)
+
+    output = args[0]
+    if demo:
+        width, height, frames = demo_frames()
+    else:
+        frames = []
+        for path in args[1:]:
+            width, height, pixels = read_frame(path)
+            if frames and len(pixels) != len(frames[0]):
+                raise SystemExit(path + ": frame size differs")
+            frames.append(pixels)
+    if width > 240 or height > 320:
+        raise SystemExit("frames are larger than the screen (240x320)")
+    if width % BLOCK or height % BLOCK:
+        raise SystemExit("width and height must be multiples of 4")
+
+    body = bytearray()
+    shown = None
+    spi = []
+    for cur in frames:
+        data, shown, pixels = encode_frame(shown, cur, width, height, tolerance)
+        body += data
+        spi.append(pixels)
+
+    header = struct.pack("<4sHHHHI", b"VID1", width, height, len(frames), frame_ms, 0)
+    with open(output, "wb") as f:
+        f.write(header + body)
+
+    raw = width * height * 2
+    print("%s: %dx%d, %d frames" % (output, width, height, len(frames)))
+    print("size %d bytes (raw frames: %d bytes), %d bytes per frame on average" % (
+        16 + len(body), raw * len(frames), len(body) // len(frames)))
+    print("SPI: %d%% of the pixels per frame on average" % (
+        100 * sum(spi) // (len(spi) * width * height)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
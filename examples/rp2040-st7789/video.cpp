@@ -0,0 +1,357 @@
+/**
+ * video.cpp
+ * Implementation of the three-stage video player
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include "video.h"
+#include "worker.h"
+#include "bytes.h"
+
+VideoPlayer::VideoPlayer(ST7789& display)
+    : _display(display), _data(nullptr), _frames(nullptr), _end(nullptr), _width(0), _height(0),
+      _frameCount(0), _frameMs(0), _x(0), _y(0), _playFrames(0), _stats(), _dma(-1),
+      _readPos(nullptr), _reading(false), _chunksFilled(0), _chunksUsed(0), _in(nullptr),
+      _inEnd(nullptr), _haveChunk(false), _bandsDecoded(0), _bandsFreed(0), _failed(false) {
+}
+
+// ========== HEADER ==========
+
+bool VideoPlayer::open(const uint8_t* data, size_t size) {
+    _data = nullptr;
+    if (size <= VIDEO_HEADER_SIZE || memcmp(data, "VID1", 4) != 0) return false;
+    
+    uint16_t width = read16(data + 4);
+    uint16_t height = read16(data + 6);
+    uint16_t frames = read16(data + 8);
+    if (width == 0 || height == 0 || width > SCREEN_WIDTH || height > SCREEN_HEIGHT) return false;
+    if (width % VIDEO_BLOCK || height % VIDEO_BLOCK || frames == 0) return false;
+    
+    _data = data;
+    _frames = data + VIDEO_HEADER_SIZE;
+    _end = data + size;
+    _width = width;
+    _height = height;
+    _frameCount = frames;
+    _frameMs = read16(data + 10);
+    return true;
+}
+
+// ========== FLUSH (core 0) ==========
+
+bool VideoPlayer::play(uint16_t x, uint16_t y, uint32_t frames, bool realTime) {
+    if (!_data || x + _width > SCREEN_WIDTH || y + _height > SCREEN_HEIGHT) return false;
+    
+    memset(&_stats, 0, sizeof(_stats));
+    _x = x;
+    _y = y;
+    _playFrames = frames;
+    _readPos = _frames;
+    _reading = false;
+    _chunksFilled = 0;
+    _chunksUsed = 0;
+    _in = _inEnd = nullptr;
+    _haveChunk = false;
+    _bandsDecoded = 0;
+    _bandsFreed = 0;
+    _failed = false;
+    if (_dma < 0) {
+        _dma = dma_claim_unused_channel(true);
+    }
+    
+    uint32_t bands = frames * (_height / VIDEO_BLOCK);
+    uint32_t frameUs = (uint32_t)_frameMs * 1000;
+    uint32_t t0 = time_us_32();
+    serviceReader();
+    workerSubmit(decodeJob, this);
+    
+    bool frameStart = true;
+    for (uint32_t flushed = 0; flushed < bands; flushed++) {
+        if (_bandsDecoded == flushed) {
+            uint32_t tw = time_us_32();
+            while (_bandsDecoded == flushed && !_failed) {
+                serviceReader();
+                freeBands(flushed);
+            }
+            _stats.bandWaitUs += time_us_32() - tw;
+            if (_bandsDecoded == flushed) break;  // Decoder gave up
+        }
+        __dmb();  // Band contents are read after the counter
+        
+        // Frames are timed from the start, so one slow frame does not
+        // shift the rest
+        if (frameStart && realTime) {
+            uint32_t due = t0 + _stats.frames * frameUs;
+            int32_t early = (int32_t)(due - time_us_32());
+            while (early > 0) {
+                serviceReader();
+                freeBands(flushed);
+                early = (int32_t)(due - time_us_32());
+            }
+            if (-early >= (int32_t)frameUs && _stats.frames > 0) _stats.lateFrames++;
+        }
+        
+        const VideoBand& band = _bands[flushed % VIDEO_BANDS];
+        flushBand(band, flushed);
+        frameStart = band.frameEnd;
+        if (band.frameEnd) _stats.frames++;
+        serviceReader();
+    }
+    
+    uint32_t tw = time_us_32();
+    _display.waitIdle();
+    _stats.spiWaitUs += time_us_32() - tw;
+    workerWait();
+    if (_reading) {
+        dma_channel_wait_for_finish_blocking(_dma);
+        _reading = false;
+    }
+    _stats.us = time_us_32() - t0;
+    return !_failed;
+}
+
+/**
+ * One window per span
+ * 
+ * 
+ * Starting a window waits for the transfer before it, so once the
+ * first span of this band is on its way, all earlier bands are off
+ * the DMA and their slots can go back to the decoder.
+ */
+void VideoPlayer::flushBand(const VideoBand& band, uint32_t index) {
+    const uint16_t* pixels = band.pixels;
+    for (uint8_t s = 0; s < band.spanCount; s++) {
+        uint16_t w = band.spanBlocks[s] * VIDEO_BLOCK;
+        uint32_t tw = time_us_32();
+        _display.drawBufferAsync(_x + band.spanBlock[s] * VIDEO_BLOCK, _y + band.y,
+                                 w, VIDEO_BLOCK, pixels);
+        _stats.spiWaitUs += time_us_32() - tw;
+        if (s == 0) {
+            __dmb();
+            _bandsFreed = index;
+        }
+        pixels += w * VIDEO_BLOCK;
+        _stats.spiBytes += VIDEO_WINDOW_BYTES + 2u * w * VIDEO_BLOCK;
+    }
+}
+
+/**
+ * Hand every flushed band back once the display DMA is idle
+ */
+void VideoPlayer::freeBands(uint32_t flushed) {
+    if (_bandsFreed != flushed && !_display.isBusy()) {
+        __dmb();
+        _bandsFreed = flushed;
+    }
+}
+
+// ========== READER (core 0 + DMA) ==========
+
+/**
+ * Copy the next chunk of the clip into a free input slot
+ * 
+ * 
+ * Whole words when source and length allow it (4× fewer bus
+ * transfers), bytes otherwise. At the end of the clip the stream
+ * wraps to the first frame, so looping needs no special case in the
+ * decoder.
+ */
+void VideoPlayer::startRead() {
+    uint32_t slot = _chunksFilled % VIDEO_CHUNKS;
+    uint32_t length = _end - _readPos;
+    if (length > VIDEO_CHUNK_SIZE) length = VIDEO_CHUNK_SIZE;
+    bool words = (((uintptr_t)_readPos | length) & 3) == 0;
+    
+    dma_channel_config config = dma_channel_get_default_config(_dma);
+    channel_config_set_transfer_data_size(&config, words ? DMA_SIZE_32 : DMA_SIZE_8);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, true);
+    dma_channel_configure(_dma, &config, _input[slot], _readPos, words ? length / 4 : length, true);
+    
+    _chunkLength[slot] = length;
+    _readPos += length;
+    if (_readPos == _end) _readPos = _frames;
+    _stats.bytesRead += length;
+    _reading = true;
+}
+
+/**
+ * Publish a finished chunk and start the next one if a slot is free
+ * 
+ * 
+ * Never blocks; core 0 calls it between bands and while waiting.
+ */
+void VideoPlayer::serviceReader() {
+    if (_reading) {
+        if (dma_channel_is_busy(_dma)) return;
+        _reading = false;
+        __dmb();
+        _chunksFilled = _chunksFilled + 1;
+    }
+    if (_chunksFilled - _chunksUsed < VIDEO_CHUNKS) {
+        startRead();
+    }
+}
+
+// ========== DECODER (core 1) ==========
+
+void VideoPlayer::decodeJob(void* arg) {
+    static_cast<VideoPlayer*>(arg)->decodeAll();
+}
+
+void VideoPlayer::decodeAll() {
+    uint32_t start = time_us_32();
+    uint16_t bandsPerFrame = _height / VIDEO_BLOCK;
+    
+    for (uint32_t frame = 0; frame < _playFrames; frame++) {
+        for (uint16_t b = 0; b < bandsPerFrame; b++) {
+            if (_bandsDecoded - _bandsFreed >= VIDEO_BANDS) {
+                uint32_t tw = time_us_32();
+                while (_bandsDecoded - _bandsFreed >= VIDEO_BANDS) {
+                    tight_loop_contents();
+                }
+                _stats.outputWaitUs += time_us_32() - tw;
+            }
+            __dmb();  // Slot is written after core 0 let go of it
+            
+            VideoBand& band = _bands[_bandsDecoded % VIDEO_BANDS];
+            band.y = b * VIDEO_BLOCK;
+            band.frameEnd = (b == bandsPerFrame - 1);
+            if (!decodeBand(band)) {
+                _failed = true;
+                frame = _playFrames;
+                break;
+            }
+            __dmb();
+            _bandsDecoded = _bandsDecoded + 1;
+        }
+    }
+    _stats.decodeUs = time_us_32() - start - _stats.inputWaitUs - _stats.outputWaitUs;
+}
+
+/**
+ * Release the chunk just read and wait for the next one
+ */
+void VideoPlayer::nextChunk() {
+    if (_haveChunk) {
+        __dmb();
+        _chunksUsed = _chunksUsed + 1;
+    }
+    if (_chunksFilled == _chunksUsed) {
+        uint32_t tw = time_us_32();
+        while (_chunksFilled == _chunksUsed) {
+            tight_loop_contents();
+        }
+        _stats.inputWaitUs += time_us_32() - tw;
+    }
+    __dmb();
+    
+    uint32_t slot = _chunksUsed % VIDEO_CHUNKS;
+    _in = _input[slot];
+    _inEnd = _in + _chunkLength[slot];
+    _haveChunk = true;
+}
+
+inline uint8_t VideoPlayer::readByte() {
+    if (_in == _inEnd) nextChunk();
+    return *_in++;
+}
+
+inline uint16_t VideoPlayer::readColor() {
+    uint8_t lo = readByte();
+    return lo | (readByte() << 8);
+}
+
+static inline void fillBlock(uint16_t* p, uint16_t stride, uint16_t color) {
+    for (uint8_t row = 0; row < VIDEO_BLOCK; row++) {
+        p[0] = p[1] = p[2] = p[3] = color;
+        p += stride;
+    }
+}
+
+/**
+ * Spans must be in order and inside the clip, which also keeps their
+ * pixels inside the band buffer
+ */
+bool VideoPlayer::decodeBand(VideoBand& band) {
+    uint8_t spans = readByte();
+    if (spans > VIDEO_MAX_SPANS) return false;
+    
+    uint16_t blocksPerRow = _width / VIDEO_BLOCK;
+    uint16_t next = 0;
+    uint16_t* out = band.pixels;
+    for (uint8_t s = 0; s < spans; s++) {
+        uint8_t first = readByte();
+        uint8_t blocks = readByte();
+        if (blocks == 0 || first < next || first + blocks > blocksPerRow) return false;
+        if (!decodeSpan(out, blocks)) return false;
+        
+        band.spanBlock[s] = first;
+        band.spanBlocks[s] = blocks;
+        out += blocks * VIDEO_BLOCK * VIDEO_BLOCK;
+        next = first + blocks;
+    }
+    band.spanCount = spans;
+    return true;
+}
+
+/**
+ * Decode the ops of one span into its window, row by row
+ */
+bool VideoPlayer::decodeSpan(uint16_t* out, uint8_t blocks) {
+    uint16_t stride = blocks * VIDEO_BLOCK;
+    
+    while (blocks) {
+        uint8_t op = readByte();
+        uint8_t n = (op & 0x3F) + 1;
+        if (n > blocks) return false;  // Ops never reach past the span
+        blocks -= n;
+        
+        switch (op >> 6) {
+        case 0:  // Solid blocks
+            for (; n; n--, out += VIDEO_BLOCK) {
+                fillBlock(out, stride, readColor());
+            }
+            break;
+        case 1: {  // Run of one solid color
+            uint16_t color = readColor();
+            for (; n; n--, out += VIDEO_BLOCK) {
+                fillBlock(out, stride, color);
+            }
+            break;
+        }
+        case 2:  // Two colors and a mask
+            for (; n; n--, out += VIDEO_BLOCK) {
+                uint16_t colors[2];
+                colors[0] = readColor();
+                colors[1] = readColor();
+                uint16_t mask = readColor();
+                uint16_t* p = out;
+                for (uint8_t row = 0; row < VIDEO_BLOCK; row++, mask >>= 4) {
+                    p[0] = colors[mask & 1];
+                    p[1] = colors[(mask >> 1) & 1];
+                    p[2] = colors[(mask >> 2) & 1];
+                    p[3] = colors[(mask >> 3) & 1];
+                    p += stride;
+                }
+            }
+            break;
+        default:  // Raw
+            for (; n; n--, out += VIDEO_BLOCK) {
+                uint16_t* p = out;
+                for (uint8_t row = 0; row < VIDEO_BLOCK; row++, p += stride) {
+                    for (uint8_t col = 0; col < VIDEO_BLOCK; col++) {
+                        p[col] = readColor();
+                    }
+                }
+            }
+            break;
+        }
+    }
+    return true;
+}
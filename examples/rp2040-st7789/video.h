@@ -0,0 +1,193 @@
+/**
+ * video.h
+ * Three-stage video player: storage reader, decoder, display DMA
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Plays clips made with tools/videoenc.py. The work is split into
+ * three stages that run at the same time, connected by ring buffers:
+ * 
+ *   reader   (DMA channel, started from core 0)
+ *            storage → input ring (VIDEO_CHUNKS × VIDEO_CHUNK_SIZE)
+ *   decoder  (core 1, see worker.h)
+ *            input ring → band ring (VIDEO_BANDS × 4 lines)
+ *   flush    (core 0 + display DMA)
+ *            band ring → display windows
+ * 
+ * Each ring has one producer and one consumer, each counter is
+ * written by one side only, so no locks are needed. A stage that
+ * finds its ring empty or full waits and counts the time, which shows
+ * the bottleneck: the decoder waiting for input means the reader is
+ * too slow, the decoder waiting for free bands means the SPI is.
+ * 
+ * The clip is read from memory-mapped storage (XIP flash). Copying
+ * it by DMA keeps flash cache misses out of the decoder; an SD card
+ * or SPI flash source only needs another startRead().
+ * 
+ * Codec (built for the M0+: no multiplications, 4×4 blocks, each
+ * block written straight into the band buffer):
+ * 
+ *   header  "VID1", width, height, frame count, frame time in ms,
+ *           uint32 0 (16 bytes, little endian)
+ *   frame   one record per band of 4 lines:
+ *             span count (0 = band unchanged)
+ *             per span: first block, block count, block ops
+ *   ops     0x00-0x3F: n + 1 solid blocks, one color each
+ *           0x40-0x7F: n + 1 solid blocks of one color
+ *           0x80-0xBF: n + 1 two-color blocks: color 0, color 1,
+ *                      16-bit mask (bit 0 = top-left, 1 = color 1)
+ *           0xC0-0xFF: n + 1 raw blocks, 16 colors each
+ * 
+ * A span is a run of changed blocks and becomes one display window;
+ * blocks outside the spans keep what the panel already shows.
+ * 
+ * example:
+ * 
+ * static VideoPlayer video(display);
+ * if (video.open(clip_vid, sizeof(clip_vid))) {
+ *     video.play(0, 0, video.frameCount(), true);
+ * }
+ * 
+ */
+
+#ifndef VIDEO_H
+#define VIDEO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+
+#define VIDEO_HEADER_SIZE 16
+#define VIDEO_BLOCK       4                        // < Block size and band height
+#define VIDEO_MAX_SPANS   16                       // < Windows per band
+#define VIDEO_CHUNK_SIZE  2048                     // < Bytes per reader DMA transfer
+#define VIDEO_CHUNKS      4                        // < Input ring slots
+#define VIDEO_BANDS       6                        // < Band ring slots
+#define VIDEO_WINDOW_BYTES 11                      // < CASET + RASET + RAMWR with parameters
+
+/**
+ * Where the time went during play()
+ * 
+ * Core 0 time is spiWaitUs + bandWaitUs + the rest (reader service,
+ * pacing); core 1 time is decodeUs + inputWaitUs + outputWaitUs.
+ */
+struct VideoStats {
+    uint32_t frames;
+    uint32_t us;               // < Total play time
+    uint32_t bytesRead;        // < Reader stage
+    uint32_t spiBytes;         // < Pixels and window commands sent
+    uint32_t decodeUs;         // < Core 1 decoding
+    uint32_t inputWaitUs;      // < Core 1 waiting for the reader
+    uint32_t outputWaitUs;     // < Core 1 waiting for a free band
+    uint32_t spiWaitUs;        // < Core 0 waiting for the display DMA
+    uint32_t bandWaitUs;       // < Core 0 waiting for a decoded band
+    uint32_t lateFrames;       // < Frames started after their time slot
+};
+
+/**
+ * One band (4 lines) of decoded spans
+ * 
+ * Span pixels are stored one after the other, each span row by row,
+ * ready for one drawBufferAsync() per span.
+ */
+struct VideoBand {
+    uint16_t y;                // < Band top in the clip
+    uint8_t spanCount;
+    bool frameEnd;             // < Last band of a frame
+    uint8_t spanBlock[VIDEO_MAX_SPANS];
+    uint8_t spanBlocks[VIDEO_MAX_SPANS];
+    uint16_t pixels[VIDEO_BLOCK * SCREEN_WIDTH];
+};
+
+/**
+ * Video player
+ * 
+ * 
+ * About 20 KB of buffers, so make it static or global.
+ */
+class VideoPlayer {
+public:
+    VideoPlayer(ST7789& display);
+    
+    /**
+     * Check the header
+     * 
+     * data Clip in memory-mapped storage; must stay valid while playing
+     * size Size in bytes
+     * 
+     * returns false if the header is damaged or the clip is larger
+     * than the screen
+     */
+    bool open(const uint8_t* data, size_t size);
+    
+    uint16_t width() const { return _width; }
+    uint16_t height() const { return _height; }
+    uint16_t frameCount() const { return _frameCount; }
+    uint16_t frameMs() const { return _frameMs; }
+    
+    /**
+     * Play frames, looping the clip as needed (blocks until done)
+     * 
+     * x, y Screen position (the clip must fit)
+     * frames Number of frames to show
+     * realTime true: one frame per frameMs(); false: as fast as the
+     *          slowest stage allows
+     * 
+     * returns false if the data was damaged
+     * 
+     * Uses core 1 (worker.h) for the whole call.
+     */
+    bool play(uint16_t x, uint16_t y, uint32_t frames, bool realTime);
+    
+    /**
+     * Numbers for the last play()
+     */
+    const VideoStats& stats() const { return _stats; }
+
+private:
+    ST7789& _display;
+    const uint8_t* _data;
+    const uint8_t* _frames;        // < First frame
+    const uint8_t* _end;
+    uint16_t _width, _height;
+    uint16_t _frameCount;
+    uint16_t _frameMs;
+    uint16_t _x, _y;
+    uint32_t _playFrames;
+    VideoStats _stats;
+    
+    // ========== READER (core 0 + DMA) ==========
+    int _dma;
+    const uint8_t* _readPos;
+    bool _reading;
+    alignas(4) uint8_t _input[VIDEO_CHUNKS][VIDEO_CHUNK_SIZE];  // < Word aligned for 32-bit DMA
+    uint16_t _chunkLength[VIDEO_CHUNKS];
+    volatile uint32_t _chunksFilled;   // < Written by core 0
+    volatile uint32_t _chunksUsed;     // < Written by core 1
+    
+    // ========== DECODER (core 1) ==========
+    const uint8_t* _in;
+    const uint8_t* _inEnd;
+    bool _haveChunk;
+    VideoBand _bands[VIDEO_BANDS];
+    volatile uint32_t _bandsDecoded;   // < Written by core 1
+    volatile uint32_t _bandsFreed;     // < Written by core 0
+    volatile bool _failed;             // < Written by core 1
+    
+    void startRead();
+    void serviceReader();
+    
+    uint8_t readByte();
+    uint16_t readColor();
+    void nextChunk();
+    bool decodeBand(VideoBand& band);
+    bool decodeSpan(uint16_t* out, uint8_t blocks);
+    void decodeAll();
+    static void decodeJob(void* arg);
+    
+    void flushBand(const VideoBand& band, uint32_t index);
+    void freeBands(uint32_t flushed);
+};
+
+#endif // VIDEO_H
@@ -0,0 +1,113 @@
+/**
+ * waterfall.cpp
+ * Implementation of the spectrum waterfall widget
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "waterfall.h"
+#include <string.h>
+
+/**
+ * Default palette, computed at compile time
+ * 
+ * 
+ * Linear interpolation between five color stops, stored in flash.
+ * It is copied to RAM by the constructor: the per-pixel lookups then
+ * never touch flash.
+ */
+struct WaterfallPalette {
+    uint16_t colors[WATERFALL_PALETTE_SIZE];
+};
+
+static constexpr WaterfallPalette makeHeatPalette() {
+    // Stops as 8-bit R, G, B at magnitudes 0, 64, 128, 192, 255
+    const uint8_t stops[5][3] = {
+        {   0,   0,   0 },  // Black
+        {   0,   0, 255 },  // Blue
+        {   0, 255, 255 },  // Cyan
+        { 255, 255,   0 },  // Yellow
+        { 255,   0,   0 }   // Red
+    };
+    
+    WaterfallPalette palette = {};
+    for (int i = 0; i < WATERFALL_PALETTE_SIZE; i++) {
+        int seg = i / 64;
+        int t = i % 64;
+        int r = stops[seg][0] + (stops[seg + 1][0] - stops[seg][0]) * t / 64;
+        int g = stops[seg][1] + (stops[seg + 1][1] - stops[seg][1]) * t / 64;
+        int b = stops[seg][2] + (stops[seg + 1][2] - stops[seg][2]) * t / 64;
+        palette.colors[i] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+    }
+    // Saturated peaks show as white
+    palette.colors[WATERFALL_PALETTE_SIZE - 1] = 0xFFFF;
+    return palette;
+}
+
+static constexpr WaterfallPalette WATERFALL_HEAT = makeHeatPalette();
+
+/**
+ * Constructor implementation
+ */
+Waterfall::Waterfall(ST7789& display, uint16_t top, uint16_t height)
+    : _display(display), _top(top), _height(height), _head(0), _rows(0),
+      _lineIndex(0) {
+    setPalette(WATERFALL_HEAT.colors);
+}
+
+void Waterfall::setPalette(const uint16_t* palette) {
+    memcpy(_palette, palette, sizeof(_palette));
+}
+
+/**
+ * Prepare the scroll band
+ * 
+ * 
+ * Lines outside the band become fixed areas. The band starts black,
+ * i.e. filled with the color of magnitude 0.
+ */
+void Waterfall::begin() {
+    _display.setScrollArea(_top, SCREEN_HEIGHT - _top - _height);
+    _display.setScrollStart(_top);
+    _display.fillRect(0, _top, SCREEN_WIDTH, _height, _palette[0]);
+    _head = 0;
+    _rows = 0;
+}
+
+/**
+ * Add one line
+ * 
+ * 
+ * 1. Map magnitudes to colors into the free line buffer. This runs
+ *    while the previous line may still be on its way out by DMA.
+ * 2. Move the newest-line pointer one line up (wrapping inside the
+ *    band) and tell the display to start showing from there.
+ *    Everything that was on screen shifts down by one line.
+ * 3. Send the new line into that frame memory line by DMA.
+ * 
+ * Bins are stretched to 240 pixels with a 16.16 fixed-point step, so
+ * no division or floating point happens per pixel.
+ */
+void Waterfall::pushRow(const uint8_t* magnitudes, uint16_t count) {
+    if (count == 0) return;
+    
+    // ========== MAP TO COLORS ==========
+    uint16_t* line = _lineBuf[_lineIndex];
+    uint32_t step = ((uint32_t)count << 16) / SCREEN_WIDTH;
+    uint32_t pos = 0;
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+        line[x] = _palette[magnitudes[pos >> 16]];
+        pos += step;
+    }
+    
+    // ========== SCROLL ==========
+    // Newest line moves up, older lines appear one line further down
+    _head = (_head == 0) ? _height - 1 : _head - 1;
+    _display.setScrollStart(_top + _head);
+    
+    // ========== SEND LINE ==========
+    _display.drawBufferAsync(0, _top + _head, SCREEN_WIDTH, 1, line);
+    
+    _lineIndex ^= 1;
+    _rows++;
+}
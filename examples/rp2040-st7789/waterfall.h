@@ -0,0 +1,103 @@
+/**
+ * waterfall.h
+ * Spectrum waterfall (spectrogram) widget
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Shows a history of spectra as colored lines: each new spectrum is
+ * one 240 pixel line at the top of the widget, older lines move down
+ * and eventually fall off the bottom.
+ * 
+ * Nothing is ever redrawn. The widget's band of the screen is set up
+ * as the ST7789 hardware scroll area, so adding a line costs:
+ * - one VSCRSADD command to move the history down by one line
+ * - one setWindow() and a 480 byte DMA transfer for the new line
+ * 
+ * Magnitudes (0-255) are turned into colors through a 256 entry
+ * RGB565 lookup table, so the per-pixel work is a single table read.
+ * While the DMA sends one line, the CPU is free to map the next.
+ * 
+ * example:
+ * 
+ * Waterfall waterfall(display, 40, 280);  // Lines 40-319
+ * waterfall.begin();
+ * waterfall.pushRow(magnitudes, 128);     // 128 bins stretched to 240 px
+ * 
+ */
+
+#ifndef WATERFALL_H
+#define WATERFALL_H
+
+#include <stdint.h>
+#include "st7789.h"
+
+#define WATERFALL_PALETTE_SIZE 256  // < One color per magnitude value
+
+/**
+ * Waterfall widget
+ * 
+ * 
+ * Uses the full screen width and a horizontal band of lines. The
+ * lines above and below the band stay fixed and can be used for
+ * labels or a spectrum plot.
+ * 
+ * The widget owns the hardware scroll region, so only one waterfall
+ * (or terminal, hex viewer, ...) can be active at a time.
+ */
+class Waterfall {
+public:
+    /**
+     * Constructor - creates waterfall on an initialized display
+     * 
+     * display Display to draw on
+     * top First screen line of the widget
+     * height Number of lines of history
+     */
+    Waterfall(ST7789& display, uint16_t top, uint16_t height);
+    
+    /**
+     * Set up the scroll area and clear the history
+     */
+    void begin();
+    
+    /**
+     * Replace the magnitude-to-color table
+     * 
+     * palette WATERFALL_PALETTE_SIZE RGB565 colors, index = magnitude
+     * 
+     * The table is copied into RAM. The default is a "heat" map
+     * (black - blue - cyan - yellow - red - white).
+     */
+    void setPalette(const uint16_t* palette);
+    
+    /**
+     * Add a new line at the top
+     * 
+     * magnitudes One value per frequency bin (0 = weakest)
+     * count Number of bins, stretched or squeezed to the screen width
+     * 
+     * 
+     * Returns as soon as the line's DMA transfer has been started.
+     * The magnitudes array may be reused immediately.
+     */
+    void pushRow(const uint8_t* magnitudes, uint16_t count);
+    
+    /**
+     * Number of lines pushed since begin()
+     */
+    uint32_t rowsPushed() const { return _rows; }
+
+private:
+    ST7789& _display;   // < Display to draw on
+    uint16_t _top;      // < First screen line of the band
+    uint16_t _height;   // < Lines in the band
+    uint16_t _head;     // < Band line (0.._height-1) holding the newest row
+    uint32_t _rows;     // < Lines pushed
+    
+    uint16_t _palette[WATERFALL_PALETTE_SIZE];  // < Magnitude to RGB565
+    uint16_t _lineBuf[2][SCREEN_WIDTH];         // < Double buffered lines
+    uint8_t _lineIndex;                         // < Buffer to fill next
+};
+
+#endif // WATERFALL_H
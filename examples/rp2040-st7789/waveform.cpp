@@ -0,0 +1,259 @@
+/**
+ * waveform.cpp
+ * Implementation of the min/max waveform pyramid and plot
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "waveform.h"
+
+// ========== PYRAMID ==========
+
+/**
+ * An entry that contains nothing: any real sample replaces both ends
+ */
+static const WaveMinMax WAVE_EMPTY = { INT16_MAX, INT16_MIN };
+
+static inline void waveMerge(WaveMinMax& into, const WaveMinMax& from) {
+    if (from.min < into.min) into.min = from.min;
+    if (from.max > into.max) into.max = from.max;
+}
+
+WaveformPyramid::WaveformPyramid()
+    : _storage(nullptr), _capacity(0), _blockSize(1), _count(0),
+      _samples(nullptr), _levels(0) {
+}
+
+size_t WaveformPyramid::storageEntries(size_t count, uint16_t blockSize) {
+    size_t entries = (count + blockSize - 1) / blockSize;
+    size_t total = entries;
+    for (int level = 1; level < WAVE_MAX_LEVELS && entries > 1; level++) {
+        entries = (entries + WAVE_LEVEL_RATIO - 1) / WAVE_LEVEL_RATIO;
+        total += entries;
+    }
+    return total;
+}
+
+void WaveformPyramid::begin(WaveMinMax* storage, size_t entries, uint16_t blockSize) {
+    _storage = storage;
+    _capacity = entries;
+    _blockSize = blockSize ? blockSize : 1;
+    _count = 0;
+    _samples = nullptr;
+    _levels = 0;
+    _levelOffset[0] = 0;
+    _levelCount[0] = 0;
+    _partial = WAVE_EMPTY;
+}
+
+/**
+ * Accumulate samples into level 0
+ * 
+ * 
+ * Every blockSize samples one min/max entry is stored. This is the
+ * only pass over the raw trace; everything above level 0 is built
+ * from level 0 in finish().
+ */
+bool WaveformPyramid::append(const int16_t* samples, size_t count) {
+    size_t fill = _count % _blockSize;
+    
+    for (size_t i = 0; i < count; i++) {
+        int16_t value = samples[i];
+        if (value < _partial.min) _partial.min = value;
+        if (value > _partial.max) _partial.max = value;
+        
+        if (++fill == _blockSize) {
+            if (_levelCount[0] == _capacity) return false;
+            _storage[_levelCount[0]++] = _partial;
+            _partial = WAVE_EMPTY;
+            fill = 0;
+        }
+        _count++;
+    }
+    return true;
+}
+
+/**
+ * Build upper levels
+ * 
+ * 
+ * Each level entry is the min/max of WAVE_LEVEL_RATIO entries of the
+ * level below. If the storage is too small for all levels, fewer are
+ * built: queries stay correct, they just combine more entries.
+ */
+void WaveformPyramid::finish(const int16_t* samples) {
+    _samples = samples;
+    
+    // Last, incomplete block
+    if (_count % _blockSize && _levelCount[0] < _capacity) {
+        _storage[_levelCount[0]++] = _partial;
+        _partial = WAVE_EMPTY;
+    }
+    _levels = 1;
+    
+    while (_levels < WAVE_MAX_LEVELS && _levelCount[_levels - 1] > 1) {
+        size_t below = _levelOffset[_levels - 1];
+        size_t belowCount = _levelCount[_levels - 1];
+        size_t offset = below + belowCount;
+        size_t count = (belowCount + WAVE_LEVEL_RATIO - 1) / WAVE_LEVEL_RATIO;
+        if (offset + count > _capacity) break;
+        
+        for (size_t i = 0; i < count; i++) {
+            WaveMinMax mm = WAVE_EMPTY;
+            size_t first = i * WAVE_LEVEL_RATIO;
+            for (size_t j = first; j < first + WAVE_LEVEL_RATIO && j < belowCount; j++) {
+                waveMerge(mm, _storage[below + j]);
+            }
+            _storage[offset + i] = mm;
+        }
+        
+        _levelOffset[_levels] = offset;
+        _levelCount[_levels] = count;
+        _levels++;
+    }
+}
+
+/**
+ * Min/max query
+ * 
+ * 
+ * Level k blocks hold blockSize × 4^k samples. The coarsest level
+ * whose block still fits into the range is used, so the range covers
+ * between 1 and 4 of its blocks (plus partial ones at both ends):
+ * never more than a handful of entries, whatever the zoom.
+ */
+WaveMinMax WaveformPyramid::range(size_t start, size_t end) const {
+    WaveMinMax mm = WAVE_EMPTY;
+    if (end > _count) end = _count;
+    if (start >= end || _levels == 0) return mm;
+    
+    size_t length = end - start;
+    
+    // ========== RAW SAMPLES ==========
+    if (_samples && length < _blockSize) {
+        for (size_t i = start; i < end; i++) {
+            int16_t value = _samples[i];
+            if (value < mm.min) mm.min = value;
+            if (value > mm.max) mm.max = value;
+        }
+        return mm;
+    }
+    
+    // ========== PYRAMID LEVEL ==========
+    uint8_t level = 0;
+    size_t block = _blockSize;
+    while (level + 1 < _levels && block * WAVE_LEVEL_RATIO <= length) {
+        block *= WAVE_LEVEL_RATIO;
+        level++;
+    }
+    
+    const WaveMinMax* entries = _storage + _levelOffset[level];
+    for (size_t i = start / block; i <= (end - 1) / block; i++) {
+        waveMerge(mm, entries[i]);
+    }
+    return mm;
+}
+
+// ========== PLOT ==========
+
+WaveformPlot::WaveformPlot(ST7789& display, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    : _display(display), _pyramid(nullptr), _x(x), _y(y),
+      _w(w > SCREEN_WIDTH ? SCREEN_WIDTH : w), _h(h),
+      _minValue(INT16_MIN), _maxValue(INT16_MAX), _viewStart(0), _viewLength(0),
+      _traceColor(COLOR_GREEN), _backColor(COLOR_BLACK), _valid(false) {
+}
+
+void WaveformPlot::setSource(const WaveformPyramid* pyramid) {
+    _pyramid = pyramid;
+}
+
+void WaveformPlot::setScale(int16_t minValue, int16_t maxValue) {
+    _minValue = minValue;
+    _maxValue = maxValue;
+}
+
+void WaveformPlot::setView(size_t start, size_t length) {
+    _viewStart = start;
+    _viewLength = length;
+}
+
+void WaveformPlot::setColors(uint16_t trace, uint16_t background) {
+    _traceColor = trace;
+    _backColor = background;
+    _valid = false;
+}
+
+void WaveformPlot::invalidate() {
+    _valid = false;
+}
+
+/**
+ * Map sample value to a row inside the plot (0 = top)
+ */
+uint16_t WaveformPlot::valueToY(int16_t value) const {
+    if (value <= _minValue) return _h - 1;
+    if (value >= _maxValue) return 0;
+    int32_t range = (int32_t)_maxValue - _minValue;
+    return (uint16_t)(((int32_t)_maxValue - value) * (_h - 1) / range);
+}
+
+/**
+ * Draw the view
+ * 
+ * 
+ * For each column:
+ * 1. Query min/max of the column's slice of samples. The slice is
+ *    extended by one sample to the right so neighbouring spans touch
+ *    and steep edges appear as a continuous line.
+ * 2. Convert to a span [top, bottom] of rows.
+ * 3. Compare with the span drawn last time: erase the rows that are
+ *    no longer covered, draw the rows that are newly covered.
+ */
+void WaveformPlot::render() {
+    if (!_valid) {
+        _display.fillRect(_x, _y, _w, _h, _backColor);
+        for (uint16_t col = 0; col < _w; col++) {
+            _top[col] = 1;
+            _bottom[col] = 0;
+        }
+        _valid = true;
+    }
+    
+    for (uint16_t col = 0; col < _w; col++) {
+        // ========== COLUMN SLICE ==========
+        uint16_t newTop = 1, newBottom = 0;  // Empty
+        if (_pyramid && _viewLength) {
+            size_t start = _viewStart + (size_t)((uint64_t)col * _viewLength / _w);
+            size_t end = _viewStart + (size_t)((uint64_t)(col + 1) * _viewLength / _w);
+            WaveMinMax mm = _pyramid->range(start, end + 1);
+            if (mm.min <= mm.max) {
+                newTop = valueToY(mm.max);
+                newBottom = valueToY(mm.min);
+            }
+        }
+        
+        uint16_t oldTop = _top[col];
+        uint16_t oldBottom = _bottom[col];
+        if (newTop == oldTop && newBottom == oldBottom) continue;
+        
+        // ========== DELTA DRAW ==========
+        uint16_t x = _x + col;
+        bool oldEmpty = oldTop > oldBottom;
+        bool newEmpty = newTop > newBottom;
+        
+        if (oldEmpty || newEmpty || newBottom < oldTop || newTop > oldBottom) {
+            // No overlap: erase old span, draw new span
+            if (!oldEmpty) _display.fillRect(x, _y + oldTop, 1, oldBottom - oldTop + 1, _backColor);
+            if (!newEmpty) _display.fillRect(x, _y + newTop, 1, newBottom - newTop + 1, _traceColor);
+        } else {
+            // Overlap: only the ends change
+            if (oldTop < newTop) _display.fillRect(x, _y + oldTop, 1, newTop - oldTop, _backColor);
+            if (oldBottom > newBottom) _display.fillRect(x, _y + newBottom + 1, 1, oldBottom - newBottom, _backColor);
+            if (newTop < oldTop) _display.fillRect(x, _y + newTop, 1, oldTop - newTop, _traceColor);
+            if (newBottom > oldBottom) _display.fillRect(x, _y + oldBottom + 1, 1, newBottom - oldBottom, _traceColor);
+        }
+        
+        _top[col] = newTop;
+        _bottom[col] = newBottom;
+    }
+}
@@ -0,0 +1,219 @@
+/**
+ * waveform.h
+ * Min/max decimated waveform plot for very long traces
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * A capture of a million samples is 4000 times wider than the screen.
+ * Plotting every sample is pointless (they land on the same 240
+ * columns) and slow. What the eye needs per column is the lowest and
+ * highest value in that column's slice of the trace: one vertical
+ * span from min to max.
+ * 
+ * WaveformPyramid precomputes those min/max values once:
+ * 
+ *   level 0: min/max of every block of B samples        (N / B entries)
+ *   level 1: min/max of every 4 level 0 entries         (N / 4B entries)
+ *   level 2: min/max of every 4 level 1 entries         ...
+ * 
+ * To find min/max of any slice, the query picks the coarsest level
+ * whose blocks are still smaller than the slice and combines a handful
+ * of entries. The cost per column no longer depends on the zoom level,
+ * so a full redraw is O(screen width).
+ * 
+ * WaveformPlot draws the result: one span per column, and only the
+ * part of each span that differs from what was drawn before.
+ * 
+ * example:
+ * 
+ * WaveformPyramid pyramid;
+ * pyramid.begin(storage, storageEntries, 256);
+ * pyramid.append(samples, count);   // Can be called per chunk
+ * pyramid.finish(samples);          // Keep samples for deep zoom
+ * 
+ * WaveformPlot plot(display, 0, 40, 240, 200);
+ * plot.setSource(&pyramid);
+ * plot.setScale(-2048, 2047);
+ * plot.setView(0, pyramid.sampleCount());
+ * plot.render();
+ * 
+ */
+
+#ifndef WAVEFORM_H
+#define WAVEFORM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "st7789.h"
+
+#define WAVE_MAX_LEVELS  12  // < Enough for 4^11 × block size samples
+#define WAVE_LEVEL_RATIO 4   // < Entries combined per next level entry
+
+/**
+ * Minimum and maximum of a range of samples
+ */
+struct WaveMinMax {
+    int16_t min;
+    int16_t max;
+};
+
+/**
+ * Min/max pyramid over a sample trace
+ * 
+ * 
+ * Storage is provided by the caller (RAM), see storageEntries() for
+ * the size needed. The samples themselves are not copied: they can be
+ * streamed in with append() from anywhere (ADC, SD card, external
+ * flash). If they are also addressable in memory (RAM or XIP flash),
+ * pass the pointer to finish() to allow zooming in below block size.
+ */
+class WaveformPyramid {
+public:
+    WaveformPyramid();
+    
+    /**
+     * Storage entries needed for a trace
+     * 
+     * count Number of samples
+     * blockSize Samples per level 0 entry
+     * 
+     * returns Number of WaveMinMax entries for all levels together
+     * 
+     * About count / blockSize × 4/3. Example: 1M samples with
+     * blockSize 256 need 5461 entries (21 KB).
+     */
+    static size_t storageEntries(size_t count, uint16_t blockSize);
+    
+    /**
+     * Start building a new pyramid
+     * 
+     * storage Array for the pyramid
+     * entries Size of storage in entries
+     * blockSize Samples per level 0 entry
+     */
+    void begin(WaveMinMax* storage, size_t entries, uint16_t blockSize);
+    
+    /**
+     * Add samples to the end of the trace
+     * 
+     * samples Pointer to samples
+     * count Number of samples
+     * 
+     * returns false if the storage is full (the extra samples are dropped)
+     */
+    bool append(const int16_t* samples, size_t count);
+    
+    /**
+     * Build the upper levels after the last append()
+     * 
+     * samples Whole trace in memory, or nullptr if not addressable
+     */
+    void finish(const int16_t* samples);
+    
+    /**
+     * Min/max of samples [start, end)
+     * 
+     * 
+     * Exact when the raw samples are available and the range is
+     * shorter than one block, otherwise the range is widened to whole
+     * blocks of the chosen level (at most one block on each side),
+     * which is invisible at that zoom level.
+     */
+    WaveMinMax range(size_t start, size_t end) const;
+    
+    size_t sampleCount() const { return _count; }
+    uint8_t levels() const { return _levels; }
+
+private:
+    WaveMinMax* _storage;                   // < All levels, level 0 first
+    size_t _capacity;                       // < Storage size in entries
+    uint16_t _blockSize;                    // < Samples per level 0 entry
+    size_t _count;                          // < Samples appended
+    const int16_t* _samples;                // < Raw trace, may be nullptr
+    uint8_t _levels;                        // < Levels built
+    size_t _levelOffset[WAVE_MAX_LEVELS];   // < First entry of each level
+    size_t _levelCount[WAVE_MAX_LEVELS];    // < Entries in each level
+    WaveMinMax _partial;                    // < Block being accumulated
+};
+
+/**
+ * Waveform plot widget
+ * 
+ * 
+ * Draws the trace in a rectangle as one vertical span per column.
+ * The spans on screen are remembered, so panning and zooming only
+ * erase and draw the difference between old and new span of each
+ * column (at most four small fills).
+ */
+class WaveformPlot {
+public:
+    /**
+     * Constructor - creates plot in a screen rectangle
+     * 
+     * display Display to draw on
+     * x, y Top-left corner
+     * w Width in pixels (one column per pixel, at most SCREEN_WIDTH)
+     * h Height in pixels
+     */
+    WaveformPlot(ST7789& display, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    
+    /**
+     * Set trace to plot
+     * 
+     * pyramid Built pyramid (must stay valid)
+     */
+    void setSource(const WaveformPyramid* pyramid);
+    
+    /**
+     * Set vertical scale
+     * 
+     * minValue Sample value at the bottom edge
+     * maxValue Sample value at the top edge
+     */
+    void setScale(int16_t minValue, int16_t maxValue);
+    
+    /**
+     * Set visible part of the trace
+     * 
+     * start First visible sample
+     * length Number of samples across the plot width
+     */
+    void setView(size_t start, size_t length);
+    
+    /**
+     * Set colors
+     * 
+     * trace Color of the spans
+     * background Plot background
+     */
+    void setColors(uint16_t trace, uint16_t background);
+    
+    /**
+     * Forget what is on screen, next render() clears and redraws
+     */
+    void invalidate();
+    
+    /**
+     * Draw the current view
+     */
+    void render();
+
+private:
+    ST7789& _display;
+    const WaveformPyramid* _pyramid;
+    uint16_t _x, _y, _w, _h;
+    int16_t _minValue, _maxValue;
+    size_t _viewStart, _viewLength;
+    uint16_t _traceColor, _backColor;
+    bool _valid;                       // < _top/_bottom match the screen
+    
+    // Span drawn in each column (inclusive, relative to _y).
+    // _top > _bottom means the column is empty.
+    uint16_t _top[SCREEN_WIDTH];
+    uint16_t _bottom[SCREEN_WIDTH];
+    
+    uint16_t valueToY(int16_t value) const;
+};
+
+#endif // WAVEFORM_H
@@ -0,0 +1,68 @@
+/**
+ * worker.cpp
+ * Implementation of the core 1 job runner
+ * dielburg
+ * 17/10/2026
+ */
+
+#include "worker.h"
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+
+#define WORKER_TOKEN_RUN   0x52554E21  // < Core 0 → core 1: job is in the slot
+#define WORKER_TOKEN_DONE  0x444F4E45  // < Core 1 → core 0: job finished
+
+/**
+ * The job slot
+ * 
+ * Written by core 0 before the token is pushed, read by core 1 after
+ * the token is popped. The FIFO orders the two accesses.
+ */
+static volatile WorkerJob s_job;
+static void* volatile s_arg;
+static bool s_started = false;   // < Core 1 launched
+static bool s_pending = false;   // < Job submitted, result not collected
+
+/**
+ * Core 1 entry point: run jobs forever
+ */
+static void workerLoop() {
+    while (true) {
+        if (multicore_fifo_pop_blocking() != WORKER_TOKEN_RUN) continue;
+        __dmb();
+        s_job(s_arg);
+        __dmb();  // Job results visible before core 0 sees DONE
+        multicore_fifo_push_blocking(WORKER_TOKEN_DONE);
+    }
+}
+
+void workerStart() {
+    if (s_started) return;
+    multicore_launch_core1(workerLoop);
+    s_started = true;
+}
+
+void workerSubmit(WorkerJob job, void* arg) {
+    workerStart();
+    workerWait();
+    s_job = job;
+    s_arg = arg;
+    __dmb();
+    s_pending = true;
+    multicore_fifo_push_blocking(WORKER_TOKEN_RUN);
+}
+
+void workerWait() {
+    if (!s_pending) return;
+    while (multicore_fifo_pop_blocking() != WORKER_TOKEN_DONE) {
+        tight_loop_contents();
+    }
+    __dmb();
+    s_pending = false;
+}
+
+bool workerBusy() {
+    if (!s_pending) return false;
+    return !multicore_fifo_rvalid();
+}
@@ -0,0 +1,77 @@
+/**
+ * worker.h
+ * Run jobs on the second CPU core
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * The RP2040 has two Cortex-M0+ cores. main() runs on core 0, core 1
+ * is idle unless something is launched on it. This module starts a
+ * small loop on core 1 that waits for jobs and runs them, so heavy
+ * computations (FFT, decoding, ...) can overlap with drawing on
+ * core 0.
+ * 
+ * Hand-over uses the SIO inter-core FIFO: submitting a job pushes a
+ * word to core 1, finishing it pushes a word back. No locks needed.
+ * 
+ * One job is in flight at a time. workerSubmit() followed by
+ * workerWait() is the whole protocol:
+ * 
+ * example:
+ * 
+ * workerStart();
+ * workerSubmit(computeSpectrum, &job);  // Core 1 starts working
+ * drawPreviousFrame();                  // Core 0 draws meanwhile
+ * workerWait();                         // Result is ready
+ * 
+ */
+
+#ifndef WORKER_H
+#define WORKER_H
+
+/**
+ * Job function run on core 1
+ * 
+ * arg The pointer given to workerSubmit()
+ */
+typedef void (*WorkerJob)(void* arg);
+
+/**
+ * Launch the job loop on core 1
+ * 
+ * 
+ * Safe to call more than once; only the first call launches.
+ */
+void workerStart();
+
+/**
+ * Hand a job to core 1 and return immediately
+ * 
+ * job Function to run
+ * arg Argument passed to the function
+ * 
+ * 
+ * Starts core 1 if workerStart() was not called yet. If the previous
+ * job has not been waited for yet, this waits for it first. Whatever
+ * arg points to must stay valid until workerWait().
+ */
+void workerSubmit(WorkerJob job, void* arg);
+
+/**
+ * Wait until the submitted job has finished
+ * 
+ * 
+ * Returns immediately if no job is in flight. After it returns, all
+ * memory written by the job is visible to core 0.
+ */
+void workerWait();
+
+/**
+ * Check whether a submitted job is still running
+ * 
+ * returns true until the job has finished (workerWait() then returns
+ * without blocking)
+ */
+bool workerBusy();
+
+#endif // WORKER_H
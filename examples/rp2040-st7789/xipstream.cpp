@@ -0,0 +1,96 @@
+/**
+ * xipstream.cpp
+ * Implementation of the XIP streaming reads
+ * dielburg
+ * 17/10/2026
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "xipstream.h"
+
+XipStream::XipStream(uint16_t* memory, uint32_t pixels)
+    : _memory(memory), _bufferPixels((pixels / 2) & ~1u), _dma(-1), _stats() {
+}
+
+void XipStream::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool XipStream::isBusy() const {
+    return _dma >= 0 && dma_channel_is_busy(_dma);
+}
+
+void XipStream::wait() {
+    if (_dma < 0 || !dma_channel_is_busy(_dma)) return;
+    uint32_t t0 = time_us_32();
+    dma_channel_wait_for_finish_blocking(_dma);
+    _stats.waitUs += time_us_32() - t0;
+}
+
+bool XipStream::read(const void* flash, void* ram, uint32_t bytes) {
+    if ((((uintptr_t)flash | (uintptr_t)ram | bytes) & 3) || bytes == 0) return false;
+    wait();
+    if (_dma < 0) {
+        _dma = dma_claim_unused_channel(true);
+    }
+    
+    // Words left from a stream that was not read to the end
+    while (!(xip_ctrl_hw->stat & XIP_STAT_FIFO_EMPTY_BITS)) {
+        (void)xip_ctrl_hw->stream_fifo;
+    }
+    xip_ctrl_hw->stream_addr = (uintptr_t)flash;
+    xip_ctrl_hw->stream_ctr = bytes / 4;
+    
+    dma_channel_config c = dma_channel_get_default_config(_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_XIP_STREAM);
+    dma_channel_configure(_dma, &c, ram, (const void*)XIP_AUX_BASE, bytes / 4, true);
+    
+    _stats.reads++;
+    _stats.bytes += bytes;
+    return true;
+}
+
+// ========== DRAWING ==========
+
+void XipStream::drawImage(ST7789& display, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                          const uint16_t* pixels) {
+    if (!_memory || _bufferPixels < 2 || w == 0) return;
+    
+    // Only the rows on screen are read; the display skips the columns that are not
+    const Rect& clip = display.clipRect();
+    int32_t rowFrom = clip.y > y ? clip.y - y : 0;
+    int32_t rowTo = clip.y + clip.h < y + h ? clip.y + clip.h - y : h;
+    if (rowFrom >= rowTo || x >= clip.x + clip.w || x + w <= clip.x) return;
+    
+    // Streams start on a word: an odd first pixel is read and not sent
+    const uint16_t* src = pixels + rowFrom * w;
+    uint32_t skip = ((uintptr_t)src >> 1) & 1;
+    src -= skip;
+    uint32_t left = (uint32_t)(rowTo - rowFrom) * w;
+    uint16_t* buffers[2] = { _memory, _memory + _bufferPixels };
+    
+    display.beginPixels(x, y + rowFrom, w, rowTo - rowFrom);
+    uint32_t count = _bufferPixels - skip < left ? _bufferPixels - skip : left;
+    read(src, buffers[0], (skip + count + 1) / 2 * 4);
+    for (uint8_t k = 0; left > 0; k ^= 1) {
+        wait();
+        uint16_t* piece = buffers[k] + skip;
+        src += skip + count;
+        left -= count;
+        skip = 0;
+        
+        // Returns once the piece before (in the other buffer) was taken
+        display.writePixelsAsync(piece, count);
+        if (left > 0) {
+            count = _bufferPixels < left ? _bufferPixels : left;
+            read(src, buffers[k ^ 1], (count + 1) / 2 * 4);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * xipstream.h
+ * Bulk reads from flash through the XIP streaming FIFO
+ * dielburg
+ * 17/10/2026
+ * 
+ * 
+ * Everything read through the normal XIP window goes through the
+ * 16 KB XIP cache. A 30 KB picture sent from flash by DMA fills the
+ * cache with pixels that are used once and evicts the code and tables
+ * the render loop needs, so the frames right after a big blit run
+ * slower while they are fetched from flash again.
+ * 
+ * The RP2040 has a second way into flash for this: the streaming
+ * FIFO. The XIP controller reads words from flash into it on its own,
+ * whenever the cache does not need the bus, without allocating
+ * anything in the cache; a DMA channel paced by DREQ_XIP_STREAM
+ * moves them to RAM. XipStream uses it to read flash into RAM, and
+ * to send pictures to the display: the picture is streamed into two
+ * line buffers in turn, and each one goes to the SPI by the
+ * display's DMA while the next is streamed (the FIFO gives 32-bit
+ * words, the SPI takes 16-bit pixels, so the pixels have to pass
+ * through RAM).
+ * 
+ * Flash streams at tens of MB/s, far faster than the display takes
+ * pixels, so the blit costs the same as from the cache; what changes
+ * is what is left in the cache afterwards. Reads shorter than
+ * XIP_STREAM_MIN_BYTES are not worth it (they evict little), which
+ * AssetPack::drawImage() follows.
+ * 
+ * There is one streaming FIFO: use one XipStream at a time, and not
+ * while the flash is written.
+ * 
+ * example:
+ * 
+ * static uint16_t lines[2 * 2 * SCREEN_WIDTH] __attribute__((aligned(4)));   // 2 buffers of 2 lines
+ * static XipStream stream(lines, sizeof(lines) / 2);
+ * AssetPack::drawImage(display, 0, 0, banner, &stream);                   // Cache left for code
+ * 
+ */
+
+#ifndef XIPSTREAM_H
+#define XIPSTREAM_H
+
+#include <stdint.h>
+#include "st7789.h"
+
+#define XIP_STREAM_MIN_BYTES 4096   // < Smaller reads go through the cache
+
+/**
+ * Counters since construction or the last resetStats()
+ */
+struct XipStreamStats {
+    uint32_t reads;    // < Streams started
+    uint32_t bytes;    // < Bytes streamed
+    uint32_t waitUs;   // < Time spent waiting for a stream to finish
+};
+
+/**
+ * Flash → RAM and flash → display through the streaming FIFO
+ */
+class XipStream {
+public:
+    /**
+     * memory Line buffer memory for drawImage(), 4-byte aligned, split
+     *        into two buffers (may be nullptr if only read() is used)
+     * pixels Size of memory in pixels
+     */
+    XipStream(uint16_t* memory, uint32_t pixels);
+    
+    /**
+     * Start streaming flash into RAM and return
+     * 
+     * flash Source in the XIP window, 4-byte aligned
+     * ram Destination, 4-byte aligned
+     * bytes Multiple of 4
+     * 
+     * returns false if an address or the size is not aligned
+     * 
+     * 
+     * Waits for the previous stream first.
+     */
+    bool read(const void* flash, void* ram, uint32_t bytes);
+    
+    /**
+     * Wait until the last read() is complete
+     */
+    void wait();
+    
+    bool isBusy() const;
+    
+    /**
+     * Send a picture from flash to the display without going through
+     * the XIP cache
+     * 
+     * pixels RGB565 pixels in the XIP window, 2-byte aligned
+     * 
+     * 
+     * Clipped like drawBufferAsync(): rows outside the clip rectangle
+     * are not read. Returns when the last piece has been handed to the
+     * display's DMA; the line buffers must not be touched until the
+     * display is idle.
+     */
+    void drawImage(ST7789& display, int16_t x, int16_t y, uint16_t w, uint16_t h,
+                   const uint16_t* pixels);
+    
+    const XipStreamStats& stats() const { return _stats; }
+    void resetStats();
+
+private:
+    uint16_t* _memory;
+    uint32_t _bufferPixels;   // < Pixels per buffer (even)
+    int _dma;
+    XipStreamStats _stats;
+};
+
+#endif // XIPSTREAM_H